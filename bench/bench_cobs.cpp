@@ -0,0 +1,99 @@
+#include "bench_harness.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <umsg/cobs.hpp>
+#include <umsg/common.hpp>
+
+namespace
+{
+    static const size_t kMaxInput = 1024;
+    static const size_t kMaxEncoded = kMaxInput + kMaxInput / 254 + 2;
+
+    struct Encode
+    {
+        const uint8_t *input;
+        size_t length;
+        uint8_t *output;
+
+        void operator()(size_t iterations) const
+        {
+            size_t total = 0;
+            for (size_t it = 0; it < iterations; ++it)
+            {
+                // Header/payload split as in Node before scatter-gather encoding.
+                size_t outLength = 0;
+                (void)umsg::cobsEncode2(input, 8, input + 8, length - 8, output, kMaxEncoded, outLength);
+                total += outLength;
+                umsg_bench::doNotOptimize(output[0]);
+            }
+            umsg_bench::doNotOptimize(total);
+        }
+    };
+
+    struct DecodeInPlace
+    {
+        const uint8_t *encoded;
+        size_t encodedLength;
+        uint8_t *scratch;
+
+        void operator()(size_t iterations) const
+        {
+            size_t total = 0;
+            for (size_t it = 0; it < iterations; ++it)
+            {
+                // Decoding is destructive; restore the input each round (as the framer's
+                // RX buffer is refilled per packet). The copy is part of the measurement.
+                ::memcpy(scratch, encoded, encodedLength);
+                size_t decoded = 0;
+                (void)umsg::cobsDecodeInPlace(scratch, encodedLength, decoded);
+                total += decoded;
+            }
+            umsg_bench::doNotOptimize(total);
+        }
+    };
+
+    // Random bytes with roughly one zero every @p zeroEvery bytes (0: no zeros).
+    void fillInput(uint8_t *data, size_t length, uint32_t zeroEvery)
+    {
+        umsg_bench::Rng rng;
+        for (size_t i = 0; i < length; ++i)
+        {
+            const uint32_t r = rng.next();
+            data[i] = (zeroEvery && r % zeroEvery == 0) ? 0u : static_cast<uint8_t>((r >> 8) | 1u);
+        }
+    }
+}
+
+void bench_cobs(umsg_bench::BenchContext &ctx)
+{
+    static uint8_t input[kMaxInput];
+    static uint8_t encoded[kMaxEncoded];
+    static uint8_t scratch[kMaxEncoded];
+    static const size_t kLengths[] = {16, 256, 1024};
+    static const uint32_t kZeroEvery[] = {0, 8};
+    char label[96];
+
+    for (size_t z = 0; z < sizeof(kZeroEvery) / sizeof(kZeroEvery[0]); ++z)
+    {
+        for (size_t l = 0; l < sizeof(kLengths) / sizeof(kLengths[0]); ++l)
+        {
+            const size_t length = kLengths[l];
+            fillInput(input, length, kZeroEvery[z]);
+            const char *mix = kZeroEvery[z] ? "zeros 1/8" : "no zeros";
+
+            Encode enc = {input, length, encoded};
+            ::snprintf(label, sizeof(label), "cobsEncode2       %5zuB %s", length, mix);
+            ctx.run(label, 1, length, enc);
+
+            size_t encodedLength = 0;
+            (void)umsg::cobsEncode(input, length, encoded, sizeof(encoded), encodedLength);
+            DecodeInPlace dec = {encoded, encodedLength, scratch};
+            ::snprintf(label, sizeof(label), "cobsDecodeInPlace %5zuB %s", length, mix);
+            ctx.run(label, 1, length, dec);
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#include "bench_harness.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <umsg/crc32.hpp>
+
+namespace
+{
+    typedef uint32_t (*UpdateFn)(uint32_t crc, const uint8_t *data, size_t length);
+
+    struct Checksum
+    {
+        UpdateFn update; // null: the configured default via crc32_iso_hdlc()
+        const uint8_t *data;
+        size_t length;
+
+        void operator()(size_t iterations) const
+        {
+            uint32_t acc = 0;
+            for (size_t it = 0; it < iterations; ++it)
+            {
+                acc ^= update ? update(0xFFFFFFFFu ^ acc, data, length) : umsg::crc32_iso_hdlc(data, length);
+            }
+            umsg_bench::doNotOptimize(acc);
+        }
+    };
+
+    struct Variant
+    {
+        const char *name;
+        UpdateFn update;
+    };
+
+    size_t variants(Variant *out)
+    {
+        size_t n = 0;
+        out[n].name = "iso_hdlc (configured)";
+        out[n++].update = 0;
+        out[n].name = "bitwise";
+        out[n++].update = &umsg::detail::crc32_update_bitwise;
+        out[n].name = "nibble table";
+        out[n++].update = &umsg::detail::crc32_update_nibble;
+        out[n].name = "byte table";
+        out[n++].update = &umsg::detail::crc32_update_byte;
+        out[n].name = "slice8";
+        out[n++].update = &umsg::detail::crc32_update_slice8;
+#if defined(UMSG_CRC32_HAVE_ARMV8)
+        out[n].name = "armv8 crc32";
+        out[n++].update = &umsg::detail::crc32_update_armv8;
+#endif
+#if defined(UMSG_CRC32_HAVE_PCLMUL)
+        if (umsg::detail::crc32_pclmul_supported())
+        {
+            out[n].name = "pclmul";
+            out[n++].update = &umsg::detail::crc32_update_pclmul;
+        }
+#endif
+        return n;
+    }
+}
+
+void bench_crc32(umsg_bench::BenchContext &ctx)
+{
+    static uint8_t data[4096];
+    umsg_bench::Rng rng;
+    rng.fill(data, sizeof(data));
+
+    static const size_t kLengths[] = {16, 256, 4096};
+    Variant list[8];
+    const size_t count = variants(list);
+    char label[96];
+
+    for (size_t l = 0; l < sizeof(kLengths) / sizeof(kLengths[0]); ++l)
+    {
+        for (size_t v = 0; v < count; ++v)
+        {
+            Checksum fn = {list[v].update, data, kLengths[l]};
+            ::snprintf(label, sizeof(label), "crc32 %-22s %5zuB", list[v].name, kLengths[l]);
+            ctx.run(label, 1, kLengths[l], fn);
+        }
+    }
+}
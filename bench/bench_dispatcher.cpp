@@ -0,0 +1,89 @@
+#include "bench_harness.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <umsg/common.hpp>
+#include <umsg/dispatcher.hpp>
+
+namespace
+{
+    static const size_t kIdSequenceLength = 4096;
+
+    struct Sink
+    {
+        uint32_t sum;
+
+        Sink() : sum(0) {}
+
+        umsg::Error onMsg(umsg::ByteSpan payload, uint32_t msgHash)
+        {
+            sum += msgHash + static_cast<uint32_t>(payload.length);
+            return umsg::Error::OK;
+        }
+    };
+
+    template <size_t Handlers, bool Dense>
+    struct Dispatch
+    {
+        umsg::Dispatcher<Handlers, Dense> *dispatcher;
+        const uint8_t *ids;
+
+        void operator()(size_t iterations) const
+        {
+            uint8_t payload[4] = {0};
+            size_t ok = 0;
+            for (size_t it = 0; it < iterations; ++it)
+            {
+                for (size_t i = 0; i < kIdSequenceLength; ++i)
+                {
+                    ok += dispatcher->dispatch(ids[i], 1u, umsg::ByteSpan{payload, sizeof(payload)}) == umsg::Error::OK;
+                }
+            }
+            umsg_bench::doNotOptimize(ok);
+        }
+    };
+
+    // Handlers on ids 3, 7, 11, ... ; received ids drawn uniformly from them, so the
+    // linear scan walks half the table on average.
+    template <size_t Handlers, bool Dense>
+    void runMode(umsg_bench::BenchContext &ctx, Sink &sink, const uint8_t *ids)
+    {
+        static umsg::Dispatcher<Handlers, Dense> d;
+        for (size_t h = 0; h < Handlers; ++h)
+        {
+            (void)d.registerHandler(static_cast<uint8_t>(3 + 4 * h), &sink, &Sink::onMsg);
+        }
+
+        char label[96];
+        ::snprintf(label, sizeof(label), "dispatch %-6s handlers=%zu", Dense ? "dense" : "linear", Handlers);
+        Dispatch<Handlers, Dense> fn = {&d, ids};
+        ctx.run(label, kIdSequenceLength, 0, fn);
+    }
+
+    template <size_t Handlers>
+    void runBoth(umsg_bench::BenchContext &ctx)
+    {
+        static uint8_t ids[kIdSequenceLength];
+        umsg_bench::Rng rng;
+        for (size_t i = 0; i < kIdSequenceLength; ++i)
+        {
+            ids[i] = static_cast<uint8_t>(3 + 4 * (rng.next() % Handlers));
+        }
+
+        Sink sink;
+        runMode<Handlers, false>(ctx, sink, ids);
+        runMode<Handlers, true>(ctx, sink, ids);
+        umsg_bench::doNotOptimize(sink.sum);
+    }
+}
+
+void bench_dispatcher(umsg_bench::BenchContext &ctx)
+{
+    runBoth<1>(ctx);
+    runBoth<4>(ctx);
+    runBoth<16>(ctx);
+    runBoth<64>(ctx);
+    runBoth<128>(ctx);
+}
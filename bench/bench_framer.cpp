@@ -0,0 +1,122 @@
+#include "bench_harness.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <umsg/common.hpp>
+#include <umsg/framer.hpp>
+
+namespace
+{
+    static const size_t kMaxPayload = 1024;
+    static const size_t kMaxPacket = umsg::maxPacketSize(kMaxPayload);
+    static const size_t kStreamCapacity = 64 * 1024;
+
+    typedef umsg::Framer<kMaxPacket> FramerT;
+
+    // A stream of back-to-back packets carrying random frames of @p frameLength bytes.
+    size_t buildStream(uint8_t *stream, size_t capacity, size_t frameLength, size_t &frames)
+    {
+        umsg_bench::Rng rng;
+        FramerT tx;
+        uint8_t frame[kMaxPayload];
+        uint8_t packet[kMaxPacket];
+        size_t length = 0;
+        frames = 0;
+        for (;;)
+        {
+            rng.fill(frame, frameLength);
+            umsg::ByteSpan out{packet, sizeof(packet)};
+            if (tx.encode(umsg::ByteSpan{frame, frameLength}, out) != umsg::Error::OK)
+            {
+                break;
+            }
+            if (length + out.length > capacity)
+            {
+                break;
+            }
+            for (size_t i = 0; i < out.length; ++i)
+            {
+                stream[length + i] = out.data[i];
+            }
+            length += out.length;
+            ++frames;
+        }
+        return length;
+    }
+
+    struct FeedBytes
+    {
+        const uint8_t *stream;
+        size_t length;
+
+        void operator()(size_t iterations) const
+        {
+            FramerT rx;
+            size_t completed = 0;
+            for (size_t it = 0; it < iterations; ++it)
+            {
+                for (size_t i = 0; i < length; ++i)
+                {
+                    completed += rx.feed(stream[i]).complete ? 1u : 0u;
+                }
+            }
+            umsg_bench::doNotOptimize(completed);
+        }
+    };
+
+    struct FeedSpan
+    {
+        uint8_t *stream;
+        size_t length;
+        size_t chunk;
+
+        void operator()(size_t iterations) const
+        {
+            FramerT rx;
+            size_t completed = 0;
+            for (size_t it = 0; it < iterations; ++it)
+            {
+                for (size_t pos = 0; pos < length; pos += chunk)
+                {
+                    const size_t n = (length - pos) < chunk ? (length - pos) : chunk;
+                    umsg::ByteSpan in{&stream[pos], n};
+                    while (in.length > 0)
+                    {
+                        size_t used = 0;
+                        completed += rx.feed(in, used).complete ? 1u : 0u;
+                        in.data += used;
+                        in.length -= used;
+                    }
+                }
+            }
+            umsg_bench::doNotOptimize(completed);
+        }
+    };
+}
+
+void bench_framer(umsg_bench::BenchContext &ctx)
+{
+    static uint8_t stream[kStreamCapacity];
+    static const size_t kFrameLengths[] = {16, 256, 1024};
+    char label[96];
+
+    for (size_t f = 0; f < sizeof(kFrameLengths) / sizeof(kFrameLengths[0]); ++f)
+    {
+        size_t frames = 0;
+        const size_t length = buildStream(stream, sizeof(stream), kFrameLengths[f], frames);
+
+        FeedBytes byBytes = {stream, length};
+        ::snprintf(label, sizeof(label), "feed(byte)          frame=%zuB", kFrameLengths[f]);
+        ctx.run(label, frames, length, byBytes);
+
+        static const size_t kChunks[] = {64, 4096};
+        for (size_t c = 0; c < sizeof(kChunks) / sizeof(kChunks[0]); ++c)
+        {
+            FeedSpan bySpan = {stream, length, kChunks[c]};
+            ::snprintf(label, sizeof(label), "feed(span) chunk=%zu frame=%zuB", kChunks[c], kFrameLengths[f]);
+            ctx.run(label, frames, length, bySpan);
+        }
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <chrono>
+
+namespace umsg_bench
+{
+    /** @brief Keep @p value alive so the optimizer cannot drop the measured work. */
+    template <class T>
+    inline void doNotOptimize(const T &value)
+    {
+#if defined(__GNUC__)
+        __asm__ __volatile__("" : : "g"(&value) : "memory");
+#else
+        static volatile const void *sink;
+        sink = &value;
+#endif
+    }
+
+    struct BenchContext
+    {
+        double minSeconds;
+
+        BenchContext() : minSeconds(0.2) {}
+
+        /**
+         * @brief Time @p fn (called as `fn(iterations)`) and print one result line.
+         *
+         * Iterations double until a run lasts at least `minSeconds`.
+         *
+         * @param name Row label.
+         * @param opsPerIter Logical operations (frames, dispatches, ...) per iteration.
+         * @param bytesPerIter Payload bytes per iteration (0 to omit MB/s).
+         */
+        template <class Fn>
+        void run(const char *name, size_t opsPerIter, size_t bytesPerIter, Fn fn)
+        {
+            typedef std::chrono::steady_clock Clock;
+            size_t iterations = 1;
+            double seconds = 0.0;
+            for (;;)
+            {
+                const Clock::time_point start = Clock::now();
+                fn(iterations);
+                const Clock::time_point stop = Clock::now();
+                seconds = std::chrono::duration<double>(stop - start).count();
+                if (seconds >= minSeconds || iterations >= (static_cast<size_t>(1) << 40))
+                {
+                    break;
+                }
+                iterations *= 2;
+            }
+
+            const double ops = static_cast<double>(iterations) * static_cast<double>(opsPerIter);
+            const double nsPerOp = seconds * 1e9 / ops;
+            if (bytesPerIter)
+            {
+                const double mbPerSec = static_cast<double>(iterations) * static_cast<double>(bytesPerIter) /
+                                        seconds / 1e6;
+                ::fprintf(stdout, "  %-48s %12.1f ns/op %10.1f MB/s\n", name, nsPerOp, mbPerSec);
+            }
+            else
+            {
+                ::fprintf(stdout, "  %-48s %12.1f ns/op\n", name, nsPerOp);
+            }
+        }
+    };
+
+    /** @brief Deterministic xorshift32 generator so every run measures the same data. */
+    struct Rng
+    {
+        uint32_t state;
+
+        explicit Rng(uint32_t seed = 0x2545F491u) : state(seed) {}
+
+        uint32_t next()
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+
+        void fill(uint8_t *data, size_t length)
+        {
+            for (size_t i = 0; i < length; ++i)
+            {
+                data[i] = static_cast<uint8_t>(next());
+            }
+        }
+    };
+}
@@ -0,0 +1,48 @@
+#include "bench_harness.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void bench_cobs(umsg_bench::BenchContext &ctx);
+void bench_crc32(umsg_bench::BenchContext &ctx);
+void bench_framer(umsg_bench::BenchContext &ctx);
+void bench_dispatcher(umsg_bench::BenchContext &ctx);
+void bench_marshal(umsg_bench::BenchContext &ctx);
+void bench_node(umsg_bench::BenchContext &ctx);
+
+int main(int argc, char **argv)
+{
+    umsg_bench::BenchContext ctx;
+
+    struct BenchDef
+    {
+        const char *name;
+        const char *description;
+        void (*fn)(umsg_bench::BenchContext &ctx);
+    };
+
+    static const BenchDef benches[] = {
+        {"cobs", "cobsEncode2 / cobsDecodeInPlace", &bench_cobs},
+        {"crc32", "CRC-32/ISO-HDLC, every backend compiled in", &bench_crc32},
+        {"framer", "Framer::feed(byte) vs feed(span, consumed)", &bench_framer},
+        {"dispatcher", "Dispatcher linear scan vs dense msgId table", &bench_dispatcher},
+        {"marshal", "write()/read() vs writeArray()/readArray(); generated Writer/Reader vs offsets; LZ4", &bench_marshal},
+        {"node", "Node::publish -> Node::poll loopback, Router forwarding (ns/frame)", &bench_node},
+    };
+
+    // Usage: umsg_bench [filter] — runs groups whose name contains `filter`.
+    const char *filter = (argc > 1) ? argv[1] : 0;
+
+    const size_t benchCount = sizeof(benches) / sizeof(benches[0]);
+    for (size_t i = 0; i < benchCount; ++i)
+    {
+        if (filter && !::strstr(benches[i].name, filter))
+        {
+            continue;
+        }
+        ::fprintf(stdout, "\n=== %s: %s\n", benches[i].name, benches[i].description);
+        benches[i].fn(ctx);
+    }
+    return 0;
+}
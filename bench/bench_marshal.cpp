@@ -0,0 +1,296 @@
+#include "bench_harness.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <umsg/compress.hpp>
+#include <umsg/marshalling.hpp>
+
+#include "../examples/Common/messages/RobotState.hpp"
+#include "../tests/messages/Telemetry.hpp"
+
+namespace
+{
+    static const size_t kElements = 256;
+
+    template <class T>
+    struct WriteBulk
+    {
+        const T *values;
+        uint8_t *out;
+
+        void operator()(size_t iterations) const
+        {
+            for (size_t it = 0; it < iterations; ++it)
+            {
+                umsg::Writer w(umsg::ByteSpan{out, kElements * sizeof(T)});
+                umsg_bench::doNotOptimize(w.writeArray(values, kElements));
+                umsg_bench::doNotOptimize(out[0]);
+            }
+        }
+    };
+
+    template <class T>
+    struct WriteScalars
+    {
+        const T *values;
+        uint8_t *out;
+
+        void operator()(size_t iterations) const
+        {
+            for (size_t it = 0; it < iterations; ++it)
+            {
+                umsg::Writer w(umsg::ByteSpan{out, kElements * sizeof(T)});
+                bool ok = true;
+                for (size_t i = 0; i < kElements; ++i)
+                {
+                    ok = w.write(values[i]) && ok;
+                }
+                umsg_bench::doNotOptimize(ok);
+                umsg_bench::doNotOptimize(out[0]);
+            }
+        }
+    };
+
+    template <class T>
+    struct ReadBulk
+    {
+        uint8_t *in;
+        T *values;
+
+        void operator()(size_t iterations) const
+        {
+            for (size_t it = 0; it < iterations; ++it)
+            {
+                umsg::Reader r(umsg::ByteSpan{in, kElements * sizeof(T)});
+                umsg_bench::doNotOptimize(r.readArray(values, kElements));
+                umsg_bench::doNotOptimize(values[0]);
+            }
+        }
+    };
+
+    template <class T>
+    struct ReadScalars
+    {
+        uint8_t *in;
+        T *values;
+
+        void operator()(size_t iterations) const
+        {
+            for (size_t it = 0; it < iterations; ++it)
+            {
+                umsg::Reader r(umsg::ByteSpan{in, kElements * sizeof(T)});
+                bool ok = true;
+                for (size_t i = 0; i < kElements; ++i)
+                {
+                    ok = r.read(values[i]) && ok;
+                }
+                umsg_bench::doNotOptimize(ok);
+                umsg_bench::doNotOptimize(values[0]);
+            }
+        }
+    };
+
+    template <class T>
+    void runType(umsg_bench::BenchContext &ctx, const char *typeName)
+    {
+        static T values[kElements];
+        static uint8_t wire[kElements * sizeof(T)];
+        umsg_bench::Rng rng;
+        rng.fill(reinterpret_cast<uint8_t *>(values), sizeof(values));
+        if (sizeof(T) == 1)
+        {
+            // Keep bools canonical in memory (and uint8/int8 unaffected).
+            for (size_t i = 0; i < kElements; ++i)
+            {
+                reinterpret_cast<uint8_t *>(values)[i] &= 1u;
+            }
+        }
+        umsg::Writer w(umsg::ByteSpan{wire, sizeof(wire)});
+        (void)w.writeArray(values, kElements);
+
+        const size_t bytes = sizeof(wire);
+        char label[96];
+
+        WriteScalars<T> ws = {values, wire};
+        ::snprintf(label, sizeof(label), "write() x%zu      %-8s", kElements, typeName);
+        ctx.run(label, kElements, bytes, ws);
+        WriteBulk<T> wb = {values, wire};
+        ::snprintf(label, sizeof(label), "writeArray(%zu)   %-8s", kElements, typeName);
+        ctx.run(label, kElements, bytes, wb);
+
+        ReadScalars<T> rs = {wire, values};
+        ::snprintf(label, sizeof(label), "read() x%zu       %-8s", kElements, typeName);
+        ctx.run(label, kElements, bytes, rs);
+        ReadBulk<T> rb = {wire, values};
+        ::snprintf(label, sizeof(label), "readArray(%zu)    %-8s", kElements, typeName);
+        ctx.run(label, kElements, bytes, rb);
+    }
+
+    // The per-field Reader decode umsg_gen emitted before the constant-offset path.
+    bool readerDecode(RobotState &m, umsg::ByteSpan payload)
+    {
+        umsg::Reader r(payload);
+        return payload.length >= RobotState::kPayloadSize && r.read(m.mode) && r.read(m.battery_voltage);
+    }
+
+    bool readerDecode(Telemetry &m, umsg::ByteSpan payload)
+    {
+        umsg::Reader r(payload);
+        return payload.length >= Telemetry::kPayloadSize && r.read(m.mode) && r.read(m.trim) &&
+               r.read(m.armed) && r.read(m.seq) && r.read(m.offset) && r.read(m.flags) &&
+               r.read(m.position) && r.read(m.timestamp_us) && r.read(m.drift_ns) && r.read(m.voltage) &&
+               r.read(m.latitude) && r.readArray(m.samples, 4) && r.readArray(m.faults, 3);
+    }
+
+    template <class Msg, bool Fixed>
+    struct EncodeMsg
+    {
+        const Msg *msg;
+        uint8_t *out;
+
+        void operator()(size_t iterations) const
+        {
+            for (size_t it = 0; it < iterations; ++it)
+            {
+                umsg::ByteSpan span{out, Msg::kPayloadSize};
+                if (Fixed)
+                {
+                    umsg_bench::doNotOptimize(msg->encode(span));
+                }
+                else
+                {
+                    umsg::Writer w(span);
+                    umsg_bench::doNotOptimize(msg->encodeTo(w));
+                }
+                umsg_bench::doNotOptimize(out[0]);
+            }
+        }
+    };
+
+    template <class Msg, bool Fixed>
+    struct DecodeMsg
+    {
+        uint8_t *in;
+        Msg *msg;
+
+        void operator()(size_t iterations) const
+        {
+            for (size_t it = 0; it < iterations; ++it)
+            {
+                const umsg::ByteSpan span{in, Msg::kPayloadSize};
+                umsg_bench::doNotOptimize(Fixed ? msg->decode(span) : readerDecode(*msg, span));
+                umsg_bench::doNotOptimize(*msg);
+            }
+        }
+    };
+
+    template <class Msg>
+    void runMessage(umsg_bench::BenchContext &ctx, const char *name)
+    {
+        static Msg msg;
+        static uint8_t wire[Msg::kPayloadSize];
+        ::memset(&msg, 0, sizeof(msg));
+        umsg::ByteSpan span{wire, sizeof(wire)};
+        (void)msg.encode(span);
+
+        char label[96];
+        EncodeMsg<Msg, false> ew = {&msg, wire};
+        ::snprintf(label, sizeof(label), "%-12s encodeTo(Writer)", name);
+        ctx.run(label, 1, sizeof(wire), ew);
+        EncodeMsg<Msg, true> ef = {&msg, wire};
+        ::snprintf(label, sizeof(label), "%-12s encode() offsets", name);
+        ctx.run(label, 1, sizeof(wire), ef);
+        DecodeMsg<Msg, false> dr = {wire, &msg};
+        ::snprintf(label, sizeof(label), "%-12s decode via Reader", name);
+        ctx.run(label, 1, sizeof(wire), dr);
+        DecodeMsg<Msg, true> df = {wire, &msg};
+        ::snprintf(label, sizeof(label), "%-12s decode() offsets", name);
+        ctx.run(label, 1, sizeof(wire), df);
+    }
+
+    static const size_t kTileSize = 8192;
+
+    struct Compress
+    {
+        const uint8_t *in;
+        uint8_t *out;
+        uint16_t *table;
+        size_t *packedLength;
+
+        void operator()(size_t iterations) const
+        {
+            for (size_t it = 0; it < iterations; ++it)
+            {
+                umsg::ByteSpan packed{out, umsg::lz4::compressBound(kTileSize)};
+                umsg_bench::doNotOptimize(umsg::lz4::compress(umsg::ByteSpan{const_cast<uint8_t *>(in), kTileSize},
+                                                              packed, table, 12));
+                *packedLength = packed.length;
+            }
+        }
+    };
+
+    struct Decompress
+    {
+        uint8_t *in;
+        size_t length;
+        uint8_t *out;
+
+        void operator()(size_t iterations) const
+        {
+            for (size_t it = 0; it < iterations; ++it)
+            {
+                umsg::ByteSpan unpacked{out, kTileSize};
+                umsg_bench::doNotOptimize(umsg::lz4::decompress(umsg::ByteSpan{in, length}, unpacked));
+                umsg_bench::doNotOptimize(out[0]);
+            }
+        }
+    };
+
+    // Occupancy-grid tile: long runs of free / unknown / occupied cells with noise.
+    void runLz4(umsg_bench::BenchContext &ctx)
+    {
+        static uint8_t tile[kTileSize];
+        static uint8_t packed[umsg::lz4::compressBound(kTileSize)];
+        static uint8_t unpacked[kTileSize];
+        static uint16_t table[1u << 12];
+        umsg_bench::Rng rng;
+        for (size_t i = 0; i < kTileSize;)
+        {
+            static const uint8_t kCells[] = {0, 0, 0xFF, 100};
+            const uint8_t cell = kCells[rng.next() & 3u];
+            for (size_t run = 8 + rng.next() % 120; run && i < kTileSize; --run, ++i)
+            {
+                tile[i] = (rng.next() & 63u) ? cell : static_cast<uint8_t>(rng.next());
+            }
+        }
+
+        size_t packedLength = 0;
+        Compress c = {tile, packed, table, &packedLength};
+        ctx.run("lz4 compress 8 KB map tile", 1, kTileSize, c);
+        Decompress d = {packed, packedLength, unpacked};
+        ctx.run("lz4 decompress 8 KB map tile", 1, kTileSize, d);
+        ::fprintf(stdout, "  %-48s %12.2f x (%zu -> %zu bytes)\n", "lz4 ratio", static_cast<double>(kTileSize) / packedLength,
+                  kTileSize, packedLength);
+    }
+}
+
+void bench_marshal(umsg_bench::BenchContext &ctx)
+{
+    runType<uint8_t>(ctx, "uint8_t");
+    runType<bool>(ctx, "bool");
+    runType<int16_t>(ctx, "int16_t");
+    runType<uint32_t>(ctx, "uint32_t");
+    runType<float>(ctx, "float");
+    runType<uint64_t>(ctx, "uint64_t");
+    runType<double>(ctx, "double");
+
+    // Generated fixed-layout messages: per-field Writer/Reader vs constant offsets.
+    runMessage<RobotState>(ctx, "RobotState");
+    runMessage<Telemetry>(ctx, "Telemetry");
+
+    // Payload compression (Node::beginCompression()).
+    runLz4(ctx);
+}
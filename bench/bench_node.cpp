@@ -0,0 +1,240 @@
+#include "bench_harness.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <umsg/umsg.h>
+
+namespace
+{
+    static const size_t kMaxPayload = 1024;
+
+    // Single-buffer loopback with a bulk read: publish() appends, poll() drains.
+    struct Loopback
+    {
+        uint8_t bytes[2 * umsg::maxPacketSize(kMaxPayload)];
+        size_t head;
+        size_t tail;
+
+        Loopback() : head(0), tail(0) {}
+
+        bool write(const uint8_t *data, size_t length)
+        {
+            if (length > sizeof(bytes) - tail)
+            {
+                return false;
+            }
+            ::memcpy(&bytes[tail], data, length);
+            tail += length;
+            return true;
+        }
+
+        bool read(uint8_t &byte)
+        {
+            if (head == tail)
+            {
+                head = tail = 0;
+                return false;
+            }
+            byte = bytes[head++];
+            return true;
+        }
+
+        bool read(uint8_t *data, size_t capacity, size_t &length)
+        {
+            length = tail - head < capacity ? tail - head : capacity;
+            if (length == 0)
+            {
+                head = tail = 0;
+                return false;
+            }
+            ::memcpy(data, &bytes[head], length);
+            head += length;
+            return true;
+        }
+    };
+
+    // One-datagram loopback for DatagramNode: write() stores, readDatagram() hands it back.
+    struct DatagramLoopback
+    {
+        uint8_t bytes[umsg::maxDatagramSize(kMaxPayload)];
+        size_t length;
+
+        DatagramLoopback() : length(0) {}
+
+        bool write(const uint8_t *data, size_t n)
+        {
+            if (length != 0 || n > sizeof(bytes))
+            {
+                return false;
+            }
+            ::memcpy(bytes, data, n);
+            length = n;
+            return true;
+        }
+
+        bool readDatagram(umsg::ByteSpan &datagram)
+        {
+            if (length == 0)
+            {
+                return false;
+            }
+            datagram.data = bytes;
+            datagram.length = length;
+            length = 0;
+            return true;
+        }
+    };
+
+    struct Counter
+    {
+        size_t frames;
+        size_t bytes;
+
+        Counter() : frames(0), bytes(0) {}
+
+        umsg::Error onPayload(umsg::ByteSpan payload, uint32_t)
+        {
+            ++frames;
+            bytes += payload.length;
+            return umsg::Error::OK;
+        }
+    };
+
+    // Output link that only counts bytes.
+    struct NullSink
+    {
+        size_t bytes;
+
+        NullSink() : bytes(0) {}
+
+        bool write(const uint8_t *, size_t length)
+        {
+            bytes += length;
+            return true;
+        }
+    };
+
+    typedef umsg::Node<NullSink, kMaxPayload, 1> OutNodeT;
+
+    // What a Node-based bridge does per frame: decode, then publish again.
+    struct Republisher
+    {
+        OutNodeT *out;
+
+        umsg::Error onPayload(umsg::ByteSpan payload, uint32_t msgHash) { return out->publish(1, msgHash, payload); }
+    };
+
+    typedef umsg::Node<Loopback, kMaxPayload, 4> NodeT;
+    typedef umsg::DatagramNode<DatagramLoopback, kMaxPayload, 4> DatagramNodeT;
+
+    template <class N>
+    struct RoundTrip
+    {
+        N *node;
+        const uint8_t *payload;
+        size_t length;
+
+        void operator()(size_t iterations) const
+        {
+            for (size_t it = 0; it < iterations; ++it)
+            {
+                (void)node->publish(1, 0x12345678u, umsg::ByteSpan{const_cast<uint8_t *>(payload), length});
+                (void)node->poll();
+            }
+        }
+    };
+
+    // Forward one pre-encoded packet per iteration, through a Router or a Node bridge.
+    struct RouterForward
+    {
+        umsg::Router<kMaxPayload> *router;
+        const uint8_t *packet;
+        size_t length;
+
+        void operator()(size_t iterations) const
+        {
+            for (size_t it = 0; it < iterations; ++it)
+            {
+                router->feed(umsg::ByteSpan{const_cast<uint8_t *>(packet), length});
+            }
+        }
+    };
+
+    struct NodeBridge
+    {
+        NodeT *node;
+        Loopback *link;
+        const uint8_t *packet;
+        size_t length;
+
+        void operator()(size_t iterations) const
+        {
+            for (size_t it = 0; it < iterations; ++it)
+            {
+                (void)link->write(packet, length);
+                (void)node->poll();
+            }
+        }
+    };
+}
+
+void bench_node(umsg_bench::BenchContext &ctx)
+{
+    static uint8_t payload[kMaxPayload];
+    umsg_bench::Rng rng;
+    rng.fill(payload, sizeof(payload));
+
+    static Loopback link;
+    static NodeT node(link, 1);
+    static DatagramLoopback dgramLink;
+    static DatagramNodeT dgramNode(dgramLink, 1);
+    Counter counter;
+    (void)node.subscribe(1, &counter, &Counter::onPayload);
+    (void)dgramNode.subscribe(1, &counter, &Counter::onPayload);
+
+    static const size_t kLengths[] = {0, 16, 64, 256, 1024};
+    char label[96];
+    for (size_t l = 0; l < sizeof(kLengths) / sizeof(kLengths[0]); ++l)
+    {
+        RoundTrip<NodeT> fn = {&node, payload, kLengths[l]};
+        ::snprintf(label, sizeof(label), "publish -> poll loopback %5zuB", kLengths[l]);
+        ctx.run(label, 1, kLengths[l], fn);
+
+        RoundTrip<DatagramNodeT> dfn = {&dgramNode, payload, kLengths[l]};
+        ::snprintf(label, sizeof(label), "publish -> poll datagram %5zuB", kLengths[l]);
+        ctx.run(label, 1, kLengths[l], dfn);
+    }
+    umsg_bench::doNotOptimize(counter.frames);
+
+    // Serial-to-serial bridge: Router (header only) vs decode + re-publish.
+    static NullSink sink;
+    static OutNodeT outNode(sink, 1);
+    static umsg::RouteTable<1> routes;
+    (void)routes.add(1, umsg::RouterPort::stream(sink));
+    static umsg::Router<kMaxPayload> router(routes);
+    static Loopback bridgeLink;
+    static NodeT bridgeNode(bridgeLink, 1);
+    Republisher republisher = {&outNode};
+    (void)bridgeNode.subscribe(1, &republisher, &Republisher::onPayload);
+    for (size_t l = 0; l < sizeof(kLengths) / sizeof(kLengths[0]); ++l)
+    {
+        bridgeLink.head = bridgeLink.tail = 0;
+        (void)bridgeNode.publish(1, 0x12345678u, umsg::ByteSpan{payload, kLengths[l]});
+        static uint8_t packet[umsg::maxPacketSize(kMaxPayload)];
+        const size_t length = bridgeLink.tail;
+        ::memcpy(packet, bridgeLink.bytes, length);
+        bridgeLink.tail = 0;
+
+        RouterForward rfn = {&router, packet, length};
+        ::snprintf(label, sizeof(label), "forward Router          %5zuB", kLengths[l]);
+        ctx.run(label, 1, kLengths[l], rfn);
+
+        NodeBridge bfn = {&bridgeNode, &bridgeLink, packet, length};
+        ::snprintf(label, sizeof(label), "forward Node republish  %5zuB", kLengths[l]);
+        ctx.run(label, 1, kLengths[l], bfn);
+    }
+    umsg_bench::doNotOptimize(sink.bytes);
+}
@@ -19,22 +19,63 @@ struct Heartbeat
     static const uint32_t kMsgHash = 0xF5BA0031u;
     static const size_t kPayloadSize = sizeof(uint32_t);
 
-    bool encode(umsg::ByteSpan& payload) const
+    template <class W>
+    bool encodeTo(W& w) const
     {
-        if (!payload.data) return false;
-        const size_t cap = payload.length;
-        umsg::Writer w(payload);
         if (!w.write(uptime_ms)) return false;
-        if (w.bytesWritten() > cap) return false;
-        payload.length = w.bytesWritten();
+        return true;
+    }
+
+    size_t encodedSize() const { return kPayloadSize; }
+
+    // Wire offset of each field.
+    struct Offset
+    {
+        static const size_t uptime_ms = 0u;
+    };
+
+    // Store every field at its offset; out must hold kPayloadSize bytes.
+    void encodeUnchecked(uint8_t* out) const
+    {
+        umsg::write_be(out + Offset::uptime_ms, uptime_ms);
+    }
+
+    bool encode(umsg::ByteSpan& payload) const
+    {
+        if (!payload.data || payload.length < kPayloadSize) return false;
+        encodeUnchecked(payload.data);
+        payload.length = kPayloadSize;
         return true;
     }
 
+    bool decode(umsg::ByteSpan payload)
+    {
+        if (!payload.data || payload.length < kPayloadSize) return false;
+        const uint8_t* in = payload.data;
+        uptime_ms = umsg::read_be<uint32_t>(in + Offset::uptime_ms);
+        return true;
+    }
+};
+
+// Zero-copy view of a Heartbeat payload: subscribe with
+// `Error (T::*)(const HeartbeatView&)` to skip the decode copy. Accessors read the
+// aliased payload, so a view is only valid for the duration of the handler call.
+struct HeartbeatView
+{
+    static const uint32_t kMsgHash = Heartbeat::kMsgHash;
+    static const size_t kPayloadSize = Heartbeat::kPayloadSize;
+
+    HeartbeatView() : data_(0) {}
+
     bool decode(umsg::ByteSpan payload)
     {
         if (payload.length < kPayloadSize) return false;
-        umsg::Reader r(payload);
-        if (!r.read(uptime_ms)) return false;
+        data_ = payload.data;
         return true;
     }
+
+    uint32_t uptime_ms() const { return umsg::read_be<uint32_t>(data_ + Heartbeat::Offset::uptime_ms); }
+
+private:
+    const uint8_t* data_;
 };
@@ -20,24 +20,68 @@ struct RobotState
     static const uint32_t kMsgHash = 0x6F95B45Au;
     static const size_t kPayloadSize = sizeof(uint8_t) + sizeof(float);
 
-    bool encode(umsg::ByteSpan& payload) const
+    template <class W>
+    bool encodeTo(W& w) const
     {
-        if (!payload.data) return false;
-        const size_t cap = payload.length;
-        umsg::Writer w(payload);
         if (!w.write(mode)) return false;
         if (!w.write(battery_voltage)) return false;
-        if (w.bytesWritten() > cap) return false;
-        payload.length = w.bytesWritten();
+        return true;
+    }
+
+    size_t encodedSize() const { return kPayloadSize; }
+
+    // Wire offset of each field.
+    struct Offset
+    {
+        static const size_t mode = 0u;
+        static const size_t battery_voltage = 1u;
+    };
+
+    // Store every field at its offset; out must hold kPayloadSize bytes.
+    void encodeUnchecked(uint8_t* out) const
+    {
+        umsg::write_be(out + Offset::mode, mode);
+        umsg::write_be(out + Offset::battery_voltage, battery_voltage);
+    }
+
+    bool encode(umsg::ByteSpan& payload) const
+    {
+        if (!payload.data || payload.length < kPayloadSize) return false;
+        encodeUnchecked(payload.data);
+        payload.length = kPayloadSize;
         return true;
     }
 
+    bool decode(umsg::ByteSpan payload)
+    {
+        if (!payload.data || payload.length < kPayloadSize) return false;
+        const uint8_t* in = payload.data;
+        mode = umsg::read_be<uint8_t>(in + Offset::mode);
+        battery_voltage = umsg::read_be<float>(in + Offset::battery_voltage);
+        return true;
+    }
+};
+
+// Zero-copy view of a RobotState payload: subscribe with
+// `Error (T::*)(const RobotStateView&)` to skip the decode copy. Accessors read the
+// aliased payload, so a view is only valid for the duration of the handler call.
+struct RobotStateView
+{
+    static const uint32_t kMsgHash = RobotState::kMsgHash;
+    static const size_t kPayloadSize = RobotState::kPayloadSize;
+
+    RobotStateView() : data_(0) {}
+
     bool decode(umsg::ByteSpan payload)
     {
         if (payload.length < kPayloadSize) return false;
-        umsg::Reader r(payload);
-        if (!r.read(mode)) return false;
-        if (!r.read(battery_voltage)) return false;
+        data_ = payload.data;
         return true;
     }
+
+    uint8_t mode() const { return umsg::read_be<uint8_t>(data_ + RobotState::Offset::mode); }
+    float battery_voltage() const { return umsg::read_be<float>(data_ + RobotState::Offset::battery_voltage); }
+
+private:
+    const uint8_t* data_;
 };
@@ -20,24 +20,68 @@ struct SensorReading
     static const uint32_t kMsgHash = 0x4DF97BD2u;
     static const size_t kPayloadSize = sizeof(uint32_t) + sizeof(float);
 
-    bool encode(umsg::ByteSpan& payload) const
+    template <class W>
+    bool encodeTo(W& w) const
     {
-        if (!payload.data) return false;
-        const size_t cap = payload.length;
-        umsg::Writer w(payload);
         if (!w.write(sensor_id)) return false;
         if (!w.write(value)) return false;
-        if (w.bytesWritten() > cap) return false;
-        payload.length = w.bytesWritten();
+        return true;
+    }
+
+    size_t encodedSize() const { return kPayloadSize; }
+
+    // Wire offset of each field.
+    struct Offset
+    {
+        static const size_t sensor_id = 0u;
+        static const size_t value = 4u;
+    };
+
+    // Store every field at its offset; out must hold kPayloadSize bytes.
+    void encodeUnchecked(uint8_t* out) const
+    {
+        umsg::write_be(out + Offset::sensor_id, sensor_id);
+        umsg::write_be(out + Offset::value, value);
+    }
+
+    bool encode(umsg::ByteSpan& payload) const
+    {
+        if (!payload.data || payload.length < kPayloadSize) return false;
+        encodeUnchecked(payload.data);
+        payload.length = kPayloadSize;
         return true;
     }
 
+    bool decode(umsg::ByteSpan payload)
+    {
+        if (!payload.data || payload.length < kPayloadSize) return false;
+        const uint8_t* in = payload.data;
+        sensor_id = umsg::read_be<uint32_t>(in + Offset::sensor_id);
+        value = umsg::read_be<float>(in + Offset::value);
+        return true;
+    }
+};
+
+// Zero-copy view of a SensorReading payload: subscribe with
+// `Error (T::*)(const SensorReadingView&)` to skip the decode copy. Accessors read the
+// aliased payload, so a view is only valid for the duration of the handler call.
+struct SensorReadingView
+{
+    static const uint32_t kMsgHash = SensorReading::kMsgHash;
+    static const size_t kPayloadSize = SensorReading::kPayloadSize;
+
+    SensorReadingView() : data_(0) {}
+
     bool decode(umsg::ByteSpan payload)
     {
         if (payload.length < kPayloadSize) return false;
-        umsg::Reader r(payload);
-        if (!r.read(sensor_id)) return false;
-        if (!r.read(value)) return false;
+        data_ = payload.data;
         return true;
     }
+
+    uint32_t sensor_id() const { return umsg::read_be<uint32_t>(data_ + SensorReading::Offset::sensor_id); }
+    float value() const { return umsg::read_be<float>(data_ + SensorReading::Offset::value); }
+
+private:
+    const uint8_t* data_;
 };
@@ -19,22 +19,65 @@ struct SetLed
     static const uint32_t kMsgHash = 0x18E29F44u;
     static const size_t kPayloadSize = sizeof(bool);
 
-    bool encode(umsg::ByteSpan& payload) const
+    template <class W>
+    bool encodeTo(W& w) const
     {
-        if (!payload.data) return false;
-        const size_t cap = payload.length;
-        umsg::Writer w(payload);
         if (!w.write(state)) return false;
-        if (w.bytesWritten() > cap) return false;
-        payload.length = w.bytesWritten();
+        return true;
+    }
+
+    size_t encodedSize() const { return kPayloadSize; }
+
+    // Wire offset of each field.
+    struct Offset
+    {
+        static const size_t state = 0u;
+    };
+
+    // Store every field at its offset; out must hold kPayloadSize bytes.
+    void encodeUnchecked(uint8_t* out) const
+    {
+        umsg::write_be(out + Offset::state, state);
+    }
+
+    bool encode(umsg::ByteSpan& payload) const
+    {
+        if (!payload.data || payload.length < kPayloadSize) return false;
+        encodeUnchecked(payload.data);
+        payload.length = kPayloadSize;
         return true;
     }
 
+    bool decode(umsg::ByteSpan payload)
+    {
+        if (!payload.data || payload.length < kPayloadSize) return false;
+        const uint8_t* in = payload.data;
+        if (!umsg::valid_bools(in + Offset::state, 1u)) return false;
+        state = umsg::read_be<bool>(in + Offset::state);
+        return true;
+    }
+};
+
+// Zero-copy view of a SetLed payload: subscribe with
+// `Error (T::*)(const SetLedView&)` to skip the decode copy. Accessors read the
+// aliased payload, so a view is only valid for the duration of the handler call.
+struct SetLedView
+{
+    static const uint32_t kMsgHash = SetLed::kMsgHash;
+    static const size_t kPayloadSize = SetLed::kPayloadSize;
+
+    SetLedView() : data_(0) {}
+
     bool decode(umsg::ByteSpan payload)
     {
         if (payload.length < kPayloadSize) return false;
-        umsg::Reader r(payload);
-        if (!r.read(state)) return false;
+        if (!umsg::valid_bools(payload.data + SetLed::Offset::state, 1u)) return false;
+        data_ = payload.data;
         return true;
     }
+
+    bool state() const { return umsg::read_be<bool>(data_ + SetLed::Offset::state); }
+
+private:
+    const uint8_t* data_;
 };
@@ -0,0 +1,113 @@
+#include <cstdlib>
+#include <iostream>
+#include <messages/SensorReading.hpp>
+#include <messages/SetLed.hpp>
+#include <sys/epoll.h>
+#include <umsg/transports/posix/udp_socket.hpp>
+#include <umsg/umsg.h>
+
+/*
+ * PosixEpollHub
+ *
+ * Serves many UDP links from one thread: every link is a Node on its own port,
+ * and the process sleeps in epoll_wait() until one of them has data (no polling
+ * loop, zero idle CPU).
+ * Usage: ./PosixEpollHub <first-port> <link-count>
+ *
+ * Feed it with e.g. ./PosixUdpLedController 127.0.0.1 <first-port + n>.
+ */
+
+namespace
+{
+    // Message IDs, as used by the other examples
+    const uint8_t MSG_SET_LED = 4;
+    const uint8_t MSG_SENSOR_ID = 10;
+
+    const int kMaxLinks = 64;
+
+    struct Link
+    {
+        typedef umsg::Node<umsg::posix::UdpSocket, 128, 4> NodeType;
+
+        umsg::posix::UdpSocket udp;
+        NodeType node;
+        uint16_t port;
+
+        Link() : node(udp), port(0) {}
+
+        umsg::Error onSetLed(const SetLed &msg)
+        {
+            std::cout << "[" << port << "] SetLed: " << (msg.state ? "ON" : "OFF") << std::endl;
+            return umsg::Error::OK;
+        }
+
+        umsg::Error onSensorReading(const SensorReading &msg)
+        {
+            std::cout << "[" << port << "] SensorReading " << msg.sensor_id << ": " << msg.value << std::endl;
+            return umsg::Error::OK;
+        }
+    };
+
+    Link links[kMaxLinks];
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <first-port> <link-count>" << std::endl;
+        return 1;
+    }
+
+    const int firstPort = std::atoi(argv[1]);
+    const int count = std::atoi(argv[2]);
+    if (count < 1 || count > kMaxLinks)
+    {
+        std::cerr << "link-count must be 1.." << kMaxLinks << std::endl;
+        return 1;
+    }
+
+    int ep = epoll_create1(0);
+    if (ep < 0)
+    {
+        std::cerr << "epoll_create1 failed" << std::endl;
+        return 1;
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        Link &link = links[i];
+        link.port = (uint16_t)(firstPort + i);
+        if (!link.udp.bind(link.port))
+        {
+            std::cerr << "Failed to bind port " << link.port << std::endl;
+            return 1;
+        }
+        link.node.subscribe(MSG_SET_LED, &link, &Link::onSetLed);
+        link.node.subscribe(MSG_SENSOR_ID, &link, &Link::onSensorReading);
+
+        // Edge-triggered is fine: onReadable() drains the socket until EAGAIN.
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.ptr = &link;
+        if (epoll_ctl(ep, EPOLL_CTL_ADD, link.udp.nativeHandle(), &ev) < 0)
+        {
+            std::cerr << "epoll_ctl failed" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Listening on UDP ports " << firstPort << ".." << (firstPort + count - 1) << std::endl;
+
+    struct epoll_event events[kMaxLinks];
+    while (true)
+    {
+        int n = epoll_wait(ep, events, kMaxLinks, -1);
+        for (int i = 0; i < n; ++i)
+        {
+            static_cast<Link *>(events[i].data.ptr)->node.onReadable();
+        }
+    }
+
+    return 0;
+}
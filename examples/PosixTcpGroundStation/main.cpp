@@ -0,0 +1,79 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <messages/Heartbeat.hpp>
+#include <messages/SensorReading.hpp>
+#include <umsg/transports/posix/tcp_server.hpp>
+#include <umsg/umsg.h>
+
+/*
+ * PosixTcpGroundStation
+ *
+ * Accepts many sensor nodes over TCP in a single thread and prints their
+ * readings, tagged with the connection they came from. Broadcasts a Heartbeat
+ * to every connected node once per second.
+ * Usage: ./PosixTcpGroundStation <port>
+ *
+ * Connect nodes with e.g. ./PosixTcpSensor 127.0.0.1 <port>.
+ */
+
+namespace
+{
+    // Message IDs, as used by the other examples
+    const uint8_t MSG_HEARTBEAT_ID = 1;
+    const uint8_t MSG_SENSOR_ID = 10;
+
+    typedef umsg::posix::TcpServer<128, 256, 4> Server;
+
+    struct Station
+    {
+        Server *server;
+
+        umsg::Error onSensorReading(const SensorReading &msg)
+        {
+            std::cout << "[conn " << server->currentConnection() << "] sensor " << msg.sensor_id << ": "
+                      << msg.value << std::endl;
+            return umsg::Error::OK;
+        }
+    };
+
+    Server server;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <port>" << std::endl;
+        return 1;
+    }
+
+    if (!server.listen((uint16_t)std::atoi(argv[1])))
+    {
+        std::cerr << "Failed to listen" << std::endl;
+        return 1;
+    }
+    std::cout << "Listening on port " << server.port() << std::endl;
+
+    Station station = {&server};
+    server.subscribe(MSG_SENSOR_ID, &station, &Station::onSensorReading);
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point nextBeat = start;
+    while (true)
+    {
+        // Sleeps in epoll_wait() until a node sends data or it is time to beat.
+        server.poll(100);
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (now >= nextBeat)
+        {
+            Heartbeat beat;
+            beat.uptime_ms = (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
+            server.publishAll(MSG_HEARTBEAT_ID, beat);
+            nextBeat += std::chrono::seconds(1);
+        }
+    }
+
+    return 0;
+}
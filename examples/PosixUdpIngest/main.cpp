@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <messages/SensorReading.hpp>
+#include <poll.h>
+#include <thread>
+#include <umsg/transports/posix/udp_socket.hpp>
+#include <umsg/umsg.h>
+
+/*
+ * PosixUdpIngest
+ *
+ * Receives SensorReading datagrams on one UDP port with one worker thread per
+ * core: every worker binds its own SO_REUSEPORT socket and has its own
+ * DatagramNode (framer, dispatcher, buffers), so nothing is shared and the
+ * kernel spreads the senders across the workers.
+ *
+ *   ./PosixUdpIngest <port> [workers] [group]
+ *       receive; with a group (e.g. 239.1.2.3 or ff15::1234) also join it
+ *       on the first worker. Per-worker counts print once a second.
+ *   ./PosixUdpIngest --send <ip> <port> [sensors]
+ *       simulate sensors: one socket (source port) each, 1000 readings/s per sensor
+ */
+
+namespace
+{
+    const uint8_t MSG_SENSOR_ID = 10; // as used by the other examples
+    const int kMaxWorkers = 64;
+    const int kMaxSensors = 1024;
+
+    struct Worker
+    {
+        typedef umsg::DatagramNode<umsg::posix::UdpSocket, 64, 2> NodeType;
+
+        umsg::posix::UdpSocket udp;
+        NodeType node;
+        std::atomic<uint64_t> readings;
+
+        Worker() : node(udp), readings(0) {}
+
+        umsg::Error onSensorReading(const SensorReading &)
+        {
+            readings.fetch_add(1, std::memory_order_relaxed);
+            return umsg::Error::OK;
+        }
+
+        void run()
+        {
+            struct pollfd pfd;
+            pfd.fd = udp.nativeHandle();
+            pfd.events = POLLIN;
+            while (true)
+            {
+                if (::poll(&pfd, 1, -1) > 0)
+                {
+                    node.onReadable();
+                }
+            }
+        }
+    };
+
+    Worker workers[kMaxWorkers];
+
+    struct Sensor
+    {
+        typedef umsg::DatagramNode<umsg::posix::UdpSocket, 64, 1> NodeType;
+
+        umsg::posix::UdpSocket udp;
+        NodeType node;
+
+        Sensor() : node(udp) {}
+    };
+
+    Sensor sensorsOut[kMaxSensors];
+
+    int receive(uint16_t port, int count, const char *group)
+    {
+        // IPv6 groups need a dual-stack socket; it serves IPv4 senders as well.
+        const bool v6 = group && std::strchr(group, ':');
+        for (int i = 0; i < count; ++i)
+        {
+            Worker &w = workers[i];
+            if (!(v6 ? w.udp.bind6(port, true) : w.udp.bind(port, true)))
+            {
+                std::cerr << "Failed to bind port " << port << " (SO_REUSEPORT)" << std::endl;
+                return 1;
+            }
+            w.node.subscribe(MSG_SENSOR_ID, &w, &Worker::onSensorReading);
+        }
+        // Every socket that joins a group gets every datagram sent to it, so
+        // one member is enough.
+        if (group && !workers[0].udp.joinGroup(group))
+        {
+            std::cerr << "Failed to join " << group << std::endl;
+            return 1;
+        }
+
+        std::cout << "Listening on UDP port " << port << " with " << count << " workers";
+        if (group)
+        {
+            std::cout << ", group " << group;
+        }
+        std::cout << std::endl;
+
+        for (int i = 0; i < count; ++i)
+        {
+            std::thread(&Worker::run, &workers[i]).detach();
+        }
+
+        uint64_t last[kMaxWorkers] = {0};
+        while (true)
+        {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            uint64_t total = 0;
+            for (int i = 0; i < count; ++i)
+            {
+                const uint64_t now = workers[i].readings.load(std::memory_order_relaxed);
+                std::cout << (i ? " " : "") << (now - last[i]);
+                total += now - last[i];
+                last[i] = now;
+            }
+            std::cout << "  = " << total << " readings/s" << std::endl;
+        }
+        return 0;
+    }
+
+    int send(const char *ip, uint16_t port, int sensors)
+    {
+        const bool v6 = std::strchr(ip, ':') != nullptr;
+        for (int i = 0; i < sensors; ++i)
+        {
+            // Distinct source ports, so the receiver's kernel can hash them apart.
+            umsg::posix::UdpSocket &udp = sensorsOut[i].udp;
+            if (!(v6 ? udp.bind6(0) : udp.bind(0)) || !udp.setDestination(ip, port))
+            {
+                std::cerr << "Cannot send to " << ip << ":" << port << std::endl;
+                return 1;
+            }
+        }
+
+        std::cout << sensors << " sensors sending to " << ip << ":" << port << std::endl;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t tick = 0;; ++tick)
+        {
+            for (int i = 0; i < sensors; ++i)
+            {
+                SensorReading reading;
+                reading.sensor_id = static_cast<uint32_t>(i);
+                reading.value = static_cast<float>(tick % 100);
+                sensorsOut[i].node.publish(MSG_SENSOR_ID, reading);
+            }
+            std::this_thread::sleep_until(start + std::chrono::milliseconds(tick + 1));
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 4 && std::strcmp(argv[1], "--send") == 0)
+    {
+        const int sensors = argc > 4 ? std::atoi(argv[4]) : 100;
+        if (sensors < 1 || sensors > kMaxSensors)
+        {
+            std::cerr << "sensors must be 1.." << kMaxSensors << std::endl;
+            return 1;
+        }
+        return send(argv[2], (uint16_t)std::atoi(argv[3]), sensors);
+    }
+    if (argc < 2 || argv[1][0] == '-')
+    {
+        std::cerr << "Usage: " << argv[0] << " <port> [workers] [group]" << std::endl;
+        std::cerr << "       " << argv[0] << " --send <ip> <port> [sensors]" << std::endl;
+        return 1;
+    }
+
+    const int cores = (int)std::thread::hardware_concurrency();
+    int count = argc > 2 ? std::atoi(argv[2]) : (cores > 0 ? std::min(cores, kMaxWorkers) : 1);
+    if (count < 1 || count > kMaxWorkers)
+    {
+        std::cerr << "workers must be 1.." << kMaxWorkers << std::endl;
+        return 1;
+    }
+    return receive((uint16_t)std::atoi(argv[1]), count, argc > 3 ? argv[3] : nullptr);
+}
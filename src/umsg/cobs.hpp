@@ -1,6 +1,9 @@
 #pragma once
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
+
+#include "common.hpp"
 
 /**
  * @file cobs.hpp
@@ -63,12 +66,138 @@ namespace umsg
                 return true;
             }
 
+            /**
+             * @brief Bulk `put()`: copies zero-free runs.
+             *
+             * @p data may alias the output buffer as long as it lies at or after the
+             * current write position (the encoder never writes ahead of its input
+             * then); runs are moved with `memmove` for that reason.
+             */
+            bool write(const uint8_t *data, size_t length)
+            {
+                while (length > 0)
+                {
+                    // Non-zero bytes that still fit in the current block (code counts them + 1).
+                    const size_t room = static_cast<size_t>(0xFFu - code);
+                    const size_t n = length < room ? length : room;
+                    const uint8_t *const zero = static_cast<const uint8_t *>(::memchr(data, 0x00, n));
+                    const size_t run = zero ? static_cast<size_t>(zero - data) : n;
+
+                    if (run > 0)
+                    {
+                        if (cap - writeIndex < run) return false;
+                        ::memmove(&out[writeIndex], data, run);
+                        writeIndex += run;
+                        code = static_cast<uint8_t>(code + run);
+                        data += run;
+                        length -= run;
+                    }
+
+                    if (zero)
+                    {
+                        if (!put(0x00)) return false;
+                        ++data;
+                        --length;
+                    }
+                    else if (code == 0xFF)
+                    {
+                        out[codeIndex] = code;
+                        codeIndex = writeIndex;
+                        if (writeIndex >= cap) return false;
+                        ++writeIndex;
+                        code = 1;
+                    }
+                }
+                return true;
+            }
+
             void finish(size_t &outputLength)
             {
                 out[codeIndex] = code;
                 outputLength = writeIndex;
             }
         };
+
+        /**
+         * @brief Streaming COBS decoder over zero-free input (the bytes between two
+         *        delimiters), fed as they arrive. Used by `Framer`.
+         *
+         * A block's implied `0x00` is emitted only when the next block starts, so
+         * once the input ends nothing is left to decode: `complete()` says whether
+         * the last block was whole, and `length` bytes are decoded at `out`.
+         * Decoded output is never longer than the encoded input.
+         */
+        struct CobsDecState
+        {
+            uint8_t *out;
+            size_t length;     ///< Decoded bytes so far.
+            uint8_t code;      ///< Code byte of the current block.
+            uint8_t remaining; ///< Data bytes still expected in the current block.
+            bool pendingZero;  ///< The current block ended and implies a `0x00`.
+
+            void begin(uint8_t *output)
+            {
+                out = output;
+                length = 0;
+                code = 0;
+                remaining = 0;
+                pendingZero = false;
+            }
+
+            /** @brief Decode one (non-zero) encoded byte. */
+            void put(uint8_t b)
+            {
+                if (remaining == 0)
+                {
+                    startBlock(b);
+                    return;
+                }
+                out[length++] = b;
+                if (--remaining == 0)
+                {
+                    pendingZero = code != 0xFF;
+                }
+            }
+
+            /** @brief Bulk `put()` of a zero-free run: block bodies are copied with `memcpy`. */
+            void write(const uint8_t *data, size_t n)
+            {
+                while (n > 0)
+                {
+                    if (remaining == 0)
+                    {
+                        startBlock(*data++);
+                        --n;
+                        continue;
+                    }
+                    const size_t m = n < remaining ? n : remaining;
+                    ::memcpy(&out[length], data, m);
+                    length += m;
+                    data += m;
+                    n -= m;
+                    remaining = static_cast<uint8_t>(remaining - m);
+                    if (remaining == 0)
+                    {
+                        pendingZero = code != 0xFF;
+                    }
+                }
+            }
+
+            /** @brief True unless the input ended inside a block (invalid encoding). */
+            bool complete() const { return remaining == 0; }
+
+        private:
+            void startBlock(uint8_t c)
+            {
+                if (pendingZero)
+                {
+                    out[length++] = 0x00;
+                }
+                code = c;
+                remaining = static_cast<uint8_t>(c - 1);
+                pendingZero = remaining == 0 && c != 0xFF;
+            }
+        };
     }
 
     /**
@@ -92,13 +221,39 @@ namespace umsg
         detail::CobsEncState enc;
         if (!enc.begin(output, outputCapacity)) return false;
 
-        for (size_t i = 0; i < inputALength; ++i)
+        if (!enc.write(inputA, inputALength)) return false;
+        if (!enc.write(inputB, inputBLength)) return false;
+
+        enc.finish(outputLength);
+        return true;
+    }
+
+    /**
+     * @brief COBS-encode the concatenation of @p count input spans into @p output.
+     *
+     * Generalises `cobsEncode2` to any number of pieces (scatter-gather), e.g.
+     * `header || payload || crc32` without assembling them first.
+     * The produced encoding does not include a trailing `0x00` delimiter.
+     *
+     * @return true on success; false if arguments are invalid or output overflows.
+     */
+    inline bool cobsEncodeV(const ByteSpan *inputs,
+                            size_t count,
+                            uint8_t *output,
+                            size_t outputCapacity,
+                            size_t &outputLength)
+    {
+        if (!inputs && count) return false;
+        for (size_t i = 0; i < count; ++i)
         {
-            if (!enc.put(inputA[i])) return false;
+            if (!inputs[i].data && inputs[i].length) return false;
         }
-        for (size_t i = 0; i < inputBLength; ++i)
+
+        detail::CobsEncState enc;
+        if (!enc.begin(output, outputCapacity)) return false;
+        for (size_t i = 0; i < count; ++i)
         {
-            if (!enc.put(inputB[i])) return false;
+            if (!enc.write(inputs[i].data, inputs[i].length)) return false;
         }
 
         enc.finish(outputLength);
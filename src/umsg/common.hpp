@@ -37,7 +37,9 @@ namespace umsg
 
         // --- Generic ---
         InvalidArgument,  ///< Null pointers or invalid arguments
-        TransportError    ///< Transport read/write failed
+        TransportError,   ///< Transport read/write failed
+        QueueFull,        ///< Bounded queue or ring has no free slot
+        CompressionInvalid ///< Compressed payload malformed or larger than MaxPayloadSize
     };
 
     /**
@@ -90,4 +92,14 @@ namespace umsg
                cobsMaxOverhead(maxFrameSize(maxPayloadSize) + 4u) +
                1u;
     }
+
+    /**
+     * @brief Largest datagram-framed packet for a given payload size.
+     *
+     * Datagram packet = `frame || crc32` (no COBS, no delimiter; see `datagram.hpp`).
+     */
+    inline constexpr size_t maxDatagramSize(size_t maxPayloadSize)
+    {
+        return maxFrameSize(maxPayloadSize) + 4u;
+    }
 }
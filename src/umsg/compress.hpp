@@ -0,0 +1,344 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "common.hpp"
+
+/**
+ * @file compress.hpp
+ * @brief Allocation-free LZ4 block codec and the caller-owned `Compression` buffers.
+ * @ingroup umsg
+ *
+ * Payloads of the msg_ids enabled in a `Compression` attached to a `Node`
+ * (`beginCompression()`) are sent as LZ4 blocks when that makes them smaller;
+ * bit 7 of the version byte (`protocol::kCompressedFlag`) tells the receiver.
+ * The block format is standard LZ4 (no frame header, no checksum: the packet
+ * CRC covers it), so any LZ4 block decoder can read it.
+ */
+
+namespace umsg
+{
+    namespace lz4
+    {
+        static const size_t kMinMatch = 4;
+        /** @brief The last 5 bytes of a block are always literals. */
+        static const size_t kLastLiterals = 5;
+        /** @brief No match starts in the last 12 bytes of the input. */
+        static const size_t kMatchFindLimit = 12;
+        static const size_t kMaxOffset = 0xFFFFu;
+
+        /** @brief Worst-case compressed size of @p length input bytes. */
+        inline constexpr size_t compressBound(size_t length) { return length + length / 255u + 16u; }
+
+        namespace detail
+        {
+            inline uint32_t read32(const uint8_t *p)
+            {
+                uint32_t v;
+                ::memcpy(&v, p, sizeof(v));
+                return v;
+            }
+
+            inline size_t hash(uint32_t v, unsigned hashBits)
+            {
+                return static_cast<size_t>((v * 2654435761u) >> (32u - hashBits));
+            }
+
+            /** @brief Bytes needed to extend a 4-bit length field holding @p n. */
+            inline size_t extraLengthBytes(size_t n) { return n < 15u ? 0u : (n - 15u) / 255u + 1u; }
+
+            inline uint8_t *writeExtraLength(uint8_t *op, size_t n)
+            {
+                if (n < 15u)
+                {
+                    return op;
+                }
+                n -= 15u;
+                while (n >= 255u)
+                {
+                    *op++ = 255u;
+                    n -= 255u;
+                }
+                *op++ = static_cast<uint8_t>(n);
+                return op;
+            }
+
+            /** @brief Add the 255-continued length bytes at @p ip to @p n. */
+            inline bool readExtraLength(const uint8_t *in, size_t inLength, size_t &ip, size_t &n)
+            {
+                uint8_t b;
+                do
+                {
+                    if (ip >= inLength)
+                    {
+                        return false;
+                    }
+                    b = in[ip++];
+                    n += b;
+                } while (b == 255u);
+                return true;
+            }
+
+            /**
+             * @brief Append one sequence: @p literalLength bytes from @p literals, then
+             *        a match (@p matchLength >= 4 at @p offset; 0 for the last sequence).
+             */
+            inline bool emit(const uint8_t *literals, size_t literalLength, size_t offset, size_t matchLength,
+                             uint8_t *out, size_t capacity, size_t &op)
+            {
+                const size_t matchCode = matchLength ? matchLength - kMinMatch : 0u;
+                const size_t needed = 1u + extraLengthBytes(literalLength) + literalLength +
+                                      (matchLength ? 2u + extraLengthBytes(matchCode) : 0u);
+                if (needed > capacity - op)
+                {
+                    return false;
+                }
+                uint8_t *p = out + op;
+                *p++ = static_cast<uint8_t>(((literalLength < 15u ? literalLength : 15u) << 4) |
+                                            (matchCode < 15u ? matchCode : 15u));
+                p = writeExtraLength(p, literalLength);
+                if (literalLength)
+                {
+                    ::memcpy(p, literals, literalLength);
+                    p += literalLength;
+                }
+                if (matchLength)
+                {
+                    *p++ = static_cast<uint8_t>(offset & 0xFFu);
+                    *p++ = static_cast<uint8_t>(offset >> 8);
+                    p = writeExtraLength(p, matchCode);
+                }
+                op = static_cast<size_t>(p - out);
+                return true;
+            }
+        }
+
+        /**
+         * @brief Compress @p in as one LZ4 block into @p out (greedy, single-probe hash).
+         *
+         * @param out Capacity-in / length-out.
+         * @param table Scratch of `1 << hashBits` entries; its contents on entry do
+         *        not matter (stale positions are verified before use).
+         * @param hashBits 8..16: more finds longer-range matches, costs 2 bytes per entry.
+         * @return false if @p out is too small (use `compressBound()` to never fail)
+         *         or @p in is longer than 64 KiB.
+         */
+        inline bool compress(ByteSpan in, ByteSpan &out, uint16_t *table, unsigned hashBits)
+        {
+            if ((!in.data && in.length) || !out.data || !table || in.length > 0x10000u)
+            {
+                return false;
+            }
+            const uint8_t *src = in.data;
+            const size_t n = in.length;
+            size_t op = 0;
+            size_t anchor = 0;
+
+            if (n > kMatchFindLimit)
+            {
+                const size_t matchEndLimit = n - kLastLiterals;
+                table[detail::hash(detail::read32(src), hashBits)] = 0;
+                size_t ip = 1;
+                while (ip + kMatchFindLimit <= n)
+                {
+                    const uint32_t sequence = detail::read32(src + ip);
+                    const size_t h = detail::hash(sequence, hashBits);
+                    size_t ref = table[h];
+                    table[h] = static_cast<uint16_t>(ip);
+                    if (ref >= ip || ip - ref > kMaxOffset || detail::read32(src + ref) != sequence)
+                    {
+                        ++ip;
+                        continue;
+                    }
+                    while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1])
+                    {
+                        --ip;
+                        --ref;
+                    }
+                    size_t length = kMinMatch;
+                    while (ip + length < matchEndLimit && src[ref + length] == src[ip + length])
+                    {
+                        ++length;
+                    }
+                    if (!detail::emit(src + anchor, ip - anchor, ip - ref, length, out.data, out.length, op))
+                    {
+                        return false;
+                    }
+                    ip += length;
+                    anchor = ip;
+                    if (ip + kMatchFindLimit <= n)
+                    {
+                        table[detail::hash(detail::read32(src + ip - 2), hashBits)] = static_cast<uint16_t>(ip - 2);
+                    }
+                }
+            }
+            if (!detail::emit(src + anchor, n - anchor, 0, 0, out.data, out.length, op))
+            {
+                return false;
+            }
+            out.length = op;
+            return true;
+        }
+
+        /**
+         * @brief Decompress one LZ4 block.
+         *
+         * Every length and offset is bounds-checked, so malformed input fails
+         * instead of reading or writing out of range.
+         *
+         * @param out Capacity-in / length-out.
+         * @return false on malformed input or if the output exceeds @p out's capacity.
+         */
+        inline bool decompress(ByteSpan in, ByteSpan &out)
+        {
+            if (!in.data || !in.length || (!out.data && out.length))
+            {
+                return false;
+            }
+            const uint8_t *src = in.data;
+            uint8_t *dst = out.data;
+            size_t ip = 0;
+            size_t op = 0;
+            for (;;)
+            {
+                if (ip >= in.length)
+                {
+                    return false;
+                }
+                const uint8_t token = src[ip++];
+                size_t literalLength = token >> 4;
+                if (literalLength == 15u && !detail::readExtraLength(src, in.length, ip, literalLength))
+                {
+                    return false;
+                }
+                if (literalLength > in.length - ip || literalLength > out.length - op)
+                {
+                    return false;
+                }
+                if (literalLength)
+                {
+                    ::memcpy(dst + op, src + ip, literalLength);
+                }
+                ip += literalLength;
+                op += literalLength;
+                if (ip == in.length)
+                {
+                    break; // the last sequence has no match
+                }
+
+                if (in.length - ip < 2u)
+                {
+                    return false;
+                }
+                const size_t offset = static_cast<size_t>(src[ip]) | (static_cast<size_t>(src[ip + 1]) << 8);
+                ip += 2;
+                size_t matchLength = token & 0x0Fu;
+                if (matchLength == 15u && !detail::readExtraLength(src, in.length, ip, matchLength))
+                {
+                    return false;
+                }
+                matchLength += kMinMatch;
+                if (offset == 0 || offset > op || matchLength > out.length - op)
+                {
+                    return false;
+                }
+                const uint8_t *ref = dst + op - offset;
+                if (offset >= matchLength)
+                {
+                    ::memcpy(dst + op, ref, matchLength);
+                }
+                else
+                {
+                    for (size_t i = 0; i < matchLength; ++i)
+                    {
+                        dst[op + i] = ref[i]; // overlapping: repeats the last `offset` bytes
+                    }
+                }
+                op += matchLength;
+            }
+            out.length = op;
+            return true;
+        }
+    }
+
+    /**
+     * @brief Size-independent part of `Compression` (what `Node` works with).
+     */
+    class CompressionBuffer
+    {
+    public:
+        /** @brief Compress the payloads of @p msgId from now on (when it makes them smaller). */
+        void enable(uint8_t msgId) { enabled_[msgId >> 3] = static_cast<uint8_t>(enabled_[msgId >> 3] | (1u << (msgId & 7u))); }
+        void disable(uint8_t msgId) { enabled_[msgId >> 3] = static_cast<uint8_t>(enabled_[msgId >> 3] & ~(1u << (msgId & 7u))); }
+        bool enabled(uint8_t msgId) const { return (enabled_[msgId >> 3] >> (msgId & 7u)) & 1u; }
+
+        /** @brief Largest (uncompressed) payload the buffers hold. */
+        size_t capacity() const { return capacity_; }
+
+        /**
+         * @brief Compress @p in into @p out if the result is strictly shorter.
+         * @param out Capacity-in / length-out.
+         */
+        bool compress(ByteSpan in, ByteSpan &out)
+        {
+            if (in.length == 0)
+            {
+                return false;
+            }
+            if (out.length >= in.length)
+            {
+                out.length = in.length - 1;
+            }
+            return lz4::compress(in, out, table_, hashBits_);
+        }
+
+        /** @brief Where `Node` decompresses received payloads (valid during the handler call). */
+        uint8_t *rxBuffer() { return rx_; }
+
+        /** @brief Where `Node` encodes typed messages before compressing them. */
+        uint8_t *txBuffer() { return tx_; }
+
+    protected:
+        CompressionBuffer(uint16_t *table, unsigned hashBits, uint8_t *rx, uint8_t *tx, size_t capacity)
+            : table_(table), hashBits_(hashBits), rx_(rx), tx_(tx), capacity_(capacity)
+        {
+            ::memset(enabled_, 0, sizeof(enabled_));
+        }
+
+    private:
+        // Copying would leave the pointers aimed at the source object's storage.
+        CompressionBuffer(const CompressionBuffer &);
+        CompressionBuffer &operator=(const CompressionBuffer &);
+
+        uint16_t *table_;
+        unsigned hashBits_;
+        uint8_t *rx_;
+        uint8_t *tx_;
+        size_t capacity_;
+        uint8_t enabled_[32];
+    };
+
+    /**
+     * @brief Compressor scratch and payload buffers for a node of @p MaxPayloadSize.
+     *
+     * @tparam MaxPayloadSize As for the `Node` it is attached to (uncompressed size).
+     * @tparam HashBits Match-finder table of `2^HashBits` 16-bit entries (default 1 KiB).
+     *
+     * RAM: `2 * MaxPayloadSize + 2^(HashBits+1)` bytes.
+     */
+    template <size_t MaxPayloadSize, unsigned HashBits = 9>
+    class Compression : public CompressionBuffer
+    {
+    public:
+        static_assert(HashBits >= 8 && HashBits <= 16, "HashBits must be 8..16");
+        static_assert(MaxPayloadSize <= 0xFFFFu, "payloads are at most 64 KiB");
+
+        Compression() : CompressionBuffer(table_, HashBits, rx_, tx_, MaxPayloadSize) {}
+
+    private:
+        uint16_t table_[1u << HashBits];
+        uint8_t rx_[MaxPayloadSize];
+        uint8_t tx_[MaxPayloadSize];
+    };
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "framer.hpp"
+
+/**
+ * @file conflation.hpp
+ * @brief Caller-owned latest-value slots: one encoded packet per msg_id.
+ * @ingroup umsg
+ *
+ * For state-like messages, where only the newest sample matters: each
+ * `Node::publishLatest()` overwrites the slot of its msg_id, and
+ * `Node::flushLatest()` writes the slots that changed since the last flush. Under
+ * congestion at most one packet per msg_id waits, however often it is published.
+ */
+
+namespace umsg
+{
+    /**
+     * @brief Size-independent part of `Conflation` (what `Node` works with).
+     */
+    class ConflationBuffer
+    {
+    public:
+        /** @brief Bytes per slot (one whole packet). */
+        size_t slotSize() const { return slotSize_; }
+        size_t slots() const { return slots_; }
+
+        /** @brief Slots holding a packet not yet flushed. */
+        size_t dirty() const
+        {
+            size_t n = 0;
+            for (size_t i = 0; i < used_; ++i)
+            {
+                n += entries_[i].dirty ? 1 : 0;
+            }
+            return n;
+        }
+
+        /** @brief Forget every slot (and the msg_ids they were bound to). */
+        void clear() { used_ = 0; }
+
+        /**
+         * @brief Slot of @p msgId, bound on first use in publish order.
+         * @return Slot index, or `slots()` if every slot belongs to another msg_id.
+         */
+        size_t find(uint8_t msgId)
+        {
+            for (size_t i = 0; i < used_; ++i)
+            {
+                if (entries_[i].msgId == msgId)
+                {
+                    return i;
+                }
+            }
+            if (used_ == slots_)
+            {
+                return slots_;
+            }
+            entries_[used_].msgId = msgId;
+            entries_[used_].dirty = false;
+            entries_[used_].length = 0;
+            return used_++;
+        }
+
+        uint8_t *packet(size_t slot) { return storage_ + slot * slotSize_; }
+        size_t length(size_t slot) const { return entries_[slot].length; }
+        bool isDirty(size_t slot) const { return slot < used_ && entries_[slot].dirty; }
+        size_t bound() const { return used_; }
+
+        /** @brief Mark slot @p slot as holding a fresh packet of @p length bytes. */
+        void set(size_t slot, size_t length)
+        {
+            entries_[slot].length = length;
+            entries_[slot].dirty = true;
+        }
+
+        /** @brief Mark slot @p slot as sent (or its packet as invalid). */
+        void done(size_t slot) { entries_[slot].dirty = false; }
+
+    protected:
+        struct Entry
+        {
+            size_t length;
+            uint8_t msgId;
+            bool dirty;
+        };
+
+        ConflationBuffer(uint8_t *storage, Entry *entries, size_t slots, size_t slotSize)
+            : storage_(storage), entries_(entries), slots_(slots), slotSize_(slotSize), used_(0) {}
+
+    private:
+        // Copying would leave the pointers aimed at the source object's storage.
+        ConflationBuffer(const ConflationBuffer &);
+        ConflationBuffer &operator=(const ConflationBuffer &);
+
+        uint8_t *storage_;
+        Entry *entries_;
+        size_t slots_;
+        size_t slotSize_;
+        size_t used_;
+    };
+
+    /**
+     * @brief Latest-value slots for up to @p Slots msg_ids.
+     *
+     * @tparam MaxPayloadSize As for the `Node` it is attached to (slots hold whole
+     *         packets of `Framing::maxPacketSize(MaxPayloadSize)` bytes).
+     * @tparam Slots Number of distinct msg_ids that can be conflated.
+     * @tparam Framing Must match the node's framing.
+     */
+    template <size_t MaxPayloadSize, size_t Slots, class Framing = StreamFraming>
+    class Conflation : public ConflationBuffer
+    {
+    public:
+        static const size_t kSlotSize = Framing::maxPacketSize(MaxPayloadSize);
+
+        Conflation() : ConflationBuffer(&storage_[0][0], entries_, Slots, kSlotSize) {}
+
+    private:
+        uint8_t storage_[Slots][kSlotSize];
+        Entry entries_[Slots];
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 /**
  * @file crc32.hpp
@@ -19,9 +20,19 @@
  *   is placed in flash (PROGMEM) automatically when `__AVR__` is defined.
  * - `UMSG_CRC32_BYTE_TABLE`: 256-entry (1 KB) table, ~8x faster. Typically too large
  *   for ATmega328-class AVRs but fine on ESP32/STM32/Linux.
+ * - `UMSG_CRC32_SLICE8`: slicing-by-8, eight 256-entry tables (8 KB of RAM, built on
+ *   first use), 8 bytes per step. For 32/64-bit hosts.
+ * - `UMSG_CRC32_HW`: hardware CRC where available, slicing-by-8 otherwise:
+ *   - ARMv8 `crc32` instructions (`__crc32d`/`__crc32b`) when the compiler targets them
+ *     (`__ARM_FEATURE_CRC32`, e.g. `-march=armv8-a+crc`); selected at compile time.
+ *   - x86/x86-64 PCLMULQDQ carry-less-multiply folding (GCC/Clang); selected at run
+ *     time from CPUID, so no `-mpclmul` is needed. Used for inputs of 64+ bytes.
+ *
+ * Every backend is also reachable as `detail::crc32_update_<name>()` (operating on
+ * the raw, non-inverted register) so tests and benchmarks can compare them in one
+ * build; unused backends cost nothing.
  */
 
-#if defined(UMSG_CRC32_NIBBLE_TABLE) || defined(UMSG_CRC32_BYTE_TABLE)
 #if defined(__AVR__)
 #include <avr/pgmspace.h>
 #define UMSG_CRC32_TABLE_ATTR PROGMEM
@@ -30,13 +41,67 @@
 #define UMSG_CRC32_TABLE_ATTR
 #define UMSG_CRC32_TABLE_READ(tbl, i) ((tbl)[i])
 #endif
+
+#if defined(__ARM_FEATURE_CRC32) && !defined(__ARM_BIG_ENDIAN)
+#include <arm_acle.h>
+/** @brief Defined when `detail::crc32_update_armv8()` is available. */
+#define UMSG_CRC32_HAVE_ARMV8 1
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)) && \
+    !defined(UMSG_CRC32_NO_PCLMUL)
+#include <immintrin.h>
+/** @brief Defined when `detail::crc32_update_pclmul()` is available (check CPU support first). */
+#define UMSG_CRC32_HAVE_PCLMUL 1
 #endif
 
 namespace umsg
 {
-#if defined(UMSG_CRC32_BYTE_TABLE)
     namespace detail
     {
+        inline uint32_t crc32_update_bitwise(uint32_t crc, const uint8_t *data, size_t length)
+        {
+            for (size_t i = 0; i < length; ++i)
+            {
+                crc ^= static_cast<uint32_t>(data[i]);
+                for (uint8_t bit = 0; bit < 8; ++bit)
+                {
+                    if (crc & 1u)
+                    {
+                        crc = (crc >> 1) ^ 0xEDB88320u;
+                    }
+                    else
+                    {
+                        crc >>= 1;
+                    }
+                }
+            }
+            return crc;
+        }
+
+        inline const uint32_t *crc32_nibble_table()
+        {
+            static const uint32_t UMSG_CRC32_TABLE_ATTR table[16] = {
+                0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu,
+                0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+                0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu,
+                0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu
+            };
+            return table;
+        }
+
+        inline uint32_t crc32_update_nibble(uint32_t crc, const uint8_t *data, size_t length)
+        {
+            const uint32_t *const table = crc32_nibble_table();
+            for (size_t i = 0; i < length; ++i)
+            {
+                crc ^= static_cast<uint32_t>(data[i]);
+                crc = (crc >> 4) ^ UMSG_CRC32_TABLE_READ(table, crc & 0x0Fu);
+                crc = (crc >> 4) ^ UMSG_CRC32_TABLE_READ(table, crc & 0x0Fu);
+            }
+            return crc;
+        }
+
         inline const uint32_t *crc32_byte_table()
         {
             static const uint32_t UMSG_CRC32_TABLE_ATTR table[256] = {
@@ -75,68 +140,270 @@ namespace umsg
             };
             return table;
         }
-    }
-#elif defined(UMSG_CRC32_NIBBLE_TABLE)
-    namespace detail
-    {
-        inline const uint32_t *crc32_nibble_table()
+
+        inline uint32_t crc32_update_byte(uint32_t crc, const uint8_t *data, size_t length)
         {
-            static const uint32_t UMSG_CRC32_TABLE_ATTR table[16] = {
-                0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu,
-                0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
-                0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu,
-                0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu
-            };
-            return table;
+            const uint32_t *const table = crc32_byte_table();
+            for (size_t i = 0; i < length; ++i)
+            {
+                const uint8_t idx = static_cast<uint8_t>((crc ^ data[i]) & 0xFFu);
+                crc = (crc >> 8) ^ UMSG_CRC32_TABLE_READ(table, idx);
+            }
+            return crc;
         }
-    }
-#endif
 
-    /**
-     * @brief Compute CRC-32/ISO-HDLC (aka "CRC-32", Ethernet/PKZIP).
-     *
-     * @param data Bytes to checksum (may be null only when @p length is 0).
-     * @param length Number of bytes.
-     * @return CRC32 value.
-     */
-    inline uint32_t crc32_iso_hdlc(const uint8_t *data, size_t length)
-    {
-        uint32_t crc = 0xFFFFFFFFu;
+        /** @brief Slicing-by-8 tables: `t[0]` is the byte table, `t[k][i]` advances `t[k-1][i]` by one zero byte. */
+        struct Crc32Slice8Tables
+        {
+            uint32_t t[8][256];
+
+            Crc32Slice8Tables()
+            {
+                const uint32_t *const base = crc32_byte_table();
+                for (size_t i = 0; i < 256; ++i)
+                {
+                    t[0][i] = UMSG_CRC32_TABLE_READ(base, i);
+                }
+                for (size_t k = 1; k < 8; ++k)
+                {
+                    for (size_t i = 0; i < 256; ++i)
+                    {
+                        const uint32_t prev = t[k - 1][i];
+                        t[k][i] = (prev >> 8) ^ t[0][prev & 0xFFu];
+                    }
+                }
+            }
+        };
 
-#if defined(UMSG_CRC32_BYTE_TABLE)
-        const uint32_t *const table = detail::crc32_byte_table();
-        for (size_t i = 0; i < length; ++i)
+        inline const Crc32Slice8Tables &crc32_slice8_tables()
         {
-            const uint8_t idx = static_cast<uint8_t>((crc ^ data[i]) & 0xFFu);
-            crc = (crc >> 8) ^ UMSG_CRC32_TABLE_READ(table, idx);
+            static const Crc32Slice8Tables tables;
+            return tables;
         }
-#elif defined(UMSG_CRC32_NIBBLE_TABLE)
-        const uint32_t *const table = detail::crc32_nibble_table();
-        for (size_t i = 0; i < length; ++i)
+
+        inline uint32_t load_u32_le(const uint8_t *p)
         {
-            crc ^= static_cast<uint32_t>(data[i]);
-            crc = (crc >> 4) ^ UMSG_CRC32_TABLE_READ(table, crc & 0x0Fu);
-            crc = (crc >> 4) ^ UMSG_CRC32_TABLE_READ(table, crc & 0x0Fu);
+            return (static_cast<uint32_t>(p[0])) |
+                   (static_cast<uint32_t>(p[1]) << 8) |
+                   (static_cast<uint32_t>(p[2]) << 16) |
+                   (static_cast<uint32_t>(p[3]) << 24);
         }
-#else
-        for (size_t i = 0; i < length; ++i)
+
+        inline uint32_t crc32_update_slice8(uint32_t crc, const uint8_t *data, size_t length)
         {
-            crc ^= static_cast<uint32_t>(data[i]);
-            for (uint8_t bit = 0; bit < 8; ++bit)
+            const Crc32Slice8Tables &s = crc32_slice8_tables();
+            while (length >= 8)
             {
-                if (crc & 1u)
-                {
-                    crc = (crc >> 1) ^ 0xEDB88320u;
-                }
-                else
+                const uint32_t one = crc ^ load_u32_le(data);
+                const uint32_t two = load_u32_le(data + 4);
+                crc = s.t[7][one & 0xFFu] ^
+                      s.t[6][(one >> 8) & 0xFFu] ^
+                      s.t[5][(one >> 16) & 0xFFu] ^
+                      s.t[4][one >> 24] ^
+                      s.t[3][two & 0xFFu] ^
+                      s.t[2][(two >> 8) & 0xFFu] ^
+                      s.t[1][(two >> 16) & 0xFFu] ^
+                      s.t[0][two >> 24];
+                data += 8;
+                length -= 8;
+            }
+            for (size_t i = 0; i < length; ++i)
+            {
+                crc = (crc >> 8) ^ s.t[0][(crc ^ data[i]) & 0xFFu];
+            }
+            return crc;
+        }
+
+#if defined(UMSG_CRC32_HAVE_ARMV8)
+        inline uint32_t crc32_update_armv8(uint32_t crc, const uint8_t *data, size_t length)
+        {
+            while (length >= 8)
+            {
+                uint64_t word;
+                ::memcpy(&word, data, sizeof(word));
+                crc = __crc32d(crc, word);
+                data += 8;
+                length -= 8;
+            }
+            for (size_t i = 0; i < length; ++i)
+            {
+                crc = __crc32b(crc, data[i]);
+            }
+            return crc;
+        }
+#endif
+
+#if defined(UMSG_CRC32_HAVE_PCLMUL)
+        /** @brief True when the running CPU supports PCLMULQDQ (queried once). */
+        inline bool crc32_pclmul_supported()
+        {
+            struct Probe
+            {
+                static bool run()
                 {
-                    crc >>= 1;
+                    __builtin_cpu_init(); // may run before libgcc's constructors
+                    return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse2");
                 }
+            };
+            static const bool supported = Probe::run();
+            return supported;
+        }
+
+        /**
+         * @brief PCLMULQDQ folding over a multiple of 16 bytes, at least 64
+         *        (Gopal et al., "Fast CRC Computation for Generic Polynomials Using
+         *        PCLMULQDQ", constants for the bit-reflected 0x04C11DB7 domain).
+         */
+        __attribute__((target("pclmul,sse2")))
+        inline uint32_t crc32_fold_pclmul(uint32_t crc, const uint8_t *data, size_t length)
+        {
+            const __m128i k1k2 = _mm_set_epi64x(0x01C6E41596LL, 0x0154442BD4LL);
+            const __m128i k3k4 = _mm_set_epi64x(0x00CCAA009ELL, 0x01751997D0LL);
+            const __m128i k5k0 = _mm_set_epi64x(0x0000000000LL, 0x0163CD6124LL);
+            const __m128i poly = _mm_set_epi64x(0x01F7011641LL, 0x01DB710641LL);
+            const __m128i mask32 = _mm_setr_epi32(-1, 0, -1, 0);
+
+            __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x00));
+            __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x10));
+            __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x20));
+            __m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x30));
+            x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+            data += 64;
+            length -= 64;
+
+            // Fold four 128-bit lanes in parallel, 64 bytes per step.
+            while (length >= 64)
+            {
+                const __m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+                const __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+                const __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+                const __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+                x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+                x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+                x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+                x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+                x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                                   _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x00)));
+                x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+                                   _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x10)));
+                x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+                                   _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x20)));
+                x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+                                   _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 0x30)));
+                data += 64;
+                length -= 64;
+            }
+
+            // Fold the four lanes into one.
+            __m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+            x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x2), x5);
+            x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+            x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x3), x5);
+            x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+            x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x11), x4), x5);
+
+            // Remaining 16-byte blocks.
+            while (length >= 16)
+            {
+                x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+                x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+                x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                                   _mm_loadu_si128(reinterpret_cast<const __m128i *>(data)));
+                data += 16;
+                length -= 16;
+            }
+
+            // 128 -> 64 bits.
+            x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+            x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+            x2 = _mm_srli_si128(x1, 4);
+            x1 = _mm_and_si128(x1, mask32);
+            x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k5k0, 0x00), x2);
+
+            // Barrett reduction to 32 bits.
+            x2 = _mm_and_si128(x1, mask32);
+            x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+            x2 = _mm_and_si128(x2, mask32);
+            x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+            x1 = _mm_xor_si128(x1, x2);
+            return static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(x1, 4)));
+        }
+
+        /** @brief PCLMULQDQ for the 16-byte-aligned bulk of 64+ byte inputs, slicing-by-8 for the rest. */
+        inline uint32_t crc32_update_pclmul(uint32_t crc, const uint8_t *data, size_t length)
+        {
+            if (length >= 64)
+            {
+                const size_t bulk = length & ~static_cast<size_t>(15);
+                crc = crc32_fold_pclmul(crc, data, bulk);
+                data += bulk;
+                length -= bulk;
             }
+            return crc32_update_slice8(crc, data, length);
         }
 #endif
 
-        return crc ^ 0xFFFFFFFFu;
+        /** @brief Advance the raw (non-inverted) CRC register with the configured backend. */
+        inline uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t length)
+        {
+#if defined(UMSG_CRC32_HW) && defined(UMSG_CRC32_HAVE_ARMV8)
+            return crc32_update_armv8(crc, data, length);
+#elif defined(UMSG_CRC32_HW) && defined(UMSG_CRC32_HAVE_PCLMUL)
+            return crc32_pclmul_supported() ? crc32_update_pclmul(crc, data, length)
+                                            : crc32_update_slice8(crc, data, length);
+#elif defined(UMSG_CRC32_HW) || defined(UMSG_CRC32_SLICE8)
+            return crc32_update_slice8(crc, data, length);
+#elif defined(UMSG_CRC32_BYTE_TABLE)
+            return crc32_update_byte(crc, data, length);
+#elif defined(UMSG_CRC32_NIBBLE_TABLE)
+            return crc32_update_nibble(crc, data, length);
+#else
+            return crc32_update_bitwise(crc, data, length);
+#endif
+        }
+    }
+
+    /**
+     * @brief Incremental CRC-32/ISO-HDLC over data that arrives in pieces.
+     *
+     * `Crc32().update(a, n).update(b, m).finish()` equals `crc32_iso_hdlc(a || b)`.
+     * Uses the backend selected for `crc32_iso_hdlc()`.
+     */
+    class Crc32
+    {
+    public:
+        Crc32() : state_(0xFFFFFFFFu) {}
+
+        /** @brief Restart as if no byte had been fed. */
+        void reset() { state_ = 0xFFFFFFFFu; }
+
+        /** @brief Feed @p length bytes (@p data may be null only when @p length is 0). */
+        Crc32 &update(const uint8_t *data, size_t length)
+        {
+            state_ = detail::crc32_update(state_, data, length);
+            return *this;
+        }
+
+        /** @brief Feed one byte. */
+        Crc32 &update(uint8_t byte) { return update(&byte, 1); }
+
+        /** @brief CRC of everything fed so far (does not modify the state). */
+        uint32_t finish() const { return state_ ^ 0xFFFFFFFFu; }
+
+    private:
+        uint32_t state_;
+    };
+
+    /**
+     * @brief Compute CRC-32/ISO-HDLC (aka "CRC-32", Ethernet/PKZIP).
+     *
+     * @param data Bytes to checksum (may be null only when @p length is 0).
+     * @param length Number of bytes.
+     * @return CRC32 value.
+     */
+    inline uint32_t crc32_iso_hdlc(const uint8_t *data, size_t length)
+    {
+        return Crc32().update(data, length).finish();
     }
 
 }
@@ -0,0 +1,131 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "common.hpp"
+#include "crc32.hpp"
+#include "marshalling.hpp"
+
+/**
+ * @file datagram.hpp
+ * @brief Datagram framing: `frame || crc32` per frame, no COBS, no delimiter.
+ * @ingroup umsg
+ *
+ * For transports that preserve message boundaries (UDP). A datagram carries one
+ * or more `frame || crc32_be` back to back; each frame's extent comes from the
+ * `len` field of its header, so no byte stuffing is needed. Select it with
+ * `BasicNode<..., DatagramFraming>` (or `DatagramNode`); the transport must
+ * provide `bool readDatagram(ByteSpan&)` (see `transport.hpp`).
+ */
+
+namespace umsg
+{
+    namespace detail
+    {
+        /**
+         * @brief `PacketEncoder` counterpart for datagrams: copies the frame and
+         *        appends its big-endian CRC32.
+         *
+         * Parts may overlap the output as long as they lie at or behind the write
+         * position (bytes are moved with `memmove`), so a payload staged in the
+         * tail of the output buffer can be encoded in place.
+         */
+        class DatagramEncoder
+        {
+        public:
+            DatagramEncoder() : out_(nullptr), cap_(0), length_(0) {}
+
+            bool begin(uint8_t *output, size_t outputCapacity)
+            {
+                out_ = output;
+                cap_ = outputCapacity;
+                length_ = 0;
+                crc_.reset();
+                return output && outputCapacity >= 4;
+            }
+
+            bool write(const uint8_t *data, size_t length)
+            {
+                if (!data && length) return false;
+                if (length > cap_ - 4 - length_) return false;
+                crc_.update(data, length);
+                if (length) ::memmove(out_ + length_, data, length);
+                length_ += length;
+                return true;
+            }
+
+            bool finish(size_t &packetLength)
+            {
+                write_u32_be(out_ + length_, crc_.finish());
+                packetLength = length_ + 4;
+                return true;
+            }
+
+        private:
+            uint8_t *out_;
+            size_t cap_;
+            size_t length_;
+            Crc32 crc_;
+        };
+    }
+
+    /** @brief `BasicNode` framing policy for datagram transports (see `datagram.hpp`). */
+    struct DatagramFraming
+    {
+        static const bool kDatagram = true;
+        typedef detail::DatagramEncoder Encoder;
+
+        static constexpr size_t maxPacketSize(size_t maxPayloadSize) { return umsg::maxDatagramSize(maxPayloadSize); }
+    };
+
+    /**
+     * @brief Splits received datagrams into CRC-checked frames, in place.
+     *
+     * `load()` a datagram, then call `next()` until `empty()`. The frames alias the
+     * datagram's storage, which must stay valid until the last `next()`.
+     */
+    class DatagramDeframer
+    {
+    public:
+        DatagramDeframer() : rest_{nullptr, 0} {}
+
+        void load(ByteSpan datagram) { rest_ = datagram; }
+
+        bool empty() const { return rest_.length == 0; }
+
+        /**
+         * @brief Take the next `frame || crc32` off the front of the datagram.
+         *
+         * @return `OK` with @p frame set, or `FrameTooShort` / `LengthMismatch` /
+         *         `CrcInvalid`; after an error the rest of the datagram is dropped,
+         *         since frame boundaries can no longer be trusted.
+         */
+        Error next(ByteSpan &frame)
+        {
+            const ByteSpan in = rest_;
+            rest_.length = 0;
+            if (in.length < kFrameHeaderSize + 4u)
+            {
+                return Error::FrameTooShort;
+            }
+            const size_t frameLength = kFrameHeaderSize + read_u16_be(&in.data[6]);
+            if (frameLength + 4u > in.length)
+            {
+                return Error::LengthMismatch;
+            }
+            if (crc32_iso_hdlc(in.data, frameLength) != read_u32_be(&in.data[frameLength]))
+            {
+                return Error::CrcInvalid;
+            }
+            frame.data = in.data;
+            frame.length = frameLength;
+            rest_.data = in.data + frameLength + 4u;
+            rest_.length = in.length - frameLength - 4u;
+            return Error::OK;
+        }
+
+    private:
+        ByteSpan rest_;
+    };
+}
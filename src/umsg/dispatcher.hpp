@@ -5,6 +5,20 @@
 
 #include "common.hpp"
 
+/**
+ * @brief Default lookup mode for `Dispatcher` (and therefore `Node`).
+ *
+ * - `0` (default): linear scan over a compact array of registered ids —
+ *   `MaxHandlers` bytes of index, best for a handful of handlers.
+ * - `1`: dense 256-entry `msgId -> slot` table — constant-time dispatch for
+ *   256 bytes of RAM (requires `MaxHandlers < 255`).
+ *
+ * Override before including, or pick per instance with `Dispatcher<N, Dense>`.
+ */
+#ifndef UMSG_DISPATCHER_DENSE
+#define UMSG_DISPATCHER_DENSE 0
+#endif
+
 /**
  * @file dispatcher.hpp
  * @brief Handler table keyed by `msgId` (no frame parsing; see `protocol.hpp`).
@@ -13,10 +27,121 @@
 
 namespace umsg
 {
+    namespace detail
+    {
+        /**
+         * @brief `msgId -> slot` lookup used by `Dispatcher`.
+         *
+         * Slots are handed out in registration order and never freed, so slot
+         * `i` is valid for `i < size()`. `find()` returns `Capacity` when absent.
+         */
+        template <size_t Capacity, bool Dense>
+        class DispatchIndex;
+
+        /** @brief Linear scan over the registered ids (one byte per handler). */
+        template <size_t Capacity>
+        class DispatchIndex<Capacity, false>
+        {
+        public:
+            DispatchIndex() : count_(0) {}
+
+            size_t size() const { return count_; }
+
+            size_t find(uint8_t msgId) const
+            {
+                for (size_t i = 0; i < count_; ++i)
+                {
+                    if (ids_[i] == msgId)
+                    {
+                        return i;
+                    }
+                }
+                return Capacity;
+            }
+
+            /** @pre `find(msgId) == Capacity`. @return New slot, or `Capacity` if full. */
+            size_t insert(uint8_t msgId)
+            {
+                if (count_ == Capacity)
+                {
+                    return Capacity;
+                }
+                ids_[count_] = msgId;
+                return count_++;
+            }
+
+        private:
+            uint8_t ids_[Capacity];
+            size_t count_;
+        };
+
+        /** @brief Dense table: one byte per possible `msgId`, `kEmpty` when unregistered. */
+        template <size_t Capacity>
+        class DispatchIndex<Capacity, true>
+        {
+        public:
+            static_assert(Capacity < 255, "Dense dispatch stores slot numbers in a uint8_t");
+
+            DispatchIndex() : count_(0)
+            {
+                ::memset(slots_, kEmpty, sizeof(slots_));
+            }
+
+            size_t size() const { return count_; }
+
+            size_t find(uint8_t msgId) const
+            {
+                const uint8_t slot = slots_[msgId];
+                return slot == kEmpty ? Capacity : slot;
+            }
+
+            /** @pre `find(msgId) == Capacity`. @return New slot, or `Capacity` if full. */
+            size_t insert(uint8_t msgId)
+            {
+                if (count_ == Capacity)
+                {
+                    return Capacity;
+                }
+                slots_[msgId] = static_cast<uint8_t>(count_);
+                return count_++;
+            }
+
+        private:
+            static const uint8_t kEmpty = 0xFF;
+
+            uint8_t slots_[256];
+            size_t count_;
+        };
+    }
+
+    namespace detail
+    {
+        /**
+         * @brief Typed-handler call: check `Msg::kMsgHash`, `Msg::decode`, then invoke.
+         * @return Error::HashMismatch / Error::InvalidArgument, or the handler's result.
+         */
+        template <class Msg, class T, class M>
+        inline Error invokeTyped(T &obj, M method, ByteSpan payload, uint32_t msgHash)
+        {
+            if (msgHash != Msg::kMsgHash)
+            {
+                return Error::HashMismatch;
+            }
+            Msg msg;
+            if (!msg.decode(payload))
+            {
+                return Error::InvalidArgument;
+            }
+            return (obj.*method)(msg);
+        }
+    }
+
     /**
      * @brief Handler table keyed by `msgId`; dispatches to a registered member function.
      *
      * @tparam MaxHandlers Fixed handler-table capacity.
+     * @tparam Dense Lookup mode: linear scan (`false`) or 256-entry table (`true`);
+     *         see `UMSG_DISPATCHER_DENSE`.
      *
      * Two registration forms:
      * - Raw: `Error (T::*)(ByteSpan payload, uint32_t msgHash)` — caller owns hash checking.
@@ -24,17 +149,11 @@ namespace umsg
      *
      * @note Payload spans alias the caller's buffer and are only valid for the dispatch call.
      */
-    template <size_t MaxHandlers>
+    template <size_t MaxHandlers, bool Dense = (UMSG_DISPATCHER_DENSE != 0)>
     class Dispatcher
     {
     public:
-        Dispatcher()
-        {
-            for (size_t i = 0; i < MaxHandlers; ++i)
-            {
-                handlers_[i].used = false;
-            }
-        }
+        static const bool kDense = Dense;
 
         /**
          * @brief Register a raw handler for @p msgId (replaces any existing entry).
@@ -73,26 +192,22 @@ namespace umsg
          */
         Error dispatch(uint8_t msgId, uint32_t msgHash, ByteSpan payload)
         {
-            for (size_t i = 0; i < MaxHandlers; ++i)
+            const size_t i = index_.find(msgId);
+            if (i == MaxHandlers)
             {
-                const Slot &s = handlers_[i];
-                if (!s.used || s.msgId != msgId)
-                {
-                    continue;
-                }
-                return s.thunk(s.obj, s.methodBytes, payload, msgHash);
+                return Error::HandlerNotFound;
             }
-            return Error::HandlerNotFound;
+            const Slot &s = handlers_[i];
+            return s.thunk(s.obj, s.methodBytes, payload, msgHash);
         }
 
     private:
         typedef Error (*Thunk)(void *obj, const uint8_t *methodBytes,
                                ByteSpan payload, uint32_t msgHash);
 
+        // Ids live in index_, so a dispatch only touches the slot it calls.
         struct Slot
         {
-            bool used;
-            uint8_t msgId;
             void *obj;
             uint8_t methodBytes[kMaxMemberFnPtrSize];
             Thunk thunk;
@@ -101,30 +216,22 @@ namespace umsg
         Error install(uint8_t msgId, void *obj, Thunk thunk,
                       const void *methodPtr, size_t methodSize)
         {
-            for (size_t i = 0; i < MaxHandlers; ++i)
-            {
-                if (handlers_[i].used && handlers_[i].msgId == msgId)
-                {
-                    writeSlot(handlers_[i], msgId, obj, thunk, methodPtr, methodSize);
-                    return Error::OK;
-                }
-            }
-            for (size_t i = 0; i < MaxHandlers; ++i)
+            size_t i = index_.find(msgId);
+            if (i == MaxHandlers)
             {
-                if (!handlers_[i].used)
+                i = index_.insert(msgId);
+                if (i == MaxHandlers)
                 {
-                    writeSlot(handlers_[i], msgId, obj, thunk, methodPtr, methodSize);
-                    return Error::OK;
+                    return Error::InvalidArgument;
                 }
             }
-            return Error::InvalidArgument;
+            writeSlot(handlers_[i], obj, thunk, methodPtr, methodSize);
+            return Error::OK;
         }
 
-        static void writeSlot(Slot &s, uint8_t msgId, void *obj, Thunk thunk,
+        static void writeSlot(Slot &s, void *obj, Thunk thunk,
                               const void *methodPtr, size_t methodSize)
         {
-            s.used = true;
-            s.msgId = msgId;
             s.obj = obj;
             s.thunk = thunk;
             ::memcpy(s.methodBytes, methodPtr, methodSize);
@@ -143,20 +250,12 @@ namespace umsg
         static Error typedThunk(void *obj, const uint8_t *methodBytes,
                                 ByteSpan payload, uint32_t msgHash)
         {
-            if (msgHash != Msg::kMsgHash)
-            {
-                return Error::HashMismatch;
-            }
-            Msg msg;
-            if (!msg.decode(payload))
-            {
-                return Error::InvalidArgument;
-            }
             M m;
             ::memcpy(&m, methodBytes, sizeof(m));
-            return (static_cast<T *>(obj)->*m)(msg);
+            return detail::invokeTyped<Msg>(*static_cast<T *>(obj), m, payload, msgHash);
         }
 
+        detail::DispatchIndex<MaxHandlers, Dense> index_;
         Slot handlers_[MaxHandlers];
     };
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "common.hpp"
 #include "cobs.hpp"
@@ -21,13 +22,86 @@
 
 namespace umsg
 {
+    namespace detail
+    {
+        /**
+         * @brief Single-pass packet encoder: CRC32 and COBS over the same bytes.
+         *
+         * Input is processed in `kSliceSize` slices: each slice is folded into the
+         * running CRC and immediately COBS-stuffed while it is still in L1, so the
+         * frame is streamed from memory once (instead of one full pass for the CRC
+         * and another for COBS) while the CRC keeps its multi-byte table/hardware path.
+         *
+         * Usage: `begin()`, any number of `write()`, then `finish()`.
+         */
+        class PacketEncoder
+        {
+        public:
+            static const size_t kSliceSize = 64;
+
+            bool begin(uint8_t *output, size_t outputCapacity)
+            {
+                crc_.reset();
+                return cobs_.begin(output, outputCapacity);
+            }
+
+            bool write(const uint8_t *data, size_t length)
+            {
+                if (!data && length) return false;
+                while (length > 0)
+                {
+                    const size_t n = length < kSliceSize ? length : kSliceSize;
+                    crc_.update(data, n);
+                    if (!cobs_.write(data, n)) return false;
+                    data += n;
+                    length -= n;
+                }
+                return true;
+            }
+
+            /** @brief Append the big-endian CRC32, close the COBS block and add the `0x00` delimiter. */
+            bool finish(size_t &packetLength)
+            {
+                uint8_t crcBytes[4];
+                write_u32_be(crcBytes, crc_.finish());
+                if (!cobs_.write(crcBytes, sizeof(crcBytes))) return false;
+
+                size_t encodedLength = 0;
+                cobs_.finish(encodedLength);
+                if (encodedLength >= cobs_.cap) return false;
+                cobs_.out[encodedLength] = 0x00;
+                packetLength = encodedLength + 1;
+                return true;
+            }
+
+        private:
+            CobsEncState cobs_;
+            Crc32 crc_;
+        };
+    }
+
+    /**
+     * @brief `BasicNode` framing policy for byte streams (the default):
+     *        `COBS(frame || crc32) || 0x00` per packet, reassembled by `Framer`.
+     */
+    struct StreamFraming
+    {
+        static const bool kDatagram = false;
+        typedef detail::PacketEncoder Encoder;
+
+        static constexpr size_t maxPacketSize(size_t maxPayloadSize) { return umsg::maxPacketSize(maxPayloadSize); }
+    };
+
     /**
      * @brief Stateful byte-stream framer/deframer using COBS + CRC32.
      *
      * @tparam MaxPacketSize Maximum encoded packet size (including delimiter) to accept.
      *
-     * RX: feed bytes with `feed()`; when a complete packet is received, the returned
-     * `Result` has `complete == true` and `frame` aliases internal RX storage.
+     * RX: feed bytes with `feed(byte)` or whole chunks with `feed(in, consumed)`; when a
+     * complete packet is received, the returned `Result` has `complete == true` and
+     * `frame` aliases internal RX storage. The frame's 4-byte CRC trailer follows it
+     * there (`frame.data[frame.length .. frame.length + 4)`), so `frame || crc32` can be
+     * passed on to a datagram link without recomputing the CRC (see `Router`).
      *
      * @warning The `frame` span returned by `feed()` aliases internal RX storage and
      *          is only valid until the next call to `feed()`.
@@ -44,18 +118,52 @@ namespace umsg
             ByteSpan frame; ///< Valid only when `complete == true`.
         };
 
-        Framer() : rxIndex_(0), resyncing_(false) {}
+        Framer() : packetSize_(0), resyncing_(false) { restart(); }
+
+        /** @brief Drop any partially received packet (e.g. when a connection is reused). */
+        void reset()
+        {
+            restart();
+            resyncing_ = false;
+        }
 
         /**
          * @brief Encode a frame into a wire packet (append CRC32, COBS encode, append `0x00`).
          *
+         * CRC and COBS are computed in a single pass (see `detail::PacketEncoder`).
+         *
          * @param frame Input bytes.
          * @param packet Output buffer; `length` used as capacity on input, set to
          *               bytes written on success.
          */
         Error encode(ByteSpan frame, ByteSpan &packet)
         {
-            if (!frame.data || !packet.data)
+            if (!frame.data)
+            {
+                return Error::InvalidArgument;
+            }
+            return encode(&frame, 1, packet);
+        }
+
+        /**
+         * @brief Scatter-gather encode: the frame is the concatenation of @p count parts.
+         *
+         * Lets callers stream e.g. a header and a payload straight into the packet
+         * without first assembling a contiguous frame.
+         *
+         * A part may alias @p packet's storage if it lies far enough behind the
+         * write position: with a payload part placed in the last `MaxPayload` bytes
+         * of a `maxPacketSize(MaxPayload)` buffer (behind an 8-byte header part),
+         * encoding in place is safe — this is how `Node` avoids a payload scratch buffer.
+         *
+         * @param parts Frame pieces, in order (`data` may be null only when `length` is 0).
+         * @param count Number of parts.
+         * @param packet Output buffer; `length` used as capacity on input, set to
+         *               bytes written on success.
+         */
+        Error encode(const ByteSpan *parts, size_t count, ByteSpan &packet)
+        {
+            if ((!parts && count) || !packet.data)
             {
                 return Error::InvalidArgument;
             }
@@ -66,99 +174,213 @@ namespace umsg
                 return Error::InvalidArgument;
             }
 
-            const uint32_t crc = crc32_iso_hdlc(frame.data, frame.length);
-            uint8_t crcBytes[4];
-            write_u32_be(crcBytes, crc);
-
-            size_t encodedLength = 0;
-            if (!cobsEncode2(frame.data, frame.length, crcBytes, 4,
-                             packet.data, outCapacity, encodedLength))
+            detail::PacketEncoder enc;
+            if (!enc.begin(packet.data, outCapacity))
             {
                 return Error::InvalidArgument;
             }
-
-            if (encodedLength >= outCapacity)
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!enc.write(parts[i].data, parts[i].length))
+                {
+                    return Error::InvalidArgument;
+                }
+            }
+            size_t packetLength = 0;
+            if (!enc.finish(packetLength))
             {
                 return Error::InvalidArgument;
             }
-            packet.data[encodedLength] = 0x00;
-            packet.length = encodedLength + 1;
+            packet.length = packetLength;
             return Error::OK;
         }
 
         /**
          * @brief Feed one incoming byte from the transport.
          *
+         * The byte is COBS-decoded and folded into a running CRC right away (the CRC
+         * lags four bytes behind, since the last four decoded bytes may be the
+         * trailer), so the delimiter only costs a 4-byte compare.
+         *
          * @return `Result{status, complete, frame}`. `complete` is true when a full
          *         frame has been decoded; `frame` then aliases internal RX storage.
          */
         Result feed(uint8_t byte)
         {
+            if (byte == 0x00)
+            {
+                return endPacket();
+            }
+
             Result r{Error::OK, false, ByteSpan{nullptr, 0}};
+            if (resyncing_)
+            {
+                return r;
+            }
 
-            if (byte == 0x00)
+            if (rxIndex_ >= MaxPacketSize)
             {
-                const bool wasResyncing = resyncing_;
-                resyncing_ = false;
-                const size_t encodedLen = rxIndex_;
-                rxIndex_ = 0;
+                restart();
+                resyncing_ = true;
+                r.status = Error::FrameOverflow;
+                return r;
+            }
 
-                if (encodedLen == 0)
-                {
-                    return r;
-                }
-                if (wasResyncing)
+            ++rxIndex_;
+            cobs_.put(byte);
+            foldCrc();
+            return r;
+        }
+
+        /**
+         * @brief Feed a chunk of incoming bytes; stops at the first event.
+         *
+         * Equivalent to calling `feed(byte)` for each byte of @p in, except that it
+         * returns as soon as a byte produces `complete == true` or a non-OK status,
+         * reporting how far it got in @p consumed. Call again with the remaining
+         * `ByteSpan{in.data + consumed, in.length - consumed}` to continue.
+         *
+         * Delimiters are located with `memchr`; runs between them are decoded block by
+         * block (each COBS block body is one `memcpy`) and folded into the running
+         * CRC in one multi-byte update per run.
+         *
+         * @param in Incoming bytes (may be empty).
+         * @param consumed Output: bytes of @p in processed (`<= in.length`).
+         * @return Result of the last processed byte (OK/incomplete if @p in ran out).
+         */
+        Result feed(ByteSpan in, size_t &consumed)
+        {
+            Result r{Error::OK, false, ByteSpan{nullptr, 0}};
+            consumed = 0;
+            if (!in.data)
+            {
+                return r;
+            }
+
+            while (consumed < in.length)
+            {
+                const uint8_t *const p = &in.data[consumed];
+                const size_t avail = in.length - consumed;
+                const uint8_t *const delim = static_cast<const uint8_t *>(::memchr(p, 0x00, avail));
+                const size_t run = delim ? static_cast<size_t>(delim - p) : avail;
+
+                if (run > 0 && !resyncing_)
                 {
-                    // Dropped the oversized packet; this delimiter restarts framing.
-                    return r;
+                    const size_t room = MaxPacketSize - rxIndex_;
+                    if (run > room)
+                    {
+                        // The byte after the last one that fits is the overflowing one.
+                        consumed += room + 1;
+                        restart();
+                        resyncing_ = true;
+                        r.status = Error::FrameOverflow;
+                        return r;
+                    }
+                    rxIndex_ += run;
+                    cobs_.write(p, run);
+                    foldCrc();
                 }
+                consumed += run;
 
-                size_t decodedLength = 0;
-                if (!cobsDecodeInPlace(rxBuffer_, encodedLen, decodedLength))
+                if (!delim)
                 {
-                    r.status = Error::CobsInvalid;
-                    return r;
+                    break;
                 }
-                if (decodedLength < 4)
+                ++consumed;
+                r = endPacket();
+                if (r.complete || r.status != Error::OK)
                 {
-                    r.status = Error::FrameTooShort;
                     return r;
                 }
+            }
+            return r;
+        }
 
-                const size_t frameLength = decodedLength - 4;
-                const uint32_t receivedCrc = read_u32_be(&rxBuffer_[frameLength]);
-                const uint32_t computedCrc = crc32_iso_hdlc(rxBuffer_, frameLength);
-                if (receivedCrc != computedCrc)
-                {
-                    r.status = Error::CrcInvalid;
-                    return r;
-                }
+        /**
+         * @brief Encoded size, delimiter included, of the packet behind the last
+         *        `complete` result: the packet ends at the delimiter just consumed.
+         */
+        size_t packetSize() const { return packetSize_; }
 
-                r.complete = true;
-                r.frame = ByteSpan{rxBuffer_, frameLength};
+        /** @brief Encoded bytes of the packet being received (0 between packets). */
+        size_t pending() const { return rxIndex_; }
+
+    private:
+        // Handle a 0x00 delimiter: everything is decoded and all but the last four
+        // bytes are in crc_ already; check the block structure and the CRC trailer.
+        Result endPacket()
+        {
+            Result r{Error::OK, false, ByteSpan{nullptr, 0}};
+
+            const bool wasResyncing = resyncing_;
+            resyncing_ = false;
+            const size_t encodedLen = rxIndex_;
+            const size_t decodedLength = cobs_.length;
+            const bool valid = cobs_.complete();
+            foldCrc();
+            const uint32_t computedCrc = crc_.finish();
+            restart();
+
+            if (encodedLen == 0)
+            {
+                return r;
+            }
+            if (wasResyncing)
+            {
+                // Dropped the oversized packet; this delimiter restarts framing.
                 return r;
             }
 
-            if (resyncing_)
+            if (!valid)
             {
+                r.status = Error::CobsInvalid;
+                return r;
+            }
+            if (decodedLength < 4)
+            {
+                r.status = Error::FrameTooShort;
                 return r;
             }
 
-            if (rxIndex_ >= MaxPacketSize)
+            const size_t frameLength = decodedLength - 4;
+            if (read_u32_be(&rxBuffer_[frameLength]) != computedCrc)
             {
-                rxIndex_ = 0;
-                resyncing_ = true;
-                r.status = Error::FrameOverflow;
+                r.status = Error::CrcInvalid;
                 return r;
             }
 
-            rxBuffer_[rxIndex_++] = byte;
+            r.complete = true;
+            r.frame = ByteSpan{rxBuffer_, frameLength};
+            packetSize_ = encodedLen + 1;
             return r;
         }
 
-    private:
-        uint8_t rxBuffer_[MaxPacketSize];
-        size_t rxIndex_;
+        // Fold decoded bytes into crc_, keeping the last four (the trailer, if the
+        // packet ends here) out.
+        void foldCrc()
+        {
+            if (cobs_.length > crcLength_ + 4)
+            {
+                const size_t n = cobs_.length - 4 - crcLength_;
+                crc_.update(&rxBuffer_[crcLength_], n);
+                crcLength_ += n;
+            }
+        }
+
+        void restart()
+        {
+            rxIndex_ = 0;
+            cobs_.begin(rxBuffer_);
+            crc_.reset();
+            crcLength_ = 0;
+        }
+
+        uint8_t rxBuffer_[MaxPacketSize]; // decoded frame || crc32
+        size_t rxIndex_;                  // encoded bytes of the current packet
+        size_t packetSize_;               // encoded size of the last complete packet
         bool resyncing_;
+        detail::CobsDecState cobs_;
+        Crc32 crc_;
+        size_t crcLength_; // decoded bytes folded into crc_
     };
 }
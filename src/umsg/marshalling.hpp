@@ -5,6 +5,30 @@
 
 #include "common.hpp"
 
+/**
+ * @brief Byte order of the target, for the bulk array paths in `marshalling.hpp`.
+ *
+ * `UMSG_NATIVE_BIG_ENDIAN`: arrays are copied with `memcpy`.
+ * `UMSG_NATIVE_LITTLE_ENDIAN`: arrays are byte-swapped 16 bytes at a time with
+ * SSE2 (x86) or NEON (ARM) when the target has them, `__builtin_bswap*` otherwise.
+ * Neither (unknown compiler, or `UMSG_MARSHAL_PORTABLE` defined): the portable
+ * shift-based code is used.
+ */
+#if defined(UMSG_MARSHAL_PORTABLE)
+#elif defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define UMSG_NATIVE_BIG_ENDIAN 1
+#elif defined(__GNUC__) && defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define UMSG_NATIVE_LITTLE_ENDIAN 1
+#if defined(__SSE2__)
+#define UMSG_MARSHAL_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define UMSG_MARSHAL_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
 /**
  * @file marshalling.hpp
  * @brief Canonical (network byte order) read/write helpers and zero-allocation Writer/Reader.
@@ -15,6 +39,10 @@
  * - `bool` is encoded as 0x00 (false) or 0x01 (true); other values are invalid on decode.
  * - `float`/`double` are transported by IEEE-754 bit pattern (written as u32/u64 big-endian).
  * - Arrays are encoded element-by-element in increasing index order.
+ * - Varints (`writeVarint`) are unsigned LEB128: 7 bits per byte, least significant
+ *   group first, high bit set on every byte but the last. Only the shortest encoding
+ *   is valid on decode. Signed varints (`writeZigzag`) are zig-zag mapped first, so
+ *   small magnitudes of either sign stay short.
  */
 
 namespace umsg
@@ -90,115 +118,673 @@ namespace umsg
     }
 
     /**
-     * @brief Cursor-based writer for canonical (network byte order) encoding.
+     * @brief Read one canonical scalar of type @p T at @p p (no bounds or bool checks).
      *
-     * The Writer never allocates. Writes fail with `false` on overflow.
-     *
-     * @note This type does not modify `ByteSpan::length`; it writes up to `length` bytes.
+     * Used by generated `<Name>View` accessors, which read fields in place at
+     * fixed payload offsets. `bool` reads as `p[0] != 0`.
      */
-    class Writer
-    {
-    public:
-        explicit Writer(ByteSpan out) : out_(out), index_(0) {}
+    template <class T>
+    T read_be(const uint8_t *p);
 
-        size_t bytesWritten() const { return index_; }
+    template <>
+    inline uint8_t read_be<uint8_t>(const uint8_t *p) { return p[0]; }
+
+    template <>
+    inline int8_t read_be<int8_t>(const uint8_t *p) { return static_cast<int8_t>(p[0]); }
+
+    template <>
+    inline bool read_be<bool>(const uint8_t *p) { return p[0] != 0; }
+
+    template <>
+    inline uint16_t read_be<uint16_t>(const uint8_t *p) { return read_u16_be(p); }
+
+    template <>
+    inline int16_t read_be<int16_t>(const uint8_t *p) { return static_cast<int16_t>(read_u16_be(p)); }
+
+    template <>
+    inline uint32_t read_be<uint32_t>(const uint8_t *p) { return read_u32_be(p); }
+
+    template <>
+    inline int32_t read_be<int32_t>(const uint8_t *p) { return static_cast<int32_t>(read_u32_be(p)); }
 
-        bool write(uint8_t value)
+    template <>
+    inline uint64_t read_be<uint64_t>(const uint8_t *p) { return read_u64_be(p); }
+
+    template <>
+    inline int64_t read_be<int64_t>(const uint8_t *p) { return static_cast<int64_t>(read_u64_be(p)); }
+
+    template <>
+    inline float read_be<float>(const uint8_t *p) { return detail::bit_cast<float>(read_u32_be(p)); }
+
+    template <>
+    inline double read_be<double>(const uint8_t *p) { return detail::bit_cast<double>(read_u64_be(p)); }
+
+    /**
+     * @brief Write one canonical scalar at @p p (no bounds checks).
+     *
+     * Counterpart of `read_be`, used by the constant-offset `encodeUnchecked()` of
+     * generated fixed-layout messages.
+     */
+    inline void write_be(uint8_t *p, uint8_t v) { p[0] = v; }
+    inline void write_be(uint8_t *p, int8_t v) { p[0] = static_cast<uint8_t>(v); }
+    inline void write_be(uint8_t *p, bool v) { p[0] = v ? 1u : 0u; }
+    inline void write_be(uint8_t *p, uint16_t v) { write_u16_be(p, v); }
+    inline void write_be(uint8_t *p, int16_t v) { write_u16_be(p, static_cast<uint16_t>(v)); }
+    inline void write_be(uint8_t *p, uint32_t v) { write_u32_be(p, v); }
+    inline void write_be(uint8_t *p, int32_t v) { write_u32_be(p, static_cast<uint32_t>(v)); }
+    inline void write_be(uint8_t *p, uint64_t v) { write_u64_be(p, v); }
+    inline void write_be(uint8_t *p, int64_t v) { write_u64_be(p, static_cast<uint64_t>(v)); }
+    inline void write_be(uint8_t *p, float v) { write_u32_be(p, detail::bit_cast<uint32_t>(v)); }
+    inline void write_be(uint8_t *p, double v) { write_u64_be(p, detail::bit_cast<uint64_t>(v)); }
+
+    /** @brief True when every byte of @p data is a valid canonical bool (0x00 / 0x01). */
+    inline bool valid_bools(const uint8_t *data, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
         {
-            if (!ensure(1))
+            if (data[i] > 1u)
             {
                 return false;
             }
-            out_.data[index_++] = value;
-            return true;
         }
+        return true;
+    }
+
+    /** @brief Maximum encoded size of a varint holding a 32-bit / 64-bit value. */
+    static const size_t kMaxVarint32Size = 5;
+    static const size_t kMaxVarint64Size = 10;
+
+    /** @brief Bytes `writeVarint(v)` produces (1..10). */
+    inline size_t varint_size(uint64_t v)
+    {
+        size_t n = 1;
+        while (v >= 0x80u)
+        {
+            v >>= 7;
+            ++n;
+        }
+        return n;
+    }
 
-        bool write(int8_t value) { return write(static_cast<uint8_t>(value)); }
+    /** @brief Zig-zag map: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ... */
+    inline uint64_t zigzag_encode(int64_t v)
+    {
+        const uint64_t u = static_cast<uint64_t>(v);
+        return (u << 1) ^ (v < 0 ? ~static_cast<uint64_t>(0) : 0u);
+    }
 
-        bool write(bool value) { return write(static_cast<uint8_t>(value ? 1u : 0u)); }
+    inline int64_t zigzag_decode(uint64_t u)
+    {
+        return detail::bit_cast<int64_t>((u >> 1) ^ (~(u & 1u) + 1u));
+    }
 
-        bool write(uint16_t value)
+    namespace detail
+    {
+#if defined(UMSG_NATIVE_LITTLE_ENDIAN)
+        inline uint16_t byteSwap(uint16_t v) { return __builtin_bswap16(v); }
+        inline uint32_t byteSwap(uint32_t v) { return __builtin_bswap32(v); }
+        inline uint64_t byteSwap(uint64_t v) { return __builtin_bswap64(v); }
+
+        /**
+         * @brief Byte-swap whole 16-byte blocks of @p WordSize-byte words from @p in to @p out.
+         * @return Number of words handled; the caller finishes the tail.
+         */
+        template <size_t WordSize>
+        inline size_t byteSwapBlocks(uint8_t *out, const uint8_t *in, size_t count);
+
+#if defined(UMSG_MARSHAL_SSE2)
+        // Swap the two bytes of every 16-bit lane.
+        inline __m128i byteSwapLanes16(__m128i v)
         {
-            if (!ensure(2))
+            return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        }
+
+        template <int LaneShuffle>
+        inline size_t byteSwapBlocksSse2(uint8_t *out, const uint8_t *in, size_t count, size_t wordSize)
+        {
+            // Less than one block: no vector load or store at all, so that once
+            // inlined against a short buffer the loop folds away (-Warray-bounds).
+            if (count * wordSize < 16)
             {
-                return false;
+                return 0;
             }
-            write_u16_be(&out_.data[index_], value);
-            index_ += 2;
-            return true;
+            const size_t blocks = count * wordSize / 16;
+            for (size_t b = 0; b < blocks; ++b)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 16 * b));
+                if (LaneShuffle != 0)
+                {
+                    // Reverse the 16-bit lanes within each word, then the bytes within each lane.
+                    v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, LaneShuffle), LaneShuffle);
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 * b), byteSwapLanes16(v));
+            }
+            return blocks * 16 / wordSize;
         }
 
-        bool write(int16_t value) { return write(static_cast<uint16_t>(value)); }
+        template <>
+        inline size_t byteSwapBlocks<2>(uint8_t *out, const uint8_t *in, size_t count)
+        {
+            return byteSwapBlocksSse2<0>(out, in, count, 2);
+        }
 
-        bool write(uint32_t value)
+        template <>
+        inline size_t byteSwapBlocks<4>(uint8_t *out, const uint8_t *in, size_t count)
         {
-            if (!ensure(4))
+            return byteSwapBlocksSse2<0xB1>(out, in, count, 4); // lanes 1,0,3,2
+        }
+
+        template <>
+        inline size_t byteSwapBlocks<8>(uint8_t *out, const uint8_t *in, size_t count)
+        {
+            return byteSwapBlocksSse2<0x1B>(out, in, count, 8); // lanes 3,2,1,0
+        }
+#elif defined(UMSG_MARSHAL_NEON)
+        template <>
+        inline size_t byteSwapBlocks<2>(uint8_t *out, const uint8_t *in, size_t count)
+        {
+            const size_t blocks = count / 8;
+            for (size_t b = 0; b < blocks; ++b)
             {
-                return false;
+                vst1q_u8(out + 16 * b, vrev16q_u8(vld1q_u8(in + 16 * b)));
             }
-            write_u32_be(&out_.data[index_], value);
-            index_ += 4;
-            return true;
+            return blocks * 8;
         }
 
-        bool write(int32_t value) { return write(static_cast<uint32_t>(value)); }
+        template <>
+        inline size_t byteSwapBlocks<4>(uint8_t *out, const uint8_t *in, size_t count)
+        {
+            const size_t blocks = count / 4;
+            for (size_t b = 0; b < blocks; ++b)
+            {
+                vst1q_u8(out + 16 * b, vrev32q_u8(vld1q_u8(in + 16 * b)));
+            }
+            return blocks * 4;
+        }
 
-        bool write(uint64_t value)
+        template <>
+        inline size_t byteSwapBlocks<8>(uint8_t *out, const uint8_t *in, size_t count)
         {
-            if (!ensure(8))
+            const size_t blocks = count / 2;
+            for (size_t b = 0; b < blocks; ++b)
             {
-                return false;
+                vst1q_u8(out + 16 * b, vrev64q_u8(vld1q_u8(in + 16 * b)));
+            }
+            return blocks * 2;
+        }
+#else
+        template <size_t WordSize>
+        inline size_t byteSwapBlocks(uint8_t *, const uint8_t *, size_t)
+        {
+            return 0;
+        }
+#endif
+
+        /** @brief Byte-swap @p count words (vector blocks, then a scalar tail). */
+        template <class Word>
+        inline void byteSwapWords(uint8_t *out, const uint8_t *in, size_t count)
+        {
+            const size_t done = byteSwapBlocks<sizeof(Word)>(out, in, count);
+            for (size_t i = done; i < count; ++i)
+            {
+                Word w;
+                ::memcpy(&w, in + i * sizeof(Word), sizeof(Word));
+                w = byteSwap(w);
+                ::memcpy(out + i * sizeof(Word), &w, sizeof(Word));
             }
-            write_u64_be(&out_.data[index_], value);
-            index_ += 8;
-            return true;
         }
+#endif
 
-        bool write(int64_t value) { return write(static_cast<uint64_t>(value)); }
+        inline void storeWordBe(uint8_t *p, uint16_t v) { write_u16_be(p, v); }
+        inline void storeWordBe(uint8_t *p, uint32_t v) { write_u32_be(p, v); }
+        inline void storeWordBe(uint8_t *p, uint64_t v) { write_u64_be(p, v); }
 
-        bool write(float value)
+        inline void loadWordBe(const uint8_t *p, uint16_t &v) { v = read_u16_be(p); }
+        inline void loadWordBe(const uint8_t *p, uint32_t &v) { v = read_u32_be(p); }
+        inline void loadWordBe(const uint8_t *p, uint64_t &v) { v = read_u64_be(p); }
+
+        /**
+         * @brief Convert @p count native-order @p Word values at @p in to big-endian at @p out.
+         *
+         * `in`/`out` are byte pointers so any same-sized scalar (e.g. `float`
+         * for `uint32_t`) can go through without aliasing issues.
+         */
+        template <class Word>
+        inline void storeWordsBe(uint8_t *out, const uint8_t *in, size_t count)
         {
-            const uint32_t bits = detail::bit_cast<uint32_t>(value);
-            return write(bits);
+#if defined(UMSG_NATIVE_BIG_ENDIAN)
+            ::memcpy(out, in, count * sizeof(Word));
+#elif defined(UMSG_NATIVE_LITTLE_ENDIAN)
+            byteSwapWords<Word>(out, in, count);
+#else
+            for (size_t i = 0; i < count; ++i)
+            {
+                Word w;
+                ::memcpy(&w, in + i * sizeof(Word), sizeof(Word));
+                storeWordBe(out + i * sizeof(Word), w);
+            }
+#endif
         }
 
-        bool write(double value)
+        /** @brief Inverse of `storeWordsBe`: big-endian words at @p in to native order at @p out. */
+        template <class Word>
+        inline void loadWordsBe(uint8_t *out, const uint8_t *in, size_t count)
         {
-            const uint64_t bits = detail::bit_cast<uint64_t>(value);
-            return write(bits);
+#if defined(UMSG_NATIVE_BIG_ENDIAN)
+            ::memcpy(out, in, count * sizeof(Word));
+#elif defined(UMSG_NATIVE_LITTLE_ENDIAN)
+            byteSwapWords<Word>(out, in, count);
+#else
+            for (size_t i = 0; i < count; ++i)
+            {
+                Word w;
+                loadWordBe(in + i * sizeof(Word), w);
+                ::memcpy(out + i * sizeof(Word), &w, sizeof(Word));
+            }
+#endif
         }
 
+        /** @brief Bulk array encoding for a scalar of @p Word wire size. */
+        template <class T, class Word>
+        struct WordArrayCodec
+        {
+            static_assert(sizeof(T) == sizeof(Word), "scalar and wire word size differ");
+            static const size_t kWireSize = sizeof(Word);
+
+            static void store(uint8_t *out, const T *values, size_t count)
+            {
+                storeWordsBe<Word>(out, reinterpret_cast<const uint8_t *>(values), count);
+            }
+
+            static bool load(T *values, const uint8_t *in, size_t count)
+            {
+                loadWordsBe<Word>(reinterpret_cast<uint8_t *>(values), in, count);
+                return true;
+            }
+        };
+
+        /** @brief Single-byte scalars: the wire format is the memory layout. */
         template <class T>
-        bool writeArray(const T *values, size_t count)
+        struct ByteArrayCodec
         {
-            if (!values && count)
+            static const size_t kWireSize = 1;
+
+            static void store(uint8_t *out, const T *values, size_t count) { ::memcpy(out, values, count); }
+
+            static bool load(T *values, const uint8_t *in, size_t count)
             {
-                return false;
+                ::memcpy(values, in, count);
+                return true;
             }
-            for (size_t i = 0; i < count; ++i)
+        };
+
+        /**
+         * @brief Canonical array encoding of @p T: `kWireSize` bytes per element,
+         *        `store()` / `load()` convert @p count elements at once.
+         */
+        template <class T>
+        struct ArrayCodec;
+
+        template <> struct ArrayCodec<uint8_t> : ByteArrayCodec<uint8_t> {};
+        template <> struct ArrayCodec<int8_t> : ByteArrayCodec<int8_t> {};
+        template <> struct ArrayCodec<uint16_t> : WordArrayCodec<uint16_t, uint16_t> {};
+        template <> struct ArrayCodec<int16_t> : WordArrayCodec<int16_t, uint16_t> {};
+        template <> struct ArrayCodec<uint32_t> : WordArrayCodec<uint32_t, uint32_t> {};
+        template <> struct ArrayCodec<int32_t> : WordArrayCodec<int32_t, uint32_t> {};
+        template <> struct ArrayCodec<float> : WordArrayCodec<float, uint32_t> {};
+        template <> struct ArrayCodec<uint64_t> : WordArrayCodec<uint64_t, uint64_t> {};
+        template <> struct ArrayCodec<int64_t> : WordArrayCodec<int64_t, uint64_t> {};
+        template <> struct ArrayCodec<double> : WordArrayCodec<double, uint64_t> {};
+
+        /** @brief `bool`: normalized to 0x00/0x01 on store, validated on load. */
+        template <>
+        struct ArrayCodec<bool>
+        {
+            static const size_t kWireSize = 1;
+
+            static void store(uint8_t *out, const bool *values, size_t count)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    out[i] = values[i] ? 1u : 0u;
+                }
+            }
+
+            static bool load(bool *values, const uint8_t *in, size_t count)
             {
-                if (!write(values[i]))
+                if (!valid_bools(in, count))
                 {
                     return false;
                 }
+                for (size_t i = 0; i < count; ++i)
+                {
+                    values[i] = in[i] != 0;
+                }
+                return true;
+            }
+        };
+    }
+
+    /** @brief Store @p count elements at @p p in canonical encoding (no bounds checks). */
+    template <class T>
+    inline void write_array_be(uint8_t *p, const T *values, size_t count)
+    {
+        detail::ArrayCodec<T>::store(p, values, count);
+    }
+
+    /**
+     * @brief Load @p count elements from @p p (no bounds checks).
+     * @return false if a `bool` element is not 0x00/0x01.
+     */
+    template <class T>
+    inline bool read_array_be(T *values, const uint8_t *p, size_t count)
+    {
+        return detail::ArrayCodec<T>::load(values, p, count);
+    }
+
+    namespace detail
+    {
+        /**
+         * @brief Canonical `write()` / `writeArray()` overloads shared by `Writer` and `StreamWriter`.
+         *
+         * CRTP: @p Derived provides `uint8_t *reserve(size_t n)` (pointer to @p n writable
+         * bytes, or null on overflow), `commit(size_t n)` (mark them written), and
+         * `kMaxReserve` (largest `n` a single `reserve()` may succeed for).
+         */
+        template <class Derived>
+        class WriterOps
+        {
+        public:
+            bool write(uint8_t value)
+            {
+                uint8_t *p = self().reserve(1);
+                if (!p)
+                {
+                    return false;
+                }
+                p[0] = value;
+                self().commit(1);
+                return true;
+            }
+
+            bool write(int8_t value) { return write(static_cast<uint8_t>(value)); }
+
+            bool write(bool value) { return write(static_cast<uint8_t>(value ? 1u : 0u)); }
+
+            bool write(uint16_t value)
+            {
+                uint8_t *p = self().reserve(2);
+                if (!p)
+                {
+                    return false;
+                }
+                write_u16_be(p, value);
+                self().commit(2);
+                return true;
+            }
+
+            bool write(int16_t value) { return write(static_cast<uint16_t>(value)); }
+
+            bool write(uint32_t value)
+            {
+                uint8_t *p = self().reserve(4);
+                if (!p)
+                {
+                    return false;
+                }
+                write_u32_be(p, value);
+                self().commit(4);
+                return true;
+            }
+
+            bool write(int32_t value) { return write(static_cast<uint32_t>(value)); }
+
+            bool write(uint64_t value)
+            {
+                uint8_t *p = self().reserve(8);
+                if (!p)
+                {
+                    return false;
+                }
+                write_u64_be(p, value);
+                self().commit(8);
+                return true;
+            }
+
+            bool write(int64_t value) { return write(static_cast<uint64_t>(value)); }
+
+            bool write(float value)
+            {
+                const uint32_t bits = detail::bit_cast<uint32_t>(value);
+                return write(bits);
+            }
+
+            bool write(double value)
+            {
+                const uint64_t bits = detail::bit_cast<uint64_t>(value);
+                return write(bits);
+            }
+
+            /**
+             * @brief Write @p count elements; one `reserve()` per `kMaxReserve` bytes and
+             *        a bulk byte-order conversion (see `detail::ArrayCodec`).
+             *
+             * With `Writer`, an array that does not fit fails without writing anything.
+             */
+            template <class T>
+            bool writeArray(const T *values, size_t count)
+            {
+                typedef detail::ArrayCodec<T> Codec;
+                if (!values && count)
+                {
+                    return false;
+                }
+                // Full chunks only occur with a bounded `reserve()` (streaming sinks). The
+                // last (usually only) chunk is written outside the loop, so its length
+                // stays visible to the optimizer and the SIMD paths fold away for
+                // short arrays (GCC -Warray-bounds otherwise).
+                const size_t maxChunk = Derived::kMaxReserve / Codec::kWireSize;
+                while (count > maxChunk)
+                {
+                    if (!writeChunk<Codec>(values, maxChunk))
+                    {
+                        return false;
+                    }
+                    values += maxChunk;
+                    count -= maxChunk;
+                }
+                return count == 0 || writeChunk<Codec>(values, count);
+            }
+
+            /** @brief Write @p value as an unsigned LEB128 varint (`varint_size(value)` bytes). */
+            bool writeVarint(uint64_t value)
+            {
+                const size_t n = varint_size(value);
+                if (n > Derived::kMaxReserve)
+                {
+                    // Longer than the writer can reserve at once (a small `StreamWriter`).
+                    for (size_t i = 0; i + 1 < n; ++i)
+                    {
+                        if (!write(static_cast<uint8_t>((value & 0x7Fu) | 0x80u)))
+                        {
+                            return false;
+                        }
+                        value >>= 7;
+                    }
+                    return write(static_cast<uint8_t>(value));
+                }
+                uint8_t *p = self().reserve(n);
+                if (!p)
+                {
+                    return false;
+                }
+                for (size_t i = 0; i + 1 < n; ++i)
+                {
+                    p[i] = static_cast<uint8_t>((value & 0x7Fu) | 0x80u);
+                    value >>= 7;
+                }
+                p[n - 1] = static_cast<uint8_t>(value);
+                self().commit(n);
+                return true;
             }
-            return true;
-        }
+
+            /** @brief Write @p value zig-zag mapped, as a varint. */
+            bool writeZigzag(int64_t value) { return writeVarint(zigzag_encode(value)); }
+
+        private:
+            Derived &self() { return *static_cast<Derived *>(this); }
+
+            template <class Codec, class T>
+            bool writeChunk(const T *values, size_t count)
+            {
+                uint8_t *p = self().reserve(count * Codec::kWireSize);
+                if (!p)
+                {
+                    return false;
+                }
+                Codec::store(p, values, count);
+                self().commit(count * Codec::kWireSize);
+                return true;
+            }
+        };
+    }
+
+    /**
+     * @brief Cursor-based writer for canonical (network byte order) encoding.
+     *
+     * The Writer never allocates. Writes fail with `false` on overflow.
+     *
+     * @note This type does not modify `ByteSpan::length`; it writes up to `length` bytes.
+     */
+    class Writer : public detail::WriterOps<Writer>
+    {
+    public:
+        explicit Writer(ByteSpan out) : out_(out), index_(0) {}
+
+        size_t bytesWritten() const { return index_; }
 
     private:
-        bool ensure(size_t n) const
+        friend class detail::WriterOps<Writer>;
+
+        static const size_t kMaxReserve = ~static_cast<size_t>(0);
+
+        uint8_t *reserve(size_t n)
         {
-            if (!out_.data)
+            if (!out_.data || n > out_.length - index_)
             {
-                return false;
+                return 0;
             }
-            return (index_ + n) <= out_.length;
+            return &out_.data[index_];
         }
 
+        void commit(size_t n) { index_ += n; }
+
         ByteSpan out_;
         size_t index_;
     };
 
+    /**
+     * @brief `Writer`-compatible encoder that streams into a byte sink instead of a span.
+     *
+     * @tparam Sink Type with `bool write(const uint8_t* data, size_t length)`.
+     * @tparam BufferSize Bytes batched locally before each `Sink::write` call, so
+     *         per-field writes don't reach the sink one scalar at a time (>= 8; varints
+     *         longer than the buffer are written a byte at a time).
+     *
+     * Lets generated messages (`encodeTo(W&)`) encode straight into e.g. the packet
+     * encoder without an intermediate payload buffer. Call `flush()` when done.
+     */
+    template <class Sink, size_t BufferSize = 32>
+    class StreamWriter : public detail::WriterOps<StreamWriter<Sink, BufferSize> >
+    {
+    public:
+        static_assert(BufferSize >= 8, "StreamWriter buffer must hold the largest scalar");
+
+        explicit StreamWriter(Sink &sink) : sink_(sink), used_(0), flushed_(0), failed_(false) {}
+
+        /** @brief Total bytes accepted so far (including any not yet flushed). */
+        size_t bytesWritten() const { return flushed_ + used_; }
+
+        /** @brief Forward buffered bytes to the sink. @return false if any sink write failed. */
+        bool flush()
+        {
+            if (!failed_ && used_ > 0)
+            {
+                failed_ = !sink_.write(buffer_, used_);
+                flushed_ += used_;
+                used_ = 0;
+            }
+            return !failed_;
+        }
+
+    private:
+        friend class detail::WriterOps<StreamWriter<Sink, BufferSize> >;
+
+        static const size_t kMaxReserve = BufferSize;
+
+        uint8_t *reserve(size_t n)
+        {
+            if (n > BufferSize)
+            {
+                return 0;
+            }
+            if (BufferSize - used_ < n && !flush())
+            {
+                return 0;
+            }
+            return failed_ ? 0 : &buffer_[used_];
+        }
+
+        void commit(size_t n) { used_ += n; }
+
+        Sink &sink_;
+        uint8_t buffer_[BufferSize];
+        size_t used_;
+        size_t flushed_;
+        bool failed_;
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief True when @p Msg has `template <class W> bool encodeTo(W&) const`
+         *        (instantiable for @p W) and `size_t encodedSize() const`.
+         */
+        template <class Msg, class W>
+        class HasEncodeTo
+        {
+            template <class U, bool (U::*)(W &) const, size_t (U::*)() const>
+            struct Check;
+
+            template <class U>
+            static char test(Check<U, &U::template encodeTo<W>, &U::encodedSize> *);
+            template <class U>
+            static long test(...);
+
+        public:
+            static const bool value = sizeof(test<Msg>(0)) == sizeof(char);
+        };
+
+        /**
+         * @brief True when @p Msg has `void encodeUnchecked(uint8_t*) const` (generated
+         *        fixed-layout messages: `kPayloadSize` bytes at constant offsets).
+         */
+        template <class Msg>
+        class HasEncodeUnchecked
+        {
+            template <class U, void (U::*)(uint8_t *) const>
+            struct Check;
+
+            template <class U>
+            static char test(Check<U, &U::encodeUnchecked> *);
+            template <class U>
+            static long test(...);
+
+        public:
+            static const bool value = sizeof(test<Msg>(0)) == sizeof(char);
+        };
+    }
+
     /**
      * @brief Cursor-based reader for canonical (network byte order) decoding.
      *
@@ -336,20 +922,107 @@ namespace umsg
             return true;
         }
 
+        /**
+         * @brief Read @p count elements with a single bounds check and a bulk
+         *        byte-order conversion. Nothing is consumed on failure.
+         */
         template <class T>
         bool readArray(T *outValues, size_t count)
         {
+            typedef detail::ArrayCodec<T> Codec;
             if (!outValues && count)
             {
                 return false;
             }
-            for (size_t i = 0; i < count; ++i)
+            if (!ensure(0) || count > (in_.length - index_) / Codec::kWireSize)
+            {
+                return false;
+            }
+            if (count == 0)
+            {
+                return true;
+            }
+            if (!Codec::load(outValues, &in_.data[index_], count))
+            {
+                return false;
+            }
+            index_ += count * Codec::kWireSize;
+            return true;
+        }
+
+        /**
+         * @brief Read an unsigned LEB128 varint. Fails on truncation, on encodings
+         *        longer than needed, and on values wider than 64 bits; nothing is
+         *        consumed on failure.
+         */
+        bool readVarint(uint64_t &out)
+        {
+            if (!ensure(0))
+            {
+                return false;
+            }
+            const size_t available = in_.length - index_;
+            uint64_t value = 0;
+            for (size_t i = 0; i < kMaxVarint64Size && i < available; ++i)
             {
-                if (!read(outValues[i]))
+                const uint8_t b = in_.data[index_ + i];
+                if (i == kMaxVarint64Size - 1 && b > 1u)
                 {
                     return false;
                 }
+                value |= static_cast<uint64_t>(b & 0x7Fu) << (7 * i);
+                if ((b & 0x80u) == 0)
+                {
+                    if (b == 0 && i > 0)
+                    {
+                        return false;
+                    }
+                    index_ += i + 1;
+                    out = value;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /** @brief As `readVarint(uint64_t&)`; also fails if the value needs more than 32 bits. */
+        bool readVarint(uint32_t &out)
+        {
+            const size_t start = index_;
+            uint64_t value;
+            if (!readVarint(value))
+            {
+                return false;
+            }
+            if (value > 0xFFFFFFFFu)
+            {
+                index_ = start;
+                return false;
+            }
+            out = static_cast<uint32_t>(value);
+            return true;
+        }
+
+        /** @brief Read a zig-zag varint (see `writeZigzag`). */
+        bool readZigzag(int64_t &out)
+        {
+            uint64_t u;
+            if (!readVarint(u))
+            {
+                return false;
+            }
+            out = zigzag_decode(u);
+            return true;
+        }
+
+        bool readZigzag(int32_t &out)
+        {
+            uint32_t u;
+            if (!readVarint(u))
+            {
+                return false;
             }
+            out = static_cast<int32_t>(zigzag_decode(u));
             return true;
         }
 
@@ -3,9 +3,25 @@
 #include <stdint.h>
 
 #include "common.hpp"
+#include "compress.hpp"
+#include "conflation.hpp"
+#include "datagram.hpp"
 #include "dispatcher.hpp"
 #include "framer.hpp"
+#include "marshalling.hpp"
+#include "packet.hpp"
 #include "protocol.hpp"
+#include "stats.hpp"
+#include "transport.hpp"
+#include "tx_batch.hpp"
+
+/**
+ * @brief Size of the stack chunk `Node::poll()` reads into when the transport
+ *        supports bulk reads (see `transport.hpp`). Override before including.
+ */
+#ifndef UMSG_RX_CHUNK_SIZE
+#define UMSG_RX_CHUNK_SIZE 64
+#endif
 
 /**
  * @file node.hpp
@@ -15,37 +31,107 @@
 
 namespace umsg
 {
+    namespace detail
+    {
+        /** @brief `poll()` stop condition that never fires. */
+        struct NoPollLimit
+        {
+            bool operator()() { return false; }
+        };
+
+        /** @brief `pollFor()` stop condition: true once @p Duration has elapsed on @p Clock. */
+        template <class Clock, class Duration>
+        class PollDeadline
+        {
+        public:
+            PollDeadline(Clock clock, Duration budget) : clock_(clock), start_(clock_()), budget_(budget) {}
+
+            bool operator()() { return !(clock_() - start_ < budget_); }
+
+        private:
+            Clock clock_;
+            decltype(clock_()) start_;
+            Duration budget_;
+        };
+
+        /** @brief Bytes read from a bulk transport but not yet fed to the framer. */
+        template <size_t Size, bool Bulk>
+        struct RxChunk
+        {
+            uint8_t data[Size];
+            size_t pos;
+            size_t length;
+
+            RxChunk() : pos(0), length(0) {}
+        };
+
+        template <size_t Size>
+        struct RxChunk<Size, false>
+        {
+        };
+
+        /** @brief C++11 stand-in for `std::conditional<B, T, F>`. */
+        template <bool B, class T, class F>
+        struct Conditional
+        {
+            typedef T type;
+        };
+
+        template <class T, class F>
+        struct Conditional<false, T, F>
+        {
+            typedef F type;
+        };
+    }
+
     /**
-     * @brief Integrates a transport, a `Framer`, and a `Dispatcher`.
+     * @brief Integrates a transport, a `Framer`, and a handler table.
      *
-     * @tparam Transport User type with `bool read(uint8_t&)` and `bool write(const uint8_t*, size_t)`.
+     * @tparam Transport User type with `bool read(uint8_t&)` and `bool write(const uint8_t*, size_t)`;
+     *         an optional bulk `bool read(uint8_t*, size_t, size_t&)` is used when present
+     *         (see `transport.hpp`).
      * @tparam MaxPayloadSize Maximum payload size for frames built/accepted.
-     * @tparam MaxHandlers Maximum number of handlers to register.
+     * @tparam DispatcherT Handler table with `Error dispatch(uint8_t, uint32_t, ByteSpan)`:
+     *         `Dispatcher<N>` (run-time `subscribe()`, see `Node`) or
+     *         `StaticDispatcher<T, Routes...>` (routes fixed at compile time; bind the
+     *         handler object through `dispatcher()`).
+     * @tparam Framing `StreamFraming` (COBS packets over a byte stream, the default) or
+     *         `DatagramFraming` (`frame || crc32` per datagram, see `datagram.hpp`;
+     *         the transport must provide `bool readDatagram(ByteSpan&)`).
      *
      * Lifecycle:
      * - Construct with a transport reference.
-     * - Register handlers via `on()`.
+     * - Register handlers via `subscribe()` (or bind a `StaticDispatcher`).
      * - Call `poll()` periodically; call `publish()` to transmit.
      *
      * Reentrancy:
      * - Do not call `poll()` recursively from a handler.
-     * - `publish()` is not re-entrant (uses internal fixed-size scratch).
+     * - `publish()` is not re-entrant (uses the internal packet buffer).
+     * - An attached `TxBatch` must outlive the batch (until `endBatch()`), and an
+     *   attached `Conflation` must outlive `endConflation()`, an attached
+     *   `Compression` must outlive `endCompression()`, a tap sink `endTap()`.
      */
-    template <class Transport, size_t MaxPayloadSize, size_t MaxHandlers>
-    class Node
+    template <class Transport, size_t MaxPayloadSize, class DispatcherT, class Framing = StreamFraming>
+    class BasicNode
     {
     public:
         static const size_t kMaxFrameSize = umsg::maxFrameSize(MaxPayloadSize);
-        static const size_t kMaxPacketSize = umsg::maxPacketSize(MaxPayloadSize);
+        static const size_t kMaxPacketSize = Framing::maxPacketSize(MaxPayloadSize);
 
         typedef umsg::Framer<kMaxPacketSize> FramerType;
-        typedef umsg::Dispatcher<MaxHandlers> DispatcherType;
+        typedef DispatcherT DispatcherType;
+
+        explicit BasicNode(Transport &transport, uint8_t expectedVersion = 1)
+            : transport_(transport), expectedVersion_(expectedVersion), batch_(nullptr), latest_(nullptr),
+              compression_(nullptr), tap_(nullptr), tapWrite_(nullptr) {}
+
+        /** @brief The handler table (e.g. to `bind()` a `StaticDispatcher`). */
+        DispatcherType &dispatcher() { return dispatcher_; }
 
-        explicit Node(Transport &transport, uint8_t expectedVersion = 1)
-            : transport_(transport), expectedVersion_(expectedVersion) {}
+        const DispatcherType &dispatcher() const { return dispatcher_; }
 
         /**
-         * @brief Subscribe a raw handler to @p msgId.
+         * @brief Subscribe a raw handler to @p msgId (`Dispatcher` only).
          *
          * Only one handler per `msgId`; re-subscribing replaces the previous handler.
          */
@@ -57,8 +143,8 @@ namespace umsg
         }
 
         /**
-         * @brief Subscribe a typed handler to @p msgId (auto-checks `Msg::kMsgHash`
-         *        and calls `Msg::decode`).
+         * @brief Subscribe a typed handler to @p msgId (`Dispatcher` only; auto-checks
+         *        `Msg::kMsgHash` and calls `Msg::decode`).
          *
          * Only one handler per `msgId`; re-subscribing replaces the previous handler.
          */
@@ -76,84 +162,688 @@ namespace umsg
          * handler return values are intentionally discarded here — the handler is the
          * right place to observe message-level outcomes, and framing-level errors only
          * matter to application code in aggregate (see `Framer::feed` if you need
-         * per-byte diagnostics).
+         * per-byte diagnostics). With `UMSG_ENABLE_STATS` they are counted in `stats()`.
+         *
+         * If the transport provides a bulk `read(uint8_t*, size_t, size_t&)`, bytes are
+         * pulled in chunks of `UMSG_RX_CHUNK_SIZE` and handed to `Framer::feed(in, consumed)`
+         * instead of one call per byte.
          *
          * @return Number of bytes consumed from the transport this call.
          */
         size_t poll()
         {
-            size_t bytes = 0;
-            uint8_t byte = 0;
-            while (transport_.read(byte))
+            detail::NoPollLimit unlimited;
+            return pollBudget(kUnlimited, kUnlimited, unlimited);
+        }
+
+        /**
+         * @brief Like `poll()`, but reads at most @p maxBytes bytes from the transport.
+         *
+         * Bulk reads are sized so that no more than @p maxBytes are taken from the
+         * transport; the rest stays there for the next call.
+         */
+        size_t poll(size_t maxBytes)
+        {
+            detail::NoPollLimit unlimited;
+            return pollBudget(maxBytes, kUnlimited, unlimited);
+        }
+
+        /**
+         * @brief Like `poll()`, but returns after @p maxFrames complete frames (dispatched
+         *        or rejected by the header checks).
+         *
+         * Bytes already read past the last frame are kept in the node and processed
+         * first by the next `poll*()` call, so nothing is lost or reordered.
+         */
+        size_t pollFrames(size_t maxFrames)
+        {
+            detail::NoPollLimit unlimited;
+            return pollBudget(kUnlimited, maxFrames, unlimited);
+        }
+
+        /**
+         * @brief Like `poll()`, but stops once @p budget has elapsed on @p clock.
+         *
+         * @param budget Time allowed, in @p clock's units (e.g. microseconds).
+         * @param clock Callable returning the current time (e.g. `micros`); `clock() - start`
+         *        must yield a value comparable with @p budget, so unsigned counters that
+         *        wrap around work as long as one call takes less than a full period.
+         *
+         * The clock is checked after every dispatched frame and before every chunk
+         * (`UMSG_RX_CHUNK_SIZE` bytes), so the overrun is bounded by one handler call
+         * plus one chunk. Remaining bytes are picked up by the next call.
+         */
+        template <class Duration, class Clock>
+        size_t pollFor(Duration budget, Clock clock)
+        {
+            detail::PollDeadline<Clock, Duration> deadline(clock, budget);
+            return pollBudget(kUnlimited, kUnlimited, deadline);
+        }
+
+        /**
+         * @brief Event-loop entry point: call when the transport's handle (e.g.
+         *        `posix::TcpClient::nativeHandle()`) reports readable.
+         *
+         * Processes everything that is available, i.e. reads until the transport
+         * has nothing more (for POSIX transports: until `EAGAIN`), so it is
+         * correct with edge-triggered `epoll` too. Bytes the transport buffers in
+         * user space are invisible to the kernel; the bounded `poll*()` variants
+         * may leave some there, so pair those with a timer rather than readiness.
+         *
+         * @return Number of bytes consumed from the transport.
+         */
+        size_t onReadable() { return poll(); }
+
+#if UMSG_ENABLE_STATS
+        /** @brief Link/dispatch counters (see `stats.hpp`). Only with `UMSG_ENABLE_STATS`. */
+        const NodeStats &stats() const { return stats_; }
+
+        void resetStats() { stats_.reset(); }
+#endif
+
+        /**
+         * @brief Queue the packets of subsequent `publish()` calls in @p batch instead
+         *        of writing each one to the transport.
+         *
+         * Packets are encoded straight into the batch while at least `kMaxPacketSize`
+         * bytes are free, and copied in otherwise. When a packet does not fit, the
+         * queued packets are written first (auto-flush); a packet larger than the
+         * whole batch is written on its own. Packets already in @p batch are kept.
+         *
+         * A failed auto-flush is returned by the `publish()` that triggered it.
+         */
+        void beginBatch(TxBatchBuffer &batch) { batch_ = &batch; }
+
+        /**
+         * @brief Write all queued packets with a single `Transport::write`.
+         *
+         * Pending conflated packets (see `beginConflation()`) are queued first.
+         * The batch is emptied whether or not the write succeeds (a partial write
+         * cannot be resumed without duplicating packets). No-op outside a batch.
+         *
+         * @return `TransportError` if the write failed.
+         */
+        Error flush()
+        {
+            const Error err = flushLatest();
+            const Error batchErr = track(flushBatch());
+            return err != Error::OK ? err : batchErr;
+        }
+
+        /** @brief `flush()` and go back to one write per `publish()`. */
+        Error endBatch()
+        {
+            const Error err = flush();
+            batch_ = nullptr;
+            return err;
+        }
+
+        /**
+         * @brief Keep only the newest packet per msg_id for `publishLatest()`, in
+         *        @p slots, until `flushLatest()` sends them.
+         *
+         * Slots are bound to msg_ids in first-publish order and keep that order
+         * on the wire. Packets already in @p slots are kept.
+         */
+        void beginConflation(ConflationBuffer &slots) { latest_ = &slots; }
+
+        /** @brief `flushLatest()` and detach the slots; `publishLatest()` becomes `publish()`. */
+        Error endConflation()
+        {
+            const Error err = flushLatest();
+            latest_ = nullptr;
+            return err;
+        }
+
+        /**
+         * @brief Encode a frame into the conflation slot of @p msgId, replacing any
+         *        packet of that msg_id not yet sent. Nothing is written until
+         *        `flushLatest()` (or `flush()`).
+         *
+         * Without `beginConflation()` this is `publish()`.
+         *
+         * @return `QueueFull` if every slot is bound to another msg_id,
+         *         `InvalidArgument` if the slots are smaller than `kMaxPacketSize`.
+         *         On an encode error the msg_id has nothing pending.
+         */
+        Error publishLatest(uint8_t msgId, uint32_t msgHash, ByteSpan payload)
+        {
+            if (!latest_)
             {
-                ++bytes;
-                typename FramerType::Result r = framer_.feed(byte);
-                if (r.complete)
+                return publish(msgId, msgHash, payload);
+            }
+            size_t slot = 0;
+            Error err = latestSlot(msgId, slot);
+            size_t packetLength = 0;
+            if (err == Error::OK)
+            {
+                err = buildRaw(msgId, msgHash, payload, latest_->packet(slot), packetLength);
+                latestDone(slot, err, packetLength);
+            }
+            return track(err);
+        }
+
+        /** @brief Typed `publishLatest()` (same `Msg` requirements as `publish()`). */
+        template <class Msg>
+        Error publishLatest(uint8_t msgId, const Msg &msg)
+        {
+            if (!latest_)
+            {
+                return publish(msgId, msg);
+            }
+            size_t slot = 0;
+            Error err = latestSlot(msgId, slot);
+            size_t packetLength = 0;
+            if (err == Error::OK)
+            {
+                uint8_t *const out = latest_->packet(slot);
+                err = buildTyped(msgId, msg, out, out + Builder::kPayloadStageOffset, packetLength);
+                latestDone(slot, err, packetLength);
+            }
+            return track(err);
+        }
+
+        /**
+         * @brief Send the conflated packets published since the last flush, in slot
+         *        order (through the batch, if one is attached).
+         *
+         * Call it when the transport can take data: once per loop, or on writability.
+         * If the transport has `bool wantsWrite() const` (e.g. `posix::TxRing`) and
+         * it returns true, nothing is sent, so a congested link keeps one packet
+         * per msg_id instead of a growing queue of stale ones.
+         *
+         * A packet stays pending if its write fails. No-op without `beginConflation()`.
+         *
+         * @return The first send error (later slots are left pending).
+         */
+        Error flushLatest()
+        {
+            if (!latest_ || transportBusy(detail::BoolConstant<kWantsWrite>()))
+            {
+                return Error::OK;
+            }
+            for (size_t i = 0; i < latest_->bound(); ++i)
+            {
+                if (!latest_->isDirty(i))
                 {
-                    protocol::Header h;
-                    ByteSpan payload;
-                    if (protocol::decodeFrame(r.frame, h, payload) != Error::OK)
+                    continue;
+                }
+                const Error err = send(latest_->packet(i), latest_->length(i));
+                if (err != Error::OK)
+                {
+                    return track(err);
+                }
+                latest_->done(i);
+            }
+            return Error::OK;
+        }
+
+        /**
+         * @brief Build a frame and transmit it (or queue it, see `beginBatch()`).
+         *
+         * The header and @p payload are streamed straight into the COBS/CRC encoder
+         * (no intermediate frame buffer), so the payload is read exactly once.
+         */
+        Error publish(uint8_t msgId, uint32_t msgHash, ByteSpan payload)
+        {
+            uint8_t *out = txBuffer();
+            size_t packetLength = 0;
+            Error err = buildRaw(msgId, msgHash, payload, out, packetLength);
+            return track(err == Error::OK ? send(out, packetLength) : err);
+        }
+
+        /**
+         * @brief Publish a typed message.
+         *
+         * Requires `Msg::kMsgHash` and either:
+         * - `template <class W> bool encodeTo(W&) const` + `size_t encodedSize() const`
+         *   (what umsg-gen emits): fields are streamed through a small `StreamWriter`
+         *   buffer straight into the COBS/CRC encoder, or
+         * - `bool Msg::encode(ByteSpan& payload) const`: the message is encoded into the
+         *   tail of the packet buffer and then COBS-encoded in place
+         *   (see `Framer::encode(parts, count, packet)`).
+         */
+        template <class Msg>
+        Error publish(uint8_t msgId, const Msg &msg)
+        {
+            uint8_t *out = txBuffer();
+            size_t packetLength = 0;
+            Error err = buildTyped(msgId, msg, out, &txPacket_[Builder::kPayloadStageOffset], packetLength);
+            return track(err == Error::OK ? send(out, packetLength) : err);
+        }
+
+        /**
+         * @brief LZ4-compress the payloads of the msg_ids enabled in @p buffers
+         *        (`publish()` and `publishLatest()`), and accept compressed frames.
+         *
+         * A payload is sent compressed (`protocol::kCompressedFlag` in the version
+         * byte) only when that makes it shorter. Received compressed payloads are
+         * inflated into @p buffers before dispatch, so handlers see the original
+         * bytes. Without an attached `Compression`, compressed frames count as
+         * `VersionMismatch`; with one, payloads that fail to inflate within
+         * `MaxPayloadSize` bytes count as `CompressionInvalid`.
+         *
+         * @p buffers must be at least `MaxPayloadSize` (otherwise nothing is
+         * compressed and compressed frames are rejected).
+         */
+        void beginCompression(CompressionBuffer &buffers) { compression_ = &buffers; }
+
+        /** @brief Send everything uncompressed again and reject compressed frames. */
+        void endCompression() { compression_ = nullptr; }
+
+        /**
+         * @brief Hand every CRC-checked frame received from now on to @p sink, as
+         *        `frame || crc32` (one `write()` per frame, before the header checks
+         *        and dispatch).
+         *
+         * @p sink needs `bool write(const uint8_t*, size_t)` and takes datagram-framed
+         * packets: a `posix::Recorder` to log traffic, or a `posix::ShmRing` /
+         * datagram `UdpSocket` to mirror it. Its result is ignored. The CRC is the
+         * received one (nothing is re-encoded).
+         */
+        template <class Sink>
+        void beginTap(Sink &sink)
+        {
+            tap_ = &sink;
+            tapWrite_ = &tapThunk<Sink>;
+        }
+
+        void endTap()
+        {
+            tap_ = nullptr;
+            tapWrite_ = nullptr;
+        }
+
+    private:
+        static const size_t kRxChunkSize = UMSG_RX_CHUNK_SIZE;
+
+        typedef detail::PacketBuilder<MaxPayloadSize, Framing> Builder;
+
+        // Where the next packet is encoded: the batch tail when a worst-case packet
+        // still fits there, txPacket_ otherwise.
+        uint8_t *txBuffer()
+        {
+            return (batch_ && batch_->remaining() >= kMaxPacketSize) ? batch_->tail() : txPacket_;
+        }
+
+        template <class Sink>
+        static bool tapThunk(void *sink, const uint8_t *data, size_t length)
+        {
+            return static_cast<Sink *>(sink)->write(data, length);
+        }
+
+        bool compressing(uint8_t msgId) const
+        {
+            return compression_ && compression_->capacity() >= MaxPayloadSize && compression_->enabled(msgId);
+        }
+
+        // The compressed payload goes into the stage area of out, which the packet
+        // encoder never overtakes (see kPayloadStageOffset).
+        Error buildRaw(uint8_t msgId, uint32_t msgHash, ByteSpan payload, uint8_t *out, size_t &packetLength)
+        {
+            if (compressing(msgId) && payload.data && payload.length <= MaxPayloadSize)
+            {
+                ByteSpan packed{out + Builder::kPayloadStageOffset, MaxPayloadSize};
+                if (compression_->compress(payload, packed))
+                {
+                    return Builder::raw(static_cast<uint8_t>(expectedVersion_ | protocol::kCompressedFlag), msgId,
+                                        msgHash, packed, out, packetLength);
+                }
+            }
+            return Builder::raw(expectedVersion_, msgId, msgHash, payload, out, packetLength);
+        }
+
+        template <class Msg>
+        Error buildTyped(uint8_t msgId, const Msg &msg, uint8_t *out, uint8_t *stage, size_t &packetLength)
+        {
+            if (compressing(msgId))
+            {
+                ByteSpan payload{compression_->txBuffer(), MaxPayloadSize};
+                if (!Builder::stage(msg, payload))
+                {
+                    return Error::InvalidArgument;
+                }
+                return buildRaw(msgId, Msg::kMsgHash, payload, out, packetLength);
+            }
+            return Builder::typed(expectedVersion_, msgId, msg, out, stage, packetLength);
+        }
+
+        Error latestSlot(uint8_t msgId, size_t &slot)
+        {
+            if (latest_->slotSize() < kMaxPacketSize)
+            {
+                return Error::InvalidArgument;
+            }
+            slot = latest_->find(msgId);
+            return slot < latest_->slots() ? Error::OK : Error::QueueFull;
+        }
+
+        void latestDone(size_t slot, Error err, size_t packetLength)
+        {
+            if (err == Error::OK)
+            {
+                latest_->set(slot, packetLength);
+            }
+            else
+            {
+                latest_->done(slot); // the old packet is partly overwritten
+            }
+        }
+
+        bool transportBusy(detail::BoolConstant<true>) const { return transport_.wantsWrite(); }
+
+        bool transportBusy(detail::BoolConstant<false>) const { return false; }
+
+        Error send(const uint8_t *packet, size_t packetLength)
+        {
+            if (batch_)
+            {
+                if (packet == batch_->tail())
+                {
+                    batch_->commit(packetLength); // encoded in place by txBuffer()
+                    return Error::OK;
+                }
+                if (packetLength > batch_->remaining())
+                {
+                    if (kBatchGather && !batch_->empty())
                     {
-                        continue;
+                        return flushBatchWith(packet, packetLength, detail::BoolConstant<kBatchGather>());
                     }
-                    if (h.version != expectedVersion_)
+                    const Error err = flushBatch();
+                    if (err != Error::OK)
                     {
-                        continue;
+                        return err;
                     }
-                    dispatcher_.dispatch(h.msgId, h.msgHash, payload);
+                }
+                if (batch_->append(packet, packetLength))
+                {
+                    return Error::OK;
                 }
             }
-            return bytes;
+            return write(packet, packetLength, 1);
         }
 
-        /** @brief Build a frame and transmit it. */
-        Error publish(uint8_t msgId, uint32_t msgHash, ByteSpan payload)
+        Error flushBatch()
         {
-            ByteSpan frame{txFrame_, kMaxFrameSize};
-            Error err = protocol::encodeFrame(expectedVersion_, msgId, msgHash, payload, frame);
-            if (err != Error::OK)
+            if (!batch_ || batch_->empty())
             {
-                return err;
+                return Error::OK;
             }
+            const Error err = write(batch_->data(), batch_->size(), batch_->packets());
+            batch_->clear();
+            return err;
+        }
 
-            ByteSpan packet{txPacket_, kMaxPacketSize};
-            err = framer_.encode(frame, packet);
-            if (err != Error::OK)
+        // Auto-flush on a gather-write transport: the queued packets and the one
+        // that did not fit go out in the same write() call.
+        Error flushBatchWith(const uint8_t *packet, size_t packetLength, detail::BoolConstant<true>)
+        {
+            const ByteSpan parts[2] = {ByteSpan{const_cast<uint8_t *>(batch_->data()), batch_->size()},
+                                       ByteSpan{const_cast<uint8_t *>(packet), packetLength}};
+            const size_t packets = batch_->packets() + 1;
+            batch_->clear();
+            if (!transport_.write(parts, 2))
             {
-                return err;
+                return Error::TransportError;
             }
+            return counted(parts[0].length + packetLength, packets);
+        }
+
+        Error flushBatchWith(const uint8_t *, size_t, detail::BoolConstant<false>) { return Error::OK; }
 
-            if (!transport_.write(packet.data, packet.length))
+        Error write(const uint8_t *data, size_t length, size_t packets)
+        {
+            if (!transport_.write(data, length))
             {
                 return Error::TransportError;
             }
+            return counted(length, packets);
+        }
+
+        Error counted(size_t length, size_t packets)
+        {
+#if UMSG_ENABLE_STATS
+            stats_.framesOut += static_cast<uint32_t>(packets);
+            stats_.bytesOut += static_cast<uint32_t>(length);
+#else
+            (void)length;
+            (void)packets;
+#endif
             return Error::OK;
         }
 
-        /**
-         * @brief Publish a typed message.
-         *
-         * Requires `Msg::kMsgHash` and `bool Msg::encode(ByteSpan& payload) const`.
-         */
-        template <class Msg>
-        Error publish(uint8_t msgId, const Msg &msg)
+        // Count a non-OK result (no-op without UMSG_ENABLE_STATS); returns it unchanged.
+        Error track(Error err)
         {
-            ByteSpan payload{txEncode_, MaxPayloadSize};
-            if (!msg.encode(payload))
+#if UMSG_ENABLE_STATS
+            stats_.count(err);
+#endif
+            return err;
+        }
+
+        static const size_t kUnlimited = ~static_cast<size_t>(0);
+        static const bool kBulkRead = detail::HasBulkRead<Transport>::value;
+        static const bool kDatagram = Framing::kDatagram;
+        // Merging a batch with the next packet would make an oversized datagram.
+        static const bool kBatchGather = detail::HasGatherWrite<Transport>::value && !kDatagram;
+        static const bool kWantsWrite = detail::HasWantsWrite<Transport>::value;
+
+        template <class Stop>
+        size_t pollBudget(size_t maxBytes, size_t maxFrames, Stop &stop)
+        {
+#if UMSG_ENABLE_STATS && defined(UMSG_STATS_NOW_US)
+            const uint32_t start = UMSG_STATS_NOW_US();
+#endif
+            const size_t bytes = pollFraming(maxBytes, maxFrames, stop, detail::BoolConstant<kDatagram>());
+#if UMSG_ENABLE_STATS
+            stats_.bytesIn += static_cast<uint32_t>(bytes);
+#if defined(UMSG_STATS_NOW_US)
+            const uint32_t elapsed = static_cast<uint32_t>(UMSG_STATS_NOW_US()) - start;
+            if (elapsed > stats_.maxPollUs)
             {
-                return Error::InvalidArgument;
+                stats_.maxPollUs = elapsed;
             }
-            return publish(msgId, Msg::kMsgHash, payload);
+#endif
+#endif
+            return bytes;
+        }
+
+        template <class Stop>
+        size_t pollFraming(size_t maxBytes, size_t maxFrames, Stop &stop, detail::BoolConstant<false>)
+        {
+            return pollImpl(maxBytes, maxFrames, stop, detail::BoolConstant<kBulkRead>());
+        }
+
+        // Datagram transport: one readDatagram() per datagram, whose frames are
+        // checked and dispatched in place. maxBytes is met at datagram granularity
+        // (a datagram cannot be read in part). Frames left in a datagram by the
+        // frame or time budget are dispatched first on the next call.
+        template <class Stop>
+        size_t pollFraming(size_t maxBytes, size_t maxFrames, Stop &stop, detail::BoolConstant<true>)
+        {
+            static_assert(detail::HasDatagramRead<Transport>::value,
+                          "DatagramFraming requires Transport::readDatagram(ByteSpan&)");
+            size_t bytes = 0;
+            size_t frames = 0;
+            for (;;)
+            {
+                while (!framer_.empty())
+                {
+                    ByteSpan frame;
+                    if (track(framer_.next(frame)) != Error::OK)
+                    {
+                        continue;
+                    }
+                    handleFrame(frame);
+                    if (++frames >= maxFrames || stop())
+                    {
+                        return bytes;
+                    }
+                }
+
+                if (bytes >= maxBytes || (bytes > 0 && stop()))
+                {
+                    return bytes;
+                }
+                ByteSpan datagram;
+                if (!transport_.readDatagram(datagram))
+                {
+                    return bytes;
+                }
+                framer_.load(datagram);
+                bytes += datagram.length;
+            }
+        }
+
+        // Byte transport: one read() per byte; the clock is consulted once per
+        // chunk-sized run of bytes and after each frame.
+        template <class Stop>
+        size_t pollImpl(size_t maxBytes, size_t maxFrames, Stop &stop, detail::BoolConstant<false>)
+        {
+            size_t bytes = 0;
+            size_t frames = 0;
+            uint8_t byte = 0;
+            while (bytes < maxBytes && frames < maxFrames)
+            {
+                if (bytes % kRxChunkSize == 0 && bytes > 0 && stop())
+                {
+                    break;
+                }
+                if (!transport_.read(byte))
+                {
+                    break;
+                }
+                ++bytes;
+                if (handleResult(framer_.feed(byte)) && (++frames >= maxFrames || stop()))
+                {
+                    break;
+                }
+            }
+            return bytes;
+        }
+
+        // Bulk transport: one read() per chunk. A chunk interrupted by the frame or
+        // time budget stays in rxChunk_ and is finished first on the next call.
+        template <class Stop>
+        size_t pollImpl(size_t maxBytes, size_t maxFrames, Stop &stop, detail::BoolConstant<true>)
+        {
+            size_t bytes = 0;
+            size_t frames = 0;
+            for (;;)
+            {
+                while (rxChunk_.pos < rxChunk_.length)
+                {
+                    size_t used = 0;
+                    const ByteSpan in{&rxChunk_.data[rxChunk_.pos], rxChunk_.length - rxChunk_.pos};
+                    const bool dispatched = handleResult(framer_.feed(in, used));
+                    rxChunk_.pos += used;
+                    if (dispatched && (++frames >= maxFrames || stop()))
+                    {
+                        return bytes;
+                    }
+                }
+
+                if (bytes >= maxBytes || (bytes > 0 && stop()))
+                {
+                    return bytes;
+                }
+                const size_t want = (maxBytes - bytes) < kRxChunkSize ? (maxBytes - bytes) : kRxChunkSize;
+                size_t n = 0;
+                if (!transport_.read(rxChunk_.data, want, n) || n == 0)
+                {
+                    return bytes;
+                }
+                rxChunk_.pos = 0;
+                rxChunk_.length = n;
+                bytes += n;
+            }
+        }
+
+        // @return true when a complete frame was handed to handleFrame().
+        bool handleResult(const typename FramerType::Result &r)
+        {
+            if (r.complete)
+            {
+                handleFrame(r.frame);
+                return true;
+            }
+            (void)track(r.status);
+            return false;
+        }
+
+        void handleFrame(ByteSpan frame)
+        {
+            protocol::Header h;
+            ByteSpan payload;
+            if (track(protocol::decodeFrame(frame, h, payload)) != Error::OK)
+            {
+                return;
+            }
+            if (tapWrite_)
+            {
+                // Both framings leave the received crc32 right after the frame.
+                (void)tapWrite_(tap_, frame.data, frame.length + 4u);
+            }
+            const bool compressed = (h.version & protocol::kCompressedFlag) != 0;
+            if (static_cast<uint8_t>(h.version & ~protocol::kCompressedFlag) != expectedVersion_ ||
+                (compressed && (!compression_ || compression_->capacity() < MaxPayloadSize)))
+            {
+                (void)track(Error::VersionMismatch);
+                return;
+            }
+            if (compressed)
+            {
+                ByteSpan inflated{compression_->rxBuffer(), MaxPayloadSize};
+                if (!lz4::decompress(payload, inflated))
+                {
+                    (void)track(Error::CompressionInvalid);
+                    return;
+                }
+                payload = inflated;
+            }
+#if UMSG_ENABLE_STATS
+            ++stats_.framesIn;
+            if (frame.length > stats_.maxFrameSize)
+            {
+                stats_.maxFrameSize = static_cast<uint16_t>(frame.length);
+            }
+#if UMSG_STATS_PER_MSG_ID
+            ++stats_.rxPerMsgId[h.msgId];
+#endif
+#endif
+            (void)track(dispatcher_.dispatch(h.msgId, h.msgHash, payload));
         }
 
-    private:
         Transport &transport_;
-        FramerType framer_;
+        typename detail::Conditional<kDatagram, DatagramDeframer, FramerType>::type framer_;
         DispatcherType dispatcher_;
         uint8_t expectedVersion_;
 
-        uint8_t txEncode_[MaxPayloadSize];
-        uint8_t txFrame_[kMaxFrameSize];
         uint8_t txPacket_[kMaxPacketSize];
+        TxBatchBuffer *batch_;
+        ConflationBuffer *latest_;
+        CompressionBuffer *compression_;
+        void *tap_;
+        bool (*tapWrite_)(void *sink, const uint8_t *data, size_t length);
+        detail::RxChunk<kRxChunkSize, kBulkRead && !kDatagram> rxChunk_;
+
+#if UMSG_ENABLE_STATS
+        NodeStats stats_;
+#endif
     };
+
+    /**
+     * @brief `BasicNode` with a run-time `Dispatcher` of @p MaxHandlers slots.
+     *
+     * @tparam MaxHandlers Maximum number of handlers to register via `subscribe()`.
+     */
+    template <class Transport, size_t MaxPayloadSize, size_t MaxHandlers>
+    using Node = BasicNode<Transport, MaxPayloadSize, Dispatcher<MaxHandlers> >;
+
+    /**
+     * @brief `Node` with `DatagramFraming`: one or more `frame || crc32` per datagram,
+     *        no COBS (see `datagram.hpp`). Both ends must use it.
+     */
+    template <class Transport, size_t MaxPayloadSize, size_t MaxHandlers>
+    using DatagramNode = BasicNode<Transport, MaxPayloadSize, Dispatcher<MaxHandlers>, DatagramFraming>;
 }
@@ -0,0 +1,201 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.hpp"
+#include "framer.hpp"
+#include "marshalling.hpp"
+#include "protocol.hpp"
+#include "transport.hpp"
+
+/**
+ * @file packet.hpp
+ * @brief Message → wire packet encoding shared by `Node` and the server transports.
+ * @ingroup umsg
+ */
+
+namespace umsg
+{
+    namespace detail
+    {
+        /**
+         * @brief Builds complete packets for payloads of up to @p MaxPayloadSize bytes:
+         *        `COBS(frame || crc32) || 0x00` with `StreamFraming`, `frame || crc32`
+         *        with `DatagramFraming`.
+         *
+         * Output buffers must hold `kMaxPacketSize` bytes.
+         */
+        template <size_t MaxPayloadSize, class Framing = StreamFraming>
+        struct PacketBuilder
+        {
+            static const size_t kMaxPacketSize = Framing::maxPacketSize(MaxPayloadSize);
+
+            // Typed payloads without encodeTo() are staged in the last MaxPayloadSize
+            // bytes of a kMaxPacketSize buffer; encoding into that same buffer is safe
+            // because the write position never overtakes them (see Framer::encode).
+            static const size_t kPayloadStageOffset = kMaxPacketSize - MaxPayloadSize;
+
+            typedef typename Framing::Encoder Encoder;
+            typedef StreamWriter<Encoder> StreamWriterType;
+
+            /** @brief Header + raw @p payload into @p out; sets @p packetLength. */
+            static Error raw(uint8_t version, uint8_t msgId, uint32_t msgHash, ByteSpan payload,
+                             uint8_t *out, size_t &packetLength)
+            {
+                if ((!payload.data && payload.length) || payload.length > MaxPayloadSize)
+                {
+                    return Error::InvalidArgument;
+                }
+                uint8_t header[kFrameHeaderSize];
+                Error err = protocol::encodeHeader(version, msgId, msgHash, payload.length, header);
+                if (err != Error::OK)
+                {
+                    return err;
+                }
+
+                const ByteSpan parts[2] = {ByteSpan{header, kFrameHeaderSize}, payload};
+                Encoder enc;
+                if (!enc.begin(out, kMaxPacketSize))
+                {
+                    return Error::InvalidArgument;
+                }
+                for (size_t i = 0; i < 2; ++i)
+                {
+                    if (!enc.write(parts[i].data, parts[i].length))
+                    {
+                        return Error::InvalidArgument;
+                    }
+                }
+                return enc.finish(packetLength) ? Error::OK : Error::InvalidArgument;
+            }
+
+            /**
+             * @brief Typed message into @p out; sets @p packetLength.
+             *
+             * @param stage `MaxPayloadSize` bytes to encode into when @p Msg is
+             *        fixed-layout or has no `encodeTo()`; may be `out + kPayloadStageOffset`.
+             */
+            template <class Msg>
+            static Error typed(uint8_t version, uint8_t msgId, const Msg &msg,
+                               uint8_t *out, uint8_t *stage, size_t &packetLength)
+            {
+                return typedFixed(version, msgId, msg, out, stage, packetLength,
+                                  BoolConstant<HasEncodeUnchecked<Msg>::value>());
+            }
+
+            /**
+             * @brief Typed message as a flat payload into @p payload (capacity-in /
+             *        length-out), e.g. to post-process it before `raw()`.
+             */
+            template <class Msg>
+            static bool stage(const Msg &msg, ByteSpan &payload)
+            {
+                return stageFixed(msg, payload, BoolConstant<HasEncodeUnchecked<Msg>::value>());
+            }
+
+        private:
+            template <class Msg>
+            static bool stageFixed(const Msg &msg, ByteSpan &payload, BoolConstant<true>)
+            {
+                if (Msg::kPayloadSize > payload.length || !payload.data)
+                {
+                    return false;
+                }
+                msg.encodeUnchecked(payload.data);
+                payload.length = Msg::kPayloadSize;
+                return true;
+            }
+
+            template <class Msg>
+            static bool stageFixed(const Msg &msg, ByteSpan &payload, BoolConstant<false>)
+            {
+                return stageWriter(msg, payload, BoolConstant<HasEncodeTo<Msg, Writer>::value>());
+            }
+
+            template <class Msg>
+            static bool stageWriter(const Msg &msg, ByteSpan &payload, BoolConstant<true>)
+            {
+                Writer w(payload);
+                if (!msg.encodeTo(w))
+                {
+                    return false;
+                }
+                payload.length = w.bytesWritten();
+                return true;
+            }
+
+            template <class Msg>
+            static bool stageWriter(const Msg &msg, ByteSpan &payload, BoolConstant<false>)
+            {
+                return msg.encode(payload);
+            }
+
+            // Fixed layout: one size check, the fields stored at constant offsets into
+            // the stage, then encoded like a raw payload (no per-field StreamWriter calls).
+            template <class Msg>
+            static Error typedFixed(uint8_t version, uint8_t msgId, const Msg &msg,
+                                    uint8_t *out, uint8_t *stage, size_t &packetLength, BoolConstant<true>)
+            {
+                if (Msg::kPayloadSize > MaxPayloadSize)
+                {
+                    return Error::InvalidArgument;
+                }
+                msg.encodeUnchecked(stage);
+                return raw(version, msgId, Msg::kMsgHash, ByteSpan{stage, Msg::kPayloadSize}, out, packetLength);
+            }
+
+            template <class Msg>
+            static Error typedFixed(uint8_t version, uint8_t msgId, const Msg &msg,
+                                    uint8_t *out, uint8_t *stage, size_t &packetLength, BoolConstant<false>)
+            {
+                return typed(version, msgId, msg, out, stage, packetLength,
+                             BoolConstant<HasEncodeTo<Msg, StreamWriterType>::value>());
+            }
+
+            // encodeTo(): header first (length from encodedSize()), then fields streamed
+            // into the encoder. A message writing a different length is rejected.
+            template <class Msg>
+            static Error typed(uint8_t version, uint8_t msgId, const Msg &msg,
+                               uint8_t *out, uint8_t *, size_t &packetLength, BoolConstant<true>)
+            {
+                const size_t length = msg.encodedSize();
+                if (length > MaxPayloadSize)
+                {
+                    return Error::InvalidArgument;
+                }
+
+                uint8_t header[kFrameHeaderSize];
+                Error err = protocol::encodeHeader(version, msgId, Msg::kMsgHash, length, header);
+                if (err != Error::OK)
+                {
+                    return err;
+                }
+
+                Encoder enc;
+                if (!enc.begin(out, kMaxPacketSize) || !enc.write(header, kFrameHeaderSize))
+                {
+                    return Error::InvalidArgument;
+                }
+                StreamWriterType w(enc);
+                if (!msg.encodeTo(w) || !w.flush() || w.bytesWritten() != length)
+                {
+                    return Error::InvalidArgument;
+                }
+                return enc.finish(packetLength) ? Error::OK : Error::InvalidArgument;
+            }
+
+            // encode() only: stage the payload, then encode it like a raw payload.
+            template <class Msg>
+            static Error typed(uint8_t version, uint8_t msgId, const Msg &msg,
+                               uint8_t *out, uint8_t *stage, size_t &packetLength, BoolConstant<false>)
+            {
+                ByteSpan payload{stage, MaxPayloadSize};
+                if (!msg.encode(payload))
+                {
+                    return Error::InvalidArgument;
+                }
+                return raw(version, msgId, Msg::kMsgHash, payload, out, packetLength);
+            }
+        };
+    }
+}
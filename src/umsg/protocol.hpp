@@ -24,6 +24,13 @@ namespace umsg
         /** @brief Maximum payload length (uint16_t bound). */
         static const size_t kMaxPayloadLength = 0xFFFFu;
 
+        /**
+         * @brief Version-byte bit set when the payload is an LZ4 block (see `compress.hpp`).
+         *
+         * `len` is then the compressed length; protocol versions use the low 7 bits.
+         */
+        static const uint8_t kCompressedFlag = 0x80u;
+
         /** @brief Parsed frame header. */
         struct Header
         {
@@ -33,6 +40,32 @@ namespace umsg
             uint16_t payloadLength;
         };
 
+        /**
+         * @brief Write the `kFrameHeaderSize`-byte header for a payload of @p payloadLength bytes.
+         *
+         * Used to build a frame as separate header/payload pieces (scatter-gather)
+         * without copying the payload; see `Framer::encode(parts, count, packet)`.
+         *
+         * @return Error::OK, or Error::InvalidArgument if @p out is null or
+         *         @p payloadLength exceeds `kMaxPayloadLength`.
+         */
+        inline Error encodeHeader(uint8_t version,
+                                  uint8_t msgId,
+                                  uint32_t msgHash,
+                                  size_t payloadLength,
+                                  uint8_t *out)
+        {
+            if (!out || payloadLength > kMaxPayloadLength)
+            {
+                return Error::InvalidArgument;
+            }
+            out[0] = version;
+            out[1] = msgId;
+            write_u32_be(&out[2], msgHash);
+            write_u16_be(&out[6], static_cast<uint16_t>(payloadLength));
+            return Error::OK;
+        }
+
         /**
          * @brief Build a frame (header + payload) into @p outFrame.
          *
@@ -69,10 +102,7 @@ namespace umsg
                 return Error::InvalidArgument;
             }
 
-            outFrame.data[0] = version;
-            outFrame.data[1] = msgId;
-            write_u32_be(&outFrame.data[2], msgHash);
-            write_u16_be(&outFrame.data[6], static_cast<uint16_t>(payload.length));
+            (void)encodeHeader(version, msgId, msgHash, payload.length, outFrame.data);
             if (payload.length > 0)
             {
                 ::memcpy(&outFrame.data[kFrameHeaderSize], payload.data, payload.length);
@@ -0,0 +1,245 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "common.hpp"
+#include "framer.hpp"
+#include "packet.hpp"
+#include "transport.hpp"
+
+/**
+ * @file publish_queue.hpp
+ * @brief Lock-free multi-producer publish queue of pre-encoded packets.
+ * @ingroup umsg
+ *
+ * Needs `<atomic>`; not included by `umsg.h` (include it explicitly).
+ */
+
+namespace umsg
+{
+    /**
+     * @brief Bounded MPSC queue of ready-to-write packets (Vyukov's bounded queue).
+     *
+     * Any number of threads `publish()` concurrently: each claims a slot with one
+     * CAS, then encodes, CRCs and frames its message straight into that slot, in
+     * parallel with the others. A single I/O thread `drain()`s finished slots, in
+     * claim order, into the transport. This takes the encode cost out of any
+     * lock around the transport and lets publishing scale across cores.
+     *
+     * A slot whose producer is still encoding holds back the slots claimed after
+     * it until the producer finishes (ordering is by claim).
+     *
+     * @tparam MaxPayloadSize Maximum payload size (as for the receiving `Node`).
+     * @tparam Slots Number of packet slots; a power of two, at least 2. Each slot
+     *         holds one `Framing::maxPacketSize(MaxPayloadSize)` packet.
+     * @tparam Framing `StreamFraming` (default) or `DatagramFraming`; must match the
+     *         receiver.
+     */
+    template <size_t MaxPayloadSize, size_t Slots, class Framing = StreamFraming>
+    class PublishQueue
+    {
+        static_assert(Slots >= 2 && (Slots & (Slots - 1)) == 0, "Slots must be a power of two (>= 2)");
+
+    public:
+        static const size_t kMaxPacketSize = Framing::maxPacketSize(MaxPayloadSize);
+        static const size_t kSlots = Slots;
+
+        explicit PublishQueue(uint8_t version = 1) : version_(version), dequeuePos_(0)
+        {
+            for (size_t i = 0; i < Slots; ++i)
+            {
+                cells_[i].seq.store(i, std::memory_order_relaxed);
+            }
+            enqueuePos_.store(0, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Encode and enqueue a raw payload. Thread-safe.
+         * @return `QueueFull` if no slot is free (nothing is enqueued).
+         */
+        Error publish(uint8_t msgId, uint32_t msgHash, ByteSpan payload)
+        {
+            size_t pos = 0;
+            Cell *c = claim(pos);
+            if (!c)
+            {
+                return Error::QueueFull;
+            }
+            size_t length = 0;
+            const Error err = Builder::raw(version_, msgId, msgHash, payload, c->packet, length);
+            commit(*c, pos, err == Error::OK ? length : 0);
+            return err;
+        }
+
+        /** @brief Encode and enqueue a typed message (see `Node::publish`). Thread-safe. */
+        template <class Msg>
+        Error publish(uint8_t msgId, const Msg &msg)
+        {
+            size_t pos = 0;
+            Cell *c = claim(pos);
+            if (!c)
+            {
+                return Error::QueueFull;
+            }
+            size_t length = 0;
+            const Error err = Builder::typed(version_, msgId, msg, c->packet,
+                                             &c->packet[Builder::kPayloadStageOffset], length);
+            commit(*c, pos, err == Error::OK ? length : 0);
+            return err;
+        }
+
+        /**
+         * @brief Write finished packets to @p transport, oldest first. Single consumer.
+         *
+         * With a gather-write transport (see `transport.hpp`) up to 16 packets go out
+         * per `write()` call. Stops at the first slot still being encoded.
+         *
+         * @param maxPackets Upper bound on packets taken off the queue.
+         * @return `TransportError` if a write failed; the packets of that write are
+         *         dropped and draining stops.
+         */
+        template <class Transport>
+        Error drain(Transport &transport, size_t maxPackets = ~static_cast<size_t>(0))
+        {
+            return drainImpl(transport, maxPackets, detail::BoolConstant<detail::HasGatherWrite<Transport>::value>());
+        }
+
+        /** @brief True if a finished packet is waiting (consumer side). */
+        bool ready() const
+        {
+            return cells_[dequeuePos_ & kMask].seq.load(std::memory_order_acquire) == dequeuePos_ + 1;
+        }
+
+    private:
+        typedef detail::PacketBuilder<MaxPayloadSize, Framing> Builder;
+
+        static const size_t kMask = Slots - 1;
+        static const size_t kMaxGather = 16;
+        static const size_t kCacheLine = 64;
+
+        // seq == pos: free for the producer claiming pos; seq == pos + 1: packet
+        // ready for the consumer; the consumer then frees it for pos + Slots.
+        struct alignas(kCacheLine) Cell
+        {
+            std::atomic<size_t> seq;
+            size_t length; // 0: encoding failed, skip
+            uint8_t packet[kMaxPacketSize];
+        };
+
+        Cell *claim(size_t &pos)
+        {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Cell &c = cells_[pos & kMask];
+                const size_t seq = c.seq.load(std::memory_order_acquire);
+                const ptrdiff_t dif = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos);
+                if (dif == 0)
+                {
+                    if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    {
+                        return &c;
+                    }
+                }
+                else if (dif < 0)
+                {
+                    return nullptr; // full: the consumer has not freed this slot yet
+                }
+                else
+                {
+                    pos = enqueuePos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        static void commit(Cell &c, size_t pos, size_t length)
+        {
+            c.length = length;
+            c.seq.store(pos + 1, std::memory_order_release);
+        }
+
+        Cell *front()
+        {
+            Cell &c = cells_[dequeuePos_ & kMask];
+            return c.seq.load(std::memory_order_acquire) == dequeuePos_ + 1 ? &c : nullptr;
+        }
+
+        void release(Cell &c)
+        {
+            c.seq.store(dequeuePos_ + Slots, std::memory_order_release);
+            ++dequeuePos_;
+        }
+
+        template <class Transport>
+        Error drainImpl(Transport &transport, size_t maxPackets, detail::BoolConstant<false>)
+        {
+            for (size_t n = 0; n < maxPackets; ++n)
+            {
+                Cell *c = front();
+                if (!c)
+                {
+                    break;
+                }
+                const bool ok = c->length == 0 || transport.write(c->packet, c->length);
+                release(*c);
+                if (!ok)
+                {
+                    return Error::TransportError;
+                }
+            }
+            return Error::OK;
+        }
+
+        template <class Transport>
+        Error drainImpl(Transport &transport, size_t maxPackets, detail::BoolConstant<true>)
+        {
+            size_t n = 0;
+            while (n < maxPackets)
+            {
+                ByteSpan parts[kMaxGather];
+                Cell *cells[kMaxGather];
+                size_t count = 0;
+                size_t taken = 0;
+                const size_t start = dequeuePos_;
+                while (taken < kMaxGather && n + taken < maxPackets)
+                {
+                    Cell &c = cells_[(start + taken) & kMask];
+                    if (c.seq.load(std::memory_order_acquire) != start + taken + 1)
+                    {
+                        break;
+                    }
+                    cells[taken] = &c;
+                    if (c.length)
+                    {
+                        parts[count].data = c.packet;
+                        parts[count].length = c.length;
+                        ++count;
+                    }
+                    ++taken;
+                }
+                if (taken == 0)
+                {
+                    break;
+                }
+                const bool ok = count == 0 || transport.write(parts, count);
+                for (size_t i = 0; i < taken; ++i)
+                {
+                    release(*cells[i]);
+                }
+                n += taken;
+                if (!ok)
+                {
+                    return Error::TransportError;
+                }
+            }
+            return Error::OK;
+        }
+
+        Cell cells_[Slots];
+        uint8_t version_;
+        alignas(kCacheLine) std::atomic<size_t> enqueuePos_;
+        alignas(kCacheLine) size_t dequeuePos_;
+    };
+}
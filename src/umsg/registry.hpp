@@ -0,0 +1,137 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "static_dispatcher.hpp"
+
+/**
+ * @file registry.hpp
+ * @brief Compile-time list of a package's messages and their msg_ids.
+ * @ingroup umsg
+ *
+ * `umsg_gen --registry <Name>` emits one per package. It sizes a node exactly
+ * (`Name::kMaxPayloadSize`, `Name::kCount`) and gives `StaticDispatcher` routes
+ * whose msg_id follows from the handler's message type (`UMSG_REGISTRY_ROUTE`).
+ */
+
+/**
+ * @brief `umsg::Route` for a typed handler, with the msg_id taken from @p Registry.
+ *
+ * @code
+ * typedef umsg::StaticDispatcher<Robot,
+ *     UMSG_REGISTRY_ROUTE(RobotMessages, &Robot::onCommand)> RobotRoutes;
+ * @endcode
+ *
+ * Handlers taking a generated `<Name>View` resolve to the id of `<Name>` (the
+ * lookup is by `kMsgHash`). Naming a message the registry lacks is a compile error.
+ */
+#define UMSG_REGISTRY_ROUTE(Registry, method)                                                \
+    ::umsg::Route< ::umsg::MessageId<Registry,                                               \
+                       typename ::umsg::detail::HandlerMessage<decltype(method)>::Type>::value, \
+                   decltype(method), (method)>
+
+namespace umsg
+{
+    /** @brief Binds msg_id @p Id to the generated message type @p Msg. */
+    template <uint8_t Id, class Msg>
+    struct MessageDef
+    {
+        typedef Msg Type;
+        static const uint8_t kId = Id;
+    };
+
+    namespace detail
+    {
+        template <class... Defs>
+        struct MaxPayloadOf
+        {
+            static const size_t value = 0;
+        };
+
+        template <class D, class... Rest>
+        struct MaxPayloadOf<D, Rest...>
+        {
+            static const size_t rest = MaxPayloadOf<Rest...>::value;
+            static const size_t value = D::Type::kPayloadSize > rest ? D::Type::kPayloadSize : rest;
+        };
+
+        /** @brief msg_id of the def whose message has @p Hash (`found` false if none). */
+        template <uint32_t Hash, class... Defs>
+        struct FindHash
+        {
+            static const bool found = false;
+            static const uint8_t id = 0;
+        };
+
+        template <uint32_t Hash, class D, class... Rest>
+        struct FindHash<Hash, D, Rest...>
+        {
+            static const bool match = D::Type::kMsgHash == Hash;
+            static const bool found = match || FindHash<Hash, Rest...>::found;
+            static const uint8_t id = match ? D::kId : FindHash<Hash, Rest...>::id;
+        };
+
+        /** @brief True when no two defs in @p Defs share a `kMsgHash`. */
+        template <class... Defs>
+        struct HashesUnique
+        {
+            static const bool value = true;
+        };
+
+        template <class D, class... Rest>
+        struct HashesUnique<D, Rest...>
+        {
+            static const bool value = !FindHash<D::Type::kMsgHash, Rest...>::found && HashesUnique<Rest...>::value;
+        };
+
+        /** @brief Message type of a typed handler `Error (T::*)(const Msg&)`. */
+        template <class M>
+        struct HandlerMessage;
+
+        template <class T, class Msg>
+        struct HandlerMessage<Error (T::*)(const Msg &)>
+        {
+            typedef Msg Type;
+        };
+    }
+
+    /**
+     * @brief The messages of one package with their msg_ids.
+     *
+     * @tparam Defs `MessageDef<id, Msg>` list; ids and `kMsgHash` values must be unique.
+     *
+     * Generated registries derive from this and add a `k<Name>Id` constant per
+     * message. The node for a package is then
+     * `umsg::Node<Transport, Reg::kMaxPayloadSize, Reg::kCount>`.
+     */
+    template <class... Defs>
+    struct MessageRegistry
+    {
+        static_assert(detail::RoutesUnique<Defs...>::value, "Duplicate msgId in MessageRegistry");
+        static_assert(detail::HashesUnique<Defs...>::value, "Two messages in a MessageRegistry share a kMsgHash");
+
+        /** @brief The registry without any derived-class additions (to match on `Defs...`). */
+        typedef MessageRegistry Types;
+
+        /** @brief Number of messages, i.e. handlers a node needs to subscribe to all of them. */
+        static const size_t kCount = sizeof...(Defs);
+
+        /** @brief Largest `kPayloadSize` in the package. */
+        static const size_t kMaxPayloadSize = detail::MaxPayloadOf<Defs...>::value;
+
+        /** @brief msg_id of @p Msg (or of the message a `<Name>View` reads). */
+        template <class Msg>
+        struct IdOf
+        {
+            static_assert(detail::FindHash<Msg::kMsgHash, Defs...>::found, "Message is not in this MessageRegistry");
+            static const uint8_t value = detail::FindHash<Msg::kMsgHash, Defs...>::id;
+        };
+    };
+
+    /** @brief `Registry::IdOf<Msg>::value`, spelled without `template` in dependent code. */
+    template <class Registry, class Msg>
+    struct MessageId
+    {
+        static const uint8_t value = Registry::template IdOf<Msg>::value;
+    };
+}
@@ -0,0 +1,474 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "cobs.hpp"
+#include "common.hpp"
+#include "datagram.hpp"
+#include "framer.hpp"
+#include "node.hpp"
+#include "protocol.hpp"
+#include "transport.hpp"
+
+/**
+ * @brief Size of the stack chunk `Router::poll()` reads into. Override before including.
+ */
+#ifndef UMSG_ROUTER_CHUNK_SIZE
+#define UMSG_ROUTER_CHUNK_SIZE 512
+#endif
+
+/**
+ * @file router.hpp
+ * @brief Cut-through forwarding of validated frames between transports, by msg_id.
+ * @ingroup umsg
+ *
+ * A bridge built from two `Node`s decodes, re-encodes and re-checksums every
+ * frame. A `Router` reads each frame's 8-byte header only and passes the frame on
+ * as it arrived:
+ *
+ * | In → out | Bytes written |
+ * |---|---|
+ * | stream → stream | the received COBS packet, unchanged |
+ * | stream → datagram | `frame || crc32` from the framer's RX buffer (CRC not recomputed) |
+ * | datagram → datagram | the frame's `frame || crc32` slice of the received datagram |
+ * | datagram → stream | `COBS(frame || crc32) || 0x00` (CRC not recomputed) |
+ *
+ * Forwarded frames are CRC- and length-checked. Versions and hashes are left to
+ * the endpoints.
+ */
+
+namespace umsg
+{
+    /**
+     * @brief Output side of a route: a transport reference and the framing its peer
+     *        expects.
+     *
+     * Type-erased so one `RouteTable` can name transports of different types; the
+     * transport only needs `bool write(const uint8_t*, size_t)` and must outlive
+     * the table.
+     */
+    class RouterPort
+    {
+    public:
+        RouterPort() : obj_(nullptr), write_(nullptr), datagram_(false) {}
+
+        /** @brief Port whose peer reads COBS packets (`StreamFraming`). */
+        template <class Transport>
+        static RouterPort stream(Transport &transport)
+        {
+            return RouterPort(&transport, &writeThunk<Transport>, false);
+        }
+
+        /** @brief Port whose peer reads `frame || crc32` datagrams (`DatagramFraming`). */
+        template <class Transport>
+        static RouterPort datagram(Transport &transport)
+        {
+            return RouterPort(&transport, &writeThunk<Transport>, true);
+        }
+
+        bool valid() const { return write_ != nullptr; }
+        bool isDatagram() const { return datagram_; }
+
+        bool write(ByteSpan bytes) const { return write_(obj_, bytes.data, bytes.length); }
+
+        bool operator==(const RouterPort &other) const
+        {
+            return obj_ == other.obj_ && write_ == other.write_ && datagram_ == other.datagram_;
+        }
+
+    private:
+        typedef bool (*WriteFn)(void *obj, const uint8_t *data, size_t length);
+
+        RouterPort(void *obj, WriteFn write, bool datagram) : obj_(obj), write_(write), datagram_(datagram) {}
+
+        template <class T>
+        static bool writeThunk(void *obj, const uint8_t *data, size_t length)
+        {
+            return static_cast<T *>(obj)->write(data, length);
+        }
+
+        void *obj_;
+        WriteFn write_;
+        bool datagram_;
+    };
+
+    /**
+     * @brief Capacity-independent part of `RouteTable` (what `Router` works with).
+     *
+     * A msg_id may have several routes (fan-out). Fallback routes take every frame
+     * whose msg_id has none of its own; frames with no route at all are dropped.
+     * One table can serve the routers of many input links.
+     */
+    class RouteTableBase
+    {
+    public:
+        struct Route
+        {
+            RouterPort port;
+            uint8_t msgId;
+            bool fallback;
+        };
+
+        /**
+         * @brief Forward frames with @p msgId to @p port (adding the same route twice is a no-op).
+         * @return `InvalidArgument` for a default-constructed port or a full table.
+         */
+        Error add(uint8_t msgId, const RouterPort &port) { return insert(msgId, port, false); }
+
+        /** @brief Forward frames of msg_ids without routes of their own to @p port. */
+        Error addFallback(const RouterPort &port) { return insert(0, port, true); }
+
+        size_t size() const { return size_; }
+        size_t capacity() const { return capacity_; }
+        const Route &operator[](size_t i) const { return routes_[i]; }
+
+        void clear() { size_ = 0; }
+
+    protected:
+        RouteTableBase(Route *routes, size_t capacity) : routes_(routes), capacity_(capacity), size_(0) {}
+
+    private:
+        // Copying would leave routes_ pointing into the source object's storage.
+        RouteTableBase(const RouteTableBase &);
+        RouteTableBase &operator=(const RouteTableBase &);
+
+        Error insert(uint8_t msgId, const RouterPort &port, bool fallback)
+        {
+            if (!port.valid())
+            {
+                return Error::InvalidArgument;
+            }
+            for (size_t i = 0; i < size_; ++i)
+            {
+                const Route &r = routes_[i];
+                if (r.fallback == fallback && (fallback || r.msgId == msgId) && r.port == port)
+                {
+                    return Error::OK;
+                }
+            }
+            if (size_ == capacity_)
+            {
+                return Error::InvalidArgument;
+            }
+            routes_[size_].port = port;
+            routes_[size_].msgId = msgId;
+            routes_[size_].fallback = fallback;
+            ++size_;
+            return Error::OK;
+        }
+
+        Route *routes_;
+        size_t capacity_;
+        size_t size_;
+    };
+
+    /**
+     * @brief Fixed-capacity forwarding table.
+     *
+     * @tparam MaxRoutes Number of (msg_id, port) and fallback routes it holds.
+     *         Lookups scan the table, which is cheap at the few dozen routes a bridge has.
+     */
+    template <size_t MaxRoutes>
+    class RouteTable : public RouteTableBase
+    {
+    public:
+        static const size_t kMaxRoutes = MaxRoutes;
+
+        RouteTable() : RouteTableBase(routes_, MaxRoutes) {}
+
+    private:
+        Route routes_[MaxRoutes];
+    };
+
+    /** @brief `Router` counters. They wrap on overflow and only increase until `resetStats()`. */
+    struct RouterStats
+    {
+        uint32_t framesIn;    ///< Frames that passed the CRC and header checks.
+        uint32_t framesOut;   ///< Frames written to a port (one per port).
+        uint32_t unrouted;    ///< Valid frames without a route.
+        uint32_t rejected;    ///< Framing, CRC, header or size errors on the input.
+        uint32_t writeErrors; ///< Port writes that failed (the frame is not retried).
+
+        RouterStats() { reset(); }
+
+        void reset()
+        {
+            framesIn = 0;
+            framesOut = 0;
+            unrouted = 0;
+            rejected = 0;
+            writeErrors = 0;
+        }
+    };
+
+    /**
+     * @brief Forwards the frames arriving on one input link according to a `RouteTable`.
+     *
+     * Use one router per input link (each keeps that link's framing state); they can
+     * share a table. Ports are written synchronously from `poll()` / `feed()`.
+     *
+     * A stream packet that arrives within one read is written straight from the read
+     * buffer; only packets split across reads are gathered in the router (at most
+     * one packet, `kMaxPacketSize` bytes).
+     *
+     * @tparam MaxPayloadSize Largest payload forwarded; longer frames are rejected.
+     * @tparam Framing Framing of the input link: `StreamFraming` or `DatagramFraming`.
+     */
+    template <size_t MaxPayloadSize, class Framing = StreamFraming>
+    class Router
+    {
+    public:
+        static const size_t kMaxPacketSize = umsg::maxPacketSize(MaxPayloadSize);
+
+        explicit Router(const RouteTableBase &routes) : routes_(routes), partialLength_(0) {}
+
+        /**
+         * @brief Read everything @p in has available and forward its frames.
+         *
+         * Byte streams are read in `UMSG_ROUTER_CHUNK_SIZE` chunks (bulk reads when the
+         * transport has them); datagram inputs need `bool readDatagram(ByteSpan&)`.
+         *
+         * @return Bytes consumed from @p in.
+         */
+        template <class Transport>
+        size_t poll(Transport &in)
+        {
+            return pollImpl(in, detail::BoolConstant<kDatagram>(),
+                            detail::BoolConstant<detail::HasBulkRead<Transport>::value>());
+        }
+
+        /**
+         * @brief Forward the frames in @p bytes: for stream input, the next bytes of
+         *        the stream; for datagram input, one whole datagram.
+         *
+         * @p bytes is only read during the call.
+         */
+        void feed(ByteSpan bytes)
+        {
+            if (bytes.data)
+            {
+                feedImpl(bytes, detail::BoolConstant<kDatagram>());
+            }
+        }
+
+        /** @brief Drop a partially received packet (e.g. after the input reconnects). */
+        void reset()
+        {
+            restart(detail::BoolConstant<kDatagram>());
+            partialLength_ = 0;
+        }
+
+        const RouterStats &stats() const { return stats_; }
+
+        void resetStats() { stats_.reset(); }
+
+    private:
+        static const bool kDatagram = Framing::kDatagram;
+        static const size_t kChunkSize = UMSG_ROUTER_CHUNK_SIZE;
+
+        typedef umsg::Framer<kMaxPacketSize> FramerType;
+
+        template <class Transport>
+        size_t pollImpl(Transport &in, detail::BoolConstant<false>, detail::BoolConstant<true>)
+        {
+            size_t bytes = 0;
+            uint8_t chunk[kChunkSize];
+            size_t n = 0;
+            while (in.read(chunk, kChunkSize, n) && n > 0)
+            {
+                feedImpl(ByteSpan{chunk, n}, detail::BoolConstant<false>());
+                bytes += n;
+            }
+            return bytes;
+        }
+
+        template <class Transport>
+        size_t pollImpl(Transport &in, detail::BoolConstant<false>, detail::BoolConstant<false>)
+        {
+            size_t bytes = 0;
+            uint8_t chunk[kChunkSize];
+            for (;;)
+            {
+                size_t n = 0;
+                while (n < kChunkSize && in.read(chunk[n]))
+                {
+                    ++n;
+                }
+                if (n > 0)
+                {
+                    feedImpl(ByteSpan{chunk, n}, detail::BoolConstant<false>());
+                    bytes += n;
+                }
+                if (n < kChunkSize)
+                {
+                    return bytes;
+                }
+            }
+        }
+
+        template <class Transport, class Bulk>
+        size_t pollImpl(Transport &in, detail::BoolConstant<true>, Bulk)
+        {
+            static_assert(detail::HasDatagramRead<Transport>::value,
+                          "DatagramFraming requires Transport::readDatagram(ByteSpan&)");
+            size_t bytes = 0;
+            ByteSpan datagram;
+            while (in.readDatagram(datagram))
+            {
+                feedImpl(datagram, detail::BoolConstant<true>());
+                bytes += datagram.length;
+            }
+            return bytes;
+        }
+
+        // Stream input. Every delimiter that ends a non-empty, in-sync packet is
+        // reported by the framer (complete or error), so partial_ is stale only
+        // until the next event.
+        void feedImpl(ByteSpan in, detail::BoolConstant<false>)
+        {
+            size_t done = 0;
+            while (done < in.length)
+            {
+                size_t consumed = 0;
+                const typename FramerType::Result r = framer_.feed(ByteSpan{in.data + done, in.length - done}, consumed);
+                done += consumed;
+                if (r.complete)
+                {
+                    forward(r.frame, packetEndingAt(in, done));
+                    partialLength_ = 0;
+                }
+                else if (r.status != Error::OK)
+                {
+                    ++stats_.rejected;
+                    partialLength_ = 0;
+                }
+            }
+            keepPartial(in);
+        }
+
+        // Datagram input: frames are checked and forwarded in place.
+        void feedImpl(ByteSpan in, detail::BoolConstant<true>)
+        {
+            framer_.load(in);
+            while (!framer_.empty())
+            {
+                ByteSpan frame;
+                if (framer_.next(frame) != Error::OK)
+                {
+                    ++stats_.rejected;
+                    continue;
+                }
+                forward(frame, ByteSpan{nullptr, 0});
+            }
+        }
+
+        void restart(detail::BoolConstant<false>) { framer_.reset(); }
+
+        void restart(detail::BoolConstant<true>) { framer_.load(ByteSpan{nullptr, 0}); }
+
+        // The encoded packet whose delimiter is in[end - 1].
+        ByteSpan packetEndingAt(ByteSpan in, size_t end)
+        {
+            const size_t size = framer_.packetSize();
+            if (size <= end)
+            {
+                return ByteSpan{in.data + end - size, size};
+            }
+            // Started in an earlier read: partial_ holds the first size - end bytes.
+            ::memcpy(&partial_[partialLength_], in.data, end);
+            return ByteSpan{partial_, size};
+        }
+
+        // Save the start of the packet left unfinished at the end of @p in.
+        void keepPartial(ByteSpan in)
+        {
+            const size_t n = framer_.pending();
+            if (n == 0)
+            {
+                partialLength_ = 0;
+            }
+            else if (n <= in.length)
+            {
+                ::memcpy(partial_, in.data + in.length - n, n);
+                partialLength_ = n;
+            }
+            else
+            {
+                ::memcpy(&partial_[partialLength_], in.data, in.length);
+                partialLength_ += in.length;
+            }
+        }
+
+        // @p packet: the received COBS packet (stream input), or empty (datagram input).
+        void forward(ByteSpan frame, ByteSpan packet)
+        {
+            protocol::Header h;
+            ByteSpan payload;
+            if (protocol::decodeFrame(frame, h, payload) != Error::OK || payload.length > MaxPayloadSize)
+            {
+                ++stats_.rejected;
+                return;
+            }
+            ++stats_.framesIn;
+
+            // frame || crc32: the trailer follows the frame in the framer's RX buffer
+            // and in the datagram alike.
+            const ByteSpan withCrc{frame.data, frame.length + 4};
+            bool routed = false;
+            for (size_t pass = 0; pass < 2 && !routed; ++pass)
+            {
+                for (size_t i = 0; i < routes_.size(); ++i)
+                {
+                    const RouteTableBase::Route &route = routes_[i];
+                    if (route.fallback != (pass == 1) || (pass == 0 && route.msgId != h.msgId))
+                    {
+                        continue;
+                    }
+                    routed = true;
+                    if (!route.port.isDatagram() && !packet.data)
+                    {
+                        packet = cobsPacket(withCrc);
+                    }
+                    write(route.port, route.port.isDatagram() ? withCrc : packet);
+                }
+            }
+            if (!routed)
+            {
+                ++stats_.unrouted;
+            }
+        }
+
+        // Datagram input to a stream port: COBS-encode once, whatever the fan-out.
+        ByteSpan cobsPacket(ByteSpan frameWithCrc)
+        {
+            size_t length = 0;
+            if (!cobsEncode(frameWithCrc.data, frameWithCrc.length, partial_, kMaxPacketSize - 1, length))
+            {
+                return ByteSpan{nullptr, 0};
+            }
+            partial_[length] = 0x00;
+            return ByteSpan{partial_, length + 1};
+        }
+
+        void write(const RouterPort &port, ByteSpan bytes)
+        {
+            if (bytes.data && port.write(bytes))
+            {
+                ++stats_.framesOut;
+            }
+            else
+            {
+                ++stats_.writeErrors;
+            }
+        }
+
+        const RouteTableBase &routes_;
+        typename detail::Conditional<kDatagram, DatagramDeframer, FramerType>::type framer_;
+        // Stream input: the start of a packet split across reads. Datagram input:
+        // scratch for COBS-encoding a frame for a stream port.
+        uint8_t partial_[kMaxPacketSize + 1];
+        size_t partialLength_;
+        RouterStats stats_;
+    };
+}
@@ -0,0 +1,222 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+
+#include "common.hpp"
+#include "dispatcher.hpp"
+#include "framer.hpp"
+#include "node.hpp"
+
+/**
+ * @file rx_pipeline.hpp
+ * @brief Receive pipeline split across two threads: I/O (deframe + check) and
+ *        handlers, joined by a lock-free SPSC ring of frames.
+ * @ingroup umsg
+ *
+ * Needs `<atomic>`; not included by `umsg.h` (include it explicitly).
+ */
+
+namespace umsg
+{
+    /**
+     * @brief Fixed-capacity single-producer/single-consumer ring of validated frames.
+     *
+     * Models the `BasicNode` dispatcher concept on the producer side: a node using
+     * it as `DispatcherT` deframes, checks CRC, header and version, and then copies
+     * each frame's id, hash and payload into the next free slot instead of running
+     * a handler. The consumer thread calls `dispatchPending()` to run the real
+     * handlers, on a payload that aliases the slot.
+     *
+     * @tparam MaxPayloadSize Largest payload a slot holds.
+     * @tparam Slots Number of frame slots; a power of two, at least 2.
+     */
+    template <size_t MaxPayloadSize, size_t Slots>
+    class FrameRing
+    {
+        static_assert(Slots >= 2 && (Slots & (Slots - 1)) == 0, "Slots must be a power of two (>= 2)");
+
+    public:
+        static const size_t kSlots = Slots;
+
+        FrameRing()
+        {
+            head_.store(0, std::memory_order_relaxed);
+            tail_.store(0, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Producer: append one frame.
+         * @return `QueueFull` if every slot is taken (the frame is not stored),
+         *         `InvalidArgument` for a payload over `MaxPayloadSize`.
+         */
+        Error dispatch(uint8_t msgId, uint32_t msgHash, ByteSpan payload)
+        {
+            if ((!payload.data && payload.length) || payload.length > MaxPayloadSize)
+            {
+                return Error::InvalidArgument;
+            }
+            const size_t head = head_.load(std::memory_order_relaxed);
+            if (head - tail_.load(std::memory_order_acquire) == Slots)
+            {
+                return Error::QueueFull;
+            }
+            Slot &s = slots_[head & kMask];
+            s.msgId = msgId;
+            s.msgHash = msgHash;
+            s.length = static_cast<uint16_t>(payload.length);
+            if (payload.length)
+            {
+                ::memcpy(s.payload, payload.data, payload.length);
+            }
+            head_.store(head + 1, std::memory_order_release);
+            return Error::OK;
+        }
+
+        /** @brief Producer: slots free right now (can only grow until the next `dispatch()`). */
+        size_t freeSlots() const
+        {
+            return Slots - (head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_acquire));
+        }
+
+        /** @brief Consumer: frames waiting. */
+        size_t pending() const
+        {
+            return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Consumer: hand queued frames to @p dispatcher, oldest first.
+         *
+         * Each slot is released after its handler returns. Handler results are
+         * discarded, as in `Node::poll()`.
+         *
+         * @param maxFrames Upper bound on frames dispatched this call.
+         * @return Number of frames dispatched.
+         */
+        template <class DispatcherT>
+        size_t dispatchPending(DispatcherT &dispatcher, size_t maxFrames = ~static_cast<size_t>(0))
+        {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            const size_t head = head_.load(std::memory_order_acquire);
+            size_t n = 0;
+            while (tail != head && n < maxFrames)
+            {
+                Slot &s = slots_[tail & kMask];
+                (void)dispatcher.dispatch(s.msgId, s.msgHash, ByteSpan{s.payload, s.length});
+                tail_.store(++tail, std::memory_order_release);
+                ++n;
+            }
+            return n;
+        }
+
+    private:
+        static const size_t kMask = Slots - 1;
+        static const size_t kCacheLine = 64;
+
+        struct Slot
+        {
+            uint32_t msgHash;
+            uint16_t length;
+            uint8_t msgId;
+            uint8_t payload[MaxPayloadSize];
+        };
+
+        Slot slots_[Slots];
+        alignas(kCacheLine) std::atomic<size_t> head_; // written by the producer
+        alignas(kCacheLine) std::atomic<size_t> tail_; // written by the consumer
+    };
+
+    /**
+     * @brief Receive side of a `Node` split into an I/O stage and a handler stage.
+     *
+     * The I/O thread calls `poll()` (or `onReadable()`): the transport is read,
+     * deframed and checked by an internal `BasicNode` whose dispatcher is a
+     * `FrameRing`. The handler thread calls `dispatchPending()`, which runs the
+     * handlers registered with `subscribe()`. A slow handler then delays only the
+     * handler thread, and bursts are absorbed by the ring.
+     *
+     * A full ring is never overrun: `poll()` takes at most as many frames off the
+     * transport as there are free slots and leaves the rest there (or in the node's
+     * chunk buffer), so the transport and the kernel buffer absorb the backlog.
+     *
+     * Both stages may run on different threads, one thread each. `subscribe()`
+     * before starting them. `node()` (e.g. for `publish()` or `stats()`) belongs to
+     * the I/O thread.
+     *
+     * @tparam Transport, MaxPayloadSize, Framing As for `BasicNode`.
+     * @tparam Slots Ring capacity in frames (power of two); RAM is about
+     *         `Slots * (MaxPayloadSize + 8)` bytes.
+     * @tparam DispatcherT Handler table run by `dispatchPending()`.
+     */
+    template <class Transport, size_t MaxPayloadSize, size_t Slots, class DispatcherT, class Framing = StreamFraming>
+    class BasicRxPipeline
+    {
+    public:
+        typedef FrameRing<MaxPayloadSize, Slots> RingType;
+        typedef BasicNode<Transport, MaxPayloadSize, RingType, Framing> NodeType;
+        typedef DispatcherT DispatcherType;
+
+        explicit BasicRxPipeline(Transport &transport, uint8_t expectedVersion = 1)
+            : node_(transport, expectedVersion) {}
+
+        /** @brief Subscribe a raw handler to @p msgId (`Dispatcher` only). */
+        template <class T>
+        Error subscribe(uint8_t msgId, T *obj,
+                        Error (T::*method)(ByteSpan payload, uint32_t msgHash))
+        {
+            return dispatcher_.registerHandler(msgId, obj, method);
+        }
+
+        /** @brief Subscribe a typed handler to @p msgId (`Dispatcher` only). */
+        template <class T, class Msg>
+        Error subscribe(uint8_t msgId, T *obj, Error (T::*method)(const Msg &msg))
+        {
+            return dispatcher_.registerHandler(msgId, obj, method);
+        }
+
+        /** @brief The handler table used by `dispatchPending()`. */
+        DispatcherType &dispatcher() { return dispatcher_; }
+
+        /** @brief The I/O-side node (I/O thread only). */
+        NodeType &node() { return node_; }
+
+        /** @brief The ring between the stages. */
+        const RingType &ring() const { return node_.dispatcher(); }
+
+        /**
+         * @brief I/O thread: read and check frames into the ring, up to its free space.
+         * @return Bytes consumed from the transport (0 while the ring is full).
+         */
+        size_t poll()
+        {
+            const size_t room = node_.dispatcher().freeSlots();
+            return room ? node_.pollFrames(room) : 0;
+        }
+
+        /** @brief I/O thread: `poll()` for event loops (see `Node::onReadable()`). */
+        size_t onReadable() { return poll(); }
+
+        /**
+         * @brief Handler thread: run handlers for queued frames, oldest first.
+         * @return Number of frames dispatched.
+         */
+        size_t dispatchPending(size_t maxFrames = ~static_cast<size_t>(0))
+        {
+            return node_.dispatcher().dispatchPending(dispatcher_, maxFrames);
+        }
+
+        /** @brief Frames waiting for `dispatchPending()`. */
+        size_t pending() const { return ring().pending(); }
+
+    private:
+        NodeType node_;
+        DispatcherType dispatcher_;
+    };
+
+    /** @brief `BasicRxPipeline` with a run-time `Dispatcher` of @p MaxHandlers slots. */
+    template <class Transport, size_t MaxPayloadSize, size_t Slots, size_t MaxHandlers>
+    using RxPipeline = BasicRxPipeline<Transport, MaxPayloadSize, Slots, Dispatcher<MaxHandlers> >;
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.hpp"
+#include "dispatcher.hpp"
+
+/**
+ * @file static_dispatcher.hpp
+ * @brief Handler table fixed at compile time (no thunks, no stored member pointers).
+ * @ingroup umsg
+ */
+
+/**
+ * @brief Shorthand for `umsg::Route<id, decltype(&T::method), &T::method>`.
+ *
+ * @code
+ * typedef umsg::StaticDispatcher<Motor,
+ *     UMSG_ROUTE(10, &Motor::onCommand),
+ *     UMSG_ROUTE(11, &Motor::onRaw)> MotorDispatcher;
+ * @endcode
+ */
+#define UMSG_ROUTE(id, method) ::umsg::Route<(id), decltype(method), (method)>
+
+namespace umsg
+{
+    /**
+     * @brief Compile-time binding of @p Id to the member function @p Method.
+     *
+     * @p Method is either a raw handler `Error (T::*)(ByteSpan, uint32_t)` or a typed
+     * handler `Error (T::*)(const Msg&)` (same semantics as `Dispatcher`). Usually
+     * spelled with `UMSG_ROUTE`.
+     */
+    template <uint8_t Id, class M, M Method>
+    struct Route;
+
+    template <uint8_t Id, class T, Error (T::*Method)(ByteSpan, uint32_t)>
+    struct Route<Id, Error (T::*)(ByteSpan, uint32_t), Method>
+    {
+        typedef T Handler;
+        static const uint8_t kId = Id;
+
+        static Error invoke(T &obj, ByteSpan payload, uint32_t msgHash)
+        {
+            return (obj.*Method)(payload, msgHash);
+        }
+    };
+
+    template <uint8_t Id, class T, class Msg, Error (T::*Method)(const Msg &)>
+    struct Route<Id, Error (T::*)(const Msg &), Method>
+    {
+        typedef T Handler;
+        static const uint8_t kId = Id;
+
+        static Error invoke(T &obj, ByteSpan payload, uint32_t msgHash)
+        {
+            return detail::invokeTyped<Msg>(obj, Method, payload, msgHash);
+        }
+    };
+
+    namespace detail
+    {
+        template <class... Routes>
+        struct RouteList
+        {
+        };
+
+        /** @brief True when no route in @p Routes uses @p Id. */
+        template <uint8_t Id, class... Routes>
+        struct IdNotIn
+        {
+            static const bool value = true;
+        };
+
+        template <uint8_t Id, class R, class... Rest>
+        struct IdNotIn<Id, R, Rest...>
+        {
+            static const bool value = R::kId != Id && IdNotIn<Id, Rest...>::value;
+        };
+
+        /** @brief True when no msgId appears twice in @p Routes. */
+        template <class... Routes>
+        struct RoutesUnique
+        {
+            static const bool value = true;
+        };
+
+        template <class R, class... Rest>
+        struct RoutesUnique<R, Rest...>
+        {
+            static const bool value = IdNotIn<R::kId, Rest...>::value && RoutesUnique<Rest...>::value;
+        };
+    }
+
+    /**
+     * @brief Handler table whose routes are template arguments.
+     *
+     * @tparam T Handler object type; every route's member function belongs to @p T.
+     * @tparam Routes `Route<...>` list (see `UMSG_ROUTE`); ids must be unique.
+     *
+     * `dispatch()` is a chain of comparisons against constants with a direct call
+     * in each arm, which optimizing compilers lower to a jump table or branch tree
+     * and inline the handlers into. RAM cost is the single bound object pointer.
+     *
+     * Drop-in for `Dispatcher` as the `DispatcherT` of `BasicNode`; registration
+     * happens through the type, so there is no `registerHandler()`.
+     */
+    template <class T, class... Routes>
+    class StaticDispatcher
+    {
+    public:
+        static_assert(detail::RoutesUnique<Routes...>::value, "Duplicate msgId in StaticDispatcher routes");
+
+        explicit StaticDispatcher(T *obj = 0) : obj_(obj) {}
+
+        /** @brief Set the object handlers are invoked on (null disables dispatch). */
+        void bind(T *obj) { obj_ = obj; }
+
+        /**
+         * @brief Dispatch a payload to the route for @p msgId.
+         * @return Error::HandlerNotFound if no route matches or no object is bound.
+         */
+        Error dispatch(uint8_t msgId, uint32_t msgHash, ByteSpan payload)
+        {
+            if (!obj_)
+            {
+                return Error::HandlerNotFound;
+            }
+            return dispatchImpl(msgId, msgHash, payload, detail::RouteList<Routes...>());
+        }
+
+    private:
+        Error dispatchImpl(uint8_t, uint32_t, ByteSpan, detail::RouteList<>)
+        {
+            return Error::HandlerNotFound;
+        }
+
+        template <class R, class... Rest>
+        Error dispatchImpl(uint8_t msgId, uint32_t msgHash, ByteSpan payload, detail::RouteList<R, Rest...>)
+        {
+            if (msgId == R::kId)
+            {
+                return R::invoke(*obj_, payload, msgHash);
+            }
+            return dispatchImpl(msgId, msgHash, payload, detail::RouteList<Rest...>());
+        }
+
+        T *obj_;
+    };
+}
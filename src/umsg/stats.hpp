@@ -0,0 +1,95 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.hpp"
+
+/**
+ * @file stats.hpp
+ * @brief Optional `Node` counters (link quality, drops, loop budget).
+ * @ingroup umsg
+ *
+ * Compile-time options (define before including umsg headers):
+ * - `UMSG_ENABLE_STATS` — `1` adds a `NodeStats` member and `Node::stats()`.
+ *   Off by default; when off, no storage or code is added.
+ * - `UMSG_STATS_PER_MSG_ID` — `1` also counts received frames per `msg_id`
+ *   (256 × `uint32_t`, 1 KB).
+ * - `UMSG_STATS_NOW_US()` — expression returning a `uint32_t` microsecond clock
+ *   (e.g. `micros()` on Arduino). When defined, `maxPollUs` is tracked.
+ */
+
+#ifndef UMSG_ENABLE_STATS
+#define UMSG_ENABLE_STATS 0
+#endif
+
+#ifndef UMSG_STATS_PER_MSG_ID
+#define UMSG_STATS_PER_MSG_ID 0
+#endif
+
+namespace umsg
+{
+    /** @brief Number of `Error` values (indexes `NodeStats::errors`). */
+    static const size_t kErrorCount = static_cast<size_t>(Error::CompressionInvalid) + 1;
+
+    /**
+     * @brief Counters maintained by `Node` when `UMSG_ENABLE_STATS` is set.
+     *
+     * Counters wrap on overflow. All of them only ever increase (or track a
+     * maximum) until `Node::resetStats()`.
+     */
+    struct NodeStats
+    {
+        uint32_t bytesIn;    ///< Bytes read from the transport by `poll()`.
+        uint32_t framesIn;   ///< Frames that passed CRC, header and version checks.
+        uint32_t bytesOut;   ///< Packet bytes handed to `Transport::write`.
+        uint32_t framesOut;  ///< Packets written successfully by `publish()` / `flush()`.
+
+        /**
+         * @brief Occurrences of each non-OK `Error`, indexed by its value.
+         *
+         * RX: framing (`CobsInvalid`, `CrcInvalid`, `FrameOverflow`), header
+         * (`FrameTooShort`, `LengthMismatch`, `VersionMismatch`) and dispatch results
+         * (`HandlerNotFound`, typed-handler `HashMismatch` / `InvalidArgument`, and
+         * whatever a handler returns). TX: `TransportError`, `InvalidArgument`.
+         */
+        uint32_t errors[kErrorCount];
+
+        uint16_t maxFrameSize; ///< Largest accepted frame (header + payload), bytes.
+        uint32_t maxPollUs;    ///< Longest `poll()` call (needs `UMSG_STATS_NOW_US`).
+
+#if UMSG_STATS_PER_MSG_ID
+        uint32_t rxPerMsgId[256]; ///< `framesIn` split by `msg_id`.
+#endif
+
+        NodeStats() { reset(); }
+
+        void reset()
+        {
+            bytesIn = framesIn = bytesOut = framesOut = 0;
+            for (size_t i = 0; i < kErrorCount; ++i)
+            {
+                errors[i] = 0;
+            }
+            maxFrameSize = 0;
+            maxPollUs = 0;
+#if UMSG_STATS_PER_MSG_ID
+            for (size_t i = 0; i < 256; ++i)
+            {
+                rxPerMsgId[i] = 0;
+            }
+#endif
+        }
+
+        /** @brief Count @p err (no-op for `Error::OK`). */
+        void count(Error err)
+        {
+            if (err != Error::OK)
+            {
+                ++errors[static_cast<size_t>(err)];
+            }
+        }
+
+        /** @brief Occurrences of @p err so far. */
+        uint32_t errorCount(Error err) const { return errors[static_cast<size_t>(err)]; }
+    };
+}
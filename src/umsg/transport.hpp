@@ -0,0 +1,113 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.hpp"
+
+/**
+ * @file transport.hpp
+ * @brief Transport concept and compile-time capability detection.
+ * @ingroup umsg
+ *
+ * A transport is any user type with:
+ * - `bool read(uint8_t& byte)` — non-blocking; false when no byte is available.
+ * - `bool write(const uint8_t* data, size_t length)` — true iff all bytes were written.
+ *
+ * Optional capabilities (detected at compile time; `Node` falls back to the
+ * byte API when absent):
+ * - `bool read(uint8_t* data, size_t capacity, size_t& length)` — bulk read.
+ *   Copies up to @p capacity available bytes into @p data and sets @p length.
+ *   Returns false (with `length == 0`) when nothing is available.
+ * - `bool write(const ByteSpan* parts, size_t count)` — gather write. Same result
+ *   as one `write()` of the concatenated @p parts. `Node` uses it to write a full
+ *   `TxBatch` together with the packet that did not fit, in one call, so datagram
+ *   transports should not offer it under this name (the datagram would exceed
+ *   the batch size).
+ * - `bool readDatagram(ByteSpan& datagram)` — datagram receive, required by
+ *   `DatagramFraming` nodes. Sets @p datagram to the next whole received datagram
+ *   (typically a view into the transport's receive buffer, valid until the next
+ *   read call); false when none is pending.
+ * - `bool wantsWrite() const` — true while earlier writes are still queued in the
+ *   transport (e.g. `posix::TxRing`). `Node::flushLatest()` holds its conflated
+ *   packets until it returns false.
+ *
+ * Capability detection requires the exact signatures above (non-const members,
+ * except `wantsWrite()`).
+ */
+
+namespace umsg
+{
+    namespace detail
+    {
+        /** @brief C++11 stand-in for `std::integral_constant<bool, B>` (tag dispatch). */
+        template <bool B>
+        struct BoolConstant
+        {
+            static const bool value = B;
+        };
+
+        /** @brief True when @p T has `bool read(uint8_t*, size_t, size_t&)`. */
+        template <class T>
+        class HasBulkRead
+        {
+            template <class U, bool (U::*)(uint8_t *, size_t, size_t &)>
+            struct Check;
+
+            template <class U>
+            static char test(Check<U, &U::read> *);
+            template <class U>
+            static long test(...);
+
+        public:
+            static const bool value = sizeof(test<T>(0)) == sizeof(char);
+        };
+
+        /** @brief True when @p T has `bool readDatagram(ByteSpan&)`. */
+        template <class T>
+        class HasDatagramRead
+        {
+            template <class U, bool (U::*)(ByteSpan &)>
+            struct Check;
+
+            template <class U>
+            static char test(Check<U, &U::readDatagram> *);
+            template <class U>
+            static long test(...);
+
+        public:
+            static const bool value = sizeof(test<T>(0)) == sizeof(char);
+        };
+
+        /** @brief True when @p T has `bool write(const ByteSpan*, size_t)`. */
+        template <class T>
+        class HasGatherWrite
+        {
+            template <class U, bool (U::*)(const ByteSpan *, size_t)>
+            struct Check;
+
+            template <class U>
+            static char test(Check<U, &U::write> *);
+            template <class U>
+            static long test(...);
+
+        public:
+            static const bool value = sizeof(test<T>(0)) == sizeof(char);
+        };
+
+        /** @brief True when @p T has `bool wantsWrite() const`. */
+        template <class T>
+        class HasWantsWrite
+        {
+            template <class U, bool (U::*)() const>
+            struct Check;
+
+            template <class U>
+            static char test(Check<U, &U::wantsWrite> *);
+            template <class U>
+            static long test(...);
+
+        public:
+            static const bool value = sizeof(test<T>(0)) == sizeof(char);
+        };
+    }
+}
@@ -3,6 +3,8 @@
 #ifdef ARDUINO
 #include <Arduino.h>
 
+#include "../../common.hpp"
+
 namespace umsg {
 namespace arduino {
 
@@ -56,12 +58,45 @@ public:
         return (written == length);
     }
 
-private:
+protected:
     UdpClass& udp_;
     IPAddress destIp_;
     uint16_t destPort_;
 };
 
+/**
+ * @brief `UdpTransport` that also receives whole datagrams, for `DatagramNode`
+ *        (one or more `frame || crc32` per datagram, no COBS).
+ *
+ * @tparam MaxDatagramSize Receive buffer size; larger datagrams are dropped.
+ *         `umsg::maxDatagramSize(MaxPayloadSize)` fits one frame.
+ */
+template <typename UdpClass, size_t MaxDatagramSize>
+class UdpDatagramTransport : public UdpTransport<UdpClass> {
+public:
+    UdpDatagramTransport(UdpClass& udp, IPAddress destIp, uint16_t destPort)
+        : UdpTransport<UdpClass>(udp, destIp, destPort) {}
+
+    // Next datagram as a view into the receive buffer, valid until the next call.
+    bool readDatagram(ByteSpan& datagram) {
+        for (;;) {
+            int size = this->udp_.parsePacket();
+            if (size <= 0) return false;
+            if (static_cast<size_t>(size) > MaxDatagramSize) {
+                continue; // parsePacket() discards the unread rest of the datagram
+            }
+            int n = this->udp_.read(rxBuffer_, static_cast<size_t>(size));
+            if (n <= 0) continue;
+            datagram.data = rxBuffer_;
+            datagram.length = static_cast<size_t>(n);
+            return true;
+        }
+    }
+
+private:
+    uint8_t rxBuffer_[MaxDatagramSize];
+};
+
 } // namespace arduino
 } // namespace umsg
 
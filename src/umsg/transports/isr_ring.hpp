@@ -0,0 +1,187 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @file isr_ring.hpp
+ * @brief Interrupt-fed RX ring transport for MCU UARTs (no heap, no virtual calls).
+ *
+ * Platform-neutral: works with any UART driver that can call `push()` from its
+ * RX interrupt, or with a DMA controller writing a circular buffer (`dmaBuffer()`
+ * + `dmaWritten()` from the idle-line / half-transfer interrupt).
+ */
+
+namespace umsg {
+
+namespace detail {
+
+// Index loads/stores shared between the interrupt and the main loop. GCC and
+// Clang (avr-gcc, arm-none-eabi, xtensa) have the __atomic builtins; elsewhere
+// fall back to volatile accesses.
+template <class T>
+inline T isrLoad(const T* p) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#else
+    return *static_cast<const volatile T*>(p);
+#endif
+}
+
+template <class T>
+inline void isrStore(T* p, T v) {
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+#else
+    *static_cast<volatile T*>(p) = v;
+#endif
+}
+
+// Smallest index type for a ring of Capacity bytes; on 8-bit MCUs a uint8_t
+// index is the only size loaded and stored in one instruction.
+template <bool Small>
+struct IsrRingIndex {
+    typedef uint8_t type;
+};
+
+template <>
+struct IsrRingIndex<false> {
+    typedef uint16_t type;
+};
+
+inline bool txWritten(bool ok, size_t) { return ok; }
+
+// Arduino-style sinks return the number of bytes written.
+template <class N>
+inline bool txWritten(N written, size_t length) { return static_cast<size_t>(written) == length; }
+
+} // namespace detail
+
+/**
+ * @brief Transport whose RX side is a single-producer/single-consumer byte ring
+ *        filled from interrupt context.
+ *
+ * Producer (RX interrupt): `push(byte)` per received byte, or `push(data, n)`
+ * for a FIFO burst. Consumer (main loop): `Node::poll()`, which uses the bulk
+ * `read(uint8_t*, size_t, size_t&)` and so drains whole spans with at most two
+ * `memcpy`s per call instead of one call per byte.
+ *
+ * DMA: point a circular DMA channel at `dmaBuffer()` (`kCapacity` bytes) and call
+ * `dmaWritten(kCapacity - NDTR)` (or the driver's equivalent write position) from
+ * the idle-line and half/complete-transfer interrupts. The DMA does not see the
+ * read position, so it overwrites unread data if the main loop falls
+ * a whole ring behind; size the ring for the longest gap between polls.
+ *
+ * TX is forwarded to @p TxSink (any type with `write(const uint8_t*, size_t)`
+ * returning `bool`, or a byte count like Arduino's `Print`).
+ *
+ * One slot stays empty to tell full from empty: the ring holds `kCapacity - 1`
+ * bytes. When the ring is full, `push()` drops the byte and counts an overrun.
+ *
+ * @tparam Capacity Ring size in bytes; a power of two. On AVR at most 256 so the
+ *         shared indices are single bytes.
+ * @tparam TxSink Where `write()` goes (e.g. `HardwareSerial`, a register-level TX).
+ */
+template <size_t Capacity, class TxSink>
+class IsrRingTransport {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two (>= 2)");
+    static_assert(Capacity <= 65536, "Capacity must fit a 16-bit index");
+#if defined(__AVR__)
+    static_assert(Capacity <= 256, "on AVR the ring indices must be single bytes");
+#endif
+
+public:
+    static const size_t kCapacity = Capacity;
+
+    typedef typename detail::IsrRingIndex<(Capacity <= 256)>::type Index;
+
+    explicit IsrRingTransport(TxSink& tx) : tx_(tx), head_(0), tail_(0), overruns_(0) {}
+
+    // --- Producer (interrupt context) ---
+
+    // Append one received byte; false (byte dropped) when the ring is full.
+    bool push(uint8_t byte) {
+        const Index head = head_;
+        const Index next = static_cast<Index>((head + 1) & kMask);
+        if (next == detail::isrLoad(&tail_)) {
+            ++overruns_;
+            return false;
+        }
+        buffer_[head] = byte;
+        detail::isrStore(&head_, next);
+        return true;
+    }
+
+    // Append a burst (e.g. a drained hardware FIFO); returns bytes stored.
+    size_t push(const uint8_t* data, size_t length) {
+        const Index head = head_;
+        const size_t room = (static_cast<size_t>(detail::isrLoad(&tail_)) - head - 1) & kMask;
+        const size_t n = length < room ? length : room;
+        const size_t first = n < Capacity - head ? n : Capacity - head;
+        ::memcpy(&buffer_[head], data, first);
+        ::memcpy(&buffer_[0], data + first, n - first);
+        overruns_ = static_cast<uint16_t>(overruns_ + (length - n));
+        detail::isrStore(&head_, static_cast<Index>((head + n) & kMask));
+        return n;
+    }
+
+    // DMA mode: the ring storage for a circular DMA channel.
+    uint8_t* dmaBuffer() { return buffer_; }
+
+    // DMA mode: the DMA has written everything before @p writePos
+    // (0 <= writePos <= kCapacity).
+    void dmaWritten(size_t writePos) {
+        detail::isrStore(&head_, static_cast<Index>(writePos & kMask));
+    }
+
+    // --- Consumer (main loop) ---
+
+    bool read(uint8_t& byte) {
+        const Index tail = tail_;
+        if (tail == detail::isrLoad(&head_)) return false;
+        byte = buffer_[tail];
+        detail::isrStore(&tail_, static_cast<Index>((tail + 1) & kMask));
+        return true;
+    }
+
+    // Bulk read (used by Node::poll()): up to two memcpy()s from the ring.
+    bool read(uint8_t* data, size_t capacity, size_t& length) {
+        const Index tail = tail_;
+        const size_t avail = (static_cast<size_t>(detail::isrLoad(&head_)) - tail) & kMask;
+        const size_t n = capacity < avail ? capacity : avail;
+        const size_t first = n < Capacity - tail ? n : Capacity - tail;
+        ::memcpy(data, &buffer_[tail], first);
+        ::memcpy(data + first, &buffer_[0], n - first);
+        detail::isrStore(&tail_, static_cast<Index>((tail + n) & kMask));
+        length = n;
+        return n > 0;
+    }
+
+    bool write(const uint8_t* data, size_t length) {
+        return detail::txWritten(tx_.write(data, length), length);
+    }
+
+    // Bytes waiting to be read.
+    size_t available() const {
+        return (static_cast<size_t>(detail::isrLoad(&head_)) - tail_) & kMask;
+    }
+
+    // Bytes dropped by push() on a full ring (wraps at 65536; on 8-bit MCUs
+    // read it with interrupts disabled for an exact value).
+    uint16_t overruns() const { return overruns_; }
+
+    // Drop buffered bytes (main loop).
+    void clear() { detail::isrStore(&tail_, detail::isrLoad(&head_)); }
+
+private:
+    static const size_t kMask = Capacity - 1;
+
+    TxSink& tx_;
+    Index head_; // written by the producer only
+    Index tail_; // written by the consumer only
+    uint16_t overruns_;
+    uint8_t buffer_[Capacity];
+};
+
+} // namespace umsg
@@ -0,0 +1,475 @@
+#pragma once
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "io.hpp"
+#include "../../common.hpp"
+#include "../../datagram.hpp"
+#include "../../marshalling.hpp"
+
+/**
+ * @file frame_log.hpp
+ * @brief Capture (`Recorder`) and replay (`Replayer`) of checked frames through
+ *        an append-only, mmap-friendly log file.
+ *
+ * Log file (all integers big-endian, records 8-byte aligned):
+ *
+ * | Offset | Size | Field |
+ * |---|---|---|
+ * | 0 | 8 | magic `"UMSGLOG\x01"` |
+ * | 8 | 8 | wall-clock time of `Recorder::open()`, ns since the Unix epoch |
+ * | 16 | 16 | reserved (0) |
+ * | 32 | ... | records |
+ *
+ * Record: `t_ns(8) | length(4) | frame || crc32 (length) | zero pad to 8`, where
+ * `t_ns` is `CLOCK_MONOTONIC` time since `open()` and never decreases. The stored
+ * bytes are exactly a `DatagramFraming` packet, so replay hands them to a
+ * `DatagramNode` straight from the mapping.
+ *
+ * Index file (`<log>.idx`): magic `"UMSGIDX\x01"`, `interval(4)`, reserved(4),
+ * then `t_ns(8) | offset(8)` for records 0, interval, 2 * interval, ... It is
+ * optional for replay and only speeds up `Replayer::seek()`. A log cut short by
+ * a crash replays up to its last complete record.
+ */
+
+namespace umsg {
+namespace posix {
+
+struct FrameLog {
+    static const size_t kHeaderSize = 32;
+    static const size_t kRecordHeaderSize = 12;
+    static const size_t kIndexHeaderSize = 16;
+    static const size_t kIndexEntrySize = 16;
+
+    // Bytes a record holding a @p packetLength-byte `frame || crc32` takes.
+    static size_t recordSize(size_t packetLength) { return (kRecordHeaderSize + packetLength + 7u) & ~static_cast<size_t>(7u); }
+
+    static const uint8_t* logMagic() { return reinterpret_cast<const uint8_t*>("UMSGLOG\x01"); }
+    static const uint8_t* indexMagic() { return reinterpret_cast<const uint8_t*>("UMSGIDX\x01"); }
+};
+
+namespace detail {
+
+inline uint64_t clockNs(clockid_t clock) {
+    struct timespec ts;
+    ::clock_gettime(clock, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+inline bool indexPath(const char* path, char (&out)[4096]) {
+    const size_t n = path ? ::strlen(path) : 0;
+    if (n == 0 || n + 5 > sizeof(out)) return false;
+    ::memcpy(out, path, n);
+    ::memcpy(out + n, ".idx", 5);
+    return true;
+}
+
+} // namespace detail
+
+/**
+ * @brief Appends checked frames with monotonic timestamps to a frame log (see
+ *        the file comment for the format).
+ *
+ * Tap a node's RX with `Node::beginTap(recorder)`, give it to a `Router` as a
+ * `RouterPort::datagram()` port, or use it as the transport of a `DatagramNode`
+ * to log what that node publishes. Records are buffered in @p BufferSize bytes
+ * and written when the buffer fills, on `flush()` and on `close()`; larger
+ * packets are written directly.
+ *
+ * @tparam BufferSize User-space write buffer in bytes.
+ */
+template <size_t BufferSize = 64 * 1024>
+class Recorder {
+    static_assert(BufferSize >= 1024, "BufferSize must hold a few records");
+
+public:
+    Recorder() : fd_(-1), indexFd_(-1), used_(0), indexUsed_(0), interval_(64), records_(0), offset_(0), startNs_(0), lastNs_(0) {}
+
+    ~Recorder() { close(); }
+
+    /**
+     * @brief Create (or truncate) @p path and `<path>.idx` and start the clock.
+     * @param indexInterval Index every this many records (>= 1).
+     */
+    bool open(const char* path, uint32_t indexInterval = 64) {
+        close();
+        char idx[4096];
+        if (indexInterval == 0 || !detail::indexPath(path, idx)) return false;
+        fd_ = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        indexFd_ = fd_ >= 0 ? ::open(idx, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) : -1;
+        if (indexFd_ < 0) {
+            close();
+            return false;
+        }
+        interval_ = indexInterval;
+        startNs_ = detail::clockNs(CLOCK_MONOTONIC);
+
+        uint8_t header[FrameLog::kHeaderSize] = {0};
+        ::memcpy(header, FrameLog::logMagic(), 8);
+        write_u64_be(&header[8], detail::clockNs(CLOCK_REALTIME));
+        uint8_t indexHeader[FrameLog::kIndexHeaderSize] = {0};
+        ::memcpy(indexHeader, FrameLog::indexMagic(), 8);
+        write_u32_be(&indexHeader[8], interval_);
+        if (!umsg::posix::detail::writeAll(fd_, header, sizeof(header)) ||
+            !umsg::posix::detail::writeAll(indexFd_, indexHeader, sizeof(indexHeader))) {
+            close();
+            return false;
+        }
+        offset_ = FrameLog::kHeaderSize;
+        return true;
+    }
+
+    // Write out buffered records and close both files.
+    void close() {
+        if (fd_ >= 0) (void)flush();
+        if (fd_ >= 0) ::close(fd_);
+        if (indexFd_ >= 0) ::close(indexFd_);
+        fd_ = -1;
+        indexFd_ = -1;
+        used_ = 0;
+        indexUsed_ = 0;
+        records_ = 0;
+        lastNs_ = 0;
+    }
+
+    bool isOpen() const { return fd_ >= 0; }
+
+    /**
+     * @brief Transport write: @p data holds one or more `frame || crc32` (a
+     *        datagram); each is CRC-checked and recorded at the current time.
+     * @return false if a frame fails the check (it and the rest are not recorded)
+     *         or a write fails.
+     */
+    bool write(const uint8_t* data, size_t length) {
+        if (fd_ < 0) return false;
+        const uint64_t now = elapsedNs();
+        DatagramDeframer frames;
+        frames.load(ByteSpan{const_cast<uint8_t*>(data), length});
+        while (!frames.empty()) {
+            ByteSpan frame;
+            if (frames.next(frame) != Error::OK) return false;
+            if (!record(ByteSpan{frame.data, frame.length + 4u}, now)) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Append one already checked `frame || crc32` with timestamp @p tNs
+     *        (ns since `open()`; raised to the previous record's if lower).
+     */
+    bool record(ByteSpan packet, uint64_t tNs) {
+        if (fd_ < 0 || (!packet.data && packet.length) || packet.length > 0xFFFFFFFFu) return false;
+        if (tNs < lastNs_) tNs = lastNs_;
+        if (records_ % interval_ == 0 && !addIndexEntry(tNs)) return false;
+
+        const size_t size = FrameLog::recordSize(packet.length);
+        if (size > BufferSize - used_ && !flushLog()) return false;
+        uint8_t header[FrameLog::kRecordHeaderSize];
+        write_u64_be(&header[0], tNs);
+        write_u32_be(&header[8], static_cast<uint32_t>(packet.length));
+        const size_t pad = size - FrameLog::kRecordHeaderSize - packet.length;
+        if (size > BufferSize) {
+            static const uint8_t kZeros[8] = {0};
+            const ByteSpan parts[3] = {ByteSpan{header, sizeof(header)}, packet,
+                                       ByteSpan{const_cast<uint8_t*>(kZeros), pad}};
+            if (!umsg::posix::detail::writeAllV(fd_, parts, 3)) return false;
+        } else {
+            uint8_t* out = &buffer_[used_];
+            ::memcpy(out, header, sizeof(header));
+            if (packet.length) ::memcpy(out + sizeof(header), packet.data, packet.length);
+            ::memset(out + sizeof(header) + packet.length, 0, pad);
+            used_ += size;
+        }
+        offset_ += size;
+        lastNs_ = tNs;
+        ++records_;
+        return true;
+    }
+
+    // Write buffered records, then the index entries that point at them.
+    bool flush() { return fd_ >= 0 && flushLog() && flushIndex(); }
+
+    // Records appended since open().
+    uint64_t records() const { return records_; }
+
+    // Log size in bytes, including buffered records.
+    uint64_t size() const { return offset_; }
+
+    // The timestamp write() would give a record now.
+    uint64_t elapsedNs() const { return detail::clockNs(CLOCK_MONOTONIC) - startNs_; }
+
+private:
+    static const size_t kIndexBufferEntries = 128;
+
+    // Copying would duplicate the fds (and double-close them).
+    Recorder(const Recorder&);
+    Recorder& operator=(const Recorder&);
+
+    bool flushLog() {
+        if (used_ == 0) return true;
+        const bool ok = umsg::posix::detail::writeAll(fd_, buffer_, used_);
+        used_ = 0;
+        return ok;
+    }
+
+    // Index entries only reach the file after the records they point at.
+    bool flushIndex() {
+        if (indexUsed_ == 0) return true;
+        const bool ok = umsg::posix::detail::writeAll(indexFd_, index_, indexUsed_);
+        indexUsed_ = 0;
+        return ok;
+    }
+
+    bool addIndexEntry(uint64_t tNs) {
+        if (indexUsed_ == sizeof(index_) && !flush()) return false;
+        write_u64_be(&index_[indexUsed_], tNs);
+        write_u64_be(&index_[indexUsed_ + 8], offset_);
+        indexUsed_ += FrameLog::kIndexEntrySize;
+        return true;
+    }
+
+    int fd_;
+    int indexFd_;
+    size_t used_;
+    size_t indexUsed_;
+    uint32_t interval_;
+    uint64_t records_;
+    uint64_t offset_;  // file offset of the next record
+    uint64_t startNs_; // CLOCK_MONOTONIC at open()
+    uint64_t lastNs_;
+    uint8_t buffer_[BufferSize];
+    uint8_t index_[kIndexBufferEntries * FrameLog::kIndexEntrySize];
+};
+
+/**
+ * @brief Read-only datagram transport over a memory-mapped frame log, for a
+ *        `DatagramNode`.
+ *
+ * `readDatagram()` returns each record's `frame || crc32` as a view into the
+ * mapping (no copy), so handlers run on the log's pages. With `setSpeed(0)` (the
+ * default) records come as fast as `poll()` takes them; with a speed `s > 0` a
+ * record is held back until `t_ns / s` has passed since the first one read,
+ * and `wait()` sleeps until then:
+ *
+ * @code
+ * umsg::posix::Replayer log;
+ * log.open("run.umsglog");
+ * log.setSpeed(1.0);                        // recorded timing
+ * umsg::DatagramNode<umsg::posix::Replayer, 1024, 8> node(log);
+ * // ... subscribe ...
+ * while (log.wait()) node.poll();
+ * @endcode
+ *
+ * `write()` always fails, so handlers that publish get `TransportError`.
+ */
+class Replayer {
+public:
+    Replayer() : map_(nullptr), size_(0), index_(nullptr), indexSize_(0), pos_(0), read_(0), speed_(0.0), paced_(false), baseLogNs_(0), baseClockNs_(0) {}
+
+    ~Replayer() { close(); }
+
+    /**
+     * @brief Map @p path (and `<path>.idx` if present and valid) and rewind.
+     * @return false if the file is missing or not a frame log.
+     */
+    bool open(const char* path) {
+        close();
+        char idx[4096];
+        if (!detail::indexPath(path, idx) || !mapFile(path, map_, size_) || size_ < FrameLog::kHeaderSize ||
+            ::memcmp(map_, FrameLog::logMagic(), 8) != 0) {
+            close();
+            return false;
+        }
+        ::madvise(map_, size_, MADV_SEQUENTIAL);
+        if (mapFile(idx, index_, indexSize_) &&
+            (indexSize_ < FrameLog::kIndexHeaderSize || ::memcmp(index_, FrameLog::indexMagic(), 8) != 0)) {
+            unmap(index_, indexSize_); // not an index: seek() scans instead
+        }
+        pos_ = FrameLog::kHeaderSize;
+        return true;
+    }
+
+    void close() {
+        unmap(map_, size_);
+        unmap(index_, indexSize_);
+        pos_ = 0;
+        read_ = 0;
+        paced_ = false;
+    }
+
+    bool isOpen() const { return map_ != nullptr; }
+
+    /**
+     * @brief Playback rate: 0 for as fast as possible, 1.0 for the recorded timing,
+     *        2.0 for twice as fast, ... Restarts the pacing clock at the next record.
+     */
+    void setSpeed(double speed) {
+        speed_ = speed > 0.0 ? speed : 0.0;
+        paced_ = false;
+    }
+
+    /**
+     * @brief Datagram receive (see umsg/transport.hpp): the next record, in place.
+     * @return false at the end of the log, or while the next record is not due.
+     */
+    bool readDatagram(ByteSpan& datagram) {
+        uint64_t tNs = 0;
+        size_t length = 0;
+        if (!peek(tNs, length) || dueInNs(tNs) > 0) return false;
+        datagram.data = map_ + pos_ + FrameLog::kRecordHeaderSize;
+        datagram.length = length;
+        pos_ += FrameLog::recordSize(length);
+        ++read_;
+        return true;
+    }
+
+    bool write(const uint8_t*, size_t) { return false; }
+
+    /**
+     * @brief Sleep until the next record is due (at once when not pacing).
+     * @return false once the log is exhausted.
+     */
+    bool wait() {
+        uint64_t tNs = 0;
+        size_t length = 0;
+        if (!peek(tNs, length)) return false;
+        for (uint64_t due = dueInNs(tNs); due > 0; due = dueInNs(tNs)) {
+            struct timespec ts;
+            ts.tv_sec = static_cast<time_t>(due / 1000000000ull);
+            ts.tv_nsec = static_cast<long>(due % 1000000000ull);
+            ::nanosleep(&ts, nullptr);
+        }
+        return true;
+    }
+
+    // True once every complete record has been read.
+    bool done() const {
+        uint64_t tNs = 0;
+        size_t length = 0;
+        return !peek(tNs, length);
+    }
+
+    /**
+     * @brief Continue from the first record at or after @p tNs (ns since the
+     *        recording started), using the index when there is one.
+     * @return false if no record is that late (the position is then the end).
+     */
+    bool seek(uint64_t tNs) {
+        if (!map_) return false;
+        pos_ = indexedOffset(tNs);
+        paced_ = false;
+        uint64_t t = 0;
+        size_t length = 0;
+        while (peek(t, length) && t < tNs) pos_ += FrameLog::recordSize(length);
+        return peek(t, length);
+    }
+
+    void rewind() { (void)seek(0); }
+
+    // Timestamp of the next record (ns since the recording started), or of none: 0.
+    uint64_t nextTimeNs() const {
+        uint64_t tNs = 0;
+        size_t length = 0;
+        return peek(tNs, length) ? tNs : 0;
+    }
+
+    // Wall-clock time the recording started, ns since the Unix epoch.
+    uint64_t startTimeNs() const { return map_ ? read_u64_be(map_ + 8) : 0; }
+
+    // Records handed out by readDatagram() since open().
+    uint64_t recordsRead() const { return read_; }
+
+    // Log bytes not read yet.
+    uint64_t remaining() const { return map_ && pos_ < size_ ? size_ - pos_ : 0; }
+
+private:
+    // Copying would unmap the same pages twice.
+    Replayer(const Replayer&);
+    Replayer& operator=(const Replayer&);
+
+    static bool mapFile(const char* path, uint8_t*& map, size_t& size) {
+        const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat st;
+        void* p = MAP_FAILED;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        map = static_cast<uint8_t*>(p);
+        size = static_cast<size_t>(st.st_size);
+        return true;
+    }
+
+    static void unmap(uint8_t*& map, size_t& size) {
+        if (map) ::munmap(map, size);
+        map = nullptr;
+        size = 0;
+    }
+
+    // Header of the record at pos_; false at the end or on a torn last record.
+    bool peek(uint64_t& tNs, size_t& length) const {
+        if (!map_ || pos_ > size_ || size_ - pos_ < FrameLog::kRecordHeaderSize) return false;
+        tNs = read_u64_be(map_ + pos_);
+        length = read_u32_be(map_ + pos_ + 8);
+        return length <= size_ - pos_ - FrameLog::kRecordHeaderSize;
+    }
+
+    // Nanoseconds until a record stamped @p tNs may be read (0: now).
+    uint64_t dueInNs(uint64_t tNs) {
+        if (speed_ == 0.0) return 0;
+        const uint64_t now = detail::clockNs(CLOCK_MONOTONIC);
+        if (!paced_) {
+            baseLogNs_ = tNs;
+            baseClockNs_ = now;
+            paced_ = true;
+        }
+        const uint64_t due = baseClockNs_ + static_cast<uint64_t>(static_cast<double>(tNs - baseLogNs_) / speed_);
+        return due > now ? due - now : 0;
+    }
+
+    // Offset of the last indexed record stamped before @p tNs (the first record
+    // without a usable index). Records sharing a timestamp stay reachable.
+    size_t indexedOffset(uint64_t tNs) const {
+        size_t best = FrameLog::kHeaderSize;
+        if (!index_) return best;
+        size_t lo = 0;
+        size_t hi = (indexSize_ - FrameLog::kIndexHeaderSize) / FrameLog::kIndexEntrySize;
+        while (lo < hi) {
+            const size_t mid = lo + (hi - lo) / 2;
+            const uint8_t* e = index_ + FrameLog::kIndexHeaderSize + mid * FrameLog::kIndexEntrySize;
+            if (read_u64_be(e) >= tNs) {
+                hi = mid;
+                continue;
+            }
+            const uint64_t offset = read_u64_be(e + 8);
+            if (offset >= FrameLog::kHeaderSize && offset < size_ && offset % 8u == 0) best = static_cast<size_t>(offset);
+            lo = mid + 1;
+        }
+        return best;
+    }
+
+    uint8_t* map_;
+    size_t size_;
+    uint8_t* index_;
+    size_t indexSize_;
+    size_t pos_; // offset of the next record
+    uint64_t read_;
+    double speed_;
+    bool paced_;
+    uint64_t baseLogNs_;   // pacing starts at this record time ...
+    uint64_t baseClockNs_; // ... at this CLOCK_MONOTONIC time
+};
+
+} // namespace posix
+} // namespace umsg
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <sys/uio.h>
+#include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../../common.hpp"
+
+namespace umsg {
+namespace posix {
+namespace detail {
+
+// iovecs handed to one writev()/sendmsg() call; longer lists are sent in rounds.
+static const size_t kMaxIov = 16;
+
+// Block until @p fd accepts more data (instead of busy-spinning on EAGAIN).
+inline bool waitWritable(int fd) {
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLOUT;
+    int pr;
+    do {
+        pr = ::poll(&pfd, 1, -1);
+    } while (pr < 0 && errno == EINTR);
+    return pr >= 0;
+}
+
+// write() all of @p data to a stream fd, retrying EINTR and waiting on EAGAIN.
+inline bool writeAll(int fd, const uint8_t* data, size_t length) {
+    size_t total = 0;
+    while (total < length) {
+        ssize_t n = ::write(fd, data + total, length - total);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if ((errno == EAGAIN || errno == EWOULDBLOCK) && waitWritable(fd)) continue;
+            return false;
+        }
+        total += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// writev() the concatenation of @p parts to a stream fd; partial writes resume
+// mid-part, so the byte stream is exactly what one write() per part would send.
+inline bool writeAllV(int fd, const ByteSpan* parts, size_t count) {
+    size_t part = 0;
+    size_t offset = 0; // bytes of parts[part] already written
+    while (part < count) {
+        struct iovec iov[kMaxIov];
+        size_t n = 0;
+        for (size_t i = part; i < count && n < kMaxIov; ++i) {
+            const size_t skip = (i == part) ? offset : 0;
+            if (parts[i].length == skip) continue;
+            iov[n].iov_base = const_cast<uint8_t*>(parts[i].data + skip);
+            iov[n].iov_len = parts[i].length - skip;
+            ++n;
+        }
+        if (n == 0) return true;
+
+        ssize_t w = ::writev(fd, iov, static_cast<int>(n));
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            if ((errno == EAGAIN || errno == EWOULDBLOCK) && waitWritable(fd)) continue;
+            return false;
+        }
+
+        size_t done = static_cast<size_t>(w);
+        while (part < count && done >= parts[part].length - offset) {
+            done -= parts[part].length - offset;
+            offset = 0;
+            ++part;
+        }
+        offset += done;
+    }
+    return true;
+}
+
+} // namespace detail
+} // namespace posix
+} // namespace umsg
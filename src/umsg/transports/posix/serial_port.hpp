@@ -5,9 +5,12 @@
 #include <termios.h>
 #include <unistd.h>
 #include <errno.h>
+#include <string.h>
 #include <stddef.h>
 #include <stdint.h>
 
+#include "io.hpp"
+
 namespace umsg {
 namespace posix {
 
@@ -53,8 +56,10 @@ public:
         // Local line, read enabled
         options.c_cflag |= (CLOCAL | CREAD);
 
-        // Raw input/output
-        options.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
+        // Raw input/output. Frames are binary: no CR/NL translation, XON/XOFF,
+        // parity marking or 8th-bit stripping on input.
+        options.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON | IXOFF | IXANY);
+        options.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG | IEXTEN);
         options.c_oflag &= ~OPOST;
 
         if (::tcsetattr(fd_, TCSANOW, &options) < 0) {
@@ -78,6 +83,10 @@ public:
 
     bool isOpen() const { return fd_ >= 0; }
 
+    // File descriptor for an external event loop (epoll/kqueue/poll), -1 when
+    // closed. Wait for readability, then drain with Node::onReadable().
+    int nativeHandle() const { return fd_; }
+
     bool read(uint8_t& byte) {
         if (fd_ < 0) return false;
 
@@ -101,33 +110,51 @@ public:
         return true;
     }
 
-    bool write(const uint8_t* data, size_t length) {
-        if (fd_ < 0) return false;
+    // Bulk read (see umsg/transport.hpp): serve buffered bytes first; when the
+    // buffer is empty, large requests bypass it and read straight into @p data.
+    bool read(uint8_t* data, size_t capacity, size_t& length) {
+        length = 0;
+        if (fd_ < 0 || !data || capacity == 0) return false;
 
-        size_t total = 0;
-        while (total < length) {
-            ssize_t n = ::write(fd_, data + total, length - total);
-            if (n < 0) {
-                if (errno == EINTR) continue;
-                if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                    // Wait until the tty accepts more data instead of busy-spinning.
-                    struct pollfd pfd;
-                    pfd.fd = fd_;
-                    pfd.events = POLLOUT;
-                    int pr;
-                    do {
-                        pr = ::poll(&pfd, 1, -1);
-                    } while (pr < 0 && errno == EINTR);
-                    if (pr < 0) return false;
-                    continue;
-                }
+        if (bufIdx_ >= bufLen_) {
+            uint8_t* dst = (capacity >= sizeof(rxBuffer_)) ? data : rxBuffer_;
+            const size_t cap = (dst == data) ? capacity : sizeof(rxBuffer_);
+
+            ssize_t n;
+            do {
+                n = ::read(fd_, dst, cap);
+            } while (n < 0 && errno == EINTR);
+
+            if (n <= 0) {
                 return false;
             }
-            total += static_cast<size_t>(n);
+            if (dst == data) {
+                length = static_cast<size_t>(n);
+                return true;
+            }
+            bufLen_ = static_cast<size_t>(n);
+            bufIdx_ = 0;
         }
+
+        size_t avail = bufLen_ - bufIdx_;
+        length = (avail < capacity) ? avail : capacity;
+        ::memcpy(data, &rxBuffer_[bufIdx_], length);
+        bufIdx_ += length;
         return true;
     }
 
+    bool write(const uint8_t* data, size_t length) {
+        if (fd_ < 0) return false;
+        return detail::writeAll(fd_, data, length);
+    }
+
+    // Gather write (see umsg/transport.hpp): all @p parts in order with writev(),
+    // one syscall per up to 16 parts instead of one per part.
+    bool write(const ByteSpan* parts, size_t count) {
+        if (fd_ < 0) return false;
+        return detail::writeAllV(fd_, parts, count);
+    }
+
 private:
     int fd_;
 
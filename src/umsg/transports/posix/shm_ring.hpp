@@ -0,0 +1,380 @@
+#pragma once
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <atomic>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "../../common.hpp"
+#include "../../datagram.hpp"
+#include "../../packet.hpp"
+
+namespace umsg {
+namespace posix {
+
+namespace detail {
+
+#if defined(__linux__)
+// Shared (not FUTEX_PRIVATE) futex ops: waiters and waker are in different processes.
+inline void futexWait(std::atomic<uint32_t>* word, uint32_t expected, int timeoutMs) {
+    struct timespec ts;
+    ts.tv_sec = timeoutMs / 1000;
+    ts.tv_nsec = static_cast<long>(timeoutMs % 1000) * 1000000L;
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, timeoutMs < 0 ? nullptr : &ts,
+              nullptr, 0);
+}
+
+inline void futexWakeAll(std::atomic<uint32_t>* word) {
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+#endif
+
+inline bool processAlive(int32_t pid) { return ::kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM; }
+
+} // namespace detail
+
+/**
+ * @brief Same-host IPC transport: a POSIX shared-memory ring (`shm_open` + `mmap`)
+ *        of datagram slots, one writer process, up to @p MaxReaders reader processes.
+ *
+ * Each slot holds one datagram-framed packet (`frame || crc32`, see `datagram.hpp`),
+ * so both ends are `DatagramNode`s. There are no syscalls, kernel copies or COBS
+ * per message:
+ * - writer: `create(name)`, then `publish()` (encodes straight into the next slot)
+ *   or `Node::publish()` (one copy from the node's packet buffer, via `write()`);
+ * - readers: `attach(name)`, then `DatagramNode::poll()`. `readDatagram()` hands out
+ *   views into the mapped slots, so handlers run on the shared memory itself;
+ *   `wait()` blocks on a futex until the writer publishes.
+ *
+ * Every reader sees every message (broadcast). The writer never overwrites a slot
+ * an attached reader has not consumed: when the slowest reader is `Slots` behind,
+ * `write()` fails and `publish()` returns `QueueFull`. Cursors of readers whose
+ * process has died are reclaimed then. A reader attaching late starts at the
+ * newest message.
+ *
+ * For two-way traffic use two rings. Lock-free; `wait()` uses a futex on Linux and
+ * sleeps in short steps elsewhere.
+ *
+ * @tparam Slots Ring size in messages; a power of two.
+ * @tparam SlotSize Largest datagram, i.e. `maxDatagramSize(MaxPayloadSize)` of the nodes.
+ * @tparam MaxReaders Reader processes that can be attached at once.
+ */
+template <size_t Slots, size_t SlotSize, size_t MaxReaders = 8>
+class ShmRing {
+    static_assert(Slots >= 2 && (Slots & (Slots - 1)) == 0, "Slots must be a power of two (>= 2)");
+    static_assert(Slots <= (1u << 30), "Slots must leave room for 32-bit positions to wrap");
+    static_assert(SlotSize >= kFrameHeaderSize + 4, "SlotSize must hold an empty frame and its CRC");
+    static_assert(MaxReaders >= 1, "MaxReaders must be at least 1");
+
+public:
+    static const size_t kSlots = Slots;
+    static const size_t kSlotSize = SlotSize;
+    static const size_t kMaxPayloadSize = SlotSize - kFrameHeaderSize - 4;
+
+    ShmRing() : map_(nullptr), cursor_(nullptr), pos_(0), held_(false), room_(0), writer_(false) { name_[0] = 0; }
+
+    ~ShmRing() { close(); }
+
+    /**
+     * @brief Writer: create (or replace) the ring named @p name (e.g. `"/robot_state"`).
+     *
+     * An existing object of that name is unlinked first; readers still mapping it
+     * keep the old ring and see `writerAlive()` turn false.
+     */
+    bool create(const char* name, mode_t mode = 0600) {
+        close();
+        if (!setName(name)) return false;
+        ::shm_unlink(name_);
+        const int fd = ::shm_open(name_, O_CREAT | O_EXCL | O_RDWR, mode);
+        if (fd < 0) return false;
+        if (::ftruncate(fd, static_cast<off_t>(sizeof(Layout))) != 0 || !map(fd)) {
+            ::close(fd);
+            ::shm_unlink(name_);
+            return false;
+        }
+        ::close(fd);
+        // ftruncate() zero-fills: every cursor is free and head_ is 0.
+        Header& h = map_->header;
+        h.slots = static_cast<uint32_t>(Slots);
+        h.slotSize = static_cast<uint32_t>(SlotSize);
+        h.maxReaders = static_cast<uint32_t>(MaxReaders);
+        h.writerPid = static_cast<int32_t>(::getpid());
+        h.magic.store(kMagic, std::memory_order_release);
+        writer_ = true;
+        room_ = Slots;
+        return true;
+    }
+
+    /**
+     * @brief Reader: map the ring named @p name and claim a cursor.
+     * @return false if it does not exist, was created with other template
+     *         arguments, or already has `MaxReaders` readers.
+     */
+    bool attach(const char* name) {
+        close();
+        if (!setName(name)) return false;
+        const int fd = ::shm_open(name_, O_RDWR, 0);
+        if (fd < 0) return false;
+        struct stat st;
+        const bool ok = ::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == sizeof(Layout) && map(fd);
+        ::close(fd);
+        if (!ok || !compatible() || !claimCursor()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // Writer: unmap and unlink the name. Reader: release the cursor and unmap.
+    void close() {
+        if (!map_) return;
+        if (cursor_) cursor_->pid.store(0, std::memory_order_release);
+        if (writer_) ::shm_unlink(name_);
+        ::munmap(map_, sizeof(Layout));
+        map_ = nullptr;
+        cursor_ = nullptr;
+        held_ = false;
+        writer_ = false;
+    }
+
+    bool isOpen() const { return map_ != nullptr; }
+
+    // --- Writer ---
+
+    /**
+     * @brief Zero-copy publish, part 1: the next free slot (`kSlotSize` bytes), or
+     *        null when the ring is full. Fill it, then `commit()`.
+     */
+    uint8_t* reserve() {
+        if (!writer_ || !hasRoom()) return nullptr;
+        return map_->slots[map_->header.head.load(std::memory_order_relaxed) & kMask].data;
+    }
+
+    // Zero-copy publish, part 2: make the reserved slot's @p length bytes visible.
+    bool commit(size_t length) {
+        if (!writer_ || length > SlotSize || !hasRoom()) return false;
+        Header& h = map_->header;
+        const uint32_t head = h.head.load(std::memory_order_relaxed);
+        map_->slots[head & kMask].length = static_cast<uint32_t>(length);
+        --room_;
+        h.head.store(head + 1, std::memory_order_seq_cst);
+#if defined(__linux__)
+        if (h.waiters.load(std::memory_order_seq_cst) != 0) detail::futexWakeAll(&h.head);
+#endif
+        return true;
+    }
+
+    // Transport write: copy one datagram into the next slot; false when full.
+    bool write(const uint8_t* data, size_t length) {
+        uint8_t* slot = length <= SlotSize ? reserve() : nullptr;
+        if (!slot) return false;
+        ::memcpy(slot, data, length);
+        return commit(length);
+    }
+
+    /**
+     * @brief Encode a frame straight into the next slot (no intermediate buffer).
+     * @return `QueueFull` when the slowest reader is a whole ring behind,
+     *         `InvalidArgument` for a payload over `kMaxPayloadSize`.
+     */
+    Error publish(uint8_t msgId, uint32_t msgHash, ByteSpan payload, uint8_t version = 1) {
+        uint8_t* out = reserve();
+        if (!out) return writer_ ? Error::QueueFull : Error::InvalidArgument;
+        size_t length = 0;
+        const Error err = Builder::raw(version, msgId, msgHash, payload, out, length);
+        return err == Error::OK ? (commit(length) ? Error::OK : Error::TransportError) : err;
+    }
+
+    // Typed publish (same Msg requirements as Node::publish).
+    template <class Msg>
+    Error publish(uint8_t msgId, const Msg& msg, uint8_t version = 1) {
+        uint8_t* out = reserve();
+        if (!out) return writer_ ? Error::QueueFull : Error::InvalidArgument;
+        size_t length = 0;
+        const Error err = Builder::typed(version, msgId, msg, out, out + Builder::kPayloadStageOffset, length);
+        return err == Error::OK ? (commit(length) ? Error::OK : Error::TransportError) : err;
+    }
+
+    // Attached readers (including ones that died and are not reclaimed yet).
+    size_t readers() const {
+        if (!map_) return 0;
+        size_t n = 0;
+        for (size_t i = 0; i < MaxReaders; ++i) n += map_->readers[i].pid.load(std::memory_order_relaxed) != 0;
+        return n;
+    }
+
+    // --- Reader ---
+
+    /**
+     * @brief Datagram receive (see umsg/transport.hpp): a view of the next slot in
+     *        the shared mapping, valid until the next call (the slot is released then).
+     */
+    bool readDatagram(ByteSpan& datagram) {
+        if (!cursor_) return false;
+        release();
+        if (map_->header.head.load(std::memory_order_acquire) == pos_) return false;
+        Slot& s = map_->slots[pos_ & kMask];
+        datagram.data = s.data;
+        datagram.length = s.length <= SlotSize ? s.length : 0;
+        ++pos_;
+        held_ = true;
+        return true;
+    }
+
+    // Reader: messages published and not yet read.
+    size_t available() const {
+        return cursor_ ? static_cast<uint32_t>(map_->header.head.load(std::memory_order_acquire) - pos_) : 0;
+    }
+
+    /**
+     * @brief Reader: block until a message is available or @p timeoutMs elapses
+     *        (-1: no timeout). Also releases the slot held by the last read.
+     * @return true if a message is available.
+     */
+    bool wait(int timeoutMs) {
+        if (!cursor_) return false;
+        release();
+        Header& h = map_->header;
+        if (h.head.load(std::memory_order_acquire) != pos_) return true;
+#if defined(__linux__)
+        h.waiters.fetch_add(1, std::memory_order_seq_cst);
+        if (h.head.load(std::memory_order_seq_cst) == pos_) detail::futexWait(&h.head, pos_, timeoutMs);
+        h.waiters.fetch_sub(1, std::memory_order_seq_cst);
+#else
+        for (int waited = 0; h.head.load(std::memory_order_acquire) == pos_; waited += 1) {
+            if (timeoutMs >= 0 && waited >= timeoutMs * 10) break;
+            struct timespec ts = {0, 100000}; // 100 us
+            ::nanosleep(&ts, nullptr);
+        }
+#endif
+        return h.head.load(std::memory_order_acquire) != pos_;
+    }
+
+    // Reader: false once the writer process has exited (re-attach after it restarts).
+    bool writerAlive() const { return map_ && detail::processAlive(map_->header.writerPid); }
+
+private:
+    static const uint32_t kMagic = 0x756D5352; // "umSR"
+    static const uint32_t kMask = static_cast<uint32_t>(Slots - 1);
+
+    typedef umsg::detail::PacketBuilder<kMaxPayloadSize, DatagramFraming> Builder;
+    static_assert(Builder::kMaxPacketSize == SlotSize, "a slot holds exactly one largest datagram");
+    static_assert(ATOMIC_INT_LOCK_FREE == 2, "shared-memory atomics must be lock-free");
+
+    struct Header {
+        std::atomic<uint32_t> magic; // set last by create()
+        uint32_t slots;
+        uint32_t slotSize;
+        uint32_t maxReaders;
+        int32_t writerPid;
+        alignas(64) std::atomic<uint32_t> head; // messages published; futex word
+        std::atomic<uint32_t> waiters;          // readers inside wait()
+    };
+
+    struct alignas(64) Cursor {
+        std::atomic<uint32_t> tail; // messages this reader has released
+        std::atomic<int32_t> pid;   // owning process, 0 when free
+    };
+
+    struct alignas(64) Slot {
+        uint32_t length;
+        uint8_t pad[4];
+        uint8_t data[SlotSize];
+    };
+
+    struct Layout {
+        Header header;
+        Cursor readers[MaxReaders];
+        Slot slots[Slots];
+    };
+
+    bool setName(const char* name) {
+        const size_t n = name ? ::strlen(name) : 0;
+        if (n == 0 || n >= sizeof(name_)) return false;
+        ::memcpy(name_, name, n + 1);
+        return true;
+    }
+
+    bool map(int fd) {
+        void* p = ::mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) return false;
+        map_ = static_cast<Layout*>(p);
+        return true;
+    }
+
+    bool compatible() const {
+        const Header& h = map_->header;
+        return h.magic.load(std::memory_order_acquire) == kMagic && h.slots == Slots && h.slotSize == SlotSize &&
+               h.maxReaders == MaxReaders;
+    }
+
+    bool claimCursor() {
+        const int32_t self = static_cast<int32_t>(::getpid());
+        for (size_t i = 0; i < MaxReaders; ++i) {
+            Cursor& c = map_->readers[i];
+            int32_t expected = 0;
+            if (!c.pid.compare_exchange_strong(expected, self, std::memory_order_acq_rel)) continue;
+            // Until tail is set the writer may see a stale one: that only makes it
+            // pessimistic about free slots, never overwrite unread ones.
+            pos_ = map_->header.head.load(std::memory_order_acquire);
+            c.tail.store(pos_, std::memory_order_release);
+            cursor_ = &c;
+            return true;
+        }
+        return false;
+    }
+
+    void release() {
+        if (held_) {
+            cursor_->tail.store(pos_, std::memory_order_release);
+            held_ = false;
+        }
+    }
+
+    // Writer: room_ is a lower bound on free slots; rescan the cursors when it runs out.
+    bool hasRoom() {
+        if (room_ > 0) return true;
+        const uint32_t head = map_->header.head.load(std::memory_order_relaxed);
+        uint32_t lag = 0;
+        for (size_t i = 0; i < MaxReaders; ++i) {
+            Cursor& c = map_->readers[i];
+            const int32_t pid = c.pid.load(std::memory_order_acquire);
+            if (pid == 0) continue;
+            const uint32_t behind = head - c.tail.load(std::memory_order_acquire);
+            if (behind >= Slots && !detail::processAlive(pid)) {
+                int32_t expected = pid; // reader died without close(): reclaim its cursor
+                c.pid.compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+                continue;
+            }
+            if (behind > lag) lag = behind;
+        }
+        room_ = lag < Slots ? Slots - lag : 0;
+        return room_ > 0;
+    }
+
+    Layout* map_;
+    Cursor* cursor_;  // reader only
+    uint32_t pos_;    // reader: next message to read
+    bool held_;       // reader: slot pos_ - 1 handed out by readDatagram(), not yet released
+    size_t room_;     // writer
+    bool writer_;
+    char name_[256];
+};
+
+} // namespace posix
+} // namespace umsg
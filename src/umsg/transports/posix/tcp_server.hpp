@@ -0,0 +1,471 @@
+#pragma once
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../../dispatcher.hpp"
+#include "../../framer.hpp"
+#include "../../packet.hpp"
+#include "../../protocol.hpp"
+
+namespace umsg {
+namespace posix {
+
+/**
+ * @brief Multi-peer TCP server (Linux, epoll): accepts many clients on one
+ *        non-blocking listener and serves them all from one thread.
+ *
+ * Every connection has its own `Framer` (packet reassembly state,
+ * `maxPacketSize(MaxPayloadSize)` bytes). Reads go into one shared buffer that is
+ * fed straight to the connection's framer, and all frames are dispatched into one
+ * shared handler table. While a handler runs, `currentConnection()` is the id of
+ * the connection the frame arrived on, so it can answer with `publishTo()`.
+ *
+ * Connection ids are slot indices in `[0, MaxConnections)`; a slot is reused after
+ * its connection closes. Clients beyond `MaxConnections` are accepted and closed.
+ *
+ * Writes never block. Bytes a peer's socket does not take right away wait in
+ * that connection's TX queue (`TxQueueSize` bytes) and go out from `poll()` on
+ * `EPOLLOUT`. A peer that stops reading fills its queue and is disconnected on
+ * the next write that does not fit, so one stalled client cannot hold up the
+ * others. A failed write closes that connection too. Writes use `MSG_NOSIGNAL`:
+ * a peer that went away does not raise `SIGPIPE`.
+ *
+ * When the process runs out of fds (`EMFILE`/`ENFILE`), pending clients are
+ * accepted on a reserved fd and closed, and the listener is paused if even that
+ * fails, instead of spinning on a listener that stays readable.
+ *
+ * @tparam MaxPayloadSize Maximum payload size for frames built/accepted.
+ * @tparam MaxConnections Number of connection slots.
+ * @tparam DispatcherT Handler table, as for `BasicNode`.
+ * @tparam TxQueueSize Per-connection TX queue in bytes (at least one packet).
+ */
+template <size_t MaxPayloadSize, size_t MaxConnections, class DispatcherT,
+          size_t TxQueueSize = 4 * umsg::maxPacketSize(MaxPayloadSize)>
+class BasicTcpServer {
+    static_assert(TxQueueSize >= umsg::maxPacketSize(MaxPayloadSize),
+                  "TxQueueSize must hold one full packet");
+
+public:
+    static const size_t kMaxPacketSize = umsg::maxPacketSize(MaxPayloadSize);
+    static const int kNoConnection = -1;
+
+    typedef umsg::Framer<kMaxPacketSize> FramerType;
+    typedef DispatcherT DispatcherType;
+
+    explicit BasicTcpServer(uint8_t expectedVersion = 1)
+        : listenFd_(-1), epollFd_(-1), reserveFd_(-1), listenerPaused_(false),
+          expectedVersion_(expectedVersion), current_(kNoConnection), connections_(0) {
+        for (size_t i = 0; i < MaxConnections; ++i) {
+            conns_[i].fd = -1;
+        }
+    }
+
+    ~BasicTcpServer() {
+        close();
+    }
+
+    // Listen on all interfaces.
+    bool listen(uint16_t port, int backlog = 128) {
+        if (listenFd_ >= 0) close();
+
+        epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd_ < 0) return false;
+
+        listenFd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd_ < 0) {
+            close();
+            return false;
+        }
+        int one = 1;
+        ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        struct sockaddr_in addr;
+        ::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(port);
+
+        if (::bind(listenFd_, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+            ::listen(listenFd_, backlog) < 0 || !watch(listenFd_, kListenerTag)) {
+            close();
+            return false;
+        }
+        reserveFd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+        listenerPaused_ = false;
+        return true;
+    }
+
+    // Close every connection and the listener.
+    void close() {
+        for (size_t i = 0; i < MaxConnections; ++i) {
+            disconnect(static_cast<int>(i));
+        }
+        if (listenFd_ >= 0) {
+            ::close(listenFd_);
+            listenFd_ = -1;
+        }
+        if (epollFd_ >= 0) {
+            ::close(epollFd_);
+            epollFd_ = -1;
+        }
+        if (reserveFd_ >= 0) {
+            ::close(reserveFd_);
+            reserveFd_ = -1;
+        }
+    }
+
+    bool isOpen() const { return listenFd_ >= 0; }
+
+    // Local port (useful after listen(0)); 0 when not listening.
+    uint16_t port() const {
+        struct sockaddr_in addr;
+        socklen_t len = sizeof(addr);
+        if (listenFd_ < 0 || ::getsockname(listenFd_, (struct sockaddr *)&addr, &len) < 0) return 0;
+        return ntohs(addr.sin_port);
+    }
+
+    // The epoll fd: readable whenever poll() has work, so the server can sit
+    // inside an outer event loop.
+    int nativeHandle() const { return epollFd_; }
+
+    DispatcherType &dispatcher() { return dispatcher_; }
+
+    // Subscribe a raw handler to @p msgId (`Dispatcher` only).
+    template <class T>
+    Error subscribe(uint8_t msgId, T *obj,
+                    Error (T::*method)(ByteSpan payload, uint32_t msgHash)) {
+        return dispatcher_.registerHandler(msgId, obj, method);
+    }
+
+    // Subscribe a typed handler to @p msgId (`Dispatcher` only).
+    template <class T, class Msg>
+    Error subscribe(uint8_t msgId, T *obj, Error (T::*method)(const Msg &msg)) {
+        return dispatcher_.registerHandler(msgId, obj, method);
+    }
+
+    /**
+     * @brief Wait up to @p timeoutMs (-1: forever, 0: don't wait) for activity,
+     *        then accept new clients and dispatch every complete frame received.
+     *
+     * Framing and protocol errors are discarded per frame, as in `Node::poll()`.
+     * A connection closed by its peer (or failing a read) is released. Queued
+     * TX bytes are written to every peer that became writable.
+     *
+     * @return Number of bytes read from all connections.
+     */
+    size_t poll(int timeoutMs = 0) {
+        if (epollFd_ < 0) return 0;
+        if (listenerPaused_) resumeListener();
+
+        struct epoll_event events[kMaxEvents];
+        int n;
+        do {
+            n = ::epoll_wait(epollFd_, events, kMaxEvents, timeoutMs);
+        } while (n < 0 && errno == EINTR);
+
+        size_t bytes = 0;
+        for (int i = 0; i < n; ++i) {
+            const uint64_t tag = events[i].data.u64;
+            if (tag == kListenerTag) {
+                acceptAll();
+                continue;
+            }
+            const int id = static_cast<int>(tag);
+            if ((events[i].events & EPOLLOUT) && isConnected(id)) flushTx(id);
+            if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) bytes += drain(id);
+        }
+        return bytes;
+    }
+
+    // Id of the connection whose frame is being dispatched, or kNoConnection
+    // outside a handler.
+    int currentConnection() const { return current_; }
+
+    bool isConnected(int id) const {
+        return id >= 0 && static_cast<size_t>(id) < MaxConnections && conns_[id].fd >= 0;
+    }
+
+    size_t connectionCount() const { return connections_; }
+
+    // Peer socket of connection @p id (-1 if not connected).
+    int connectionHandle(int id) const { return isConnected(id) ? conns_[id].fd : -1; }
+
+    // Bytes queued for connection @p id, waiting for its socket to drain.
+    size_t pending(int id) const {
+        return isConnected(id) ? conns_[id].txTail - conns_[id].txHead : 0;
+    }
+
+    // Close connection @p id (no-op if not connected); its queued bytes are
+    // discarded. Safe from a handler.
+    void disconnect(int id) {
+        if (!isConnected(id)) return;
+        Connection &c = conns_[id];
+        if (epollFd_ >= 0) ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, c.fd, NULL);
+        ::close(c.fd);
+        c.fd = -1;
+        --connections_;
+    }
+
+    /** @brief Send a raw payload to connection @p id. */
+    Error publishTo(int id, uint8_t msgId, uint32_t msgHash, ByteSpan payload) {
+        size_t length = 0;
+        Error err = Builder::raw(expectedVersion_, msgId, msgHash, payload, txPacket_, length);
+        return err == Error::OK ? sendTo(id, length) : err;
+    }
+
+    /** @brief Send a typed message to connection @p id (see `Node::publish`). */
+    template <class Msg>
+    Error publishTo(int id, uint8_t msgId, const Msg &msg) {
+        size_t length = 0;
+        Error err = Builder::typed(expectedVersion_, msgId, msg, txPacket_,
+                                   &txPacket_[Builder::kPayloadStageOffset], length);
+        return err == Error::OK ? sendTo(id, length) : err;
+    }
+
+    /**
+     * @brief Send a raw payload to every connection (encoded once).
+     * @return `TransportError` if any write failed (those connections are closed).
+     */
+    Error publishAll(uint8_t msgId, uint32_t msgHash, ByteSpan payload) {
+        size_t length = 0;
+        Error err = Builder::raw(expectedVersion_, msgId, msgHash, payload, txPacket_, length);
+        return err == Error::OK ? sendAll(length) : err;
+    }
+
+    /** @brief Send a typed message to every connection (encoded once). */
+    template <class Msg>
+    Error publishAll(uint8_t msgId, const Msg &msg) {
+        size_t length = 0;
+        Error err = Builder::typed(expectedVersion_, msgId, msg, txPacket_,
+                                   &txPacket_[Builder::kPayloadStageOffset], length);
+        return err == Error::OK ? sendAll(length) : err;
+    }
+
+private:
+    typedef umsg::detail::PacketBuilder<MaxPayloadSize> Builder;
+
+    static const int kMaxEvents = 64;
+    static const uint64_t kListenerTag = ~static_cast<uint64_t>(0);
+
+    struct Connection {
+        int fd;
+        bool writing; // EPOLLOUT armed: the TX queue is not empty
+        size_t txHead; // free-running byte positions in tx
+        size_t txTail;
+        FramerType framer;
+        uint8_t tx[TxQueueSize];
+    };
+
+    bool watch(int fd, uint64_t tag, int op = EPOLL_CTL_ADD, uint32_t events = EPOLLIN) {
+        struct epoll_event ev;
+        ::memset(&ev, 0, sizeof(ev));
+        ev.events = events;
+        ev.data.u64 = tag;
+        return ::epoll_ctl(epollFd_, op, fd, &ev) == 0;
+    }
+
+    void acceptAll() {
+        for (;;) {
+            int fd = ::accept4(listenFd_, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                if ((errno == EMFILE || errno == ENFILE) && shedOne()) continue;
+                return; // EAGAIN: backlog drained (or a transient error)
+            }
+            size_t slot = 0;
+            while (slot < MaxConnections && conns_[slot].fd >= 0) ++slot;
+            if (slot == MaxConnections || !watch(fd, slot)) {
+                ::close(fd);
+                continue;
+            }
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            conns_[slot].fd = fd;
+            conns_[slot].writing = false;
+            conns_[slot].txHead = conns_[slot].txTail = 0;
+            conns_[slot].framer.reset();
+            ++connections_;
+        }
+    }
+
+    // Out of fds: accept the next client on the reserved fd and close it, so
+    // the listener stops being readable. Without a reserve, pause the listener
+    // until poll() can open one again.
+    bool shedOne() {
+        if (reserveFd_ >= 0) {
+            ::close(reserveFd_);
+            const int fd = ::accept4(listenFd_, NULL, NULL, SOCK_CLOEXEC);
+            const int err = errno;
+            if (fd >= 0) ::close(fd);
+            reserveFd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+            if (fd >= 0) return true;
+            if (err == EAGAIN || err == EWOULDBLOCK) return false; // backlog drained
+        }
+        listenerPaused_ = watch(listenFd_, kListenerTag, EPOLL_CTL_MOD, 0);
+        return false;
+    }
+
+    void resumeListener() {
+        if (reserveFd_ < 0) reserveFd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+        if (reserveFd_ >= 0 && watch(listenFd_, kListenerTag, EPOLL_CTL_MOD)) listenerPaused_ = false;
+    }
+
+    // Read connection @p id until EAGAIN, dispatching frames as they complete.
+    size_t drain(int id) {
+        size_t bytes = 0;
+        while (isConnected(id)) {
+            ssize_t n = ::read(conns_[id].fd, rxBuffer_, sizeof(rxBuffer_));
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            if (n <= 0) {
+                disconnect(id); // closed by the peer, or failed
+                break;
+            }
+            bytes += static_cast<size_t>(n);
+
+            current_ = id;
+            ByteSpan in{rxBuffer_, static_cast<size_t>(n)};
+            while (in.length > 0 && isConnected(id)) {
+                size_t used = 0;
+                const typename FramerType::Result r = conns_[id].framer.feed(in, used);
+                in.data += used;
+                in.length -= used;
+                if (r.complete) handleFrame(r.frame);
+            }
+            current_ = kNoConnection;
+        }
+        return bytes;
+    }
+
+    void handleFrame(ByteSpan frame) {
+        protocol::Header h;
+        ByteSpan payload;
+        if (protocol::decodeFrame(frame, h, payload) != Error::OK || h.version != expectedVersion_) {
+            return;
+        }
+        (void)dispatcher_.dispatch(h.msgId, h.msgHash, payload);
+    }
+
+    // Send txPacket_ to connection @p id: straight to the socket when nothing is
+    // queued, the rest (or all of it) into the TX queue.
+    Error sendTo(int id, size_t length) {
+        if (!isConnected(id)) return Error::InvalidArgument;
+        Connection &c = conns_[id];
+        if (c.txTail != c.txHead && !flushTx(id)) return Error::TransportError;
+
+        size_t sent = 0;
+        if (c.txTail == c.txHead) {
+            ssize_t n;
+            do {
+                n = ::send(c.fd, txPacket_, length, MSG_NOSIGNAL);
+            } while (n < 0 && errno == EINTR);
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+                disconnect(id);
+                return Error::TransportError;
+            }
+            if (n > 0) sent = static_cast<size_t>(n);
+            if (sent == length) return Error::OK;
+        }
+        if (TxQueueSize - (c.txTail - c.txHead) < length - sent) {
+            disconnect(id); // the peer stopped reading: its queue is full
+            return Error::TransportError;
+        }
+        const size_t off = c.txTail % TxQueueSize;
+        const size_t first = length - sent < TxQueueSize - off ? length - sent : TxQueueSize - off;
+        ::memcpy(&c.tx[off], txPacket_ + sent, first);
+        ::memcpy(&c.tx[0], txPacket_ + sent + first, length - sent - first);
+        c.txTail += length - sent;
+        if (!c.writing) {
+            if (!watch(c.fd, static_cast<uint64_t>(id), EPOLL_CTL_MOD, EPOLLIN | EPOLLOUT)) {
+                disconnect(id);
+                return Error::TransportError;
+            }
+            c.writing = true;
+        }
+        return Error::OK;
+    }
+
+    // Write queued bytes of connection @p id until its socket would block; stop
+    // watching EPOLLOUT once the queue is empty. A write error disconnects.
+    bool flushTx(int id) {
+        Connection &c = conns_[id];
+        while (c.txTail != c.txHead) {
+            const size_t off = c.txHead % TxQueueSize;
+            const size_t left = c.txTail - c.txHead;
+            struct iovec iov[2];
+            iov[0].iov_base = &c.tx[off];
+            iov[0].iov_len = left < TxQueueSize - off ? left : TxQueueSize - off;
+            iov[1].iov_base = &c.tx[0];
+            iov[1].iov_len = left - iov[0].iov_len;
+
+            struct msghdr msg;
+            ::memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = iov;
+            msg.msg_iovlen = iov[1].iov_len > 0 ? 2 : 1;
+            ssize_t n;
+            do {
+                n = ::sendmsg(c.fd, &msg, MSG_NOSIGNAL);
+            } while (n < 0 && errno == EINTR);
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+            if (n < 0) {
+                disconnect(id);
+                return false;
+            }
+            c.txHead += static_cast<size_t>(n);
+        }
+        c.txHead = c.txTail = 0;
+        if (c.writing) {
+            if (!watch(c.fd, static_cast<uint64_t>(id), EPOLL_CTL_MOD)) {
+                disconnect(id);
+                return false;
+            }
+            c.writing = false;
+        }
+        return true;
+    }
+
+    Error sendAll(size_t length) {
+        Error result = Error::OK;
+        for (size_t i = 0; i < MaxConnections; ++i) {
+            if (isConnected(static_cast<int>(i)) && sendTo(static_cast<int>(i), length) != Error::OK) {
+                result = Error::TransportError;
+            }
+        }
+        return result;
+    }
+
+    int listenFd_;
+    int epollFd_;
+    int reserveFd_; // spare fd, given up to shed clients when out of fds
+    bool listenerPaused_;
+    uint8_t expectedVersion_;
+    int current_;
+    size_t connections_;
+
+    DispatcherType dispatcher_;
+    Connection conns_[MaxConnections];
+
+    uint8_t rxBuffer_[4096]; // shared by all connections; fed straight to their framers
+    uint8_t txPacket_[kMaxPacketSize];
+};
+
+/**
+ * @brief `BasicTcpServer` with a run-time `Dispatcher` of @p MaxHandlers slots.
+ */
+template <size_t MaxPayloadSize, size_t MaxConnections, size_t MaxHandlers,
+          size_t TxQueueSize = 4 * umsg::maxPacketSize(MaxPayloadSize)>
+using TcpServer = BasicTcpServer<MaxPayloadSize, MaxConnections, umsg::Dispatcher<MaxHandlers>, TxQueueSize>;
+
+} // namespace posix
+} // namespace umsg
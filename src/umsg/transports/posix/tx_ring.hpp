@@ -0,0 +1,280 @@
+#pragma once
+
+#include <sys/uio.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "io.hpp"
+#include "../../common.hpp"
+
+namespace umsg {
+namespace posix {
+
+// What TxRing::write() does when a packet does not fit in the ring.
+enum class TxOverflow : uint8_t {
+    Reject,    // write() fails; everything queued stays queued
+    DropOldest // whole queued packets are discarded, oldest first, to make room
+};
+
+/**
+ * @brief Non-blocking TX for a stream transport (`TcpClient`, `SerialPort`):
+ *        writes go out as far as the kernel takes them, the rest waits in a
+ *        fixed ring.
+ *
+ * `write()` never blocks: it sends what the fd accepts right now and copies the
+ * remainder into the ring. Call `flushPending()` when the fd is writable (e.g. on
+ * `EPOLLOUT` while `wantsWrite()`, or once per loop) to push queued bytes out.
+ * A stalled peer therefore costs ring space, not publish latency.
+ *
+ * Queued data is kept per `write()` call (one packet, or one `TxBatch` flush),
+ * so `TxOverflow::DropOldest` discards whole packets and the receiver never sees
+ * a torn one. A packet already partly on the wire is never dropped. Writes of
+ * more than `Capacity - 4` bytes are always rejected (each entry carries a 4-byte
+ * length).
+ *
+ * The ring is emptied on `close()` and when the fd changes (e.g. reconnect).
+ *
+ * @tparam Base Transport with a non-blocking fd behind `nativeHandle()`.
+ * @tparam Capacity Ring size in bytes.
+ * @tparam Policy Overflow policy.
+ */
+template <class Base, size_t Capacity, TxOverflow Policy = TxOverflow::Reject>
+class TxRing : public Base {
+    static_assert(Capacity > 4, "Capacity must exceed the 4-byte entry header");
+
+public:
+    static const size_t kCapacity = Capacity;
+
+    TxRing() : fd_(-1), head_(0), tail_(0), headSent_(0), headLocked_(false), dropped_(0), rejected_(0) {}
+
+    void close() {
+        clear();
+        Base::close();
+    }
+
+    bool write(const uint8_t* data, size_t length) {
+        const ByteSpan part{const_cast<uint8_t*>(data), length};
+        return write(&part, 1);
+    }
+
+    // Gather write (see umsg/transport.hpp); the parts form one ring entry.
+    bool write(const ByteSpan* parts, size_t count) {
+        if (!syncFd()) return false;
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) total += parts[i].length;
+        if (total > Capacity - kEntryHeader) {
+            ++rejected_;
+            return false;
+        }
+        if (total == 0) return true;
+
+        // Anything queued goes first, to keep the byte stream in order.
+        if (used() > 0 && !flushPending()) return false;
+
+        size_t sent = 0;
+        if (used() == 0) {
+            if (!sendNow(parts, count, sent)) return false;
+            if (sent == total) return true;
+        }
+        if (!makeRoom(total + kEntryHeader)) {
+            ++rejected_;
+            return false;
+        }
+        append(parts, count, total);
+        if (sent > 0) {
+            headSent_ = sent; // the ring was empty: this is the head entry
+            headLocked_ = true;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Write queued bytes until the fd would block or the ring is empty.
+     * @return false on a write error (the ring is kept; `close()` to discard it).
+     */
+    bool flushPending() {
+        if (!syncFd()) return false;
+        while (used() > 0) {
+            struct iovec iov[detail::kMaxIov];
+            const int n = gather(iov);
+            ssize_t w;
+            do {
+                w = ::writev(fd_, iov, n);
+            } while (w < 0 && errno == EINTR);
+            if (w < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+            consume(static_cast<size_t>(w));
+        }
+        return true;
+    }
+
+    // True while bytes are queued: watch the fd for writability.
+    bool wantsWrite() const { return used() > 0; }
+
+    // Bytes queued (including entry headers).
+    size_t pending() const { return used(); }
+
+    // Packets discarded by TxOverflow::DropOldest.
+    uint32_t dropped() const { return dropped_; }
+
+    // write() calls refused for lack of room (or larger than the ring).
+    uint32_t rejected() const { return rejected_; }
+
+private:
+    static const size_t kEntryHeader = 4;
+
+    size_t used() const { return tail_ - head_; }
+
+    void clear() {
+        head_ = tail_ = 0;
+        headSent_ = 0;
+        headLocked_ = false;
+    }
+
+    // Forget queued bytes meant for a previous connection.
+    bool syncFd() {
+        const int fd = Base::nativeHandle();
+        if (fd != fd_) {
+            clear();
+            fd_ = fd;
+        }
+        return fd_ >= 0;
+    }
+
+    bool sendNow(const ByteSpan* parts, size_t count, size_t& sent) {
+        struct iovec iov[detail::kMaxIov];
+        size_t n = 0;
+        for (size_t i = 0; i < count && n < detail::kMaxIov; ++i) {
+            if (parts[i].length == 0) continue;
+            iov[n].iov_base = parts[i].data;
+            iov[n].iov_len = parts[i].length;
+            ++n;
+        }
+        sent = 0;
+        if (n == 0) return true;
+        ssize_t w;
+        do {
+            w = ::writev(fd_, iov, static_cast<int>(n));
+        } while (w < 0 && errno == EINTR);
+        if (w < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+        sent = static_cast<size_t>(w);
+        return true;
+    }
+
+    uint8_t& at(size_t pos) { return ring_[pos % Capacity]; }
+
+    uint32_t entryLength(size_t pos) {
+        return static_cast<uint32_t>(at(pos)) << 24 | static_cast<uint32_t>(at(pos + 1)) << 16 |
+               static_cast<uint32_t>(at(pos + 2)) << 8 | at(pos + 3);
+    }
+
+    void setEntryLength(size_t pos, size_t length) {
+        at(pos) = static_cast<uint8_t>(length >> 24);
+        at(pos + 1) = static_cast<uint8_t>(length >> 16);
+        at(pos + 2) = static_cast<uint8_t>(length >> 8);
+        at(pos + 3) = static_cast<uint8_t>(length);
+    }
+
+    void copyIn(size_t pos, const uint8_t* data, size_t length) {
+        const size_t off = pos % Capacity;
+        const size_t first = length < Capacity - off ? length : Capacity - off;
+        ::memcpy(&ring_[off], data, first);
+        ::memcpy(&ring_[0], data + first, length - first);
+    }
+
+    void append(const ByteSpan* parts, size_t count, size_t total) {
+        setEntryLength(tail_, total);
+        size_t pos = tail_ + kEntryHeader;
+        for (size_t i = 0; i < count; ++i) {
+            copyIn(pos, parts[i].data, parts[i].length);
+            pos += parts[i].length;
+        }
+        tail_ = pos;
+    }
+
+    bool makeRoom(size_t need) {
+        if (Capacity - used() >= need) return true;
+        if (Policy != TxOverflow::DropOldest) return false;
+        while (Capacity - used() < need) {
+            const size_t headEnd = head_ + kEntryHeader + entryLength(head_);
+            if (!headLocked_) {
+                head_ = headEnd; // nothing of it sent yet: drop the whole entry
+            } else if (headEnd < tail_) {
+                dropSecond(headEnd);
+            } else {
+                return false; // only the half-sent entry is left
+            }
+            ++dropped_;
+        }
+        return true;
+    }
+
+    // Drop the entry after the half-sent head by moving the head's unsent bytes
+    // forward over it: [H hdr|sent|rest][S hdr|S] -> [H' hdr|rest]. H' stays
+    // locked: its first bytes are on the wire.
+    void dropSecond(size_t second) {
+        const size_t rest = second - (head_ + kEntryHeader + headSent_);
+        const size_t end = second + kEntryHeader + entryLength(second);
+        const size_t newHead = end - rest - kEntryHeader;
+        for (size_t i = rest; i > 0; --i) {
+            at(newHead + kEntryHeader + i - 1) = at(second - rest + i - 1);
+        }
+        setEntryLength(newHead, rest);
+        head_ = newHead;
+        headSent_ = 0;
+    }
+
+    // iovecs for the unsent bytes of the first entries, in order.
+    int gather(struct iovec* iov) {
+        size_t n = 0;
+        size_t pos = head_;
+        size_t skip = headSent_;
+        while (pos < tail_ && n + 2 <= detail::kMaxIov) {
+            const size_t length = entryLength(pos);
+            size_t from = pos + kEntryHeader + skip;
+            size_t left = length - skip;
+            while (left > 0) {
+                const size_t off = from % Capacity;
+                const size_t run = left < Capacity - off ? left : Capacity - off;
+                iov[n].iov_base = &ring_[off];
+                iov[n].iov_len = run;
+                ++n;
+                from += run;
+                left -= run;
+            }
+            pos += kEntryHeader + length;
+            skip = 0;
+        }
+        return static_cast<int>(n);
+    }
+
+    void consume(size_t written) {
+        while (written > 0 && head_ < tail_) {
+            const size_t left = entryLength(head_) - headSent_;
+            if (written < left) {
+                headSent_ += written;
+                headLocked_ = true;
+                return;
+            }
+            written -= left;
+            head_ += kEntryHeader + entryLength(head_);
+            headSent_ = 0;
+            headLocked_ = false;
+        }
+        if (head_ == tail_) clear();
+    }
+
+    int fd_;
+    size_t head_; // free-running byte positions; entry = len(4, BE) || bytes
+    size_t tail_;
+    size_t headSent_;  // bytes of the head entry already written
+    bool headLocked_;  // head entry partly on the wire: never drop it
+    uint32_t dropped_;
+    uint32_t rejected_;
+    uint8_t ring_[Capacity];
+};
+
+} // namespace posix
+} // namespace umsg
@@ -1,11 +1,42 @@
 #pragma once
 
 #include <sys/socket.h>
+#include <netinet/in.h>
 #include <arpa/inet.h>
+#include <net/if.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <string.h>
 #include <errno.h>
+#include <sys/uio.h>
+
+#include "io.hpp"
+
+/**
+ * @brief Datagrams `UdpSocket` receives per syscall. Override before including.
+ *
+ * Above 1, and where `recvmmsg()` is available (Linux), an empty receive buffer
+ * is refilled with up to this many datagrams in one call. Each slot is
+ * `UMSG_POSIX_UDP_DATAGRAM_SIZE` bytes.
+ */
+#ifndef UMSG_POSIX_UDP_RX_BATCH
+#if defined(__linux__)
+#define UMSG_POSIX_UDP_RX_BATCH 8
+#else
+#define UMSG_POSIX_UDP_RX_BATCH 1
+#endif
+#endif
+
+/** @brief Largest datagram `UdpSocket` receives without truncation. */
+#ifndef UMSG_POSIX_UDP_DATAGRAM_SIZE
+#define UMSG_POSIX_UDP_DATAGRAM_SIZE 4096
+#endif
+
+#if defined(__linux__) && defined(MSG_WAITFORONE)
+#define UMSG_POSIX_HAVE_MMSG 1
+#else
+#define UMSG_POSIX_HAVE_MMSG 0
+#endif
 
 namespace umsg {
 namespace posix {
@@ -17,44 +48,165 @@ namespace posix {
  * Note: umsg is a stream protocol (COBS framed), so it technically survives
  * fragmentation, but UDP packet boundaries do not necessarily map 1:1 to umsg frames.
  * However, `read(byte)` interface abstracts that away.
+ *
+ * Datagrams are received in batches of `UMSG_POSIX_UDP_RX_BATCH` with
+ * `recvmmsg()` when available, and served in arrival order, either as bytes or
+ * whole (`readDatagram()`, for `DatagramNode`). On the TX side, `writeGather()`
+ * sends several buffers as one datagram (`sendmsg()`) and `writeDatagrams()`
+ * sends one datagram per buffer with `sendmmsg()`.
+ *
+ * Multi-core ingest: bind several sockets to one port with `reusePort` and give
+ * each its own node and thread. The kernel spreads senders across them
+ * (`SO_REUSEPORT`); each sender's datagrams stay on one socket, in order.
+ * `bind6()` opens a dual-stack socket, and `joinGroup()` subscribes
+ * to IPv4/IPv6 multicast groups.
  */
 class UdpSocket {
 public:
-    UdpSocket() : fd_(-1), bufLen_(0), bufIdx_(0) {}
+    static const size_t kRxBatch = (UMSG_POSIX_HAVE_MMSG && UMSG_POSIX_UDP_RX_BATCH > 1) ? UMSG_POSIX_UDP_RX_BATCH : 1;
+    static const size_t kDatagramSize = UMSG_POSIX_UDP_DATAGRAM_SIZE;
+
+    UdpSocket() : fd_(-1), family_(AF_INET), destLen_(0), rxCount_(0), rxSlot_(0), bufIdx_(0) {}
     
     ~UdpSocket() {
         close();
     }
 
-    // Bind to a local port to receive packets
-    bool bind(uint16_t port) {
-        if (fd_ >= 0) close();
-
-        fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
-        if (fd_ < 0) return false;
-
+    /**
+     * @brief Bind an IPv4 socket to @p port on all interfaces (0: any free port).
+     *
+     * @param reusePort Set `SO_REUSEPORT` (and `SO_REUSEADDR`) first, so that
+     *        other sockets doing the same can bind the same port. Unicast
+     *        datagrams are then spread across them by a hash of the sender's
+     *        address (Linux; other systems pick one socket); see `joinGroup()`
+     *        for multicast.
+     */
+    bool bind(uint16_t port, bool reusePort = false) {
         struct sockaddr_in addr;
         memset(&addr, 0, sizeof(addr));
         addr.sin_family = AF_INET;
         addr.sin_addr.s_addr = htonl(INADDR_ANY);
         addr.sin_port = htons(port);
+        return open(AF_INET, (struct sockaddr*)&addr, sizeof(addr), reusePort);
+    }
 
-        if (::bind(fd_, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
-            close();
-            return false;
-        }
+    // As bind(), on a dual-stack IPv6 socket: IPv4 peers work too (as
+    // ::ffff:a.b.c.d), and both IPv4 and IPv6 groups can be joined.
+    bool bind6(uint16_t port, bool reusePort = false) {
+        struct sockaddr_in6 addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin6_family = AF_INET6;
+        addr.sin6_addr = in6addr_any;
+        addr.sin6_port = htons(port);
+        return open(AF_INET6, (struct sockaddr*)&addr, sizeof(addr), reusePort);
+    }
 
-        makeNonBlocking();
-        return true;
+    // Local port (after bind(0): the one the kernel picked), 0 when closed.
+    uint16_t port() const {
+        struct sockaddr_storage addr;
+        socklen_t len = sizeof(addr);
+        if (fd_ < 0 || ::getsockname(fd_, (struct sockaddr*)&addr, &len) < 0) return 0;
+        return ntohs(addr.ss_family == AF_INET6 ? ((struct sockaddr_in6*)&addr)->sin6_port
+                                                : ((struct sockaddr_in*)&addr)->sin_port);
     }
 
-    // Set a default destination for write()
-    void setDestination(const char* ip, uint16_t port) {
+    /**
+     * @brief Set the destination of write() (unicast or multicast group).
+     *
+     * On a `bind6()` socket, IPv4 addresses are sent as IPv4-mapped IPv6
+     * (call it after `bind6()`).
+     *
+     * @return false if @p ip is not an address of the socket's family.
+     */
+    bool setDestination(const char* ip, uint16_t port) {
+        hasDest_ = false;
         memset(&destAddr_, 0, sizeof(destAddr_));
-        destAddr_.sin_family = AF_INET;
-        destAddr_.sin_port = htons(port);
-        inet_pton(AF_INET, ip, &destAddr_.sin_addr);
+        struct in_addr v4;
+        struct in6_addr v6;
+        if (family_ == AF_INET) {
+            struct sockaddr_in* dest = (struct sockaddr_in*)&destAddr_;
+            if (inet_pton(AF_INET, ip, &dest->sin_addr) != 1) return false;
+            dest->sin_family = AF_INET;
+            dest->sin_port = htons(port);
+            destLen_ = sizeof(*dest);
+        } else {
+            struct sockaddr_in6* dest = (struct sockaddr_in6*)&destAddr_;
+            if (inet_pton(AF_INET, ip, &v4) == 1) {
+                dest->sin6_addr.s6_addr[10] = 0xFF;
+                dest->sin6_addr.s6_addr[11] = 0xFF;
+                memcpy(&dest->sin6_addr.s6_addr[12], &v4, 4);
+            } else if (inet_pton(AF_INET6, ip, &v6) == 1) {
+                dest->sin6_addr = v6;
+            } else {
+                return false;
+            }
+            dest->sin6_family = AF_INET6;
+            dest->sin6_port = htons(port);
+            destLen_ = sizeof(*dest);
+        }
         hasDest_ = true;
+        return true;
+    }
+
+    /**
+     * @brief Receive the datagrams sent to multicast @p group (e.g. `"239.1.2.3"`
+     *        or `"ff15::1234"`) on the bound port.
+     *
+     * IPv6 groups need a `bind6()` socket. Only sockets that joined receive
+     * the group (on Linux too). Several sockets of one host can join the same
+     * group on one port if each is bound with `reusePort`, and each of them
+     * gets every datagram: group traffic is not sharded.
+     *
+     * @param interface Interface name (e.g. `"eth0"`); null: the kernel's choice
+     *        (the route to the group).
+     */
+    bool joinGroup(const char* group, const char* interface = nullptr) {
+        return membership(group, interface, true);
+    }
+
+    bool leaveGroup(const char* group, const char* interface = nullptr) {
+        return membership(group, interface, false);
+    }
+
+    /** @brief Sender: how many routers a multicast datagram may cross (default 1: the local link). */
+    bool setMulticastHops(int hops) {
+        if (fd_ < 0) return false;
+        if (family_ == AF_INET6 &&
+            ::setsockopt(fd_, IPPROTO_IPV6, IPV6_MULTICAST_HOPS, &hops, sizeof(hops)) != 0) {
+            return false;
+        }
+        const unsigned char ttl = static_cast<unsigned char>(hops);
+        return setIpv4Option(IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+    }
+
+    /** @brief Sender: whether this host's own group members get a copy (default on). */
+    bool setMulticastLoopback(bool enabled) {
+        if (fd_ < 0) return false;
+        if (family_ == AF_INET6) {
+            const unsigned int loop6 = enabled ? 1u : 0u;
+            if (::setsockopt(fd_, IPPROTO_IPV6, IPV6_MULTICAST_LOOP, &loop6, sizeof(loop6)) != 0) return false;
+        }
+        const unsigned char loop = enabled ? 1 : 0;
+        return setIpv4Option(IP_MULTICAST_LOOP, &loop, sizeof(loop));
+    }
+
+    /** @brief Sender: send multicast datagrams out of @p interface (name), not the routed one. */
+    bool setMulticastInterface(const char* interface) {
+        if (fd_ < 0) return false;
+        const unsigned int index = ::if_nametoindex(interface);
+        if (index == 0) return false;
+        if (family_ == AF_INET6 &&
+            ::setsockopt(fd_, IPPROTO_IPV6, IPV6_MULTICAST_IF, &index, sizeof(index)) != 0) {
+            return false;
+        }
+#if defined(__linux__)
+        struct ip_mreqn req;
+        memset(&req, 0, sizeof(req));
+        req.imr_ifindex = static_cast<int>(index);
+        return setIpv4Option(IP_MULTICAST_IF, &req, sizeof(req));
+#else
+        return family_ == AF_INET6; // IPv4 needs the interface's address here; use a bind6() socket
+#endif
     }
 
     void close() {
@@ -62,44 +214,206 @@ public:
             ::close(fd_);
             fd_ = -1;
         }
+        rxCount_ = 0;
+        rxSlot_ = 0;
+        bufIdx_ = 0;
     }
 
+    // File descriptor for an external event loop (epoll/kqueue/poll), -1 when
+    // closed. Wait for readability, then drain with Node::onReadable().
+    int nativeHandle() const { return fd_; }
+
     // Buffer incoming datagrams to satisfy the byte-by-byte read interface
     bool read(uint8_t& byte) {
         if (fd_ < 0) return false;
+        if (!buffered() && !receive()) return false;
+        byte = rxBuffer_[rxSlot_][bufIdx_++];
+        return true;
+    }
 
-        // If we have data buffered from the last packet, serve it
-        if (bufIdx_ < bufLen_) {
-            byte = rxBuffer_[bufIdx_++];
-            return true;
-        }
+    // Bulk read (see umsg/transport.hpp): serve the rest of the buffered datagram;
+    // when the buffer is exhausted, receive the next batch (without batching,
+    // straight into @p data when the caller's buffer can hold a whole datagram).
+    bool read(uint8_t* data, size_t capacity, size_t& length) {
+        length = 0;
+        if (fd_ < 0 || !data || capacity == 0) return false;
 
-        // Try to read a new packet
-        struct sockaddr_in sender;
-        socklen_t slen = sizeof(sender);
-        ssize_t len = ::recvfrom(fd_, rxBuffer_, sizeof(rxBuffer_), 0, (struct sockaddr*)&sender, &slen);
-        
-        if (len > 0) {
-            // We got a packet
-            bufLen_ = static_cast<size_t>(len);
-            bufIdx_ = 0;
-            byte = rxBuffer_[bufIdx_++];
-            // Optional: capture sender addr if we want to reply? 
-            // For now, simple fixed dest topology.
-            return true;
+        if (!buffered()) {
+            if (kRxBatch == 1 && capacity >= kDatagramSize) {
+                struct sockaddr_in sender;
+                socklen_t slen = sizeof(sender);
+                ssize_t len = ::recvfrom(fd_, data, capacity, 0, (struct sockaddr*)&sender, &slen);
+                if (len <= 0) return false;
+                length = static_cast<size_t>(len);
+                return true;
+            }
+            if (!receive()) return false;
         }
 
-        return false;
+        size_t avail = rxLength_[rxSlot_] - bufIdx_;
+        length = (avail < capacity) ? avail : capacity;
+        memcpy(data, &rxBuffer_[rxSlot_][bufIdx_], length);
+        bufIdx_ += length;
+        return true;
+    }
+
+    // Datagram receive (see umsg/transport.hpp, DatagramFraming): the rest of the
+    // current datagram (normally all of it) as a view into the receive buffer,
+    // valid until the next read call.
+    bool readDatagram(ByteSpan& datagram) {
+        if (fd_ < 0) return false;
+        if (!buffered() && !receive()) return false;
+        datagram.data = &rxBuffer_[rxSlot_][bufIdx_];
+        datagram.length = rxLength_[rxSlot_] - bufIdx_;
+        bufIdx_ = rxLength_[rxSlot_];
+        return true;
     }
 
     bool write(const uint8_t* data, size_t length) {
         if (fd_ < 0 || !hasDest_) return false;
         
-        ssize_t sent = ::sendto(fd_, data, length, 0, (struct sockaddr*)&destAddr_, sizeof(destAddr_));
+        ssize_t sent = ::sendto(fd_, data, length, 0, (struct sockaddr*)&destAddr_, destLen_);
         return (sent >= 0 && static_cast<size_t>(sent) == length);
     }
 
+    // The concatenation of @p parts as a single datagram (at most 16 parts).
+    // Deliberately not the transport gather write(parts, count): Node would use
+    // it to merge a full TxBatch with the next packet into one oversized datagram.
+    bool writeGather(const ByteSpan* parts, size_t count) {
+        if (fd_ < 0 || !hasDest_ || count > detail::kMaxIov) return false;
+
+        struct iovec iov[detail::kMaxIov];
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            iov[i].iov_base = const_cast<uint8_t*>(parts[i].data);
+            iov[i].iov_len = parts[i].length;
+            total += parts[i].length;
+        }
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_name = &destAddr_;
+        msg.msg_namelen = destLen_;
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+
+        ssize_t sent = ::sendmsg(fd_, &msg, 0);
+        return (sent >= 0 && static_cast<size_t>(sent) == total);
+    }
+
+    /**
+     * @brief Send each of @p datagrams as its own datagram to the destination.
+     *
+     * Uses `sendmmsg()` (up to 16 datagrams per syscall) where available and
+     * `sendto()` per datagram otherwise.
+     *
+     * @param sent Number of datagrams sent, in order, before any failure.
+     * @return true iff all @p count datagrams were sent.
+     */
+    bool writeDatagrams(const ByteSpan* datagrams, size_t count, size_t& sent) {
+        sent = 0;
+        if (fd_ < 0 || !hasDest_) return false;
+#if UMSG_POSIX_HAVE_MMSG
+        while (sent < count) {
+            struct mmsghdr msgs[detail::kMaxIov];
+            struct iovec iov[detail::kMaxIov];
+            const size_t n = (count - sent < detail::kMaxIov) ? count - sent : detail::kMaxIov;
+            memset(msgs, 0, sizeof(msgs));
+            for (size_t i = 0; i < n; ++i) {
+                iov[i].iov_base = const_cast<uint8_t*>(datagrams[sent + i].data);
+                iov[i].iov_len = datagrams[sent + i].length;
+                msgs[i].msg_hdr.msg_name = &destAddr_;
+                msgs[i].msg_hdr.msg_namelen = destLen_;
+                msgs[i].msg_hdr.msg_iov = &iov[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+            int r;
+            do {
+                r = ::sendmmsg(fd_, msgs, static_cast<unsigned int>(n), 0);
+            } while (r < 0 && errno == EINTR);
+            if (r <= 0) return false;
+            for (int i = 0; i < r; ++i) {
+                if (msgs[i].msg_len != datagrams[sent].length) return false;
+                ++sent;
+            }
+        }
+        return true;
+#else
+        for (; sent < count; ++sent) {
+            if (!write(datagrams[sent].data, datagrams[sent].length)) return false;
+        }
+        return true;
+#endif
+    }
+
 private:
+    bool open(int family, const struct sockaddr* addr, socklen_t length, bool reusePort) {
+        if (fd_ >= 0) close();
+
+        fd_ = ::socket(family, SOCK_DGRAM, 0);
+        if (fd_ < 0) return false;
+        if (family != family_) hasDest_ = false; // set it again for the new family
+        family_ = family;
+
+        int one = 1;
+        int zero = 0;
+        if ((reusePort && (::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) < 0 ||
+                           ::setsockopt(fd_, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) < 0)) ||
+            (family == AF_INET6 && ::setsockopt(fd_, IPPROTO_IPV6, IPV6_V6ONLY, &zero, sizeof(zero)) < 0) ||
+            ::bind(fd_, addr, length) < 0) {
+            close();
+            return false;
+        }
+#if defined(__linux__)
+        // Linux delivers a group joined by any socket to every socket on the
+        // port; make membership per socket, as on the BSDs (best effort, 4.20+ for IPv6).
+#if defined(IP_MULTICAST_ALL)
+        (void)::setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_ALL, &zero, sizeof(zero));
+#endif
+#if defined(IPV6_MULTICAST_ALL)
+        if (family == AF_INET6) (void)::setsockopt(fd_, IPPROTO_IPV6, IPV6_MULTICAST_ALL, &zero, sizeof(zero));
+#endif
+#endif
+
+        makeNonBlocking();
+        return true;
+    }
+
+    // IPv4 multicast options. On a dual-stack bind6() socket they govern the
+    // IPv4 groups it sends to (Linux passes IPPROTO_IP through; elsewhere an
+    // IPv6 socket may refuse them, and only the IPv6 option applies).
+    bool setIpv4Option(int name, const void* value, socklen_t length) {
+        if (::setsockopt(fd_, IPPROTO_IP, name, value, length) == 0) return true;
+#if defined(__linux__)
+        return false;
+#else
+        return family_ == AF_INET6;
+#endif
+    }
+
+    // MCAST_JOIN_GROUP (RFC 3678) takes the interface by index for both families.
+    bool membership(const char* group, const char* interface, bool join) {
+        if (fd_ < 0) return false;
+        struct group_req req;
+        memset(&req, 0, sizeof(req));
+        if (interface) {
+            req.gr_interface = ::if_nametoindex(interface);
+            if (req.gr_interface == 0) return false;
+        }
+        int level;
+        struct sockaddr_in* v4 = (struct sockaddr_in*)&req.gr_group;
+        struct sockaddr_in6* v6 = (struct sockaddr_in6*)&req.gr_group;
+        if (inet_pton(AF_INET, group, &v4->sin_addr) == 1) {
+            v4->sin_family = AF_INET;
+            level = IPPROTO_IP;
+        } else if (family_ == AF_INET6 && inet_pton(AF_INET6, group, &v6->sin6_addr) == 1) {
+            v6->sin6_family = AF_INET6;
+            level = IPPROTO_IPV6;
+        } else {
+            return false;
+        }
+        return ::setsockopt(fd_, level, join ? MCAST_JOIN_GROUP : MCAST_LEAVE_GROUP, &req, sizeof(req)) == 0;
+    }
+
     void makeNonBlocking() {
         if (fd_ < 0) return;
         int flags = ::fcntl(fd_, F_GETFL, 0);
@@ -107,14 +421,64 @@ private:
     }
 
     int fd_;
-    struct sockaddr_in destAddr_;
+    int family_;
+    struct sockaddr_storage destAddr_;
+    socklen_t destLen_;
     bool hasDest_ = false;
 
+    bool buffered() {
+        while (rxSlot_ < rxCount_) {
+            if (bufIdx_ < rxLength_[rxSlot_]) return true;
+            ++rxSlot_; // next datagram of the batch (skips empty ones)
+            bufIdx_ = 0;
+        }
+        return false;
+    }
+
+    // Refill the receive slots; false when no datagram is pending.
+    bool receive() {
+        rxCount_ = 0;
+        rxSlot_ = 0;
+        bufIdx_ = 0;
+#if UMSG_POSIX_HAVE_MMSG
+        if (kRxBatch > 1) {
+            struct mmsghdr msgs[kRxBatch];
+            struct iovec iov[kRxBatch];
+            memset(msgs, 0, sizeof(msgs));
+            for (size_t i = 0; i < kRxBatch; ++i) {
+                iov[i].iov_base = rxBuffer_[i];
+                iov[i].iov_len = kDatagramSize;
+                msgs[i].msg_hdr.msg_iov = &iov[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+            int n;
+            do {
+                n = ::recvmmsg(fd_, msgs, static_cast<unsigned int>(kRxBatch), MSG_DONTWAIT, NULL);
+            } while (n < 0 && errno == EINTR);
+            if (n <= 0) return false;
+            for (int i = 0; i < n; ++i) {
+                rxLength_[i] = msgs[i].msg_len;
+            }
+            rxCount_ = static_cast<size_t>(n);
+            return buffered();
+        }
+#endif
+        struct sockaddr_storage sender;
+        socklen_t slen = sizeof(sender);
+        ssize_t len = ::recvfrom(fd_, rxBuffer_[0], kDatagramSize, 0, (struct sockaddr*)&sender, &slen);
+        if (len <= 0) return false;
+        rxLength_[0] = static_cast<size_t>(len);
+        rxCount_ = 1;
+        return true;
+    }
+
     // UDP is datagram based, but Node expects a stream of bytes.
-    // We must buffer the current datagram.
-    uint8_t rxBuffer_[4096];
-    size_t bufLen_;
-    size_t bufIdx_;
+    // We must buffer the received datagrams.
+    uint8_t rxBuffer_[kRxBatch][kDatagramSize];
+    size_t rxLength_[kRxBatch];
+    size_t rxCount_; // datagrams in rxBuffer_
+    size_t rxSlot_;  // datagram being served
+    size_t bufIdx_;  // read position within it
 };
 
 } // namespace posix
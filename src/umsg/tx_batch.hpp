@@ -0,0 +1,96 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @file tx_batch.hpp
+ * @brief Caller-owned buffer that coalesces several packets into one transport write.
+ * @ingroup umsg
+ *
+ * Packets are self-delimiting (`0x00` terminator), so they can be concatenated
+ * and written with a single `Transport::write`; the receiver's `Framer` splits
+ * them again. See `Node::beginBatch()`.
+ */
+
+namespace umsg
+{
+    /**
+     * @brief Capacity-independent part of `TxBatch` (what `Node` works with).
+     *
+     * Holds whole packets only: a packet is either appended in full or not at all.
+     */
+    class TxBatchBuffer
+    {
+    public:
+        /** @brief Queued bytes, ready for `Transport::write`. */
+        const uint8_t *data() const { return data_; }
+        size_t size() const { return length_; }
+        size_t capacity() const { return capacity_; }
+        /** @brief Number of packets queued. */
+        size_t packets() const { return packets_; }
+        bool empty() const { return length_ == 0; }
+
+        void clear()
+        {
+            length_ = 0;
+            packets_ = 0;
+        }
+
+        /** @brief Free space at the end of the buffer (for in-place encoding). */
+        uint8_t *tail() { return data_ + length_; }
+        size_t remaining() const { return capacity_ - length_; }
+
+        /** @brief Account for a packet of @p length bytes already written at `tail()`. */
+        void commit(size_t length)
+        {
+            length_ += length;
+            ++packets_;
+        }
+
+        /** @brief Copy one packet in; false (nothing copied) if it does not fit. */
+        bool append(const uint8_t *packet, size_t length)
+        {
+            if (length > remaining())
+            {
+                return false;
+            }
+            ::memcpy(tail(), packet, length);
+            commit(length);
+            return true;
+        }
+
+    protected:
+        TxBatchBuffer(uint8_t *storage, size_t capacity)
+            : data_(storage), capacity_(capacity), length_(0), packets_(0) {}
+
+    private:
+        // Copying would leave data_ pointing into the source object's storage.
+        TxBatchBuffer(const TxBatchBuffer &);
+        TxBatchBuffer &operator=(const TxBatchBuffer &);
+
+        uint8_t *data_;
+        size_t capacity_;
+        size_t length_;
+        size_t packets_;
+    };
+
+    /**
+     * @brief Fixed-capacity batch buffer.
+     *
+     * @tparam Capacity Bytes of packet storage. Size it to the transport's
+     *         preferred write unit (e.g. a UDP datagram or an MTU); a packet larger
+     *         than @p Capacity bypasses the batch and is written on its own.
+     */
+    template <size_t Capacity>
+    class TxBatch : public TxBatchBuffer
+    {
+    public:
+        static const size_t kCapacity = Capacity;
+
+        TxBatch() : TxBatchBuffer(storage_, Capacity) {}
+
+    private:
+        uint8_t storage_[Capacity];
+    };
+}
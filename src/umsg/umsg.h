@@ -7,9 +7,17 @@
  * - `ByteSpan`, `Error`, sizing helpers (`common.hpp`)
  * - Canonical marshalling (`Writer`/`Reader`) (`marshalling.hpp`)
  * - Byte-stream framing (COBS + CRC32) (`Framer`) (`framer.hpp`)
+ * - Datagram framing (`frame || crc32`, no COBS) (`DatagramFraming`) (`datagram.hpp`)
  * - Frame header codec (`protocol::encodeFrame` / `decodeFrame`) (`protocol.hpp`)
  * - Handler table (`Dispatcher`) (`dispatcher.hpp`)
- * - Integration (`Node`) (`node.hpp`)
+ * - Compile-time handler table (`StaticDispatcher`, `UMSG_ROUTE`) (`static_dispatcher.hpp`)
+ * - Generated package registries (`MessageRegistry`, `UMSG_REGISTRY_ROUTE`) (`registry.hpp`)
+ * - Transport concept and capability detection (`transport.hpp`)
+ * - Integration (`Node`, `BasicNode`) (`node.hpp`)
+ * - Cut-through forwarding between links (`Router`, `RouteTable`) (`router.hpp`)
+ * - Batched transmit buffer (`TxBatch`, `Node::beginBatch`) (`tx_batch.hpp`)
+ * - Latest-value slots (`Conflation`, `Node::publishLatest`) (`conflation.hpp`)
+ * - Optional `Node` counters (`NodeStats`, `UMSG_ENABLE_STATS`) (`stats.hpp`)
  *
  * @defgroup umsg umsg
  * @brief Header-only embedded messaging library.
@@ -31,5 +39,14 @@
 #include "crc32.hpp"
 #include "protocol.hpp"
 #include "framer.hpp"
+#include "datagram.hpp"
 #include "dispatcher.hpp"
+#include "static_dispatcher.hpp"
+#include "registry.hpp"
+#include "transport.hpp"
+#include "stats.hpp"
+#include "tx_batch.hpp"
+#include "conflation.hpp"
+#include "compress.hpp"
 #include "node.hpp"
+#include "router.hpp"
@@ -0,0 +1,111 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// This file was generated by umsg-gen.
+// Source: Compact.umsg
+//
+// DO NOT EDIT THIS FILE DIRECTLY.
+// Edit the corresponding .umsg schema and re-run umsg-gen instead.
+// -----------------------------------------------------------------------------
+
+#include <umsg/marshalling.hpp>
+
+struct Compact
+{
+    uint32_t seq;
+    int32_t offset;
+    uint64_t timestamp_us;
+    int64_t drift_ns;
+    uint8_t mode;
+    float samples[16];
+    uint8_t samples_count; // valid elements of samples
+    int32_t deltas[4];
+    uint8_t deltas_count; // valid elements of deltas
+    bool faults[3];
+    uint8_t faults_count; // valid elements of faults
+    uint32_t ids[2];
+
+    static const uint32_t kMsgHash = 0x1BB0B6F2u;
+    // Upper bound: varints and [<=N] arrays encode only what they hold.
+    static const size_t kPayloadSize = umsg::kMaxVarint32Size + umsg::kMaxVarint32Size + umsg::kMaxVarint64Size + umsg::kMaxVarint64Size + sizeof(uint8_t) + (1u + sizeof(float) * 16u) + (1u + umsg::kMaxVarint32Size * 4u) + (1u + sizeof(bool) * 3u) + (umsg::kMaxVarint32Size * 2u);
+
+    template <class W>
+    bool encodeTo(W& w) const
+    {
+        if (!w.writeVarint(seq)) return false;
+        if (!w.writeZigzag(offset)) return false;
+        if (!w.writeVarint(timestamp_us)) return false;
+        if (!w.writeZigzag(drift_ns)) return false;
+        if (!w.write(mode)) return false;
+        if (samples_count > 16u || !w.writeVarint(samples_count)) return false;
+        if (!w.writeArray(samples, samples_count)) return false;
+        if (deltas_count > 4u || !w.writeVarint(deltas_count)) return false;
+        for (size_t i = 0; i < deltas_count; ++i)
+            if (!w.writeZigzag(deltas[i])) return false;
+        if (faults_count > 3u || !w.writeVarint(faults_count)) return false;
+        if (!w.writeArray(faults, faults_count)) return false;
+        for (size_t i = 0; i < 2u; ++i)
+            if (!w.writeVarint(ids[i])) return false;
+        return true;
+    }
+
+    size_t encodedSize() const
+    {
+        size_t n = sizeof(uint8_t);
+        n += umsg::varint_size(seq);
+        n += umsg::varint_size(umsg::zigzag_encode(offset));
+        n += umsg::varint_size(timestamp_us);
+        n += umsg::varint_size(umsg::zigzag_encode(drift_ns));
+        n += umsg::varint_size(samples_count);
+        n += 4u * samples_count;
+        n += umsg::varint_size(deltas_count);
+        for (size_t i = 0; i < deltas_count; ++i) n += umsg::varint_size(umsg::zigzag_encode(deltas[i]));
+        n += umsg::varint_size(faults_count);
+        n += 1u * faults_count;
+        for (size_t i = 0; i < 2u; ++i) n += umsg::varint_size(ids[i]);
+        return n;
+    }
+
+    bool encode(umsg::ByteSpan& payload) const
+    {
+        if (!payload.data) return false;
+        umsg::Writer w(payload);
+        if (!encodeTo(w)) return false;
+        payload.length = w.bytesWritten();
+        return true;
+    }
+
+    bool decode(umsg::ByteSpan payload)
+    {
+        umsg::Reader r(payload);
+        if (!r.readVarint(seq)) return false;
+        if (!r.readZigzag(offset)) return false;
+        if (!r.readVarint(timestamp_us)) return false;
+        if (!r.readZigzag(drift_ns)) return false;
+        if (!r.read(mode)) return false;
+        {
+            uint32_t count;
+            if (!r.readVarint(count) || count > 16u) return false;
+            samples_count = static_cast<uint8_t>(count);
+        }
+        if (!r.readArray(samples, samples_count)) return false;
+        {
+            uint32_t count;
+            if (!r.readVarint(count) || count > 4u) return false;
+            deltas_count = static_cast<uint8_t>(count);
+        }
+        for (size_t i = 0; i < deltas_count; ++i)
+            if (!r.readZigzag(deltas[i])) return false;
+        {
+            uint32_t count;
+            if (!r.readVarint(count) || count > 3u) return false;
+            faults_count = static_cast<uint8_t>(count);
+        }
+        if (!r.readArray(faults, faults_count)) return false;
+        for (size_t i = 0; i < 2u; ++i)
+            if (!r.readVarint(ids[i])) return false;
+        return true;
+    }
+};
@@ -0,0 +1,169 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// This file was generated by umsg-gen.
+// Source: Telemetry.umsg
+//
+// DO NOT EDIT THIS FILE DIRECTLY.
+// Edit the corresponding .umsg schema and re-run umsg-gen instead.
+// -----------------------------------------------------------------------------
+
+#include <umsg/marshalling.hpp>
+
+struct Telemetry
+{
+    uint8_t mode;
+    int8_t trim;
+    bool armed;
+    uint16_t seq;
+    int16_t offset;
+    uint32_t flags;
+    int32_t position;
+    uint64_t timestamp_us;
+    int64_t drift_ns;
+    float voltage;
+    double latitude;
+    int16_t samples[4];
+    bool faults[3];
+
+    static const uint32_t kMsgHash = 0xA8FA4092u;
+    static const size_t kPayloadSize = sizeof(uint8_t) + sizeof(int8_t) + sizeof(bool) + sizeof(uint16_t) + sizeof(int16_t) + sizeof(uint32_t) + sizeof(int32_t) + sizeof(uint64_t) + sizeof(int64_t) + sizeof(float) + sizeof(double) + (sizeof(int16_t) * 4u) + (sizeof(bool) * 3u);
+
+    template <class W>
+    bool encodeTo(W& w) const
+    {
+        if (!w.write(mode)) return false;
+        if (!w.write(trim)) return false;
+        if (!w.write(armed)) return false;
+        if (!w.write(seq)) return false;
+        if (!w.write(offset)) return false;
+        if (!w.write(flags)) return false;
+        if (!w.write(position)) return false;
+        if (!w.write(timestamp_us)) return false;
+        if (!w.write(drift_ns)) return false;
+        if (!w.write(voltage)) return false;
+        if (!w.write(latitude)) return false;
+        if (!w.writeArray(samples, 4u)) return false;
+        if (!w.writeArray(faults, 3u)) return false;
+        return true;
+    }
+
+    size_t encodedSize() const { return kPayloadSize; }
+
+    // Wire offset of each field.
+    struct Offset
+    {
+        static const size_t mode = 0u;
+        static const size_t trim = 1u;
+        static const size_t armed = 2u;
+        static const size_t seq = 3u;
+        static const size_t offset = 5u;
+        static const size_t flags = 7u;
+        static const size_t position = 11u;
+        static const size_t timestamp_us = 15u;
+        static const size_t drift_ns = 23u;
+        static const size_t voltage = 31u;
+        static const size_t latitude = 35u;
+        static const size_t samples = 43u;
+        static const size_t faults = 51u;
+    };
+
+    // Store every field at its offset; out must hold kPayloadSize bytes.
+    void encodeUnchecked(uint8_t* out) const
+    {
+        umsg::write_be(out + Offset::mode, mode);
+        umsg::write_be(out + Offset::trim, trim);
+        umsg::write_be(out + Offset::armed, armed);
+        umsg::write_be(out + Offset::seq, seq);
+        umsg::write_be(out + Offset::offset, offset);
+        umsg::write_be(out + Offset::flags, flags);
+        umsg::write_be(out + Offset::position, position);
+        umsg::write_be(out + Offset::timestamp_us, timestamp_us);
+        umsg::write_be(out + Offset::drift_ns, drift_ns);
+        umsg::write_be(out + Offset::voltage, voltage);
+        umsg::write_be(out + Offset::latitude, latitude);
+        umsg::write_be(out + Offset::samples + 0u, samples[0]);
+        umsg::write_be(out + Offset::samples + 2u, samples[1]);
+        umsg::write_be(out + Offset::samples + 4u, samples[2]);
+        umsg::write_be(out + Offset::samples + 6u, samples[3]);
+        umsg::write_be(out + Offset::faults + 0u, faults[0]);
+        umsg::write_be(out + Offset::faults + 1u, faults[1]);
+        umsg::write_be(out + Offset::faults + 2u, faults[2]);
+    }
+
+    bool encode(umsg::ByteSpan& payload) const
+    {
+        if (!payload.data || payload.length < kPayloadSize) return false;
+        encodeUnchecked(payload.data);
+        payload.length = kPayloadSize;
+        return true;
+    }
+
+    bool decode(umsg::ByteSpan payload)
+    {
+        if (!payload.data || payload.length < kPayloadSize) return false;
+        const uint8_t* in = payload.data;
+        if (!umsg::valid_bools(in + Offset::armed, 1u)) return false;
+        if (!umsg::valid_bools(in + Offset::faults, 3u)) return false;
+        mode = umsg::read_be<uint8_t>(in + Offset::mode);
+        trim = umsg::read_be<int8_t>(in + Offset::trim);
+        armed = umsg::read_be<bool>(in + Offset::armed);
+        seq = umsg::read_be<uint16_t>(in + Offset::seq);
+        offset = umsg::read_be<int16_t>(in + Offset::offset);
+        flags = umsg::read_be<uint32_t>(in + Offset::flags);
+        position = umsg::read_be<int32_t>(in + Offset::position);
+        timestamp_us = umsg::read_be<uint64_t>(in + Offset::timestamp_us);
+        drift_ns = umsg::read_be<int64_t>(in + Offset::drift_ns);
+        voltage = umsg::read_be<float>(in + Offset::voltage);
+        latitude = umsg::read_be<double>(in + Offset::latitude);
+        samples[0] = umsg::read_be<int16_t>(in + Offset::samples + 0u);
+        samples[1] = umsg::read_be<int16_t>(in + Offset::samples + 2u);
+        samples[2] = umsg::read_be<int16_t>(in + Offset::samples + 4u);
+        samples[3] = umsg::read_be<int16_t>(in + Offset::samples + 6u);
+        faults[0] = umsg::read_be<bool>(in + Offset::faults + 0u);
+        faults[1] = umsg::read_be<bool>(in + Offset::faults + 1u);
+        faults[2] = umsg::read_be<bool>(in + Offset::faults + 2u);
+        return true;
+    }
+};
+
+// Zero-copy view of a Telemetry payload: subscribe with
+// `Error (T::*)(const TelemetryView&)` to skip the decode copy. Accessors read the
+// aliased payload, so a view is only valid for the duration of the handler call.
+struct TelemetryView
+{
+    static const uint32_t kMsgHash = Telemetry::kMsgHash;
+    static const size_t kPayloadSize = Telemetry::kPayloadSize;
+
+    TelemetryView() : data_(0) {}
+
+    bool decode(umsg::ByteSpan payload)
+    {
+        if (payload.length < kPayloadSize) return false;
+        if (!umsg::valid_bools(payload.data + Telemetry::Offset::armed, 1u)) return false;
+        if (!umsg::valid_bools(payload.data + Telemetry::Offset::faults, 3u)) return false;
+        data_ = payload.data;
+        return true;
+    }
+
+    uint8_t mode() const { return umsg::read_be<uint8_t>(data_ + Telemetry::Offset::mode); }
+    int8_t trim() const { return umsg::read_be<int8_t>(data_ + Telemetry::Offset::trim); }
+    bool armed() const { return umsg::read_be<bool>(data_ + Telemetry::Offset::armed); }
+    uint16_t seq() const { return umsg::read_be<uint16_t>(data_ + Telemetry::Offset::seq); }
+    int16_t offset() const { return umsg::read_be<int16_t>(data_ + Telemetry::Offset::offset); }
+    uint32_t flags() const { return umsg::read_be<uint32_t>(data_ + Telemetry::Offset::flags); }
+    int32_t position() const { return umsg::read_be<int32_t>(data_ + Telemetry::Offset::position); }
+    uint64_t timestamp_us() const { return umsg::read_be<uint64_t>(data_ + Telemetry::Offset::timestamp_us); }
+    int64_t drift_ns() const { return umsg::read_be<int64_t>(data_ + Telemetry::Offset::drift_ns); }
+    float voltage() const { return umsg::read_be<float>(data_ + Telemetry::Offset::voltage); }
+    double latitude() const { return umsg::read_be<double>(data_ + Telemetry::Offset::latitude); }
+    /** @pre i < 4 */
+    int16_t samples(size_t i) const { return umsg::read_be<int16_t>(data_ + Telemetry::Offset::samples + 2u * i); }
+    /** @pre i < 3 */
+    bool faults(size_t i) const { return umsg::read_be<bool>(data_ + Telemetry::Offset::faults + 1u * i); }
+
+private:
+    const uint8_t* data_;
+};
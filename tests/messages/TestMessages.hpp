@@ -0,0 +1,25 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// This file was generated by umsg-gen.
+// Source: Telemetry.umsg, Compact.umsg
+//
+// DO NOT EDIT THIS FILE DIRECTLY.
+// Edit the corresponding .umsg schemas and re-run umsg-gen instead.
+// -----------------------------------------------------------------------------
+
+#include <umsg/registry.hpp>
+
+#include "Telemetry.hpp"
+#include "Compact.hpp"
+
+// Messages of package `messages` and their msg_ids.
+struct TestMessages : umsg::MessageRegistry<
+    umsg::MessageDef<6, Telemetry>,
+    umsg::MessageDef<7, Compact> >
+{
+    static const uint8_t kTelemetryId = 6;
+    static const uint8_t kCompactId = 7;
+};
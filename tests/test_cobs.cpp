@@ -70,9 +70,138 @@ namespace
         }
         round_trip(ctx, big, sizeof(big));
     }
+
+    // Byte-at-a-time reference built on the same state machine as the bulk path.
+    size_t encode_bytewise(const uint8_t *input, size_t inputLen, uint8_t *output, size_t outputCap)
+    {
+        umsg::detail::CobsEncState enc;
+        enc.begin(output, outputCap);
+        for (size_t i = 0; i < inputLen; ++i)
+        {
+            enc.put(input[i]);
+        }
+        size_t len = 0;
+        enc.finish(len);
+        return len;
+    }
+
+    void test_known_encodings(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "cobs: known encodings");
+        const uint8_t in1[] = {0x00};
+        const uint8_t out1[] = {0x01, 0x01};
+        const uint8_t in2[] = {0x11, 0x22, 0x00, 0x33};
+        const uint8_t out2[] = {0x03, 0x11, 0x22, 0x02, 0x33};
+        const uint8_t in3[] = {0x11, 0x00, 0x00, 0x00};
+        const uint8_t out3[] = {0x02, 0x11, 0x01, 0x01, 0x01};
+
+        uint8_t encoded[16];
+        size_t encodedLen = 0;
+        UMSG_TEST_EXPECT_TRUE(ctx, umsg::cobsEncode(in1, sizeof(in1), encoded, sizeof(encoded), encodedLen));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, sizeof(out1), encodedLen);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, out1, encoded, sizeof(out1));
+        UMSG_TEST_EXPECT_TRUE(ctx, umsg::cobsEncode(in2, sizeof(in2), encoded, sizeof(encoded), encodedLen));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, sizeof(out2), encodedLen);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, out2, encoded, sizeof(out2));
+        UMSG_TEST_EXPECT_TRUE(ctx, umsg::cobsEncode(in3, sizeof(in3), encoded, sizeof(encoded), encodedLen));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, sizeof(out3), encodedLen);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, out3, encoded, sizeof(out3));
+
+        UMSG_TEST_SECTION(ctx, "cobs: bulk encode matches byte-at-a-time put() around 254-byte blocks");
+        uint8_t input[600];
+        static const size_t kLengths[] = {253, 254, 255, 508, 509, 600};
+        for (size_t z = 0; z < 3; ++z)
+        {
+            for (size_t i = 0; i < sizeof(input); ++i)
+            {
+                input[i] = static_cast<uint8_t>((i % 251) + 1);
+            }
+            if (z == 1) input[253] = 0; // zero right at the block edge
+            if (z == 2) input[0] = 0;
+
+            for (size_t l = 0; l < sizeof(kLengths) / sizeof(kLengths[0]); ++l)
+            {
+                uint8_t bulk[700];
+                uint8_t ref[700];
+                size_t bulkLen = 0;
+                UMSG_TEST_EXPECT_TRUE(ctx, umsg::cobsEncode(input, kLengths[l], bulk, sizeof(bulk), bulkLen));
+                const size_t refLen = encode_bytewise(input, kLengths[l], ref, sizeof(ref));
+                UMSG_TEST_EXPECT_EQ_SIZE(ctx, refLen, bulkLen);
+                UMSG_TEST_EXPECT_BUF_EQ(ctx, ref, bulk, refLen);
+            }
+        }
+
+        UMSG_TEST_SECTION(ctx, "cobs: bulk encode reports overflow");
+        UMSG_TEST_EXPECT_TRUE(ctx, !umsg::cobsEncode(input, 300, encoded, sizeof(encoded), encodedLen));
+    }
+    void test_streaming_decode(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "cobs: streaming decoder (put / split write) == cobsDecodeInPlace");
+        uint8_t input[600];
+        static const size_t kLengths[] = {0, 1, 253, 254, 255, 508, 509, 600};
+        static const size_t kSplits[] = {1, 3, 254, 1000};
+        for (size_t z = 0; z < 3; ++z)
+        {
+            for (size_t i = 0; i < sizeof(input); ++i)
+            {
+                input[i] = static_cast<uint8_t>((i % 251) + 1);
+            }
+            if (z == 1) input[253] = 0;
+            if (z == 2)
+            {
+                for (size_t i = 0; i < sizeof(input); i += 7) input[i] = 0;
+            }
+
+            for (size_t l = 0; l < sizeof(kLengths) / sizeof(kLengths[0]); ++l)
+            {
+                uint8_t encoded[700];
+                size_t encodedLen = 0;
+                UMSG_TEST_EXPECT_TRUE(ctx, umsg::cobsEncode(input, kLengths[l], encoded, sizeof(encoded), encodedLen));
+
+                uint8_t byByte[700];
+                umsg::detail::CobsDecState dec;
+                dec.begin(byByte);
+                for (size_t i = 0; i < encodedLen; ++i)
+                {
+                    dec.put(encoded[i]);
+                }
+                UMSG_TEST_EXPECT_TRUE(ctx, dec.complete());
+                UMSG_TEST_EXPECT_EQ_SIZE(ctx, kLengths[l], dec.length);
+                UMSG_TEST_EXPECT_BUF_EQ(ctx, input, byByte, kLengths[l]);
+
+                for (size_t sp = 0; sp < sizeof(kSplits) / sizeof(kSplits[0]); ++sp)
+                {
+                    uint8_t bulk[700];
+                    dec.begin(bulk);
+                    for (size_t pos = 0; pos < encodedLen; pos += kSplits[sp])
+                    {
+                        const size_t n = encodedLen - pos < kSplits[sp] ? encodedLen - pos : kSplits[sp];
+                        dec.write(&encoded[pos], n);
+                    }
+                    UMSG_TEST_EXPECT_TRUE(ctx, dec.complete());
+                    UMSG_TEST_EXPECT_EQ_SIZE(ctx, kLengths[l], dec.length);
+                    UMSG_TEST_EXPECT_BUF_EQ(ctx, input, bulk, kLengths[l]);
+                }
+            }
+        }
+
+        UMSG_TEST_SECTION(ctx, "cobs: streaming decoder flags a truncated block");
+        const uint8_t truncated[] = {0x02, 0x11, 0x05, 0x22, 0x33};
+        uint8_t out[8];
+        umsg::detail::CobsDecState dec;
+        dec.begin(out);
+        dec.write(truncated, sizeof(truncated));
+        UMSG_TEST_EXPECT_TRUE(ctx, !dec.complete());
+        size_t decodedLen = 0;
+        uint8_t scratch[sizeof(truncated)];
+        ::memcpy(scratch, truncated, sizeof(truncated));
+        UMSG_TEST_EXPECT_TRUE(ctx, !umsg::cobsDecodeInPlace(scratch, sizeof(scratch), decodedLen));
+    }
 }
 
 void test_cobs(umsg_test::TestContext &ctx)
 {
     test_patterns(ctx);
+    test_known_encodings(ctx);
+    test_streaming_decode(ctx);
 }
@@ -7,6 +7,40 @@
 
 namespace
 {
+    typedef uint32_t (*UpdateFn)(uint32_t crc, const uint8_t *data, size_t length);
+
+    struct Backend
+    {
+        const char *name;
+        UpdateFn update;
+    };
+
+    // Every backend compiled into this build, whatever crc32_iso_hdlc() selects.
+    size_t backends(Backend *out)
+    {
+        size_t n = 0;
+        out[n].name = "crc32: bitwise backend (reference)";
+        out[n++].update = &umsg::detail::crc32_update_bitwise;
+        out[n].name = "crc32: nibble backend matches bitwise reference";
+        out[n++].update = &umsg::detail::crc32_update_nibble;
+        out[n].name = "crc32: byte backend matches bitwise reference";
+        out[n++].update = &umsg::detail::crc32_update_byte;
+        out[n].name = "crc32: slice8 backend matches bitwise reference";
+        out[n++].update = &umsg::detail::crc32_update_slice8;
+#if defined(UMSG_CRC32_HAVE_ARMV8)
+        out[n].name = "crc32: armv8 backend matches bitwise reference";
+        out[n++].update = &umsg::detail::crc32_update_armv8;
+#endif
+#if defined(UMSG_CRC32_HAVE_PCLMUL)
+        if (umsg::detail::crc32_pclmul_supported())
+        {
+            out[n].name = "crc32: pclmul backend matches bitwise reference";
+            out[n++].update = &umsg::detail::crc32_update_pclmul;
+        }
+#endif
+        return n;
+    }
+
     void test_crc32_known_vector(umsg_test::TestContext &ctx)
     {
         UMSG_TEST_SECTION(ctx, "crc32: known vector '123456789' -> 0xCBF43926");
@@ -21,10 +55,74 @@ namespace
         const uint32_t crc = umsg::crc32_iso_hdlc(0, 0);
         UMSG_TEST_EXPECT_EQ_U32(ctx, 0x00000000u, crc);
     }
+
+    void test_crc32_backends_agree(umsg_test::TestContext &ctx)
+    {
+        Backend list[8];
+        const size_t count = backends(list);
+
+        static uint8_t data[4096 + 8];
+        uint32_t x = 0x12345678u;
+        for (size_t i = 0; i < sizeof(data); ++i)
+        {
+            x = x * 1103515245u + 12345u;
+            data[i] = static_cast<uint8_t>(x >> 24);
+        }
+
+        static const size_t kLengths[] = {0, 1, 7, 8, 9, 15, 16, 63, 64, 65, 80, 127, 128, 129, 255, 1000, 4096};
+        const uint8_t vector[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+        for (size_t b = 0; b < count; ++b)
+        {
+            UMSG_TEST_SECTION(ctx, list[b].name);
+            UMSG_TEST_EXPECT_EQ_U32(ctx, 0xCBF43926u,
+                                    list[b].update(0xFFFFFFFFu, vector, sizeof(vector)) ^ 0xFFFFFFFFu);
+            UMSG_TEST_EXPECT_EQ_U32(ctx, 0x00000000u, list[b].update(0xFFFFFFFFu, 0, 0) ^ 0xFFFFFFFFu);
+
+            for (size_t offset = 0; offset < 4; ++offset)
+            {
+                for (size_t l = 0; l < sizeof(kLengths) / sizeof(kLengths[0]); ++l)
+                {
+                    const uint32_t expected = umsg::detail::crc32_update_bitwise(0xFFFFFFFFu, &data[offset], kLengths[l]);
+                    UMSG_TEST_EXPECT_EQ_U32(ctx, expected, list[b].update(0xFFFFFFFFu, &data[offset], kLengths[l]));
+                }
+            }
+        }
+    }
+
+    void test_crc32_incremental(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "crc32: Crc32 update()/finish() over split input equals one-shot");
+        uint8_t data[200];
+        for (size_t i = 0; i < sizeof(data); ++i)
+        {
+            data[i] = static_cast<uint8_t>(i * 31u + 7u);
+        }
+        const uint32_t expected = umsg::crc32_iso_hdlc(data, sizeof(data));
+
+        for (size_t split = 0; split <= sizeof(data); split += 13)
+        {
+            umsg::Crc32 crc;
+            crc.update(data, split).update(&data[split], sizeof(data) - split);
+            UMSG_TEST_EXPECT_EQ_U32(ctx, expected, crc.finish());
+        }
+
+        umsg::Crc32 bytewise;
+        for (size_t i = 0; i < sizeof(data); ++i)
+        {
+            bytewise.update(data[i]);
+        }
+        UMSG_TEST_EXPECT_EQ_U32(ctx, expected, bytewise.finish());
+
+        bytewise.reset();
+        UMSG_TEST_EXPECT_EQ_U32(ctx, 0x00000000u, bytewise.finish());
+    }
 }
 
 void test_crc32(umsg_test::TestContext &ctx)
 {
     test_crc32_known_vector(ctx);
     test_crc32_empty(ctx);
+    test_crc32_backends_agree(ctx);
+    test_crc32_incremental(ctx);
 }
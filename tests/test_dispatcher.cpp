@@ -5,6 +5,7 @@
 #include <string.h>
 
 #include <umsg/dispatcher.hpp>
+#include <umsg/static_dispatcher.hpp>
 #include <umsg/protocol.hpp>
 #include <umsg/marshalling.hpp>
 
@@ -66,6 +67,56 @@ namespace
         UMSG_TEST_EXPECT_TRUE(ctx, !cap.called);
     }
 
+    struct CountingHandler
+    {
+        uint8_t lastId;
+        size_t calls;
+
+        CountingHandler() : lastId(0), calls(0) {}
+
+        umsg::Error onMsg(umsg::ByteSpan payload, uint32_t)
+        {
+            ++calls;
+            lastId = payload.length ? payload.data[0] : 0;
+            return umsg::Error::OK;
+        }
+    };
+
+    template <bool Dense>
+    void check_lookup_mode(umsg_test::TestContext &ctx)
+    {
+        umsg::Dispatcher<3, Dense> d;
+        CountingHandler a, b;
+
+        // Ids at both ends of the range; re-registering replaces, not consumes a slot.
+        UMSG_TEST_EXPECT_TRUE(ctx, d.registerHandler(0, &a, &CountingHandler::onMsg) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, d.registerHandler(255, &a, &CountingHandler::onMsg) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, d.registerHandler(0, &b, &CountingHandler::onMsg) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, d.registerHandler(42, &b, &CountingHandler::onMsg) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, d.registerHandler(43, &b, &CountingHandler::onMsg) == umsg::Error::InvalidArgument);
+
+        uint8_t tag[1] = {0};
+        for (unsigned id = 0; id < 256; ++id)
+        {
+            tag[0] = static_cast<uint8_t>(id);
+            const umsg::Error err = d.dispatch(static_cast<uint8_t>(id), 0u, umsg::ByteSpan{tag, 1});
+            const bool registered = (id == 0 || id == 42 || id == 255);
+            UMSG_TEST_EXPECT_TRUE(ctx, err == (registered ? umsg::Error::OK : umsg::Error::HandlerNotFound));
+        }
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, a.calls);
+        UMSG_TEST_EXPECT_TRUE(ctx, a.lastId == 255);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, b.calls);
+        UMSG_TEST_EXPECT_TRUE(ctx, b.lastId == 42);
+    }
+
+    void test_dispatch_lookup_modes(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "dispatcher: linear lookup (replace, full table, all 256 ids)");
+        check_lookup_mode<false>(ctx);
+        UMSG_TEST_SECTION(ctx, "dispatcher: dense lookup (replace, full table, all 256 ids)");
+        check_lookup_mode<true>(ctx);
+    }
+
     void test_protocol_encode_decode(umsg_test::TestContext &ctx)
     {
         UMSG_TEST_SECTION(ctx, "protocol: encodeFrame() + decodeFrame() round-trip");
@@ -156,13 +207,61 @@ namespace
             d.dispatch(10, 0x00000000u, umsg::ByteSpan{payload, 4}) == umsg::Error::HashMismatch);
         UMSG_TEST_EXPECT_TRUE(ctx, !recv.called);
     }
+
+    struct Controller
+    {
+        HandlerCapture raw;
+        TypedReceiver typed;
+
+        umsg::Error onRaw(umsg::ByteSpan payload, uint32_t msgHash) { return raw.onMsg(payload, msgHash); }
+        umsg::Error onTyped(const TypedMsg &msg) { return typed.onMsg(msg); }
+    };
+
+    typedef umsg::StaticDispatcher<Controller,
+                                   UMSG_ROUTE(3, &Controller::onRaw),
+                                   UMSG_ROUTE(10, &Controller::onTyped)>
+        ControllerDispatcher;
+
+    void test_static_dispatch(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "static dispatcher: unbound object -> HandlerNotFound");
+        ControllerDispatcher d;
+        uint8_t payload[4];
+        umsg::write_u32_be(payload, 0xCAFEF00Du);
+        UMSG_TEST_EXPECT_TRUE(ctx,
+            d.dispatch(3, 1u, umsg::ByteSpan{payload, 4}) == umsg::Error::HandlerNotFound);
+
+        UMSG_TEST_SECTION(ctx, "static dispatcher: raw and typed routes");
+        Controller c;
+        d.bind(&c);
+        UMSG_TEST_EXPECT_TRUE(ctx, d.dispatch(3, 0x01020304u, umsg::ByteSpan{payload, 4}) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, c.raw.called);
+        UMSG_TEST_EXPECT_EQ_U32(ctx, 0x01020304u, c.raw.msgHash);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, payload, c.raw.payload, c.raw.payloadLen);
+        UMSG_TEST_EXPECT_TRUE(ctx, !c.typed.called);
+
+        UMSG_TEST_EXPECT_TRUE(ctx,
+            d.dispatch(10, TypedMsg::kMsgHash, umsg::ByteSpan{payload, 4}) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, c.typed.called);
+        UMSG_TEST_EXPECT_EQ_U32(ctx, 0xCAFEF00Du, c.typed.val);
+
+        UMSG_TEST_SECTION(ctx, "static dispatcher: typed hash/decode checks and unknown ids");
+        c.typed.called = false;
+        UMSG_TEST_EXPECT_TRUE(ctx, d.dispatch(10, 0u, umsg::ByteSpan{payload, 4}) == umsg::Error::HashMismatch);
+        UMSG_TEST_EXPECT_TRUE(ctx,
+            d.dispatch(10, TypedMsg::kMsgHash, umsg::ByteSpan{payload, 2}) == umsg::Error::InvalidArgument);
+        UMSG_TEST_EXPECT_TRUE(ctx, !c.typed.called);
+        UMSG_TEST_EXPECT_TRUE(ctx, d.dispatch(4, 0u, umsg::ByteSpan{payload, 4}) == umsg::Error::HandlerNotFound);
+    }
 }
 
 void test_dispatcher(umsg_test::TestContext &ctx)
 {
     test_dispatch_by_msg_id(ctx);
     test_dispatch_unknown_id(ctx);
+    test_dispatch_lookup_modes(ctx);
     test_protocol_encode_decode(ctx);
     test_protocol_length_mismatch(ctx);
     test_dispatch_typed(ctx);
+    test_static_dispatch(ctx);
 }
@@ -4,8 +4,11 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <umsg/cobs.hpp>
 #include <umsg/common.hpp>
+#include <umsg/crc32.hpp>
 #include <umsg/framer.hpp>
+#include <umsg/marshalling.hpp>
 
 namespace
 {
@@ -58,6 +61,38 @@ namespace
         UMSG_TEST_EXPECT_BUF_EQ(ctx, frameBytes, emittedBytes, emittedLen);
     }
 
+    void test_framer_encode_matches_reference(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "framer: single-pass encode() == COBS(frame || crc32_be) || 0x00");
+        static const size_t kMaxPayload = 512;
+        static const size_t kMaxPacket = umsg::maxPacketSize(kMaxPayload);
+
+        uint8_t frameBytes[300];
+        for (size_t i = 0; i < sizeof(frameBytes); ++i)
+        {
+            frameBytes[i] = (i % 37 == 0) ? 0u : static_cast<uint8_t>(i);
+        }
+
+        uint8_t crcBytes[4];
+        umsg::write_u32_be(crcBytes, umsg::crc32_iso_hdlc(frameBytes, sizeof(frameBytes)));
+        uint8_t expected[kMaxPacket];
+        size_t expectedLen = 0;
+        UMSG_TEST_EXPECT_TRUE(ctx, umsg::cobsEncode2(frameBytes, sizeof(frameBytes), crcBytes, 4,
+                                                     expected, sizeof(expected), expectedLen));
+        expected[expectedLen++] = 0x00;
+
+        umsg::Framer<kMaxPacket> tx;
+        uint8_t packetBytes[kMaxPacket];
+        umsg::ByteSpan packet{packetBytes, sizeof(packetBytes)};
+        UMSG_TEST_EXPECT_TRUE(ctx, tx.encode(umsg::ByteSpan{frameBytes, sizeof(frameBytes)}, packet) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, expectedLen, packet.length);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, expected, packet.data, expectedLen);
+
+        UMSG_TEST_SECTION(ctx, "framer: encode() rejects a packet buffer that is too small");
+        packet.length = expectedLen - 1;
+        UMSG_TEST_EXPECT_TRUE(ctx, tx.encode(umsg::ByteSpan{frameBytes, sizeof(frameBytes)}, packet) == umsg::Error::InvalidArgument);
+    }
+
     void test_framer_crc_failure(umsg_test::TestContext &ctx)
     {
         UMSG_TEST_SECTION(ctx, "framer: CRC mismatch is rejected");
@@ -98,10 +133,195 @@ namespace
         UMSG_TEST_EXPECT_TRUE(ctx, sawFailure);
         UMSG_TEST_EXPECT_TRUE(ctx, !anyComplete);
     }
+
+    struct FeedEvent
+    {
+        umsg::Error status;
+        size_t frameLength;
+        uint8_t firstByte;
+    };
+
+    template <size_t MaxPacket>
+    void record(const typename umsg::Framer<MaxPacket>::Result &r, FeedEvent *events, size_t &count)
+    {
+        if ((r.complete || r.status != umsg::Error::OK) && count < 16)
+        {
+            FeedEvent e;
+            e.status = r.status;
+            e.frameLength = r.complete ? r.frame.length : 0;
+            e.firstByte = (r.complete && r.frame.length) ? r.frame.data[0] : 0;
+            events[count++] = e;
+        }
+    }
+
+    void test_framer_block_feed(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "framer: feed(span) emits the same events as feed(byte)");
+        static const size_t kMaxPayload = 16;
+        static const size_t kMaxPacket = umsg::maxPacketSize(kMaxPayload);
+        typedef umsg::Framer<kMaxPacket> FramerT;
+
+        FramerT tx;
+        uint8_t stream[512];
+        size_t streamLen = 0;
+
+        // good, corrupted, oversized, good, empty delimiters, good
+        for (size_t k = 0; k < 6; ++k)
+        {
+            uint8_t frameBytes[20];
+            for (size_t i = 0; i < sizeof(frameBytes); ++i)
+            {
+                frameBytes[i] = static_cast<uint8_t>((i * 7u + k) & 0x03u ? i + k : 0);
+            }
+            uint8_t packetBytes[kMaxPacket];
+            umsg::ByteSpan packet{packetBytes, sizeof(packetBytes)};
+            UMSG_TEST_EXPECT_TRUE(ctx, tx.encode(umsg::ByteSpan{frameBytes, 12 + k}, packet) == umsg::Error::OK);
+            if (k == 1)
+            {
+                packet.data[2] ^= 0x10u;
+            }
+            if (k == 2)
+            {
+                for (size_t i = 0; i < kMaxPacket + 5; ++i)
+                {
+                    stream[streamLen++] = 0x55;
+                }
+            }
+            if (k == 4)
+            {
+                stream[streamLen++] = 0x00;
+                stream[streamLen++] = 0x00;
+            }
+            ::memcpy(&stream[streamLen], packet.data, packet.length);
+            streamLen += packet.length;
+        }
+
+        FeedEvent byteEvents[16];
+        size_t byteCount = 0;
+        FramerT rxByte;
+        for (size_t i = 0; i < streamLen; ++i)
+        {
+            record<kMaxPacket>(rxByte.feed(stream[i]), byteEvents, byteCount);
+        }
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 6, byteCount);
+
+        static const size_t kChunks[] = {1, 3, 7, 64, sizeof(stream)};
+        for (size_t c = 0; c < sizeof(kChunks) / sizeof(kChunks[0]); ++c)
+        {
+            FeedEvent blockEvents[16];
+            size_t blockCount = 0;
+            FramerT rxBlock;
+            size_t pos = 0;
+            while (pos < streamLen)
+            {
+                const size_t n = (streamLen - pos) < kChunks[c] ? (streamLen - pos) : kChunks[c];
+                umsg::ByteSpan in{&stream[pos], n};
+                while (in.length > 0)
+                {
+                    size_t used = 0;
+                    FramerT::Result r = rxBlock.feed(in, used);
+                    UMSG_TEST_EXPECT_TRUE(ctx, used > 0 && used <= in.length);
+                    record<kMaxPacket>(r, blockEvents, blockCount);
+                    in.data += used;
+                    in.length -= used;
+                }
+                pos += n;
+            }
+
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, byteCount, blockCount);
+            for (size_t i = 0; i < byteCount && i < blockCount; ++i)
+            {
+                UMSG_TEST_EXPECT_TRUE(ctx, byteEvents[i].status == blockEvents[i].status);
+                UMSG_TEST_EXPECT_EQ_SIZE(ctx, byteEvents[i].frameLength, blockEvents[i].frameLength);
+                UMSG_TEST_EXPECT_TRUE(ctx, byteEvents[i].firstByte == blockEvents[i].firstByte);
+            }
+        }
+    }
+    void test_framer_incremental_decode(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "framer: long frames (0xFF blocks) round-trip for every chunk split");
+        static const size_t kMaxPayload = 600;
+        static const size_t kMaxPacket = umsg::maxPacketSize(kMaxPayload);
+        typedef umsg::Framer<kMaxPacket> FramerT;
+
+        static FramerT tx;
+        static FramerT rx;
+        uint8_t frameBytes[umsg::kFrameHeaderSize + 520];
+        for (size_t i = 0; i < sizeof(frameBytes); ++i)
+        {
+            frameBytes[i] = static_cast<uint8_t>((i % 253) + 1);
+        }
+        frameBytes[254] = 0; // zero right at a block edge
+
+        uint8_t packetBytes[kMaxPacket];
+        umsg::ByteSpan packet{packetBytes, sizeof(packetBytes)};
+        UMSG_TEST_EXPECT_TRUE(ctx, tx.encode(umsg::ByteSpan{frameBytes, sizeof(frameBytes)}, packet) == umsg::Error::OK);
+
+        static const size_t kChunks[] = {1, 2, 7, 64, 255, 4096};
+        for (size_t c = 0; c < sizeof(kChunks) / sizeof(kChunks[0]); ++c)
+        {
+            size_t frames = 0;
+            bool match = true;
+            for (size_t pos = 0; pos < packet.length;)
+            {
+                const size_t n = packet.length - pos < kChunks[c] ? packet.length - pos : kChunks[c];
+                umsg::ByteSpan in{&packet.data[pos], n};
+                while (in.length > 0)
+                {
+                    size_t used = 0;
+                    const FramerT::Result r = rx.feed(in, used);
+                    in.data += used;
+                    in.length -= used;
+                    if (r.status != umsg::Error::OK)
+                    {
+                        match = false;
+                    }
+                    if (r.complete)
+                    {
+                        ++frames;
+                        match = match && r.frame.length == sizeof(frameBytes) &&
+                                ::memcmp(r.frame.data, frameBytes, sizeof(frameBytes)) == 0;
+                    }
+                }
+                pos += n;
+            }
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, frames);
+            UMSG_TEST_EXPECT_TRUE(ctx, match);
+        }
+
+        UMSG_TEST_SECTION(ctx, "framer: truncated COBS block, short packet, reset() mid-packet");
+        umsg::Framer<64> small;
+        const uint8_t truncated[] = {0x02, 0x11, 0x09, 0x22, 0x33, 0x00};
+        umsg::Framer<64>::Result r{umsg::Error::OK, false, umsg::ByteSpan{nullptr, 0}};
+        for (size_t i = 0; i < sizeof(truncated); ++i)
+        {
+            r = small.feed(truncated[i]);
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, r.status == umsg::Error::CobsInvalid);
+
+        const uint8_t runt[] = {0x04, 0x01, 0x02, 0x03, 0x00};
+        size_t used = 0;
+        r = small.feed(umsg::ByteSpan{const_cast<uint8_t *>(runt), sizeof(runt)}, used);
+        UMSG_TEST_EXPECT_TRUE(ctx, r.status == umsg::Error::FrameTooShort);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, sizeof(runt), used);
+
+        uint8_t okBytes[umsg::kFrameHeaderSize] = {1, 2, 0, 4, 5, 6, 7, 8};
+        uint8_t okPacket[64];
+        umsg::ByteSpan ok{okPacket, sizeof(okPacket)};
+        UMSG_TEST_EXPECT_TRUE(ctx, tx.encode(umsg::ByteSpan{okBytes, sizeof(okBytes)}, ok) == umsg::Error::OK);
+        (void)small.feed(umsg::ByteSpan{okPacket, 5}, used); // half a packet...
+        small.reset();                                      // ...dropped
+        r = small.feed(ok, used);
+        UMSG_TEST_EXPECT_TRUE(ctx, r.complete);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, sizeof(okBytes), r.complete ? r.frame.length : 0);
+    }
 }
 
 void test_framer(umsg_test::TestContext &ctx)
 {
     test_framer_round_trip(ctx);
+    test_framer_encode_matches_reference(ctx);
     test_framer_crc_failure(ctx);
+    test_framer_block_feed(ctx);
+    test_framer_incremental_decode(ctx);
 }
@@ -8,6 +8,11 @@ void test_framer(umsg_test::TestContext &ctx);
 void test_dispatcher(umsg_test::TestContext &ctx);
 void test_node(umsg_test::TestContext &ctx);
 void test_marshal(umsg_test::TestContext &ctx);
+void test_queues(umsg_test::TestContext &ctx);
+void test_router(umsg_test::TestContext &ctx);
+#if defined(UMSG_TEST_POSIX)
+void test_posix(umsg_test::TestContext &ctx);
+#endif
 
 int main()
 {
@@ -27,6 +32,11 @@ int main()
         {"dispatcher", "Frame codec + handler dispatch", &test_dispatcher},
         {"node", "Transport integration end-to-end", &test_node},
         {"marshal", "Canonical payload Writer/Reader", &test_marshal},
+        {"queues", "Lock-free queues, RX pipeline, ISR ring", &test_queues},
+        {"router", "Cut-through forwarding between links", &test_router},
+#if defined(UMSG_TEST_POSIX)
+        {"posix", "POSIX transports over real fds", &test_posix},
+#endif
     };
 
     const size_t testCount = sizeof(tests) / sizeof(tests[0]);
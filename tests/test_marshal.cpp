@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <umsg/compress.hpp>
 #include <umsg/marshalling.hpp>
 
 namespace
@@ -99,6 +100,223 @@ namespace
         UMSG_TEST_EXPECT_TRUE(ctx, arr_r[2] == arr[2]);
     }
 
+    struct CaptureSink
+    {
+        uint8_t bytes[64];
+        size_t length;
+        size_t writes;
+        size_t failAfter;
+
+        CaptureSink() : length(0), writes(0), failAfter(~static_cast<size_t>(0)) {}
+
+        bool write(const uint8_t *data, size_t n)
+        {
+            if (writes++ >= failAfter || length + n > sizeof(bytes)) return false;
+            ::memcpy(&bytes[length], data, n);
+            length += n;
+            return true;
+        }
+    };
+
+    template <class W>
+    static bool write_sample(W &w)
+    {
+        const uint16_t arr[3] = {0x0102u, 0x0304u, 0x0506u};
+        return w.write(static_cast<uint8_t>(0xA5u)) && w.write(static_cast<uint32_t>(0x11223344u)) &&
+               w.write(true) && w.write(-1.5) && w.writeArray(arr, 3) &&
+               w.write(static_cast<int64_t>(-2));
+    }
+
+    void test_stream_writer_matches_writer(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "common: StreamWriter produces the same bytes as Writer");
+
+        uint8_t expected[64] = {0};
+        umsg::Writer w(umsg::ByteSpan{expected, sizeof(expected)});
+        UMSG_TEST_EXPECT_TRUE(ctx, write_sample(w));
+
+        CaptureSink sink;
+        umsg::StreamWriter<CaptureSink, 8> sw(sink); // small buffer: several flushes
+        UMSG_TEST_EXPECT_TRUE(ctx, write_sample(sw));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, w.bytesWritten(), sw.bytesWritten());
+        UMSG_TEST_EXPECT_TRUE(ctx, sw.flush());
+        UMSG_TEST_EXPECT_TRUE(ctx, sink.writes > 1);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, w.bytesWritten(), sink.length);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, expected, sink.bytes, sink.length);
+
+        UMSG_TEST_SECTION(ctx, "common: StreamWriter reports sink failure");
+        CaptureSink failing;
+        failing.failAfter = 1;
+        umsg::StreamWriter<CaptureSink, 8> fw(failing);
+        const bool ok = write_sample(fw) && fw.flush();
+        UMSG_TEST_EXPECT_TRUE(ctx, !ok);
+        UMSG_TEST_EXPECT_TRUE(ctx, !fw.flush());
+    }
+
+    // Bulk writeArray/readArray must match element-by-element write()/read().
+    // Arrays longer than 16 bytes cover the SIMD blocks and the scalar tail.
+    template <class T>
+    void check_array_matches_scalars(umsg_test::TestContext &ctx, const T *values, size_t count)
+    {
+        uint8_t bulk[128] = {0};
+        uint8_t scalar[128] = {0};
+        umsg::Writer wb(umsg::ByteSpan{bulk, sizeof(bulk)});
+        umsg::Writer ws(umsg::ByteSpan{scalar, sizeof(scalar)});
+        UMSG_TEST_EXPECT_TRUE(ctx, wb.writeArray(values, count));
+        for (size_t i = 0; i < count; ++i)
+        {
+            UMSG_TEST_EXPECT_TRUE(ctx, ws.write(values[i]));
+        }
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, ws.bytesWritten(), wb.bytesWritten());
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, scalar, bulk, ws.bytesWritten());
+
+        T back[16];
+        umsg::Reader r(umsg::ByteSpan{bulk, wb.bytesWritten()});
+        UMSG_TEST_EXPECT_TRUE(ctx, r.readArray(back, count));
+        UMSG_TEST_EXPECT_TRUE(ctx, r.fullyConsumed());
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, reinterpret_cast<const uint8_t *>(values),
+                                reinterpret_cast<const uint8_t *>(back), count * sizeof(T));
+    }
+
+    void test_bulk_arrays(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "common: bulk writeArray/readArray match scalar encoding (every type)");
+        const uint8_t u8[5] = {0, 1, 0x7F, 0x80, 0xFF};
+        const int8_t i8[3] = {-128, 0, 127};
+        const bool b[4] = {true, false, false, true};
+        const uint16_t u16[13] = {0x0102u, 0xFFFEu, 0, 0x8000u, 0x00FFu, 0x1234u, 0x5678u,
+                                  0x9ABCu, 0xDEF0u, 0x0F0Fu, 0xF0F0u, 0x0001u, 0x1000u};
+        const int16_t i16[3] = {-2, 32767, -32768};
+        const uint32_t u32[7] = {0x01020304u, 0xDEADBEEFu, 0, 1, 0x80000000u, 0x00FF00FFu, 0x12345678u};
+        const int32_t i32[3] = {-1, 0x7FFFFFFF, -0x7FFFFFFF - 1};
+        const float f[3] = {1.5f, -0.0f, 3.0e38f};
+        const uint64_t u64[5] = {0x0102030405060708ull, 0xFFFFFFFF00000001ull, 0, 0x8000000000000000ull,
+                                 0x1122334455667788ull};
+        const int64_t i64[2] = {-1, 0x0123456789ABCDEFll};
+        const double d[3] = {-2.25, 1e-300, 6.02214076e23};
+        check_array_matches_scalars(ctx, u8, 5);
+        check_array_matches_scalars(ctx, i8, 3);
+        check_array_matches_scalars(ctx, b, 4);
+        check_array_matches_scalars(ctx, u16, 13);
+        check_array_matches_scalars(ctx, i16, 3);
+        check_array_matches_scalars(ctx, u32, 7);
+        check_array_matches_scalars(ctx, i32, 3);
+        check_array_matches_scalars(ctx, f, 3);
+        check_array_matches_scalars(ctx, u64, 5);
+        check_array_matches_scalars(ctx, i64, 2);
+        check_array_matches_scalars(ctx, d, 3);
+
+        UMSG_TEST_SECTION(ctx, "common: writeArray/readArray overflow fails without partial progress");
+        uint8_t buf[7] = {0};
+        umsg::Writer w(umsg::ByteSpan{buf, sizeof(buf)});
+        UMSG_TEST_EXPECT_TRUE(ctx, !w.writeArray(u32, 2));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, w.bytesWritten());
+        UMSG_TEST_EXPECT_TRUE(ctx, w.writeArray(u16, 3));
+
+        uint16_t back16[4];
+        umsg::Reader r(umsg::ByteSpan{buf, 6});
+        UMSG_TEST_EXPECT_TRUE(ctx, !r.readArray(back16, 4));
+        UMSG_TEST_EXPECT_TRUE(ctx, r.readArray(back16, 3));
+        UMSG_TEST_EXPECT_TRUE(ctx, r.fullyConsumed());
+
+        UMSG_TEST_SECTION(ctx, "common: readArray<bool> rejects non-canonical bytes");
+        const uint8_t badBools[3] = {1, 0, 2};
+        bool outBools[3];
+        umsg::Reader rb(umsg::ByteSpan{const_cast<uint8_t *>(badBools), sizeof(badBools)});
+        UMSG_TEST_EXPECT_TRUE(ctx, !rb.readArray(outBools, 3));
+
+        UMSG_TEST_SECTION(ctx, "common: StreamWriter splits arrays larger than its buffer");
+        uint16_t ramp[20];
+        for (size_t i = 0; i < 20; ++i)
+        {
+            ramp[i] = static_cast<uint16_t>(0x0101u * i);
+        }
+        uint8_t expected[40];
+        umsg::Writer we(umsg::ByteSpan{expected, sizeof(expected)});
+        UMSG_TEST_EXPECT_TRUE(ctx, we.writeArray(ramp, 20));
+        CaptureSink sink;
+        umsg::StreamWriter<CaptureSink, 8> sw(sink);
+        UMSG_TEST_EXPECT_TRUE(ctx, sw.writeArray(ramp, 20) && sw.flush());
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, sizeof(expected), sink.length);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, expected, sink.bytes, sizeof(expected));
+    }
+
+    void test_varints(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "common: varint/zig-zag encodings and sizes");
+        uint8_t buf[32];
+        umsg::Writer w(umsg::ByteSpan{buf, sizeof(buf)});
+        UMSG_TEST_EXPECT_TRUE(ctx, w.writeVarint(0u));
+        UMSG_TEST_EXPECT_TRUE(ctx, w.writeVarint(127u));
+        UMSG_TEST_EXPECT_TRUE(ctx, w.writeVarint(300u));
+        UMSG_TEST_EXPECT_TRUE(ctx, w.writeZigzag(-1));
+        UMSG_TEST_EXPECT_TRUE(ctx, w.writeZigzag(64));
+        UMSG_TEST_EXPECT_TRUE(ctx, w.writeVarint(~static_cast<uint64_t>(0)));
+        const uint8_t expected[] = {0x00, 0x7F, 0xAC, 0x02, 0x01, 0x80, 0x01,
+                                    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01};
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, sizeof(expected), w.bytesWritten());
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, expected, buf, sizeof(expected));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, umsg::varint_size(127u));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, umsg::varint_size(128u));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, umsg::kMaxVarint32Size, umsg::varint_size(0xFFFFFFFFu));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, umsg::kMaxVarint64Size, umsg::varint_size(~static_cast<uint64_t>(0)));
+
+        umsg::Reader r(umsg::ByteSpan{buf, sizeof(expected)});
+        uint32_t u32 = 1;
+        uint64_t u64 = 0;
+        int32_t s32 = 0;
+        int64_t s64 = 0;
+        UMSG_TEST_EXPECT_TRUE(ctx, r.readVarint(u32) && u32 == 0u);
+        UMSG_TEST_EXPECT_TRUE(ctx, r.readVarint(u32) && u32 == 127u);
+        UMSG_TEST_EXPECT_TRUE(ctx, r.readVarint(u64) && u64 == 300u);
+        UMSG_TEST_EXPECT_TRUE(ctx, r.readZigzag(s32) && s32 == -1);
+        UMSG_TEST_EXPECT_TRUE(ctx, r.readZigzag(s64) && s64 == 64);
+        UMSG_TEST_EXPECT_TRUE(ctx, !r.readVarint(u32)); // needs 64 bits; not consumed
+        UMSG_TEST_EXPECT_TRUE(ctx, r.readVarint(u64) && u64 == ~static_cast<uint64_t>(0));
+        UMSG_TEST_EXPECT_TRUE(ctx, r.fullyConsumed());
+
+        UMSG_TEST_SECTION(ctx, "common: zig-zag round-trips the extremes");
+        const int64_t extremes[] = {0, 1, -1, INT32_MIN, INT32_MAX, INT64_MIN, INT64_MAX};
+        for (size_t i = 0; i < sizeof(extremes) / sizeof(extremes[0]); ++i)
+        {
+            UMSG_TEST_EXPECT_TRUE(ctx, umsg::zigzag_decode(umsg::zigzag_encode(extremes[i])) == extremes[i]);
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, umsg::zigzag_encode(INT32_MIN) == 0xFFFFFFFFu);
+
+        UMSG_TEST_SECTION(ctx, "common: readVarint rejects truncated, overlong and oversized encodings");
+        const uint8_t truncated[] = {0x80, 0x80};
+        const uint8_t overlong[] = {0x80, 0x00};
+        const uint8_t tooWide[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02};
+        umsg::Reader rt(umsg::ByteSpan{const_cast<uint8_t *>(truncated), sizeof(truncated)});
+        umsg::Reader ro(umsg::ByteSpan{const_cast<uint8_t *>(overlong), sizeof(overlong)});
+        umsg::Reader rw(umsg::ByteSpan{const_cast<uint8_t *>(tooWide), sizeof(tooWide)});
+        UMSG_TEST_EXPECT_TRUE(ctx, !rt.readVarint(u64));
+        UMSG_TEST_EXPECT_TRUE(ctx, !ro.readVarint(u64));
+        UMSG_TEST_EXPECT_TRUE(ctx, !rw.readVarint(u64));
+
+        UMSG_TEST_SECTION(ctx, "common: writeVarint fits exactly or fails without writing");
+        uint8_t small[2];
+        umsg::Writer ws(umsg::ByteSpan{small, sizeof(small)});
+        UMSG_TEST_EXPECT_TRUE(ctx, !ws.writeVarint(1u << 14));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, ws.bytesWritten());
+        UMSG_TEST_EXPECT_TRUE(ctx, ws.writeVarint((1u << 14) - 1u));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, ws.bytesWritten());
+
+        UMSG_TEST_SECTION(ctx, "common: StreamWriter streams 10-byte varints through an 8-byte buffer");
+        uint8_t direct[32] = {0};
+        umsg::Writer wv(umsg::ByteSpan{direct, sizeof(direct)});
+        UMSG_TEST_EXPECT_TRUE(ctx, wv.writeVarint(~static_cast<uint64_t>(0)) && wv.writeVarint(1u << 28) &&
+                                       wv.writeZigzag(INT64_MIN));
+        CaptureSink sink;
+        umsg::StreamWriter<CaptureSink, 8> sw(sink);
+        UMSG_TEST_EXPECT_TRUE(ctx, sw.writeVarint(~static_cast<uint64_t>(0)) && sw.writeVarint(1u << 28) &&
+                                       sw.writeZigzag(INT64_MIN));
+        UMSG_TEST_EXPECT_TRUE(ctx, sw.flush());
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2 * umsg::kMaxVarint64Size + 5, sink.length);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, wv.bytesWritten(), sink.length);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, direct, sink.bytes, sink.length);
+    }
+
     void test_reader_rejects_invalid_bool(umsg_test::TestContext &ctx)
     {
         UMSG_TEST_SECTION(ctx, "common: Reader rejects invalid bool");
@@ -109,6 +327,89 @@ namespace
         bool b = false;
         UMSG_TEST_EXPECT_TRUE(ctx, !r.read(b));
     }
+
+    static bool lz4_round_trip(const uint8_t *data, size_t length, uint16_t *table)
+    {
+        uint8_t packed[umsg::lz4::compressBound(1024)];
+        umsg::ByteSpan out{packed, sizeof(packed)};
+        if (!umsg::lz4::compress(umsg::ByteSpan{const_cast<uint8_t *>(data), length}, out, table, 10))
+        {
+            return false;
+        }
+        uint8_t unpacked[1024];
+        umsg::ByteSpan back{unpacked, sizeof(unpacked)};
+        return umsg::lz4::decompress(out, back) && back.length == length &&
+               (length == 0 || ::memcmp(unpacked, data, length) == 0);
+    }
+
+    void test_lz4(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "compress: LZ4 block output matches the reference encoder");
+        uint16_t table[1u << 10];
+        uint8_t input[1024];
+        ::memset(input, 'a', 40);
+        uint8_t packed[umsg::lz4::compressBound(sizeof(input))];
+        umsg::ByteSpan out{packed, sizeof(packed)};
+        UMSG_TEST_EXPECT_TRUE(ctx, umsg::lz4::compress(umsg::ByteSpan{input, 40}, out, table, 10));
+        // 1 literal, match at offset 1 of 34 (15 + 15 extra) bytes, 5 last literals.
+        const uint8_t expected[] = {0x1F, 'a', 0x01, 0x00, 0x0F, 0x50, 'a', 'a', 'a', 'a', 'a'};
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, sizeof(expected), out.length);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, expected, packed, sizeof(expected));
+
+        UMSG_TEST_SECTION(ctx, "compress: round-trips short, repetitive and incompressible inputs");
+        UMSG_TEST_EXPECT_TRUE(ctx, lz4_round_trip(input, 0, table));
+        UMSG_TEST_EXPECT_TRUE(ctx, lz4_round_trip(input, 1, table));
+        UMSG_TEST_EXPECT_TRUE(ctx, lz4_round_trip(input, 12, table));
+        UMSG_TEST_EXPECT_TRUE(ctx, lz4_round_trip(input, 13, table));
+        for (size_t i = 0; i < sizeof(input); ++i)
+        {
+            input[i] = static_cast<uint8_t>((i / 3) % 17);
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, lz4_round_trip(input, sizeof(input), table));
+        uint32_t lcg = 1u;
+        for (size_t i = 0; i < sizeof(input); ++i)
+        {
+            lcg = lcg * 1103515245u + 12345u;
+            input[i] = static_cast<uint8_t>(lcg >> 24);
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, lz4_round_trip(input, sizeof(input), table)); // literal runs > 270 bytes
+        ::memcpy(&input[600], &input[10], 300);
+        UMSG_TEST_EXPECT_TRUE(ctx, lz4_round_trip(input, sizeof(input), table)); // long match, stale table
+
+        UMSG_TEST_SECTION(ctx, "compress: compress() fails when the output does not fit");
+        out = umsg::ByteSpan{packed, 100};
+        UMSG_TEST_EXPECT_TRUE(ctx, !umsg::lz4::compress(umsg::ByteSpan{input, 200}, out, table, 10));
+        umsg::Compression<256> buffers;
+        out = umsg::ByteSpan{packed, sizeof(packed)};
+        UMSG_TEST_EXPECT_TRUE(ctx, !buffers.compress(umsg::ByteSpan{input, 200}, out)); // not smaller
+        UMSG_TEST_EXPECT_TRUE(ctx, !buffers.compress(umsg::ByteSpan{input, 0}, out));
+
+        UMSG_TEST_SECTION(ctx, "compress: decompress() rejects malformed blocks and output overflow");
+        uint8_t unpacked[16];
+        const uint8_t valid[] = {0x11, 'a', 0x01, 0x00, 0x50, 'b', 'b', 'b', 'b', 'b'};
+        umsg::ByteSpan back{unpacked, sizeof(unpacked)};
+        UMSG_TEST_EXPECT_TRUE(ctx, umsg::lz4::decompress(umsg::ByteSpan{const_cast<uint8_t *>(valid), sizeof(valid)}, back));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 11, back.length);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, "aaaaaabbbbb", unpacked, 11);
+        back = umsg::ByteSpan{unpacked, 10};
+        UMSG_TEST_EXPECT_TRUE(ctx, !umsg::lz4::decompress(umsg::ByteSpan{const_cast<uint8_t *>(valid), sizeof(valid)}, back));
+
+        const uint8_t zeroOffset[] = {0x10, 'a', 0x00, 0x00};
+        const uint8_t farOffset[] = {0x10, 'a', 0x02, 0x00};
+        const uint8_t shortLiterals[] = {0x30, 'a'};
+        const uint8_t shortOffset[] = {0x10, 'a', 0x01};
+        const uint8_t shortLength[] = {0xF0, 0xFF};
+        const uint8_t *const bad[] = {zeroOffset, farOffset, shortLiterals, shortOffset, shortLength};
+        const size_t badLength[] = {sizeof(zeroOffset), sizeof(farOffset), sizeof(shortLiterals), sizeof(shortOffset),
+                                    sizeof(shortLength)};
+        for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i)
+        {
+            back = umsg::ByteSpan{unpacked, sizeof(unpacked)};
+            UMSG_TEST_EXPECT_TRUE(ctx, !umsg::lz4::decompress(umsg::ByteSpan{const_cast<uint8_t *>(bad[i]), badLength[i]}, back));
+        }
+        back = umsg::ByteSpan{unpacked, sizeof(unpacked)};
+        UMSG_TEST_EXPECT_TRUE(ctx, !umsg::lz4::decompress(umsg::ByteSpan{unpacked, 0}, back));
+    }
 }
 
 void test_marshal(umsg_test::TestContext &ctx)
@@ -116,4 +417,8 @@ void test_marshal(umsg_test::TestContext &ctx)
     test_endian_u64(ctx);
     test_writer_reader_roundtrip(ctx);
     test_reader_rejects_invalid_bool(ctx);
+    test_varints(ctx);
+    test_stream_writer_matches_writer(ctx);
+    test_bulk_arrays(ctx);
+    test_lz4(ctx);
 }
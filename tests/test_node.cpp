@@ -4,8 +4,18 @@
 #include <stdint.h>
 #include <string.h>
 
+#if UMSG_ENABLE_STATS
+// Test clock for maxPollUs; handlers advance it.
+extern uint32_t g_test_clock_us;
+#define UMSG_STATS_NOW_US() g_test_clock_us
+#endif
+
 #include <umsg/umsg.h>
 
+#include "messages/Compact.hpp"
+#include "messages/Telemetry.hpp"
+#include "messages/TestMessages.hpp"
+
 namespace
 {
     template <size_t Capacity>
@@ -89,6 +99,51 @@ namespace
         }
     };
 
+    // Endpoint exposing the optional bulk read; hands out at most kMaxChunk bytes
+    // per call so frames straddle read() boundaries.
+    template <size_t Capacity>
+    struct BulkEndpoint
+    {
+        static const size_t kMaxChunk = 5;
+
+        Ring<Capacity> *in;
+        Ring<Capacity> *out;
+        size_t bulkReads;
+
+        bool read(uint8_t &byte)
+        {
+            return in->pop(byte);
+        }
+
+        bool read(uint8_t *data, size_t capacity, size_t &length)
+        {
+            length = 0;
+            const size_t limit = capacity < kMaxChunk ? capacity : kMaxChunk;
+            while (length < limit && in->pop(data[length]))
+            {
+                ++length;
+            }
+            if (length == 0)
+            {
+                return false;
+            }
+            ++bulkReads;
+            return true;
+        }
+
+        bool write(const uint8_t *data, size_t length)
+        {
+            for (size_t i = 0; i < length; ++i)
+            {
+                if (!out->push(data[i]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
     struct Sink
     {
         bool called;
@@ -115,6 +170,92 @@ namespace
         }
     };
 
+    struct BlobMsg
+    {
+        static const uint32_t kMsgHash = 0x0B10B000u;
+        static const size_t kPayloadSize = 600;
+        uint8_t bytes[kPayloadSize];
+
+        bool encode(umsg::ByteSpan &payload) const
+        {
+            umsg::Writer w(payload);
+            if (!w.writeArray(bytes, kPayloadSize)) return false;
+            payload.length = w.bytesWritten();
+            return true;
+        }
+
+        bool decode(umsg::ByteSpan payload)
+        {
+            umsg::Reader r(payload);
+            return r.readArray(bytes, kPayloadSize);
+        }
+    };
+
+    // Same wire format as BlobMsg, but exposes encodeTo()/encodedSize() like
+    // umsg-gen output, so publish() streams it instead of staging it.
+    struct StreamedBlobMsg : BlobMsg
+    {
+        size_t declaredSize;
+
+        StreamedBlobMsg() : declaredSize(kPayloadSize) {}
+
+        template <class W>
+        bool encodeTo(W &w) const { return w.writeArray(bytes, kPayloadSize); }
+
+        size_t encodedSize() const { return declaredSize; }
+    };
+
+    struct BlobReceiver
+    {
+        size_t calls;
+        BlobMsg last;
+
+        BlobReceiver() : calls(0) {}
+
+        umsg::Error onBlob(const BlobMsg &msg)
+        {
+            ++calls;
+            last = msg;
+            return umsg::Error::OK;
+        }
+    };
+
+    void test_node_typed_publish_in_place(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "node: typed publish() at MaxPayloadSize round-trips (in-place packet encode)");
+        typedef DuplexLink<2048> Link;
+        Link link;
+        Link::Endpoint a = link.endpointA();
+        Link::Endpoint b = link.endpointB();
+
+        umsg::Node<Link::Endpoint, BlobMsg::kPayloadSize, 2> nodeA(a, 1);
+        umsg::Node<Link::Endpoint, BlobMsg::kPayloadSize, 2> nodeB(b, 1);
+
+        BlobReceiver recv;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeB.subscribe(4, &recv, &BlobReceiver::onBlob) == umsg::Error::OK);
+
+        // Long zero-free runs (forces 0xFF COBS blocks), then sprinkled zeros.
+        BlobMsg msg;
+        for (size_t i = 0; i < BlobMsg::kPayloadSize; ++i)
+        {
+            msg.bytes[i] = (i > 400 && i % 9 == 0) ? 0u : static_cast<uint8_t>((i % 250) + 1);
+        }
+
+        for (size_t round = 0; round < 2; ++round)
+        {
+            UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(4, msg) == umsg::Error::OK);
+            (void)nodeB.poll();
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, round + 1, recv.calls);
+            UMSG_TEST_EXPECT_BUF_EQ(ctx, msg.bytes, recv.last.bytes, BlobMsg::kPayloadSize);
+            msg.bytes[0] = 0; // second round: zero right after the header
+        }
+
+        UMSG_TEST_SECTION(ctx, "node: raw publish() rejects payloads above MaxPayloadSize");
+        uint8_t tooBig[BlobMsg::kPayloadSize + 1] = {0};
+        UMSG_TEST_EXPECT_TRUE(ctx,
+            nodeA.publish(4, BlobMsg::kMsgHash, umsg::ByteSpan{tooBig, sizeof(tooBig)}) == umsg::Error::InvalidArgument);
+    }
+
     void test_node_end_to_end(umsg_test::TestContext &ctx)
     {
         UMSG_TEST_SECTION(ctx, "node: publish() on A -> poll() on B -> handler called with payload+hash");
@@ -140,9 +281,1198 @@ namespace
         UMSG_TEST_EXPECT_EQ_SIZE(ctx, sizeof(payloadBytes), sink.payloadLen);
         UMSG_TEST_EXPECT_BUF_EQ(ctx, payloadBytes, sink.payload, sink.payloadLen);
     }
+
+    void test_node_static_dispatcher(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "node: BasicNode with a StaticDispatcher routes by msg_id");
+        DuplexLink<1024> link;
+        DuplexLink<1024>::Endpoint a = link.endpointA();
+        DuplexLink<1024>::Endpoint b = link.endpointB();
+
+        typedef umsg::StaticDispatcher<Sink, UMSG_ROUTE(9, &Sink::onPayload)> SinkRoutes;
+        umsg::Node<DuplexLink<1024>::Endpoint, 32, 4> nodeA(a, 1);
+        umsg::BasicNode<DuplexLink<1024>::Endpoint, 32, SinkRoutes> nodeB(b, 1);
+
+        Sink sink;
+        nodeB.dispatcher().bind(&sink);
+
+        uint8_t payloadBytes[2] = {0x00, 0x7F};
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(8, 0x1u, umsg::ByteSpan{payloadBytes, sizeof(payloadBytes)}) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(9, 0x2u, umsg::ByteSpan{payloadBytes, sizeof(payloadBytes)}) == umsg::Error::OK);
+        (void)nodeB.poll();
+
+        UMSG_TEST_EXPECT_TRUE(ctx, sink.called);
+        UMSG_TEST_EXPECT_EQ_U32(ctx, 0x2u, sink.hash);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, payloadBytes, sink.payload, sink.payloadLen);
+    }
+
+    void test_node_bulk_read(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "node: poll() uses bulk read() when the transport provides it");
+        UMSG_TEST_EXPECT_TRUE(ctx, umsg::detail::HasBulkRead<BulkEndpoint<1024> >::value);
+        UMSG_TEST_EXPECT_TRUE(ctx, !umsg::detail::HasBulkRead<DuplexLink<1024>::Endpoint>::value);
+
+        Ring<1024> a2b;
+        Ring<1024> b2a;
+        BulkEndpoint<1024> a = {&b2a, &a2b, 0};
+        BulkEndpoint<1024> b = {&a2b, &b2a, 0};
+
+        umsg::Node<BulkEndpoint<1024>, 32, 4> nodeA(a, 1);
+        umsg::Node<BulkEndpoint<1024>, 32, 4> nodeB(b, 1);
+
+        Sink sink;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeB.subscribe(3, &sink, &Sink::onPayload) == umsg::Error::OK);
+
+        uint8_t payloadBytes[12] = {1, 0, 2, 0, 3, 4, 5, 6, 7, 8, 9, 0};
+        UMSG_TEST_EXPECT_TRUE(ctx,
+            nodeA.publish(3, 0x01020304u, umsg::ByteSpan{payloadBytes, sizeof(payloadBytes)}) == umsg::Error::OK);
+        const size_t queued = a2b.count;
+
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, queued, nodeB.poll());
+        UMSG_TEST_EXPECT_TRUE(ctx, b.bulkReads > 1);
+        UMSG_TEST_EXPECT_TRUE(ctx, sink.called);
+        UMSG_TEST_EXPECT_EQ_U32(ctx, 0x01020304u, sink.hash);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, sizeof(payloadBytes), sink.payloadLen);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, payloadBytes, sink.payload, sink.payloadLen);
+    }
+}
+
+namespace
+{
+    void test_node_typed_publish_streamed(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "node: typed publish() streams encodeTo() messages");
+        UMSG_TEST_EXPECT_TRUE(ctx,
+            (umsg::detail::HasEncodeTo<StreamedBlobMsg, umsg::StreamWriter<umsg::detail::PacketEncoder> >::value));
+        UMSG_TEST_EXPECT_TRUE(ctx,
+            (!umsg::detail::HasEncodeTo<BlobMsg, umsg::StreamWriter<umsg::detail::PacketEncoder> >::value));
+
+        typedef DuplexLink<2048> Link;
+        Link link;
+        Link::Endpoint a = link.endpointA();
+        Link::Endpoint b = link.endpointB();
+
+        umsg::Node<Link::Endpoint, BlobMsg::kPayloadSize, 2> nodeA(a, 1);
+        umsg::Node<Link::Endpoint, BlobMsg::kPayloadSize, 2> nodeB(b, 1);
+
+        BlobReceiver recv;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeB.subscribe(4, &recv, &BlobReceiver::onBlob) == umsg::Error::OK);
+
+        StreamedBlobMsg msg;
+        for (size_t i = 0; i < BlobMsg::kPayloadSize; ++i)
+        {
+            msg.bytes[i] = (i % 7 == 0) ? 0u : static_cast<uint8_t>(i * 31u);
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(4, msg) == umsg::Error::OK);
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, recv.calls);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, msg.bytes, recv.last.bytes, BlobMsg::kPayloadSize);
+
+        UMSG_TEST_SECTION(ctx, "node: streamed publish() rejects encodedSize() mismatch");
+        msg.declaredSize = BlobMsg::kPayloadSize - 1;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(4, msg) == umsg::Error::InvalidArgument);
+        msg.declaredSize = BlobMsg::kPayloadSize + 1;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(4, msg) == umsg::Error::InvalidArgument);
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, recv.calls);
+    }
+}
+
+namespace
+{
+    struct TelemetryViewReceiver
+    {
+        size_t calls;
+        bool fieldsMatch;
+        Telemetry expected;
+
+        TelemetryViewReceiver() : calls(0), fieldsMatch(false) {}
+
+        umsg::Error onView(const TelemetryView &v)
+        {
+            ++calls;
+            const Telemetry &e = expected;
+            fieldsMatch = v.mode() == e.mode && v.trim() == e.trim && v.armed() == e.armed &&
+                          v.seq() == e.seq && v.offset() == e.offset && v.flags() == e.flags &&
+                          v.position() == e.position && v.timestamp_us() == e.timestamp_us &&
+                          v.drift_ns() == e.drift_ns && v.voltage() == e.voltage &&
+                          v.latitude() == e.latitude;
+            for (size_t i = 0; i < 4; ++i)
+            {
+                fieldsMatch = fieldsMatch && v.samples(i) == e.samples[i];
+            }
+            for (size_t i = 0; i < 3; ++i)
+            {
+                fieldsMatch = fieldsMatch && v.faults(i) == e.faults[i];
+            }
+            return umsg::Error::OK;
+        }
+    };
+
+    void test_node_generated_view(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "node: generated View handler reads fields in place");
+        typedef DuplexLink<1024> Link;
+        Link link;
+        Link::Endpoint a = link.endpointA();
+        Link::Endpoint b = link.endpointB();
+
+        umsg::Node<Link::Endpoint, 64, 2> nodeA(a, 1);
+        umsg::Node<Link::Endpoint, 64, 2> nodeB(b, 1);
+
+        TelemetryViewReceiver recv;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeB.subscribe(6, &recv, &TelemetryViewReceiver::onView) == umsg::Error::OK);
+
+        Telemetry &t = recv.expected;
+        t.mode = 0xFE;
+        t.trim = -3;
+        t.armed = true;
+        t.seq = 0xBEEF;
+        t.offset = -12345;
+        t.flags = 0x80000001u;
+        t.position = -2000000000;
+        t.timestamp_us = 0x0102030405060708ull;
+        t.drift_ns = -42;
+        t.voltage = 11.75f;
+        t.latitude = -33.8688;
+        const int16_t samples[4] = {1, -1, 32767, -32768};
+        ::memcpy(t.samples, samples, sizeof(samples));
+        t.faults[0] = false;
+        t.faults[1] = true;
+        t.faults[2] = false;
+
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(6, t) == umsg::Error::OK);
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, recv.calls);
+        UMSG_TEST_EXPECT_TRUE(ctx, recv.fieldsMatch);
+
+        UMSG_TEST_SECTION(ctx, "node: View decode rejects non-canonical bools and short payloads");
+        uint8_t payload[Telemetry::kPayloadSize];
+        umsg::ByteSpan encoded{payload, sizeof(payload)};
+        UMSG_TEST_EXPECT_TRUE(ctx, t.encode(encoded));
+        payload[52] = 2; // faults[1]
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(6, Telemetry::kMsgHash, encoded) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx,
+            nodeA.publish(6, Telemetry::kMsgHash, umsg::ByteSpan{payload, sizeof(payload) - 1}) == umsg::Error::OK);
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, recv.calls);
+    }
+}
+
+namespace
+{
+    void test_node_generated_fixed_codec(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "node: generated constant-offset encode/decode matches the Writer path");
+        UMSG_TEST_EXPECT_TRUE(ctx, umsg::detail::HasEncodeUnchecked<Telemetry>::value);
+        UMSG_TEST_EXPECT_TRUE(ctx, !umsg::detail::HasEncodeUnchecked<Compact>::value);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, Telemetry::Offset::mode);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 51, Telemetry::Offset::faults);
+
+        Telemetry t;
+        ::memset(&t, 0, sizeof(t));
+        t.mode = 0x81;
+        t.trim = -7;
+        t.armed = true;
+        t.seq = 0x1234;
+        t.offset = -2;
+        t.flags = 0xDEADBEEFu;
+        t.position = -123456;
+        t.timestamp_us = 0x1122334455667788ull;
+        t.drift_ns = INT64_MIN;
+        t.voltage = -0.5f;
+        t.latitude = 51.5;
+        t.samples[3] = -32768;
+        t.faults[2] = true;
+
+        uint8_t streamed[Telemetry::kPayloadSize];
+        umsg::Writer w(umsg::ByteSpan{streamed, sizeof(streamed)});
+        UMSG_TEST_EXPECT_TRUE(ctx, t.encodeTo(w));
+        uint8_t fixed[Telemetry::kPayloadSize + 1];
+        umsg::ByteSpan encoded{fixed, sizeof(fixed)};
+        UMSG_TEST_EXPECT_TRUE(ctx, t.encode(encoded));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, Telemetry::kPayloadSize, encoded.length);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, streamed, fixed, sizeof(streamed));
+
+        Telemetry back;
+        UMSG_TEST_EXPECT_TRUE(ctx, back.decode(encoded));
+        UMSG_TEST_EXPECT_TRUE(ctx, back.mode == t.mode && back.trim == t.trim && back.armed && back.seq == t.seq &&
+                                       back.offset == t.offset && back.flags == t.flags &&
+                                       back.position == t.position && back.timestamp_us == t.timestamp_us &&
+                                       back.drift_ns == t.drift_ns && back.voltage == t.voltage &&
+                                       back.latitude == t.latitude && back.samples[3] == -32768 && back.faults[2]);
+
+        UMSG_TEST_SECTION(ctx, "node: constant-offset codec checks capacity, length and bools once");
+        umsg::ByteSpan small{fixed, Telemetry::kPayloadSize - 1};
+        UMSG_TEST_EXPECT_TRUE(ctx, !t.encode(small));
+        UMSG_TEST_EXPECT_TRUE(ctx, !back.decode(small));
+        UMSG_TEST_EXPECT_TRUE(ctx, !back.decode(umsg::ByteSpan{0, Telemetry::kPayloadSize}));
+        fixed[Telemetry::Offset::armed] = 2;
+        UMSG_TEST_EXPECT_TRUE(ctx, !back.decode(encoded));
+        fixed[Telemetry::Offset::armed] = 1;
+        fixed[Telemetry::Offset::faults + 1] = 0xFF;
+        UMSG_TEST_EXPECT_TRUE(ctx, !back.decode(encoded));
+    }
+}
+
+namespace
+{
+    struct CompactReceiver
+    {
+        size_t calls;
+        size_t payloadLength;
+        Compact last;
+
+        CompactReceiver() : calls(0), payloadLength(0) {}
+
+        umsg::Error onCompact(const Compact &msg)
+        {
+            ++calls;
+            last = msg;
+            return umsg::Error::OK;
+        }
+
+        umsg::Error onPayload(umsg::ByteSpan p, uint32_t)
+        {
+            payloadLength = p.length;
+            return umsg::Error::OK;
+        }
+    };
+
+    void test_node_generated_compact(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "node: generated varints and bounded arrays round-trip");
+        typedef DuplexLink<1024> Link;
+        Link link;
+        Link::Endpoint a = link.endpointA();
+        Link::Endpoint b = link.endpointB();
+
+        umsg::Node<Link::Endpoint, Compact::kPayloadSize, 2> nodeA(a, 1);
+        umsg::Node<Link::Endpoint, Compact::kPayloadSize, 2> nodeB(b, 1);
+
+        CompactReceiver recv;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeB.subscribe(7, &recv, &CompactReceiver::onCompact) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeB.subscribe(8, &recv, &CompactReceiver::onPayload) == umsg::Error::OK);
+
+        Compact m;
+        ::memset(&m, 0, sizeof(m));
+        m.seq = 300;
+        m.offset = -2;
+        m.timestamp_us = 0x0102030405060708ull;
+        m.drift_ns = INT64_MIN;
+        m.mode = 5;
+        m.samples_count = 3;
+        m.samples[0] = 1.5f;
+        m.samples[1] = -2.25f;
+        m.samples[2] = 1e9f;
+        m.deltas_count = 2;
+        m.deltas[0] = -64;
+        m.deltas[1] = INT32_MAX;
+        m.faults_count = 1;
+        m.faults[0] = true;
+        m.ids[0] = 0;
+        m.ids[1] = 0xFFFFFFFFu;
+
+        // 2 + 1 + 9 + 10 + 1 + (1 + 12) + (1 + 1 + 5) + (1 + 1) + (1 + 5)
+        const size_t expectedSize = 51;
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, expectedSize, m.encodedSize());
+        UMSG_TEST_EXPECT_TRUE(ctx, expectedSize < Compact::kPayloadSize);
+
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(7, m) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(8, m) == umsg::Error::OK);
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, recv.calls);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, expectedSize, recv.payloadLength);
+        const Compact &r = recv.last;
+        UMSG_TEST_EXPECT_TRUE(ctx, r.seq == m.seq && r.offset == m.offset && r.timestamp_us == m.timestamp_us &&
+                                       r.drift_ns == m.drift_ns && r.mode == m.mode);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 3, r.samples_count);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, m.samples, r.samples, 3 * sizeof(float));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, r.deltas_count);
+        UMSG_TEST_EXPECT_TRUE(ctx, r.deltas[0] == -64 && r.deltas[1] == INT32_MAX);
+        UMSG_TEST_EXPECT_TRUE(ctx, r.faults_count == 1 && r.faults[0]);
+        UMSG_TEST_EXPECT_TRUE(ctx, r.ids[0] == 0 && r.ids[1] == 0xFFFFFFFFu);
+
+        UMSG_TEST_SECTION(ctx, "node: bounded arrays reject counts above their bound");
+        uint8_t payload[Compact::kPayloadSize];
+        umsg::ByteSpan encoded{payload, sizeof(payload)};
+        UMSG_TEST_EXPECT_TRUE(ctx, m.encode(encoded));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, expectedSize, encoded.length);
+        Compact back;
+        UMSG_TEST_EXPECT_TRUE(ctx, back.decode(encoded));
+        UMSG_TEST_EXPECT_TRUE(ctx, !back.decode(umsg::ByteSpan{payload, encoded.length - 1}));
+        payload[23] = 17; // samples_count
+        UMSG_TEST_EXPECT_TRUE(ctx, !back.decode(encoded));
+        payload[23] = 3;
+
+        m.samples_count = 17;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(7, m) != umsg::Error::OK);
+        encoded.length = sizeof(payload);
+        UMSG_TEST_EXPECT_TRUE(ctx, !m.encode(encoded));
+    }
+}
+
+namespace
+{
+    struct RegistryReceiver
+    {
+        size_t telemetry;
+        size_t compact;
+
+        RegistryReceiver() : telemetry(0), compact(0) {}
+
+        umsg::Error onTelemetry(const TelemetryView &)
+        {
+            ++telemetry;
+            return umsg::Error::OK;
+        }
+
+        umsg::Error onCompact(const Compact &)
+        {
+            ++compact;
+            return umsg::Error::OK;
+        }
+    };
+
+    void test_node_generated_registry(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "node: generated registry sizes the node and routes by message type");
+        static_assert(TestMessages::kCount == 2, "two messages in the test package");
+        static_assert(TestMessages::kMaxPayloadSize ==
+                          (Telemetry::kPayloadSize > Compact::kPayloadSize ? Telemetry::kPayloadSize
+                                                                           : Compact::kPayloadSize),
+                      "registry payload size is the package maximum");
+        const size_t telemetryId = umsg::MessageId<TestMessages, Telemetry>::value;
+        const size_t viewId = umsg::MessageId<TestMessages, TelemetryView>::value;
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 6, telemetryId);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, TestMessages::kTelemetryId, viewId);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, TestMessages::kCompactId, TestMessages::IdOf<Compact>::value);
+
+        typedef DuplexLink<1024> Link;
+        Link link;
+        Link::Endpoint a = link.endpointA();
+        Link::Endpoint b = link.endpointB();
+
+        typedef umsg::StaticDispatcher<RegistryReceiver,
+            UMSG_REGISTRY_ROUTE(TestMessages, &RegistryReceiver::onTelemetry),
+            UMSG_REGISTRY_ROUTE(TestMessages, &RegistryReceiver::onCompact)> Routes;
+        umsg::Node<Link::Endpoint, TestMessages::kMaxPayloadSize, TestMessages::kCount> nodeA(a, 1);
+        umsg::BasicNode<Link::Endpoint, TestMessages::kMaxPayloadSize, Routes> nodeB(b, 1);
+
+        RegistryReceiver recv;
+        nodeB.dispatcher().bind(&recv);
+
+        Telemetry t;
+        ::memset(&t, 0, sizeof(t));
+        Compact c;
+        ::memset(&c, 0, sizeof(c));
+        c.samples_count = 16;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(TestMessages::kTelemetryId, t) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(TestMessages::kCompactId, c) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(TestMessages::kCompactId, t) == umsg::Error::OK);
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, recv.telemetry);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, recv.compact);
+    }
+}
+
+namespace
+{
+    struct SequenceSink
+    {
+        uint8_t seen[16];
+        size_t count;
+
+        SequenceSink() : count(0) {}
+
+        umsg::Error onPayload(umsg::ByteSpan p, uint32_t)
+        {
+            if (count < sizeof(seen) && p.length > 0)
+            {
+                seen[count++] = p.data[0];
+            }
+            return umsg::Error::OK;
+        }
+    };
+
+    struct FakeClock
+    {
+        uint32_t *now;
+        uint32_t step; // advance per reading
+
+        uint32_t operator()() const
+        {
+            *now += step;
+            return *now;
+        }
+    };
+
+    template <class Endpoint>
+    void check_bounded_poll(umsg_test::TestContext &ctx, Endpoint &tx, Endpoint &rx)
+    {
+        umsg::Node<Endpoint, 16, 2> nodeA(tx, 1);
+        umsg::Node<Endpoint, 16, 2> nodeB(rx, 1);
+        SequenceSink sink;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeB.subscribe(1, &sink, &SequenceSink::onPayload) == umsg::Error::OK);
+
+        uint8_t payload[4] = {0, 0xAA, 0x00, 0xBB};
+        size_t packetBytes = 0;
+        for (uint8_t i = 0; i < 8; ++i)
+        {
+            payload[0] = i;
+            UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(1, 0u, umsg::ByteSpan{payload, sizeof(payload)}) == umsg::Error::OK);
+        }
+        packetBytes = rx.in->count;
+        const size_t perPacket = packetBytes / 8;
+
+        // Frame budget: exactly two frames, the rest stays queued (in the ring or the node).
+        (void)nodeB.pollFrames(2);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, sink.count);
+        (void)nodeB.pollFrames(1);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 3, sink.count);
+
+        // Byte budget: never takes more than asked from the transport.
+        const size_t before = rx.in->count;
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 3, nodeB.poll(3));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, before - 3, rx.in->count);
+
+        // Time budget: each clock reading advances 10 units, budget 25 -> stops early.
+        uint32_t now = 0;
+        FakeClock clock = {&now, 10};
+        (void)nodeB.pollFor(static_cast<uint32_t>(25), clock);
+        UMSG_TEST_EXPECT_TRUE(ctx, sink.count < 8);
+
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 8, sink.count);
+        bool inOrder = true;
+        for (size_t i = 0; i < sink.count; ++i)
+        {
+            inOrder = inOrder && sink.seen[i] == i;
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, inOrder);
+        UMSG_TEST_EXPECT_TRUE(ctx, perPacket > 3);
+    }
+
+    void test_node_bounded_poll(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "node: pollFrames/poll(maxBytes)/pollFor resume in order (byte transport)");
+        DuplexLink<1024> link;
+        DuplexLink<1024>::Endpoint a = link.endpointA();
+        DuplexLink<1024>::Endpoint b = link.endpointB();
+        check_bounded_poll(ctx, a, b);
+
+        UMSG_TEST_SECTION(ctx, "node: pollFrames/poll(maxBytes)/pollFor resume in order (bulk transport)");
+        Ring<1024> a2b;
+        Ring<1024> b2a;
+        BulkEndpoint<1024> ba = {&b2a, &a2b, 0};
+        BulkEndpoint<1024> bb = {&a2b, &b2a, 0};
+        check_bounded_poll(ctx, ba, bb);
+    }
+}
+
+namespace
+{
+    // Counts write() calls on top of a DuplexLink endpoint.
+    struct WriteCountingEndpoint
+    {
+        DuplexLink<4096>::Endpoint link;
+        size_t writes;
+
+        bool read(uint8_t &byte) { return link.read(byte); }
+
+        bool write(const uint8_t *data, size_t length)
+        {
+            ++writes;
+            return link.write(data, length);
+        }
+    };
+
+    // WriteCountingEndpoint plus the optional gather write.
+    struct GatherEndpoint : WriteCountingEndpoint
+    {
+        size_t gathers;
+
+        using WriteCountingEndpoint::write;
+
+        bool write(const umsg::ByteSpan *parts, size_t count)
+        {
+            ++gathers;
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!link.write(parts[i].data, parts[i].length))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    // Records the first payload byte of every frame, in arrival order.
+    struct OrderSink
+    {
+        uint8_t seen[32];
+        size_t calls;
+
+        OrderSink() : calls(0) {}
+
+        umsg::Error onPayload(umsg::ByteSpan p, uint32_t)
+        {
+            if (calls < sizeof(seen) && p.length)
+            {
+                seen[calls] = p.data[0];
+            }
+            ++calls;
+            return umsg::Error::OK;
+        }
+    };
+
+    void test_node_tx_batch(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "node: publish() inside a batch queues packets; flush() writes them at once");
+        DuplexLink<4096> link;
+        WriteCountingEndpoint a = {link.endpointA(), 0};
+        DuplexLink<4096>::Endpoint b = link.endpointB();
+
+        umsg::Node<WriteCountingEndpoint, 32, 2> nodeA(a, 1);
+        umsg::Node<DuplexLink<4096>::Endpoint, 32, 2> nodeB(b, 1);
+        OrderSink sink;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeB.subscribe(2, &sink, &OrderSink::onPayload) == umsg::Error::OK);
+
+        uint8_t payload[20] = {0};
+        umsg::TxBatch<128> batch;
+        nodeA.beginBatch(batch);
+        for (uint8_t i = 0; i < 3; ++i)
+        {
+            payload[0] = i;
+            UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(2, 0u, umsg::ByteSpan{payload, 4}) == umsg::Error::OK);
+        }
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, a.writes);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 3, batch.packets());
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.flush() == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, a.writes);
+        UMSG_TEST_EXPECT_TRUE(ctx, batch.empty());
+#if UMSG_ENABLE_STATS
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 3, nodeA.stats().framesOut);
+#endif
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.flush() == umsg::Error::OK); // nothing queued: no write
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, a.writes);
+
+        UMSG_TEST_SECTION(ctx, "node: a full batch auto-flushes; packets arrive complete and in order");
+        a.writes = 0;
+        for (uint8_t i = 3; i < 13; ++i)
+        {
+            payload[0] = i;
+            UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(2, 0u, umsg::ByteSpan{payload, sizeof(payload)}) == umsg::Error::OK);
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, a.writes > 0 && a.writes < 10);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.endBatch() == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, batch.empty());
+
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 13, sink.calls);
+        bool ordered = true;
+        for (size_t i = 0; i < 13; ++i)
+        {
+            ordered = ordered && sink.seen[i] == i;
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, ordered);
+
+        UMSG_TEST_SECTION(ctx, "node: after endBatch() (or with a too-small batch) each publish() writes");
+        a.writes = 0;
+        payload[0] = 13;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(2, 0u, umsg::ByteSpan{payload, 4}) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, a.writes);
+        umsg::TxBatch<16> tiny;
+        nodeA.beginBatch(tiny);
+        payload[0] = 14;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(2, 0u, umsg::ByteSpan{payload, sizeof(payload)}) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, a.writes);
+        UMSG_TEST_EXPECT_TRUE(ctx, tiny.empty());
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.endBatch() == umsg::Error::OK);
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 15, sink.calls);
+
+        UMSG_TEST_SECTION(ctx, "node: auto-flush on a gather-write transport sends batch + packet in one call");
+        UMSG_TEST_EXPECT_TRUE(ctx, umsg::detail::HasGatherWrite<GatherEndpoint>::value);
+        UMSG_TEST_EXPECT_TRUE(ctx, !umsg::detail::HasGatherWrite<WriteCountingEndpoint>::value);
+        GatherEndpoint g;
+        g.link = link.endpointA();
+        g.writes = 0;
+        g.gathers = 0;
+        umsg::Node<GatherEndpoint, 32, 2> nodeG(g, 1);
+        nodeG.beginBatch(batch);
+        for (uint8_t i = 15; i < 25; ++i)
+        {
+            payload[0] = i;
+            UMSG_TEST_EXPECT_TRUE(ctx, nodeG.publish(2, 0u, umsg::ByteSpan{payload, sizeof(payload)}) == umsg::Error::OK);
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, g.gathers > 0);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, g.writes);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeG.endBatch() == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, g.writes);
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 25, sink.calls);
+        ordered = true;
+        for (size_t i = 0; i < 25; ++i)
+        {
+            ordered = ordered && sink.seen[i] == i;
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, ordered);
+
+        UMSG_TEST_SECTION(ctx, "node: typed publish() (streamed and staged) into a batch round-trips");
+        DuplexLink<4096> blobLink;
+        WriteCountingEndpoint ba = {blobLink.endpointA(), 0};
+        DuplexLink<4096>::Endpoint bb = blobLink.endpointB();
+        umsg::Node<WriteCountingEndpoint, BlobMsg::kPayloadSize, 2> blobA(ba, 1);
+        umsg::Node<DuplexLink<4096>::Endpoint, BlobMsg::kPayloadSize, 2> blobB(bb, 1);
+        BlobReceiver recv;
+        UMSG_TEST_EXPECT_TRUE(ctx, blobB.subscribe(4, &recv, &BlobReceiver::onBlob) == umsg::Error::OK);
+
+        StreamedBlobMsg streamed;
+        BlobMsg staged;
+        for (size_t i = 0; i < BlobMsg::kPayloadSize; ++i)
+        {
+            streamed.bytes[i] = static_cast<uint8_t>(i % 7);
+            staged.bytes[i] = static_cast<uint8_t>(i % 5);
+        }
+        umsg::TxBatch<1400> big;
+        blobA.beginBatch(big);
+        UMSG_TEST_EXPECT_TRUE(ctx, blobA.publish(4, streamed) == umsg::Error::OK); // encoded in place
+        UMSG_TEST_EXPECT_TRUE(ctx, blobA.publish(4, staged) == umsg::Error::OK);   // copied in
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, big.packets());
+        UMSG_TEST_EXPECT_TRUE(ctx, blobA.endBatch() == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, ba.writes);
+        (void)blobB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, recv.calls);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, staged.bytes, recv.last.bytes, BlobMsg::kPayloadSize);
+    }
+
+    // WriteCountingEndpoint that reports a backed-up TX queue while `busy`.
+    struct BusyEndpoint : WriteCountingEndpoint
+    {
+        bool busy;
+
+        bool wantsWrite() const { return busy; }
+    };
+
+    void test_node_conflation(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "node: publishLatest() keeps the newest packet per msg_id until flushLatest()");
+        DuplexLink<4096> link;
+        WriteCountingEndpoint a = {link.endpointA(), 0};
+        DuplexLink<4096>::Endpoint b = link.endpointB();
+
+        umsg::Node<WriteCountingEndpoint, 32, 2> nodeA(a, 1);
+        umsg::Node<DuplexLink<4096>::Endpoint, 32, 4> nodeB(b, 1);
+        OrderSink sink2;
+        OrderSink sink3;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeB.subscribe(2, &sink2, &OrderSink::onPayload) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeB.subscribe(3, &sink3, &OrderSink::onPayload) == umsg::Error::OK);
+
+        uint8_t payload[20] = {0};
+        umsg::Conflation<32, 2> latest;
+        nodeA.beginConflation(latest);
+        for (uint8_t i = 0; i < 5; ++i)
+        {
+            payload[0] = i;
+            UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publishLatest(2, 0u, umsg::ByteSpan{payload, 4}) == umsg::Error::OK);
+            payload[0] = static_cast<uint8_t>(100 + i);
+            UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publishLatest(3, 0u, umsg::ByteSpan{payload, 8}) == umsg::Error::OK);
+        }
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, a.writes);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, latest.dirty());
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.flushLatest() == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, a.writes);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, latest.dirty());
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.flushLatest() == umsg::Error::OK); // nothing new: no write
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, a.writes);
+
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, sink2.calls);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, sink3.calls);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 4, sink2.seen[0]);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 104, sink3.seen[0]);
+
+        UMSG_TEST_SECTION(ctx, "node: publishLatest() returns QueueFull / InvalidArgument; encode errors leave nothing pending");
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publishLatest(4, 0u, umsg::ByteSpan{payload, 4}) == umsg::Error::QueueFull);
+        uint8_t oversized[33] = {0};
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publishLatest(2, 0u, umsg::ByteSpan{payload, 4}) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publishLatest(2, 0u, umsg::ByteSpan{oversized, sizeof(oversized)}) !=
+                                       umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, latest.dirty());
+        umsg::Conflation<8, 2> small;
+        nodeA.beginConflation(small);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publishLatest(2, 0u, umsg::ByteSpan{payload, 4}) ==
+                                       umsg::Error::InvalidArgument);
+
+        UMSG_TEST_SECTION(ctx, "node: flush() sends conflated packets through the batch in one write");
+        nodeA.beginConflation(latest);
+        umsg::TxBatch<128> batch;
+        nodeA.beginBatch(batch);
+        a.writes = 0;
+        payload[0] = 7;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(2, 0u, umsg::ByteSpan{payload, 4}) == umsg::Error::OK);
+        payload[0] = 8;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publishLatest(3, 0u, umsg::ByteSpan{payload, 4}) == umsg::Error::OK);
+        payload[0] = 9;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publishLatest(2, 0u, umsg::ByteSpan{payload, 4}) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.flush() == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, a.writes);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.endBatch() == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.endConflation() == umsg::Error::OK);
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 3, sink2.calls);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, sink3.calls);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 7, sink2.seen[1]);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 8, sink3.seen[1]); // slot order: msg_id 3 was bound first
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 9, sink2.seen[2]);
+
+        UMSG_TEST_SECTION(ctx, "node: without beginConflation() publishLatest() is publish()");
+        a.writes = 0;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publishLatest(2, 0u, umsg::ByteSpan{payload, 4}) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, a.writes);
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 4, sink2.calls);
+
+        UMSG_TEST_SECTION(ctx, "node: flushLatest() holds packets while the transport wantsWrite()");
+        UMSG_TEST_EXPECT_TRUE(ctx, umsg::detail::HasWantsWrite<BusyEndpoint>::value);
+        UMSG_TEST_EXPECT_TRUE(ctx, !umsg::detail::HasWantsWrite<WriteCountingEndpoint>::value);
+        BusyEndpoint busy;
+        busy.link = link.endpointA();
+        busy.writes = 0;
+        busy.busy = true;
+        umsg::Node<BusyEndpoint, 32, 2> nodeC(busy, 1);
+        umsg::Conflation<32, 2> latestC;
+        nodeC.beginConflation(latestC);
+        for (uint8_t i = 20; i < 30; ++i)
+        {
+            payload[0] = i;
+            UMSG_TEST_EXPECT_TRUE(ctx, nodeC.publishLatest(2, 0u, umsg::ByteSpan{payload, 4}) == umsg::Error::OK);
+            UMSG_TEST_EXPECT_TRUE(ctx, nodeC.flushLatest() == umsg::Error::OK);
+        }
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, busy.writes);
+        busy.busy = false;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeC.flushLatest() == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, busy.writes);
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 5, sink2.calls);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 29, sink2.seen[4]);
+
+        UMSG_TEST_SECTION(ctx, "node: typed publishLatest() (streamed and staged) round-trips");
+        DuplexLink<4096> blobLink;
+        WriteCountingEndpoint ba = {blobLink.endpointA(), 0};
+        DuplexLink<4096>::Endpoint bb = blobLink.endpointB();
+        umsg::Node<WriteCountingEndpoint, BlobMsg::kPayloadSize, 2> blobA(ba, 1);
+        umsg::Node<DuplexLink<4096>::Endpoint, BlobMsg::kPayloadSize, 2> blobB(bb, 1);
+        BlobReceiver recv;
+        UMSG_TEST_EXPECT_TRUE(ctx, blobB.subscribe(4, &recv, &BlobReceiver::onBlob) == umsg::Error::OK);
+
+        StreamedBlobMsg streamed;
+        BlobMsg staged;
+        for (size_t i = 0; i < BlobMsg::kPayloadSize; ++i)
+        {
+            streamed.bytes[i] = static_cast<uint8_t>(i % 7);
+            staged.bytes[i] = static_cast<uint8_t>(i % 5);
+        }
+        umsg::Conflation<BlobMsg::kPayloadSize, 1> blobLatest;
+        blobA.beginConflation(blobLatest);
+        UMSG_TEST_EXPECT_TRUE(ctx, blobA.publishLatest(4, streamed) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, blobA.publishLatest(4, staged) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, blobA.endConflation() == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, ba.writes);
+        (void)blobB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, recv.calls);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, staged.bytes, recv.last.bytes, BlobMsg::kPayloadSize);
+        UMSG_TEST_EXPECT_TRUE(ctx, blobA.publishLatest(4, streamed) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, ba.writes);
+    }
+}
+
+namespace
+{
+    struct CopySink
+    {
+        uint8_t bytes[256];
+        size_t length;
+        size_t calls;
+        Telemetry last;
+
+        CopySink() : length(0), calls(0) {}
+
+        umsg::Error onPayload(umsg::ByteSpan p, uint32_t)
+        {
+            length = p.length < sizeof(bytes) ? p.length : sizeof(bytes);
+            ::memcpy(bytes, p.data, length);
+            ++calls;
+            return umsg::Error::OK;
+        }
+
+        umsg::Error onTelemetry(const Telemetry &msg)
+        {
+            last = msg;
+            ++calls;
+            return umsg::Error::OK;
+        }
+    };
+
+    void test_node_compression(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "node: enabled msg_ids are sent LZ4-compressed and inflated before dispatch");
+        typedef DuplexLink<4096> Link;
+        Link link;
+        Link::Endpoint a = link.endpointA();
+        Link::Endpoint b = link.endpointB();
+
+        umsg::Node<Link::Endpoint, 256, 4> nodeA(a, 1);
+        umsg::Node<Link::Endpoint, 256, 4> nodeB(b, 1);
+        umsg::Compression<256> txBuffers;
+        umsg::Compression<256> rxBuffers;
+        txBuffers.enable(2);
+        txBuffers.enable(4);
+        UMSG_TEST_EXPECT_TRUE(ctx, txBuffers.enabled(2) && !txBuffers.enabled(3));
+        nodeA.beginCompression(txBuffers);
+        nodeB.beginCompression(rxBuffers);
+
+        CopySink sink;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeB.subscribe(2, &sink, &CopySink::onPayload) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeB.subscribe(3, &sink, &CopySink::onPayload) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeB.subscribe(4, &sink, &CopySink::onTelemetry) == umsg::Error::OK);
+
+        uint8_t payload[200];
+        for (size_t i = 0; i < sizeof(payload); ++i)
+        {
+            payload[i] = static_cast<uint8_t>("sensor-"[i % 7]);
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(3, 0u, umsg::ByteSpan{payload, sizeof(payload)}) == umsg::Error::OK);
+        const size_t plainBytes = link.a2b.count;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(2, 0u, umsg::ByteSpan{payload, sizeof(payload)}) == umsg::Error::OK);
+        const size_t packedBytes = link.a2b.count - plainBytes;
+        UMSG_TEST_EXPECT_TRUE(ctx, packedBytes < plainBytes / 4);
+
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, sink.calls);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, sizeof(payload), sink.length);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, payload, sink.bytes, sizeof(payload));
+
+        UMSG_TEST_SECTION(ctx, "node: incompressible payloads of enabled msg_ids go out uncompressed");
+        uint32_t lcg = 12345u;
+        for (size_t i = 0; i < 40; ++i)
+        {
+            lcg = lcg * 1103515245u + 12345u;
+            payload[i] = static_cast<uint8_t>(lcg >> 24);
+        }
+        umsg::Node<Link::Endpoint, 256, 4> plainB(b, 1);
+        UMSG_TEST_EXPECT_TRUE(ctx, plainB.subscribe(2, &sink, &CopySink::onPayload) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(2, 0u, umsg::ByteSpan{payload, 40}) == umsg::Error::OK);
+        (void)plainB.poll(); // no Compression attached: only an uncompressed frame gets through
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 3, sink.calls);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, payload, sink.bytes, 40);
+
+        UMSG_TEST_SECTION(ctx, "node: typed publish() and publishLatest() compress the encoded message");
+        Telemetry t;
+        ::memset(&t, 0, sizeof(t));
+        t.seq = 0x4242;
+        t.samples[1] = -5;
+        const size_t before = link.a2b.count;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(4, t) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, link.a2b.count - before < Telemetry::kPayloadSize);
+        umsg::Conflation<256, 1> latest;
+        nodeA.beginConflation(latest);
+        t.seq = 0x4343;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publishLatest(4, t) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.endConflation() == umsg::Error::OK);
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 5, sink.calls);
+        UMSG_TEST_EXPECT_TRUE(ctx, sink.last.seq == 0x4343 && sink.last.samples[1] == -5);
+
+        UMSG_TEST_SECTION(ctx, "node: compressed frames without Compression or that fail to inflate are dropped");
+        for (size_t i = 0; i < sizeof(payload); ++i)
+        {
+            payload[i] = 0xAB;
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(2, 0u, umsg::ByteSpan{payload, sizeof(payload)}) == umsg::Error::OK);
+        (void)plainB.poll();
+        const uint8_t bogus[] = {0x10, 'x', 0x09, 0x00}; // match before the start of the output
+        uint8_t packet[umsg::maxPacketSize(256)];
+        size_t packetLength = 0;
+        UMSG_TEST_EXPECT_TRUE(ctx, umsg::detail::PacketBuilder<256>::raw(
+                                       static_cast<uint8_t>(1u | umsg::protocol::kCompressedFlag), 2, 0u,
+                                       umsg::ByteSpan{const_cast<uint8_t *>(bogus), sizeof(bogus)}, packet,
+                                       packetLength) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, a.write(packet, packetLength));
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 5, sink.calls);
+#if UMSG_ENABLE_STATS
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, plainB.stats().errorCount(umsg::Error::VersionMismatch));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, nodeB.stats().errorCount(umsg::Error::CompressionInvalid));
+#endif
+
+        nodeA.endCompression();
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(2, 0u, umsg::ByteSpan{payload, sizeof(payload)}) == umsg::Error::OK);
+        (void)plainB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 6, sink.calls);
+    }
+}
+
+namespace
+{
+    // In-memory datagram queue: write() enqueues one datagram, readDatagram()
+    // hands out views in order.
+    struct DatagramLink
+    {
+        static const size_t kSlots = 16;
+        static const size_t kSlotSize = 1500;
+
+        uint8_t data[kSlots][kSlotSize];
+        size_t length[kSlots];
+        size_t head;
+        size_t count;
+
+        DatagramLink() : head(0), count(0) {}
+
+        bool write(const uint8_t *bytes, size_t n)
+        {
+            if (count == kSlots || n > kSlotSize)
+            {
+                return false;
+            }
+            const size_t slot = (head + count) % kSlots;
+            ::memcpy(data[slot], bytes, n);
+            length[slot] = n;
+            ++count;
+            return true;
+        }
+
+        bool readDatagram(umsg::ByteSpan &datagram)
+        {
+            if (count == 0)
+            {
+                return false;
+            }
+            datagram.data = data[head];
+            datagram.length = length[head];
+            head = (head + 1) % kSlots;
+            --count;
+            return true;
+        }
+    };
+
+    void test_node_datagram_framing(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "node: DatagramNode sends frame || crc32 per datagram (no COBS, no delimiter)");
+        UMSG_TEST_EXPECT_TRUE(ctx, umsg::detail::HasDatagramRead<DatagramLink>::value);
+        UMSG_TEST_EXPECT_TRUE(ctx, !umsg::detail::HasDatagramRead<DuplexLink<64>::Endpoint>::value);
+
+        DatagramLink link;
+        umsg::DatagramNode<DatagramLink, BlobMsg::kPayloadSize, 4> tx(link, 1);
+        umsg::DatagramNode<DatagramLink, BlobMsg::kPayloadSize, 4> rx(link, 1);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, umsg::maxDatagramSize(BlobMsg::kPayloadSize), tx.kMaxPacketSize);
+
+        OrderSink sink;
+        BlobReceiver blobs;
+        UMSG_TEST_EXPECT_TRUE(ctx, rx.subscribe(2, &sink, &OrderSink::onPayload) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, rx.subscribe(4, &blobs, &BlobReceiver::onBlob) == umsg::Error::OK);
+
+        uint8_t payload[5] = {0, 0x00, 0x11, 0x00, 0x22};
+        UMSG_TEST_EXPECT_TRUE(ctx, tx.publish(2, 0xCAFEF00Du, umsg::ByteSpan{payload, sizeof(payload)}) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, link.count);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, umsg::kFrameHeaderSize + sizeof(payload) + 4, link.length[0]);
+        uint8_t frame[umsg::kFrameHeaderSize + sizeof(payload)];
+        umsg::ByteSpan frameSpan{frame, sizeof(frame)};
+        UMSG_TEST_EXPECT_TRUE(ctx,
+            umsg::protocol::encodeFrame(1, 2, 0xCAFEF00Du, umsg::ByteSpan{payload, sizeof(payload)}, frameSpan) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, frame, link.data[0], sizeof(frame));
+        UMSG_TEST_EXPECT_EQ_U32(ctx, umsg::crc32_iso_hdlc(frame, sizeof(frame)), umsg::read_u32_be(&link.data[0][sizeof(frame)]));
+
+        UMSG_TEST_SECTION(ctx, "node: DatagramNode typed publish (streamed and staged) round-trips in place");
+        StreamedBlobMsg streamed;
+        BlobMsg staged;
+        for (size_t i = 0; i < BlobMsg::kPayloadSize; ++i)
+        {
+            streamed.bytes[i] = static_cast<uint8_t>(i * 3);
+            staged.bytes[i] = static_cast<uint8_t>(i * 7);
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, tx.publish(4, streamed) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, tx.publish(4, staged) == umsg::Error::OK);
+        (void)rx.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, sink.calls);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, blobs.calls);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, staged.bytes, blobs.last.bytes, BlobMsg::kPayloadSize);
+
+        UMSG_TEST_SECTION(ctx, "node: several frames per datagram (TxBatch); pollFrames resumes mid-datagram");
+        umsg::TxBatch<256> batch;
+        tx.beginBatch(batch);
+        for (uint8_t i = 1; i < 6; ++i)
+        {
+            payload[0] = i;
+            UMSG_TEST_EXPECT_TRUE(ctx, tx.publish(2, 0u, umsg::ByteSpan{payload, sizeof(payload)}) == umsg::Error::OK);
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, tx.endBatch() == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, link.count);
+        const size_t datagramBytes = link.length[link.head];
+
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, datagramBytes, rx.pollFrames(2));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 3, sink.calls);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, rx.poll());
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 6, sink.calls);
+        bool ordered = true;
+        for (size_t i = 1; i < 6; ++i)
+        {
+            ordered = ordered && sink.seen[i] == i;
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, ordered);
+
+        UMSG_TEST_SECTION(ctx, "node: DatagramNode drops a datagram from its first bad frame on");
+        tx.beginBatch(batch);
+        UMSG_TEST_EXPECT_TRUE(ctx, tx.publish(2, 0u, umsg::ByteSpan{payload, sizeof(payload)}) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, tx.publish(2, 0u, umsg::ByteSpan{payload, sizeof(payload)}) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, tx.endBatch() == umsg::Error::OK);
+        link.data[link.head][umsg::kFrameHeaderSize] ^= 0x01; // first frame's payload
+        const uint8_t runt[6] = {1, 2, 0, 0, 0, 0};
+        UMSG_TEST_EXPECT_TRUE(ctx, link.write(runt, sizeof(runt)));
+        UMSG_TEST_EXPECT_TRUE(ctx, tx.publish(2, 0u, umsg::ByteSpan{payload, sizeof(payload)}) == umsg::Error::OK);
+        (void)rx.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 7, sink.calls);
+#if UMSG_ENABLE_STATS
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, rx.stats().errorCount(umsg::Error::CrcInvalid));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, rx.stats().errorCount(umsg::Error::FrameTooShort));
+#endif
+    }
+
+    void test_node_tap(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "node: beginTap() copies each checked RX frame as frame || crc32, replayable by a DatagramNode");
+        typedef DuplexLink<1024> Link;
+        Link link;
+        Link::Endpoint a = link.endpointA();
+        Link::Endpoint b = link.endpointB();
+        umsg::Node<Link::Endpoint, 32, 4> nodeA(a, 1);
+        umsg::Node<Link::Endpoint, 32, 4> nodeB(b, 1);
+        OrderSink live;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeB.subscribe(2, &live, &OrderSink::onPayload) == umsg::Error::OK);
+
+        DatagramLink tapped;
+        nodeB.beginTap(tapped);
+        uint8_t payload[6] = {1, 0x00, 0x11, 0x00, 0x22, 0x00};
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(2, 0u, umsg::ByteSpan{payload, sizeof(payload)}) == umsg::Error::OK);
+        payload[0] = 2;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(9, 0u, umsg::ByteSpan{payload, 2}) == umsg::Error::OK); // no handler
+        const uint8_t corrupt[] = {0x07, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x00};          // bad CRC
+        UMSG_TEST_EXPECT_TRUE(ctx, a.write(corrupt, sizeof(corrupt)));
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, live.calls);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, tapped.count);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, umsg::kFrameHeaderSize + sizeof(payload) + 4, tapped.length[0]);
+
+        nodeB.endTap();
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(2, 0u, umsg::ByteSpan{payload, sizeof(payload)}) == umsg::Error::OK);
+        (void)nodeB.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, live.calls);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, tapped.count);
+
+        umsg::DatagramNode<DatagramLink, 32, 4> replay(tapped, 1);
+        OrderSink replayed;
+        UMSG_TEST_EXPECT_TRUE(ctx, replay.subscribe(2, &replayed, &OrderSink::onPayload) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, replay.subscribe(9, &replayed, &OrderSink::onPayload) == umsg::Error::OK);
+        (void)replay.poll();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, replayed.calls);
+        UMSG_TEST_EXPECT_TRUE(ctx, replayed.seen[0] == 1 && replayed.seen[1] == 2);
+    }
+}
+
+#if UMSG_ENABLE_STATS
+uint32_t g_test_clock_us = 0;
+
+namespace
+{
+    // Handler that advances the test clock, so poll() has a measurable duration.
+    struct SlowSink
+    {
+        umsg::Error onPayload(umsg::ByteSpan, uint32_t)
+        {
+            g_test_clock_us += 250;
+            return umsg::Error::OK;
+        }
+
+        umsg::Error onReject(umsg::ByteSpan, uint32_t) { return umsg::Error::LengthMismatch; }
+    };
+
+    void test_node_stats(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "node: stats() counts frames, bytes and each discarded error");
+        typedef DuplexLink<1024> Link;
+        Link link;
+        Link::Endpoint a = link.endpointA();
+        Link::Endpoint b = link.endpointB();
+
+        umsg::Node<Link::Endpoint, 32, 4> nodeA(a, 1);
+        umsg::Node<Link::Endpoint, 32, 4> nodeB(b, 1);
+        umsg::Node<Link::Endpoint, 32, 4> wrongVersion(a, 2);
+
+        SlowSink sink;
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeB.subscribe(5, &sink, &SlowSink::onPayload) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeB.subscribe(6, &sink, &SlowSink::onReject) == umsg::Error::OK);
+
+        uint8_t payload[20] = {1, 2, 3};
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(5, 0u, umsg::ByteSpan{payload, 20}) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(5, 0u, umsg::ByteSpan{payload, 3}) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(6, 0u, umsg::ByteSpan{payload, 3}) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(7, 0u, umsg::ByteSpan{payload, 3}) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, wrongVersion.publish(5, 0u, umsg::ByteSpan{payload, 3}) == umsg::Error::OK);
+        const uint8_t corrupt[] = {0x07, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x00}; // valid COBS, bad CRC
+        UMSG_TEST_EXPECT_TRUE(ctx, a.write(corrupt, sizeof(corrupt)));
+        uint8_t tooBig[33] = {0};
+        UMSG_TEST_EXPECT_TRUE(ctx, nodeA.publish(5, 0u, umsg::ByteSpan{tooBig, sizeof(tooBig)}) == umsg::Error::InvalidArgument);
+
+        const umsg::NodeStats &tx = nodeA.stats();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 4, tx.framesOut);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, tx.errorCount(umsg::Error::InvalidArgument));
+
+        const size_t queued = link.a2b.count;
+        g_test_clock_us = 0;
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, queued, nodeB.poll());
+
+        const umsg::NodeStats &rx = nodeB.stats();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, queued, rx.bytesIn);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 4, rx.framesIn);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, umsg::kFrameHeaderSize + 20, rx.maxFrameSize);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, rx.errorCount(umsg::Error::HandlerNotFound));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, rx.errorCount(umsg::Error::LengthMismatch));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, rx.errorCount(umsg::Error::VersionMismatch));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, rx.errorCount(umsg::Error::CrcInvalid));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 500, rx.maxPollUs);
+#if UMSG_STATS_PER_MSG_ID
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, rx.rxPerMsgId[5]);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, rx.rxPerMsgId[6]);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, rx.rxPerMsgId[7]);
+#endif
+
+        nodeB.resetStats();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, nodeB.stats().framesIn);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, nodeB.stats().errorCount(umsg::Error::CrcInvalid));
+    }
 }
+#endif
 
 void test_node(umsg_test::TestContext &ctx)
 {
     test_node_end_to_end(ctx);
+    test_node_static_dispatcher(ctx);
+    test_node_bulk_read(ctx);
+    test_node_typed_publish_in_place(ctx);
+    test_node_typed_publish_streamed(ctx);
+    test_node_generated_view(ctx);
+    test_node_generated_fixed_codec(ctx);
+    test_node_generated_compact(ctx);
+    test_node_generated_registry(ctx);
+    test_node_bounded_poll(ctx);
+    test_node_tx_batch(ctx);
+    test_node_conflation(ctx);
+    test_node_compression(ctx);
+    test_node_datagram_framing(ctx);
+    test_node_tap(ctx);
+#if UMSG_ENABLE_STATS
+    test_node_stats(ctx);
+#endif
 }
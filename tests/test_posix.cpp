@@ -0,0 +1,806 @@
+#include "test_harness.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <thread>
+
+#include <umsg/framer.hpp>
+#include <umsg/marshalling.hpp>
+#include <umsg/node.hpp>
+#include <umsg/packet.hpp>
+#include <umsg/protocol.hpp>
+#include <umsg/transports/posix/frame_log.hpp>
+#include <umsg/transports/posix/shm_ring.hpp>
+#include <umsg/transports/posix/tcp_server.hpp>
+#include <umsg/transports/posix/tx_ring.hpp>
+#include <umsg/transports/posix/udp_socket.hpp>
+
+namespace
+{
+    static const size_t kMaxPayload = 700;
+    static const uint8_t kMsgId = 7;
+
+    typedef umsg::Framer<umsg::maxPacketSize(kMaxPayload)> StreamFramer;
+
+    // Checks a stream of packets whose payloads are (sequence number u32, filler
+    // bytes = low byte of the sequence number): every frame must decode intact,
+    // with increasing sequence numbers. The first kKept are recorded.
+    struct SequenceChecker
+    {
+        static const size_t kKept = 4096;
+
+        StreamFramer framer;
+        uint32_t seqs[kKept];
+        uint32_t last;
+        size_t frames;
+        bool intact;
+        bool ordered;
+
+        SequenceChecker() : last(0), frames(0), intact(true), ordered(true) {}
+
+        void feed(const uint8_t *data, size_t length)
+        {
+            umsg::ByteSpan in{const_cast<uint8_t *>(data), length};
+            while (in.length > 0)
+            {
+                size_t used = 0;
+                const StreamFramer::Result r = framer.feed(in, used);
+                in.data += used;
+                in.length -= used;
+                if (r.status != umsg::Error::OK)
+                {
+                    intact = false;
+                }
+                if (r.complete)
+                {
+                    frame(r.frame);
+                }
+            }
+        }
+
+        void frame(umsg::ByteSpan frame)
+        {
+            umsg::protocol::Header h;
+            umsg::ByteSpan payload;
+            if (umsg::protocol::decodeFrame(frame, h, payload) != umsg::Error::OK || h.msgId != kMsgId ||
+                payload.length != kMaxPayload)
+            {
+                intact = false;
+                return;
+            }
+            const uint32_t seq = umsg::read_u32_be(payload.data);
+            for (size_t i = 4; i < payload.length; ++i)
+            {
+                intact = intact && payload.data[i] == static_cast<uint8_t>(seq & 0xFFu);
+            }
+            ordered = ordered && (frames == 0 || seq > last);
+            if (frames < kKept)
+            {
+                seqs[frames] = seq;
+            }
+            last = seq;
+            ++frames;
+        }
+    };
+
+    static void sequence_payload(uint8_t *payload, size_t length, uint32_t seq)
+    {
+        ::memset(payload, static_cast<int>(seq & 0xFFu), length);
+        umsg::write_u32_be(payload, seq);
+    }
+
+    static size_t sequence_packet(uint8_t *packet, uint32_t seq)
+    {
+        uint8_t payload[kMaxPayload];
+        sequence_payload(payload, sizeof(payload), seq);
+        size_t length = 0;
+        umsg::detail::PacketBuilder<kMaxPayload>::raw(1, kMsgId, 0, umsg::ByteSpan{payload, sizeof(payload)},
+                                                     packet, length);
+        return length;
+    }
+
+    // Non-blocking AF_UNIX stream pair; fds[0] has the smallest send buffer the
+    // kernel allows, so a few packets fill it.
+    static bool stream_pair(int fds[2])
+    {
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+        {
+            return false;
+        }
+        const int tiny = 1;
+        ::setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &tiny, sizeof(tiny));
+        for (int i = 0; i < 2; ++i)
+        {
+            ::fcntl(fds[i], F_SETFL, ::fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+        }
+        return true;
+    }
+
+    // TxRing's base: a bare non-blocking fd.
+    struct FdStream
+    {
+        int fd;
+
+        FdStream() : fd(-1) {}
+
+        int nativeHandle() const { return fd; }
+
+        void close()
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+    };
+
+    // Alternate flushPending() with short reads (so most writev() calls are
+    // partial) until the ring and the socket are empty.
+    template <class Ring>
+    static bool drain_ring(Ring &ring, int reader, SequenceChecker &checker)
+    {
+        uint8_t rx[200];
+        for (int i = 0; i < 100000; ++i)
+        {
+            if (!ring.flushPending())
+            {
+                return false;
+            }
+            const ssize_t n = ::read(reader, rx, sizeof(rx));
+            if (n > 0)
+            {
+                checker.feed(rx, static_cast<size_t>(n));
+            }
+            else if (!ring.wantsWrite())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void test_tx_ring_reject(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "posix: TxRing<Reject> queues what the socket refuses, then refuses whole packets");
+
+        typedef umsg::posix::TxRing<FdStream, 8192, umsg::posix::TxOverflow::Reject> Ring;
+        Ring ring;
+        int fds[2];
+        UMSG_TEST_EXPECT_TRUE(ctx, stream_pair(fds));
+        ring.fd = fds[0];
+
+        // Each round fills the socket and then the ring until write() refuses a
+        // packet, then drains everything. Over the rounds the ring wraps.
+        SequenceChecker checker;
+        uint8_t packet[umsg::maxPacketSize(kMaxPayload)];
+        uint32_t accepted[SequenceChecker::kKept];
+        size_t acceptedCount = 0;
+        size_t queuedBytes = 0;
+        uint32_t seq = 0;
+        bool drained = true;
+        for (int round = 0; round < 4; ++round)
+        {
+            const uint32_t rejectedBefore = ring.rejected();
+            while (ring.rejected() == rejectedBefore && acceptedCount < SequenceChecker::kKept)
+            {
+                const size_t length = sequence_packet(packet, seq);
+                const size_t before = ring.pending();
+                if (ring.write(packet, length))
+                {
+                    accepted[acceptedCount++] = seq;
+                    queuedBytes += ring.pending() > before ? ring.pending() - before : 0;
+                }
+                ++seq;
+            }
+            UMSG_TEST_EXPECT_TRUE(ctx, ring.wantsWrite() && ring.pending() <= Ring::kCapacity);
+            drained = drain_ring(ring, fds[1], checker) && drained;
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, drained);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 4, ring.rejected());
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, ring.dropped());
+        UMSG_TEST_EXPECT_TRUE(ctx, queuedBytes > 2 * Ring::kCapacity);
+
+        // Every accepted packet arrives intact and in order; refused ones never do.
+        UMSG_TEST_EXPECT_TRUE(ctx, checker.intact && checker.ordered);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, acceptedCount, checker.frames);
+        bool same = checker.frames == acceptedCount;
+        for (size_t i = 0; same && i < acceptedCount; ++i)
+        {
+            same = checker.seqs[i] == accepted[i];
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, same);
+
+        UMSG_TEST_SECTION(ctx, "posix: TxRing rejects a write larger than the ring");
+        uint8_t big[Ring::kCapacity];
+        ::memset(big, 0x55, sizeof(big));
+        UMSG_TEST_EXPECT_TRUE(ctx, !ring.write(big, sizeof(big)));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 5, ring.rejected());
+
+        ring.close();
+        ::close(fds[1]);
+    }
+
+    void test_tx_ring_drop_oldest(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "posix: TxRing<DropOldest> drops whole packets around a half-sent head");
+
+        typedef umsg::posix::TxRing<FdStream, 8192, umsg::posix::TxOverflow::DropOldest> Ring;
+        Ring ring;
+        int fds[2];
+        UMSG_TEST_EXPECT_TRUE(ctx, stream_pair(fds));
+        ring.fd = fds[0];
+
+        SequenceChecker checker;
+        uint8_t packet[umsg::maxPacketSize(kMaxPayload)];
+        uint8_t rx[4096];
+
+        // Fill the socket, then let the reader free some of it: the next write()
+        // flushes the queued packets with one writev(), which the socket takes
+        // only part of. Repeat until the cut falls inside a packet, whose rest
+        // is then the (locked) head entry.
+        size_t ends[1000]; // stream offset just past each packet
+        size_t delivered = 0;
+        uint32_t seq = 0;
+        bool halfSent = false;
+        while (seq < 1000 && !halfSent)
+        {
+            const size_t length = sequence_packet(packet, seq);
+            ends[seq] = (seq ? ends[seq - 1] : 0) + length;
+            ring.write(packet, length);
+            ++seq;
+            int unread = 0;
+            ::ioctl(fds[1], FIONREAD, &unread);
+            const size_t inKernel = delivered + static_cast<size_t>(unread);
+            bool boundary = false;
+            for (size_t i = 0; i < seq && !boundary; ++i)
+            {
+                boundary = ends[i] == inKernel;
+            }
+            halfSent = ring.wantsWrite() && inKernel > 0 && !boundary;
+            if (!halfSent && ring.pending() > Ring::kCapacity / 2)
+            {
+                const ssize_t n = ::read(fds[1], rx, sizeof(rx));
+                if (n > 0)
+                {
+                    checker.feed(rx, static_cast<size_t>(n));
+                    delivered += static_cast<size_t>(n);
+                }
+            }
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, halfSent);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, ring.dropped());
+
+        // Overflow without reading: the entries behind the head make room
+        // (dropSecond()), the head itself stays.
+        for (int i = 0; i < 40; ++i)
+        {
+            UMSG_TEST_EXPECT_TRUE(ctx, ring.write(packet, sequence_packet(packet, seq)));
+            ++seq;
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, ring.dropped() > 0);
+        UMSG_TEST_EXPECT_TRUE(ctx, ring.pending() <= Ring::kCapacity);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, ring.rejected());
+
+        // The half-sent packet completes, the survivors follow in order, and the
+        // newest packet is never the one dropped.
+        UMSG_TEST_EXPECT_TRUE(ctx, drain_ring(ring, fds[1], checker));
+        UMSG_TEST_EXPECT_TRUE(ctx, checker.intact && checker.ordered);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, seq - ring.dropped(), checker.frames);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, seq - 1, checker.last);
+
+        UMSG_TEST_SECTION(ctx, "posix: TxRing::close() discards queued bytes");
+        while (ring.write(packet, sequence_packet(packet, seq)) && !ring.wantsWrite())
+        {
+            ++seq;
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, ring.wantsWrite());
+        ring.close();
+        UMSG_TEST_EXPECT_TRUE(ctx, !ring.wantsWrite());
+        UMSG_TEST_EXPECT_TRUE(ctx, !ring.write(packet, sequence_packet(packet, seq)));
+
+        ::close(fds[1]);
+    }
+
+    static int connect_to(uint16_t port, int rcvbuf)
+    {
+        const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0)
+        {
+            return -1;
+        }
+        if (rcvbuf > 0)
+        {
+            ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        }
+        struct sockaddr_in addr;
+        ::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        if (::connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+        return fd;
+    }
+
+    template <class Server>
+    static bool accept_clients(Server &server, size_t count)
+    {
+        for (int i = 0; i < 100 && server.connectionCount() < count; ++i)
+        {
+            server.poll(10);
+        }
+        return server.connectionCount() == count;
+    }
+
+    static bool wait_readable(int fd, int timeoutMs)
+    {
+        struct pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLIN;
+        return ::poll(&pfd, 1, timeoutMs) == 1;
+    }
+
+    void test_tcp_server_stalled_peer(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "posix: TcpServer queues for a slow peer and drops a stalled one");
+
+        umsg::posix::TcpServer<kMaxPayload, 4, 1, 2048> server;
+        UMSG_TEST_EXPECT_TRUE(ctx, server.listen(0));
+
+        const int stalled = connect_to(server.port(), 2048);
+        UMSG_TEST_EXPECT_TRUE(ctx, stalled >= 0 && accept_clients(server, 1));
+        const int reader = connect_to(server.port(), 0);
+        UMSG_TEST_EXPECT_TRUE(ctx, reader >= 0 && accept_clients(server, 2));
+        const int small = 4096;
+        ::setsockopt(server.connectionHandle(0), SOL_SOCKET, SO_SNDBUF, &small, sizeof(small));
+        ::setsockopt(server.connectionHandle(1), SOL_SOCKET, SO_SNDBUF, &small, sizeof(small));
+
+        // The stalled client never reads: its socket buffers, then its queue, fill
+        // and publishAll() drops it. The reader, drained between publishes, keeps
+        // up through EPOLLOUT and gets every frame.
+        SequenceChecker checker;
+        uint8_t payload[kMaxPayload];
+        uint8_t rx[4096];
+        uint32_t published = 0;
+        bool queued = false;
+        umsg::Error dropErr = umsg::Error::OK;
+        while (published < 20000 && (server.isConnected(0) || published < 2000))
+        {
+            sequence_payload(payload, sizeof(payload), published);
+            const umsg::Error err = server.publishAll(kMsgId, 0, umsg::ByteSpan{payload, sizeof(payload)});
+            if (err != umsg::Error::OK)
+            {
+                dropErr = err;
+            }
+            ++published;
+            queued = queued || server.pending(0) > 0;
+            server.poll(0);
+            ssize_t n;
+            while ((n = ::read(reader, rx, sizeof(rx))) > 0)
+            {
+                checker.feed(rx, static_cast<size_t>(n));
+            }
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, queued);
+        UMSG_TEST_EXPECT_TRUE(ctx, !server.isConnected(0));
+        UMSG_TEST_EXPECT_TRUE(ctx, dropErr == umsg::Error::TransportError);
+        UMSG_TEST_EXPECT_TRUE(ctx, server.isConnected(1));
+
+        for (int i = 0; i < 1000 && checker.frames < published; ++i)
+        {
+            server.poll(0);
+            if (!wait_readable(reader, 10))
+            {
+                continue;
+            }
+            const ssize_t n = ::read(reader, rx, sizeof(rx));
+            if (n > 0)
+            {
+                checker.feed(rx, static_cast<size_t>(n));
+            }
+        }
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, published, checker.frames);
+        UMSG_TEST_EXPECT_TRUE(ctx, checker.intact && checker.ordered);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, server.pending(1));
+
+        ::close(stalled);
+        ::close(reader);
+    }
+
+    void test_tcp_server_out_of_fds(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "posix: TcpServer sheds clients instead of spinning on EMFILE");
+
+        umsg::posix::TcpServer<kMaxPayload, 4, 1> server;
+        UMSG_TEST_EXPECT_TRUE(ctx, server.listen(0));
+
+        struct rlimit saved;
+        ::getrlimit(RLIMIT_NOFILE, &saved);
+        struct rlimit low = saved;
+        low.rlim_cur = 128;
+        ::setrlimit(RLIMIT_NOFILE, &low);
+
+        // Use up every fd but the one the client needs.
+        int held[128];
+        size_t count = 0;
+        while (count < 128)
+        {
+            const int fd = ::open("/dev/null", O_RDONLY);
+            if (fd < 0)
+            {
+                break;
+            }
+            held[count++] = fd;
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, count > 0 && count < 128);
+        ::close(held[--count]);
+        const int client = connect_to(server.port(), 0);
+        UMSG_TEST_EXPECT_TRUE(ctx, client >= 0);
+
+        // The pending client is accepted on the reserved fd and closed ...
+        server.poll(50);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, server.connectionCount());
+        uint8_t byte = 0;
+        UMSG_TEST_EXPECT_TRUE(ctx, wait_readable(client, 1000) && ::read(client, &byte, 1) == 0);
+
+        // ... so the listener is no longer readable.
+        struct pollfd pfd;
+        pfd.fd = server.nativeHandle();
+        pfd.events = POLLIN;
+        UMSG_TEST_EXPECT_TRUE(ctx, ::poll(&pfd, 1, 0) == 0);
+
+        ::close(client);
+        while (count > 0)
+        {
+            ::close(held[--count]);
+        }
+        ::setrlimit(RLIMIT_NOFILE, &saved);
+
+        // With fds back, clients are served again.
+        const int later = connect_to(server.port(), 0);
+        UMSG_TEST_EXPECT_TRUE(ctx, later >= 0 && accept_clients(server, 1));
+        ::close(later);
+    }
+
+    static int ip_option(int fd, int level, int name)
+    {
+        int value = -1;
+        socklen_t len = sizeof(value);
+        if (::getsockopt(fd, level, name, &value, &len) < 0)
+        {
+            return -1;
+        }
+        return len == 1 ? static_cast<unsigned char>(value) : value;
+    }
+
+    void test_udp_multicast_options(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "posix: multicast options on a bind6() socket cover IPv4 groups too");
+
+        umsg::posix::UdpSocket udp;
+        UMSG_TEST_EXPECT_TRUE(ctx, udp.bind6(0));
+        const int fd = udp.nativeHandle();
+        UMSG_TEST_EXPECT_TRUE(ctx, udp.setMulticastHops(5));
+        UMSG_TEST_EXPECT_TRUE(ctx, ip_option(fd, IPPROTO_IPV6, IPV6_MULTICAST_HOPS) == 5);
+        UMSG_TEST_EXPECT_TRUE(ctx, ip_option(fd, IPPROTO_IP, IP_MULTICAST_TTL) == 5);
+        UMSG_TEST_EXPECT_TRUE(ctx, udp.setMulticastLoopback(false));
+        UMSG_TEST_EXPECT_TRUE(ctx, ip_option(fd, IPPROTO_IPV6, IPV6_MULTICAST_LOOP) == 0);
+        UMSG_TEST_EXPECT_TRUE(ctx, ip_option(fd, IPPROTO_IP, IP_MULTICAST_LOOP) == 0);
+        UMSG_TEST_EXPECT_TRUE(ctx, udp.setMulticastInterface("lo"));
+        UMSG_TEST_EXPECT_TRUE(ctx, ip_option(fd, IPPROTO_IPV6, IPV6_MULTICAST_IF) ==
+                                       static_cast<int>(::if_nametoindex("lo")));
+
+        UMSG_TEST_SECTION(ctx, "posix: multicast options on an IPv4 socket");
+        umsg::posix::UdpSocket udp4;
+        UMSG_TEST_EXPECT_TRUE(ctx, udp4.bind(0));
+        UMSG_TEST_EXPECT_TRUE(ctx, udp4.setMulticastHops(3));
+        UMSG_TEST_EXPECT_TRUE(ctx, ip_option(udp4.nativeHandle(), IPPROTO_IP, IP_MULTICAST_TTL) == 3);
+        UMSG_TEST_EXPECT_TRUE(ctx, !udp4.setMulticastInterface("no-such-interface"));
+    }
+
+    static const size_t kSmallPayload = 16;
+    typedef umsg::posix::ShmRing<8, umsg::maxDatagramSize(kSmallPayload), 2> ShmRingType;
+
+    // Handler recording the sequence numbers (u32 payloads) it is given.
+    struct SeqList
+    {
+        uint32_t seqs[64];
+        size_t count;
+
+        SeqList() : count(0) {}
+
+        umsg::Error onMessage(umsg::ByteSpan payload, uint32_t)
+        {
+            if (payload.length == 4 && count < 64)
+            {
+                seqs[count++] = umsg::read_u32_be(payload.data);
+            }
+            return umsg::Error::OK;
+        }
+
+        // Exactly @p from, from + 1, ..., @p to - 1.
+        bool received(uint32_t from, uint32_t to) const
+        {
+            if (count != to - from)
+            {
+                return false;
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (seqs[i] != from + i)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    // One ShmRing reader with its DatagramNode.
+    struct ShmSubscriber : SeqList
+    {
+        ShmRingType ring;
+        umsg::DatagramNode<ShmRingType, kSmallPayload, 1> node;
+
+        ShmSubscriber() : node(ring) { node.subscribe(kMsgId, static_cast<SeqList *>(this), &SeqList::onMessage); }
+    };
+
+    static umsg::Error shm_publish(ShmRingType &ring, uint32_t seq)
+    {
+        uint8_t payload[4];
+        umsg::write_u32_be(payload, seq);
+        return ring.publish(kMsgId, 0, umsg::ByteSpan{payload, sizeof(payload)});
+    }
+
+    void test_shm_ring(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "posix: ShmRing delivers every message to each attached reader, in order");
+
+        char name[64];
+        ::snprintf(name, sizeof(name), "/umsg_test_%d", static_cast<int>(::getpid()));
+        ShmRingType writer;
+        UMSG_TEST_EXPECT_TRUE(ctx, writer.create(name));
+        ShmSubscriber a;
+        ShmSubscriber b;
+        UMSG_TEST_EXPECT_TRUE(ctx, a.ring.attach(name) && b.ring.attach(name));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, writer.readers());
+        ShmRingType third;
+        UMSG_TEST_EXPECT_TRUE(ctx, !third.attach(name)); // MaxReaders = 2
+
+        for (uint32_t seq = 0; seq < ShmRingType::kSlots; ++seq)
+        {
+            UMSG_TEST_EXPECT_TRUE(ctx, shm_publish(writer, seq) == umsg::Error::OK);
+        }
+        a.node.poll();
+        UMSG_TEST_EXPECT_TRUE(ctx, a.received(0, 8));
+
+        UMSG_TEST_SECTION(ctx, "posix: ShmRing returns QueueFull while the slowest reader is Slots behind");
+        UMSG_TEST_EXPECT_TRUE(ctx, shm_publish(writer, 8) == umsg::Error::QueueFull);
+        UMSG_TEST_EXPECT_TRUE(ctx, !writer.write(reinterpret_cast<const uint8_t *>("x"), 1));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 8, b.ring.available());
+        b.node.poll();
+        UMSG_TEST_EXPECT_TRUE(ctx, b.received(0, 8));
+        UMSG_TEST_EXPECT_TRUE(ctx, shm_publish(writer, 8) == umsg::Error::OK);
+        a.node.poll();
+        b.node.poll();
+        UMSG_TEST_EXPECT_TRUE(ctx, a.received(0, 9) && b.received(0, 9));
+
+        UMSG_TEST_SECTION(ctx, "posix: ShmRing::wait() times out, and returns once the writer commits");
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        UMSG_TEST_EXPECT_TRUE(ctx, !a.ring.wait(20));
+        UMSG_TEST_EXPECT_TRUE(ctx, std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(15));
+
+        std::thread publisher([&writer]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            uint8_t *slot = writer.reserve();
+            size_t length = 0;
+            uint8_t payload[4];
+            umsg::write_u32_be(payload, 9);
+            if (slot && umsg::detail::PacketBuilder<kSmallPayload, umsg::DatagramFraming>::raw(
+                            1, kMsgId, 0, umsg::ByteSpan{payload, sizeof(payload)}, slot, length) == umsg::Error::OK)
+            {
+                writer.commit(length);
+            }
+        });
+        const bool woke = a.ring.wait(5000);
+        const std::chrono::steady_clock::duration waited = std::chrono::steady_clock::now() - start;
+        publisher.join();
+        UMSG_TEST_EXPECT_TRUE(ctx, woke && waited < std::chrono::seconds(5));
+        a.node.poll();
+        UMSG_TEST_EXPECT_TRUE(ctx, a.received(0, 10));
+
+        UMSG_TEST_SECTION(ctx, "posix: ShmRing::attach() rejects another ring geometry");
+        umsg::posix::ShmRing<16, umsg::maxDatagramSize(kSmallPayload), 2> moreSlots;
+        umsg::posix::ShmRing<8, umsg::maxDatagramSize(2 * kSmallPayload), 2> biggerSlots;
+        umsg::posix::ShmRing<8, umsg::maxDatagramSize(kSmallPayload), 4> moreReaders;
+        UMSG_TEST_EXPECT_TRUE(ctx, !moreSlots.attach(name));
+        UMSG_TEST_EXPECT_TRUE(ctx, !biggerSlots.attach(name));
+        UMSG_TEST_EXPECT_TRUE(ctx, !moreReaders.attach(name));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, writer.readers());
+
+        writer.close(); // unlinks the name
+        UMSG_TEST_EXPECT_TRUE(ctx, !third.attach(name));
+    }
+
+    // One-datagram mailbox: a DatagramNode publishes into it, another reads it.
+    struct DatagramMailbox
+    {
+        uint8_t data[umsg::maxDatagramSize(kSmallPayload)];
+        size_t length;
+        bool full;
+
+        DatagramMailbox() : length(0), full(false) {}
+
+        bool write(const uint8_t *bytes, size_t n)
+        {
+            if (full || n > sizeof(data))
+            {
+                return false;
+            }
+            ::memcpy(data, bytes, n);
+            length = n;
+            full = true;
+            return true;
+        }
+
+        bool readDatagram(umsg::ByteSpan &datagram)
+        {
+            if (!full)
+            {
+                return false;
+            }
+            datagram.data = data;
+            datagram.length = length;
+            full = false;
+            return true;
+        }
+    };
+
+    typedef umsg::DatagramNode<umsg::posix::Replayer, kSmallPayload, 1> ReplayNode;
+
+    // Replay all of @p path into @p seqs.
+    static bool replay_all(const char *path, SeqList &seqs)
+    {
+        umsg::posix::Replayer log;
+        if (!log.open(path))
+        {
+            return false;
+        }
+        ReplayNode node(log);
+        node.subscribe(kMsgId, &seqs, &SeqList::onMessage);
+        while (!log.done())
+        {
+            node.poll();
+        }
+        return log.recordsRead() == seqs.count;
+    }
+
+    void test_frame_log(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "posix: Recorder logs tapped frames; Replayer replays them in order");
+
+        char path[64];
+        char indexPath[68];
+        ::snprintf(path, sizeof(path), "/tmp/umsg_test_%d.umsglog", static_cast<int>(::getpid()));
+        ::snprintf(indexPath, sizeof(indexPath), "%s.idx", path);
+
+        static const uint32_t kRecords = 50;
+        DatagramMailbox wire;
+        umsg::DatagramNode<DatagramMailbox, kSmallPayload, 1> tx(wire);
+        umsg::DatagramNode<DatagramMailbox, kSmallPayload, 1> rx(wire);
+        umsg::posix::Recorder<> recorder;
+        UMSG_TEST_EXPECT_TRUE(ctx, recorder.open(path, 4)); // an index entry every 4 records
+        rx.beginTap(recorder);
+        uint8_t payload[4];
+        for (uint32_t seq = 0; seq < kRecords; ++seq)
+        {
+            umsg::write_u32_be(payload, seq);
+            tx.publish(kMsgId, 0, umsg::ByteSpan{payload, sizeof(payload)});
+            rx.poll();
+        }
+        rx.endTap();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, kRecords, recorder.records());
+        const size_t logSize = static_cast<size_t>(recorder.size());
+        recorder.close();
+
+        SeqList all;
+        UMSG_TEST_EXPECT_TRUE(ctx, replay_all(path, all));
+        UMSG_TEST_EXPECT_TRUE(ctx, all.received(0, kRecords));
+
+        // Record times, read back in order (they never decrease).
+        uint64_t times[kRecords];
+        umsg::posix::Replayer log;
+        UMSG_TEST_EXPECT_TRUE(ctx, log.open(path));
+        for (uint32_t i = 0; i < kRecords; ++i)
+        {
+            times[i] = log.nextTimeNs();
+            umsg::ByteSpan datagram;
+            UMSG_TEST_EXPECT_TRUE(ctx, log.readDatagram(datagram));
+            UMSG_TEST_EXPECT_TRUE(ctx, i == 0 || times[i] >= times[i - 1]);
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, log.done());
+
+        UMSG_TEST_SECTION(ctx, "posix: Replayer::seek(t) lands on the first record with t_ns >= t");
+        ReplayNode node(log);
+        for (uint32_t k = 0; k < kRecords; ++k)
+        {
+            // Just before, at and just after each record time.
+            const uint64_t targets[3] = {times[k] - 1, times[k], times[k] + 1};
+            for (size_t j = 0; j < 3; ++j)
+            {
+                uint32_t first = 0;
+                while (first < kRecords && times[first] < targets[j])
+                {
+                    ++first;
+                }
+                const bool found = log.seek(targets[j]);
+                UMSG_TEST_EXPECT_TRUE(ctx, found == (first < kRecords));
+                if (first == kRecords)
+                {
+                    UMSG_TEST_EXPECT_TRUE(ctx, log.done());
+                    continue;
+                }
+                SeqList next;
+                node.subscribe(kMsgId, &next, &SeqList::onMessage);
+                UMSG_TEST_EXPECT_TRUE(ctx, log.nextTimeNs() == times[first]);
+                node.pollFrames(1);
+                UMSG_TEST_EXPECT_TRUE(ctx, next.received(first, first + 1));
+            }
+        }
+        log.close();
+
+        UMSG_TEST_SECTION(ctx, "posix: a log cut mid-record replays exactly its complete records");
+        const size_t recordSize = umsg::posix::FrameLog::recordSize(umsg::maxDatagramSize(4)); // 4-byte payloads
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, umsg::posix::FrameLog::kHeaderSize + kRecords * recordSize, logSize);
+        // Cut the last record in its payload, then the one before in its header.
+        const size_t cuts[2] = {logSize - recordSize / 2, logSize - recordSize - 5};
+        for (size_t c = 0; c < 2; ++c)
+        {
+            const uint32_t complete = kRecords - 1 - static_cast<uint32_t>(c);
+            UMSG_TEST_EXPECT_TRUE(ctx, ::truncate(path, static_cast<off_t>(cuts[c])) == 0);
+            SeqList cut;
+            UMSG_TEST_EXPECT_TRUE(ctx, replay_all(path, cut));
+            UMSG_TEST_EXPECT_TRUE(ctx, cut.received(0, complete));
+
+            // The index still lists the torn record; seek() must not land on it.
+            UMSG_TEST_EXPECT_TRUE(ctx, log.open(path));
+            UMSG_TEST_EXPECT_TRUE(ctx, log.seek(times[complete - 1]) && log.nextTimeNs() == times[complete - 1]);
+            UMSG_TEST_EXPECT_TRUE(ctx, !log.seek(times[complete - 1] + 1) && log.done());
+            log.close();
+        }
+
+        ::unlink(path);
+        ::unlink(indexPath);
+    }
+}
+
+void test_posix(umsg_test::TestContext &ctx)
+{
+    test_tcp_server_stalled_peer(ctx);
+    test_tcp_server_out_of_fds(ctx);
+    test_udp_multicast_options(ctx);
+    test_tx_ring_reject(ctx);
+    test_tx_ring_drop_oldest(ctx);
+    test_shm_ring(ctx);
+    test_frame_log(ctx);
+}
@@ -0,0 +1,591 @@
+#include "test_harness.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <umsg/common.hpp>
+#include <umsg/datagram.hpp>
+#include <umsg/framer.hpp>
+#include <umsg/protocol.hpp>
+#include <umsg/node.hpp>
+#include <umsg/publish_queue.hpp>
+#include <umsg/rx_pipeline.hpp>
+#include <umsg/transports/isr_ring.hpp>
+
+namespace
+{
+    static const size_t kMaxPayload = 16;
+    static const size_t kProducers = 4;
+
+    // Deframes everything written to it; records (msgId, payload[0], payload[1]).
+    struct FrameSink
+    {
+        umsg::Framer<umsg::maxPacketSize(kMaxPayload)> framer;
+        uint8_t ids[4096];
+        uint8_t first[4096];
+        uint8_t second[4096];
+        size_t frames;
+        size_t writes;
+        size_t errors;
+        bool failWrites;
+
+        FrameSink() : frames(0), writes(0), errors(0), failWrites(false) {}
+
+        bool write(const uint8_t *data, size_t length)
+        {
+            ++writes;
+            if (failWrites)
+            {
+                return false;
+            }
+            for (size_t i = 0; i < length; ++i)
+            {
+                const umsg::Framer<umsg::maxPacketSize(kMaxPayload)>::Result r = framer.feed(data[i]);
+                if (r.status != umsg::Error::OK)
+                {
+                    ++errors;
+                }
+                if (r.complete)
+                {
+                    record(r.frame);
+                }
+            }
+            return true;
+        }
+
+        void record(umsg::ByteSpan frame)
+        {
+            umsg::protocol::Header h;
+            umsg::ByteSpan payload;
+            if (umsg::protocol::decodeFrame(frame, h, payload) != umsg::Error::OK || payload.length < 2 ||
+                frames >= sizeof(ids))
+            {
+                ++errors;
+                return;
+            }
+            ids[frames] = h.msgId;
+            first[frames] = payload.data[0];
+            second[frames] = payload.data[1];
+            ++frames;
+        }
+    };
+
+    struct GatherSink : FrameSink
+    {
+        size_t gathers;
+        size_t maxParts;
+
+        GatherSink() : gathers(0), maxParts(0) {}
+
+        using FrameSink::write;
+
+        bool write(const umsg::ByteSpan *parts, size_t count)
+        {
+            ++gathers;
+            if (count > maxParts)
+            {
+                maxParts = count;
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!write(parts[i].data, parts[i].length))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    void test_publish_queue_single_thread(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "publish queue: fills to Slots, drains in order");
+        typedef umsg::PublishQueue<kMaxPayload, 8> Queue;
+        static Queue q;
+
+        for (uint8_t i = 0; i < 8; ++i)
+        {
+            const uint8_t p[2] = {i, static_cast<uint8_t>(0xA0 + i)};
+            UMSG_TEST_EXPECT_TRUE(ctx, q.publish(5, 0x01020304u, umsg::ByteSpan{const_cast<uint8_t *>(p), 2}) ==
+                                           umsg::Error::OK);
+        }
+        const uint8_t extra[2] = {0xFF, 0xFF};
+        UMSG_TEST_EXPECT_TRUE(ctx, q.publish(5, 0, umsg::ByteSpan{const_cast<uint8_t *>(extra), 2}) ==
+                                       umsg::Error::QueueFull);
+
+        // Oversized payload: rejected, slot skipped by drain().
+        uint8_t big[kMaxPayload + 1] = {0};
+        FrameSink sink;
+        UMSG_TEST_EXPECT_TRUE(ctx, q.ready());
+        UMSG_TEST_EXPECT_TRUE(ctx, q.drain(sink, 3) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 3, sink.frames);
+        UMSG_TEST_EXPECT_TRUE(ctx, q.publish(5, 0, umsg::ByteSpan{big, sizeof(big)}) ==
+                                       umsg::Error::InvalidArgument);
+        UMSG_TEST_EXPECT_TRUE(ctx, q.drain(sink) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, !q.ready());
+
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 8, sink.frames);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, sink.errors);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 8, sink.writes);
+        for (size_t i = 0; i < sink.frames; ++i)
+        {
+            UMSG_TEST_EXPECT_EQ_U32(ctx, 5, sink.ids[i]);
+            UMSG_TEST_EXPECT_EQ_U32(ctx, i, sink.first[i]);
+            UMSG_TEST_EXPECT_EQ_U32(ctx, 0xA0 + i, sink.second[i]);
+        }
+
+        UMSG_TEST_SECTION(ctx, "publish queue: gather drain, failed write drops packets");
+        GatherSink gather;
+        for (uint8_t i = 0; i < 6; ++i)
+        {
+            const uint8_t p[2] = {i, 0};
+            (void)q.publish(6, 0, umsg::ByteSpan{const_cast<uint8_t *>(p), 2});
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, q.drain(gather) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 6, gather.frames);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, gather.gathers);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 6, gather.maxParts);
+
+        (void)q.publish(6, 0, umsg::ByteSpan{const_cast<uint8_t *>(extra), 2});
+        gather.failWrites = true;
+        UMSG_TEST_EXPECT_TRUE(ctx, q.drain(gather) == umsg::Error::TransportError);
+        UMSG_TEST_EXPECT_TRUE(ctx, !q.ready());
+    }
+
+    void test_publish_queue_datagram(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "publish queue: DatagramFraming packets deframe");
+        static umsg::PublishQueue<kMaxPayload, 2, umsg::DatagramFraming> q;
+
+        struct DatagramSink
+        {
+            size_t frames;
+            uint8_t last;
+
+            bool write(const uint8_t *data, size_t length)
+            {
+                umsg::DatagramDeframer d;
+                d.load(umsg::ByteSpan{const_cast<uint8_t *>(data), length});
+                umsg::ByteSpan frame;
+                if (d.next(frame) != umsg::Error::OK || !d.empty())
+                {
+                    return false;
+                }
+                last = frame.data[umsg::kFrameHeaderSize];
+                ++frames;
+                return true;
+            }
+        } sink = {0, 0};
+
+        const uint8_t p[3] = {0x42, 0, 0};
+        UMSG_TEST_EXPECT_TRUE(ctx, q.publish(1, 0, umsg::ByteSpan{const_cast<uint8_t *>(p), 3}) ==
+                                       umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, q.drain(sink) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, sink.frames);
+        UMSG_TEST_EXPECT_EQ_U32(ctx, 0x42, sink.last);
+    }
+
+    void test_publish_queue_threads(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "publish queue: concurrent producers, one drainer");
+        static const size_t kPerProducer = 500;
+        typedef umsg::PublishQueue<kMaxPayload, 16> Queue;
+        static Queue q;
+        static GatherSink sink;
+
+        struct Producer
+        {
+            static void run(uint8_t id)
+            {
+                for (size_t i = 0; i < kPerProducer; ++i)
+                {
+                    const uint8_t p[2] = {id, static_cast<uint8_t>(i)};
+                    while (q.publish(static_cast<uint8_t>(10 + id), 0,
+                                     umsg::ByteSpan{const_cast<uint8_t *>(p), 2}) == umsg::Error::QueueFull)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        };
+
+        std::atomic<size_t> done(0);
+        std::thread producers[kProducers];
+        for (size_t i = 0; i < kProducers; ++i)
+        {
+            producers[i] = std::thread([i, &done]() {
+                Producer::run(static_cast<uint8_t>(i));
+                done.fetch_add(1);
+            });
+        }
+
+        bool drainOk = true;
+        while (done.load() < kProducers || q.ready())
+        {
+            if (q.drain(sink) != umsg::Error::OK)
+            {
+                drainOk = false;
+            }
+            std::this_thread::yield();
+        }
+        for (size_t i = 0; i < kProducers; ++i)
+        {
+            producers[i].join();
+        }
+        drainOk = q.drain(sink) == umsg::Error::OK && drainOk;
+
+        UMSG_TEST_EXPECT_TRUE(ctx, drainOk);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, sink.errors);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, kProducers * kPerProducer, sink.frames);
+
+        // Each producer's messages arrive complete and in its own order.
+        size_t next[kProducers] = {0};
+        bool ordered = true;
+        for (size_t i = 0; i < sink.frames; ++i)
+        {
+            const uint8_t id = sink.first[i];
+            if (id >= kProducers || sink.ids[i] != 10 + id ||
+                sink.second[i] != static_cast<uint8_t>(next[id]))
+            {
+                ordered = false;
+                break;
+            }
+            ++next[id];
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, ordered);
+    }
+    // In-memory byte stream with bulk reads; written by one Node, read by another.
+    struct StreamBuffer
+    {
+        uint8_t data[65536];
+        size_t head;
+        size_t tail;
+
+        StreamBuffer() : head(0), tail(0) {}
+
+        bool write(const uint8_t *bytes, size_t length)
+        {
+            if (length > sizeof(data) - tail)
+            {
+                return false;
+            }
+            ::memcpy(&data[tail], bytes, length);
+            tail += length;
+            return true;
+        }
+
+        bool read(uint8_t &byte)
+        {
+            if (head == tail)
+            {
+                return false;
+            }
+            byte = data[head++];
+            return true;
+        }
+
+        bool read(uint8_t *out, size_t maxLength, size_t &n)
+        {
+            n = tail - head < maxLength ? tail - head : maxLength;
+            ::memcpy(out, &data[head], n);
+            head += n;
+            return true;
+        }
+    };
+
+    // Records payload[0..1] of every frame; optionally slow.
+    struct Recorder
+    {
+        uint8_t first[4096];
+        uint8_t second[4096];
+        size_t count;
+        bool slow;
+
+        Recorder() : count(0), slow(false) {}
+
+        umsg::Error onPayload(umsg::ByteSpan p, uint32_t)
+        {
+            if (count < sizeof(first) && p.length >= 2)
+            {
+                first[count] = p.data[0];
+                second[count] = p.data[1];
+                ++count;
+            }
+            if (slow)
+            {
+                std::this_thread::yield();
+            }
+            return umsg::Error::OK;
+        }
+    };
+
+    void test_frame_ring(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "frame ring: QueueFull at Slots, dispatchPending in order");
+        typedef umsg::FrameRing<kMaxPayload, 4> Ring;
+        Ring ring;
+        umsg::Dispatcher<2> handlers;
+        Recorder rec;
+        UMSG_TEST_EXPECT_TRUE(ctx, handlers.registerHandler(3, &rec, &Recorder::onPayload) == umsg::Error::OK);
+
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 4, ring.freeSlots());
+        for (uint8_t i = 0; i < 4; ++i)
+        {
+            uint8_t p[2] = {i, 7};
+            UMSG_TEST_EXPECT_TRUE(ctx, ring.dispatch(3, 0, umsg::ByteSpan{p, 2}) == umsg::Error::OK);
+        }
+        uint8_t p[kMaxPayload + 1] = {0};
+        UMSG_TEST_EXPECT_TRUE(ctx, ring.dispatch(3, 0, umsg::ByteSpan{p, 2}) == umsg::Error::QueueFull);
+        UMSG_TEST_EXPECT_TRUE(ctx, ring.dispatch(3, 0, umsg::ByteSpan{p, sizeof(p)}) == umsg::Error::InvalidArgument);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, ring.freeSlots());
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 4, ring.pending());
+
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 3, ring.dispatchPending(handlers, 3));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 3, ring.freeSlots());
+        p[0] = 4;
+        UMSG_TEST_EXPECT_TRUE(ctx, ring.dispatch(3, 0, umsg::ByteSpan{p, 2}) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2, ring.dispatchPending(handlers));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, ring.pending());
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 5, rec.count);
+        for (size_t i = 0; i < rec.count; ++i)
+        {
+            UMSG_TEST_EXPECT_EQ_U32(ctx, i, rec.first[i]);
+        }
+    }
+
+    void test_rx_pipeline_backpressure(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "rx pipeline: a full ring leaves frames in the transport");
+        static StreamBuffer wire;
+        umsg::Node<StreamBuffer, kMaxPayload, 1> tx(wire);
+        for (uint8_t i = 0; i < 20; ++i)
+        {
+            uint8_t p[2] = {i, 0};
+            (void)tx.publish(3, 0, umsg::ByteSpan{p, 2});
+        }
+        uint8_t bad[2] = {0xEE, 0};
+        umsg::Node<StreamBuffer, kMaxPayload, 1> wrongVersion(wire, 2);
+        (void)wrongVersion.publish(3, 0, umsg::ByteSpan{bad, 2});
+        (void)tx.publish(3, 0, umsg::ByteSpan{bad, 0}); // shorter than the recorder wants
+
+        umsg::RxPipeline<StreamBuffer, kMaxPayload, 4, 2> rx(wire);
+        Recorder rec;
+        UMSG_TEST_EXPECT_TRUE(ctx, rx.subscribe(3, &rec, &Recorder::onPayload) == umsg::Error::OK);
+
+        UMSG_TEST_EXPECT_TRUE(ctx, rx.poll() > 0);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 4, rx.pending());
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, rx.poll()); // ring full: nothing read
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, rec.count);
+
+        size_t rounds = 0;
+        while ((rx.poll() > 0 || rx.pending() > 0) && rounds < 100)
+        {
+            (void)rx.dispatchPending(1);
+            ++rounds;
+        }
+        (void)rx.dispatchPending();
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 20, rec.count);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, wire.tail, wire.head);
+        for (size_t i = 0; i < rec.count; ++i)
+        {
+            UMSG_TEST_EXPECT_EQ_U32(ctx, i, rec.first[i]);
+        }
+    }
+
+    void test_rx_pipeline_threads(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "rx pipeline: I/O thread + slow handler thread, no frame lost");
+        static const size_t kFrames = 2000;
+        static StreamBuffer wire;
+        umsg::Node<StreamBuffer, kMaxPayload, 1> tx(wire);
+        for (size_t i = 0; i < kFrames; ++i)
+        {
+            uint8_t p[2] = {static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i)};
+            (void)tx.publish(3, 0, umsg::ByteSpan{p, 2});
+        }
+
+        static umsg::RxPipeline<StreamBuffer, kMaxPayload, 8, 2> rx(wire);
+        static Recorder rec;
+        rec.slow = true;
+        UMSG_TEST_EXPECT_TRUE(ctx, rx.subscribe(3, &rec, &Recorder::onPayload) == umsg::Error::OK);
+
+        std::atomic<bool> stop(false);
+        std::thread io([&stop]() {
+            while (!stop.load())
+            {
+                if (rx.poll() == 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        const std::chrono::steady_clock::time_point deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (rec.count < kFrames && std::chrono::steady_clock::now() < deadline)
+        {
+            if (rx.dispatchPending() == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        stop.store(true);
+        io.join();
+
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, kFrames, rec.count);
+        bool ordered = rec.count == kFrames;
+        for (size_t i = 0; ordered && i < kFrames; ++i)
+        {
+            ordered = rec.first[i] == static_cast<uint8_t>(i >> 8) && rec.second[i] == static_cast<uint8_t>(i);
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, ordered);
+    }
+    // Arduino-style TX: returns a byte count.
+    struct CountingTx
+    {
+        size_t bytes;
+
+        size_t write(const uint8_t *, size_t length)
+        {
+            bytes += length;
+            return length;
+        }
+    };
+
+    void test_isr_ring(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "isr ring: push / bulk read across the wrap, overruns counted");
+        CountingTx txSink = {0};
+        umsg::IsrRingTransport<16, CountingTx> ring(txSink);
+
+        uint8_t out[32];
+        size_t n = 0;
+        UMSG_TEST_EXPECT_TRUE(ctx, !ring.read(out, sizeof(out), n));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, n);
+
+        for (uint8_t i = 0; i < 10; ++i)
+        {
+            UMSG_TEST_EXPECT_TRUE(ctx, ring.push(i));
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, ring.read(out, 8, n));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 8, n);
+
+        uint8_t burst[20];
+        for (uint8_t i = 0; i < sizeof(burst); ++i)
+        {
+            burst[i] = static_cast<uint8_t>(10 + i);
+        }
+        // 2 bytes buffered, 13 free of 15 usable: the burst wraps and 7 bytes overrun.
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 13, ring.push(burst, sizeof(burst)));
+        UMSG_TEST_EXPECT_TRUE(ctx, !ring.push(0xEE));
+        UMSG_TEST_EXPECT_EQ_U32(ctx, 8, ring.overruns());
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 15, ring.available());
+
+        UMSG_TEST_EXPECT_TRUE(ctx, ring.read(out, sizeof(out), n));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 15, n);
+        bool inOrder = true;
+        for (size_t i = 0; i < n; ++i)
+        {
+            inOrder = inOrder && out[i] == 8 + i;
+        }
+        UMSG_TEST_EXPECT_TRUE(ctx, inOrder);
+
+        uint8_t b = 0;
+        UMSG_TEST_EXPECT_TRUE(ctx, ring.push(0x42) && ring.read(b) && b == 0x42 && !ring.read(b));
+        UMSG_TEST_EXPECT_TRUE(ctx, ring.write(burst, 5));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 5, txSink.bytes);
+
+        UMSG_TEST_SECTION(ctx, "isr ring: DMA mode publishes the write position");
+        uint8_t *dma = ring.dmaBuffer();
+        ring.clear(); // read position is now 8
+        for (size_t i = 0; i < 16; ++i)
+        {
+            dma[i] = static_cast<uint8_t>(0x80 + i);
+        }
+        ring.dmaWritten(3); // DMA wrote 8..15, wrapped, then 0..2
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 11, ring.available());
+        UMSG_TEST_EXPECT_TRUE(ctx, ring.read(out, sizeof(out), n));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 11, n);
+        UMSG_TEST_EXPECT_TRUE(ctx, out[0] == 0x88 && out[10] == 0x82);
+        ring.dmaWritten(16); // == kCapacity: position 0
+        UMSG_TEST_EXPECT_TRUE(ctx, ring.read(out, sizeof(out), n));
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 13, n);
+        UMSG_TEST_EXPECT_TRUE(ctx, out[0] == 0x83 && out[12] == 0x8F);
+    }
+
+    struct FrameCounter
+    {
+        size_t count;
+        size_t nextSeq;
+        bool ordered;
+
+        umsg::Error onPayload(umsg::ByteSpan p, uint32_t)
+        {
+            const size_t seq = p.length >= 2 ? static_cast<size_t>(p.data[0]) << 8 | p.data[1] : ~static_cast<size_t>(0);
+            ordered = ordered && seq == nextSeq;
+            ++nextSeq;
+            ++count;
+            return umsg::Error::OK;
+        }
+    };
+
+    void test_isr_ring_node(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "isr ring: Node::poll drains bytes pushed from another thread");
+        static const size_t kFrames = 1000;
+        static StreamBuffer wire;
+        umsg::Node<StreamBuffer, kMaxPayload, 1> tx(wire);
+        for (size_t i = 0; i < kFrames; ++i)
+        {
+            uint8_t p[4] = {static_cast<uint8_t>(i >> 8), static_cast<uint8_t>(i), 0, 0x55};
+            (void)tx.publish(3, 0, umsg::ByteSpan{p, sizeof(p)});
+        }
+
+        CountingTx txSink = {0};
+        typedef umsg::IsrRingTransport<64, CountingTx> Ring;
+        static Ring ring(txSink);
+        umsg::Node<Ring, kMaxPayload, 1> rx(ring);
+        FrameCounter counter = {0, 0, true};
+        UMSG_TEST_EXPECT_TRUE(ctx, rx.subscribe(3, &counter, &FrameCounter::onPayload) == umsg::Error::OK);
+
+        // Stands in for the UART interrupt; waits instead of overrunning.
+        std::thread isr([]() {
+            for (size_t i = 0; i < wire.tail; ++i)
+            {
+                while (!ring.push(wire.data[i]))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        const std::chrono::steady_clock::time_point deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (counter.count < kFrames && std::chrono::steady_clock::now() < deadline)
+        {
+            if (rx.poll() == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        isr.join();
+
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, kFrames, counter.count);
+        UMSG_TEST_EXPECT_TRUE(ctx, counter.ordered);
+    }
+}
+
+void test_queues(umsg_test::TestContext &ctx)
+{
+    test_publish_queue_single_thread(ctx);
+    test_publish_queue_datagram(ctx);
+    test_publish_queue_threads(ctx);
+    test_frame_ring(ctx);
+    test_rx_pipeline_backpressure(ctx);
+    test_rx_pipeline_threads(ctx);
+    test_isr_ring(ctx);
+    test_isr_ring_node(ctx);
+}
@@ -0,0 +1,304 @@
+#include "test_harness.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <umsg/common.hpp>
+#include <umsg/crc32.hpp>
+#include <umsg/datagram.hpp>
+#include <umsg/framer.hpp>
+#include <umsg/marshalling.hpp>
+#include <umsg/protocol.hpp>
+#include <umsg/router.hpp>
+
+namespace
+{
+    static const size_t kMaxPayload = 64;
+    static const size_t kPacketSize = umsg::maxPacketSize(kMaxPayload);
+
+    // Byte stream: write() appends, read() hands the bytes back (byte or bulk).
+    struct StreamLink
+    {
+        uint8_t data[8192];
+        size_t head;
+        size_t tail;
+        size_t writes;
+
+        StreamLink() : head(0), tail(0), writes(0) {}
+
+        bool write(const uint8_t *bytes, size_t length)
+        {
+            if (length > sizeof(data) - tail)
+            {
+                return false;
+            }
+            ::memcpy(&data[tail], bytes, length);
+            tail += length;
+            ++writes;
+            return true;
+        }
+
+        bool read(uint8_t &byte)
+        {
+            if (head == tail)
+            {
+                return false;
+            }
+            byte = data[head++];
+            return true;
+        }
+    };
+
+    struct BulkStreamLink : StreamLink
+    {
+        using StreamLink::read;
+
+        bool read(uint8_t *out, size_t capacity, size_t &n)
+        {
+            n = tail - head < capacity ? tail - head : capacity;
+            ::memcpy(out, &data[head], n);
+            head += n;
+            return n > 0;
+        }
+    };
+
+    // Datagram queue: one write() per datagram, readDatagram() in order.
+    struct DatagramLink
+    {
+        static const size_t kSlots = 32;
+
+        uint8_t data[kSlots][256];
+        size_t length[kSlots];
+        size_t count;
+        size_t next;
+
+        DatagramLink() : count(0), next(0) {}
+
+        bool write(const uint8_t *bytes, size_t n)
+        {
+            if (count == kSlots || n > sizeof(data[0]))
+            {
+                return false;
+            }
+            ::memcpy(data[count], bytes, n);
+            length[count++] = n;
+            return true;
+        }
+
+        bool readDatagram(umsg::ByteSpan &datagram)
+        {
+            if (next == count)
+            {
+                return false;
+            }
+            datagram = umsg::ByteSpan{data[next], length[next]};
+            ++next;
+            return true;
+        }
+    };
+
+    struct FailingLink
+    {
+        bool write(const uint8_t *, size_t) { return false; }
+    };
+
+    // frame || crc32 for (msgId, payload of @p n bytes starting at @p seed); returns its length.
+    size_t makeFrame(uint8_t msgId, uint8_t seed, size_t n, uint8_t *out)
+    {
+        uint8_t payload[kMaxPayload];
+        for (size_t i = 0; i < n; ++i)
+        {
+            payload[i] = static_cast<uint8_t>(seed + i * 37); // includes 0x00 bytes
+        }
+        umsg::ByteSpan frame{out, umsg::maxFrameSize(kMaxPayload)};
+        (void)umsg::protocol::encodeFrame(1, msgId, 0xA5A5A5A5u, umsg::ByteSpan{payload, n}, frame);
+        umsg::write_u32_be(out + frame.length, umsg::crc32_iso_hdlc(out, frame.length));
+        return frame.length + 4;
+    }
+
+    // Appends the COBS packet for makeFrame(...) to @p link.
+    void writePacket(StreamLink &link, uint8_t msgId, uint8_t seed, size_t n)
+    {
+        uint8_t frame[umsg::maxDatagramSize(kMaxPayload)];
+        const size_t length = makeFrame(msgId, seed, n, frame);
+        umsg::Framer<kPacketSize> framer;
+        uint8_t packet[kPacketSize];
+        umsg::ByteSpan out{packet, sizeof(packet)};
+        (void)framer.encode(umsg::ByteSpan{frame, length - 4}, out);
+        (void)link.write(packet, out.length);
+    }
+
+    void test_router_stream(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "router: stream -> stream forwards the received packets byte for byte, for any read split");
+        StreamLink in;
+        writePacket(in, 1, 0, 0);
+        writePacket(in, 2, 9, 40);
+        writePacket(in, 1, 3, kMaxPayload);
+        writePacket(in, 7, 5, 10); // no route
+        writePacket(in, 2, 1, 3);
+
+        const size_t splits[] = {1, 3, 7, 64, sizeof(in.data)};
+        for (size_t s = 0; s < sizeof(splits) / sizeof(splits[0]); ++s)
+        {
+            StreamLink out;
+            umsg::RouteTable<4> table;
+            UMSG_TEST_EXPECT_TRUE(ctx, table.add(1, umsg::RouterPort::stream(out)) == umsg::Error::OK);
+            UMSG_TEST_EXPECT_TRUE(ctx, table.add(2, umsg::RouterPort::stream(out)) == umsg::Error::OK);
+            umsg::Router<kMaxPayload> router(table);
+            for (size_t pos = 0; pos < in.tail; pos += splits[s])
+            {
+                const size_t n = in.tail - pos < splits[s] ? in.tail - pos : splits[s];
+                router.feed(umsg::ByteSpan{&in.data[pos], n});
+            }
+            StreamLink expected;
+            writePacket(expected, 1, 0, 0);
+            writePacket(expected, 2, 9, 40);
+            writePacket(expected, 1, 3, kMaxPayload);
+            writePacket(expected, 2, 1, 3);
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, expected.tail, out.tail);
+            UMSG_TEST_EXPECT_BUF_EQ(ctx, expected.data, out.data, expected.tail);
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, 4, out.writes);
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, 5, router.stats().framesIn);
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, 4, router.stats().framesOut);
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, router.stats().unrouted);
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, router.stats().rejected);
+        }
+
+        UMSG_TEST_SECTION(ctx, "router: stream -> datagram writes frame || crc32 per frame");
+        {
+            DatagramLink out;
+            umsg::RouteTable<2> table;
+            UMSG_TEST_EXPECT_TRUE(ctx, table.addFallback(umsg::RouterPort::datagram(out)) == umsg::Error::OK);
+            umsg::Router<kMaxPayload> router(table);
+            router.feed(umsg::ByteSpan{in.data, in.tail});
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, 5, out.count);
+            uint8_t frame[umsg::maxDatagramSize(kMaxPayload)];
+            const size_t length = makeFrame(2, 9, 40, frame);
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, length, out.length[1]);
+            UMSG_TEST_EXPECT_BUF_EQ(ctx, frame, out.data[1], length);
+        }
+
+        UMSG_TEST_SECTION(ctx, "router: corrupt, oversized and runt packets are rejected without losing the next one");
+        {
+            StreamLink bad;
+            writePacket(bad, 1, 0, 5);
+            bad.data[3] ^= 0x40; // CRC error
+            const uint8_t runt[] = {0x02, 0x01, 0x00};
+            (void)bad.write(runt, sizeof(runt));
+            uint8_t junk[kPacketSize + 8];
+            ::memset(junk, 0x11, sizeof(junk)); // overflows the framer
+            (void)bad.write(junk, sizeof(junk));
+            const uint8_t delimiter = 0x00;
+            (void)bad.write(&delimiter, 1);
+            writePacket(bad, 1, 4, 6);
+
+            StreamLink out;
+            umsg::RouteTable<1> table;
+            (void)table.add(1, umsg::RouterPort::stream(out));
+            umsg::Router<kMaxPayload> router(table);
+            for (size_t pos = 0; pos < bad.tail; pos += 5)
+            {
+                router.feed(umsg::ByteSpan{&bad.data[pos], bad.tail - pos < 5 ? bad.tail - pos : 5});
+            }
+            StreamLink expected;
+            writePacket(expected, 1, 4, 6);
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, 3, router.stats().rejected);
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, expected.tail, out.tail);
+            UMSG_TEST_EXPECT_BUF_EQ(ctx, expected.data, out.data, expected.tail);
+        }
+
+        UMSG_TEST_SECTION(ctx, "router: poll() reads byte and bulk transports; reset() drops a partial packet");
+        {
+            StreamLink out;
+            umsg::RouteTable<1> table;
+            (void)table.addFallback(umsg::RouterPort::stream(out));
+            umsg::Router<kMaxPayload> router(table);
+
+            StreamLink bytes;
+            ::memcpy(bytes.data, in.data, in.tail);
+            bytes.tail = in.tail;
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, in.tail, router.poll(bytes));
+            BulkStreamLink bulk;
+            ::memcpy(bulk.data, in.data, in.tail);
+            bulk.tail = in.tail;
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, in.tail, router.poll(bulk));
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, 10, out.writes);
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, 2 * in.tail, out.tail);
+
+            router.feed(umsg::ByteSpan{in.data, 6});
+            router.reset();
+            router.feed(umsg::ByteSpan{in.data, in.tail});
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, 15, out.writes);
+            UMSG_TEST_EXPECT_EQ_SIZE(ctx, 0, router.stats().rejected);
+        }
+    }
+
+    void test_router_datagram(umsg_test::TestContext &ctx)
+    {
+        UMSG_TEST_SECTION(ctx, "router: datagram -> datagram / stream, fan-out and fallback");
+        DatagramLink in;
+        uint8_t datagram[256];
+        size_t length = makeFrame(1, 2, 30, datagram);
+        length += makeFrame(3, 0, 0, datagram + length);
+        length += makeFrame(9, 8, 12, datagram + length);
+        (void)in.write(datagram, length);
+        datagram[4] ^= 0x01; // CRC error in the first frame drops the whole datagram
+        (void)in.write(datagram, length);
+
+        DatagramLink udp;
+        StreamLink serial;
+        StreamLink other;
+        umsg::RouteTable<4> table;
+        UMSG_TEST_EXPECT_TRUE(ctx, table.add(1, umsg::RouterPort::datagram(udp)) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, table.add(1, umsg::RouterPort::stream(serial)) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, table.add(3, umsg::RouterPort::stream(serial)) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_TRUE(ctx, table.add(3, umsg::RouterPort::stream(serial)) == umsg::Error::OK); // no-op
+        UMSG_TEST_EXPECT_TRUE(ctx, table.addFallback(umsg::RouterPort::stream(other)) == umsg::Error::OK);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 4, table.size());
+        UMSG_TEST_EXPECT_TRUE(ctx, table.add(5, umsg::RouterPort::stream(other)) == umsg::Error::InvalidArgument);
+        UMSG_TEST_EXPECT_TRUE(ctx, table.add(5, umsg::RouterPort()) == umsg::Error::InvalidArgument);
+
+        umsg::Router<kMaxPayload, umsg::DatagramFraming> router(table);
+        (void)router.poll(in);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 3, router.stats().framesIn);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 4, router.stats().framesOut);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, router.stats().rejected);
+
+        uint8_t frame[umsg::maxDatagramSize(kMaxPayload)];
+        const size_t first = makeFrame(1, 2, 30, frame);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, udp.count);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, first, udp.length[0]);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, frame, udp.data[0], first);
+
+        StreamLink expected;
+        writePacket(expected, 1, 2, 30);
+        writePacket(expected, 3, 0, 0);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, expected.tail, serial.tail);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, expected.data, serial.data, expected.tail);
+        StreamLink expectedOther;
+        writePacket(expectedOther, 9, 8, 12);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, expectedOther.tail, other.tail);
+        UMSG_TEST_EXPECT_BUF_EQ(ctx, expectedOther.data, other.data, expectedOther.tail);
+
+        UMSG_TEST_SECTION(ctx, "router: a failed port write is counted and other ports still get the frame");
+        FailingLink down;
+        StreamLink up;
+        umsg::RouteTable<2> table2;
+        (void)table2.add(3, umsg::RouterPort::stream(down));
+        (void)table2.add(3, umsg::RouterPort::stream(up));
+        umsg::Router<kMaxPayload, umsg::DatagramFraming> router2(table2);
+        const size_t n = makeFrame(3, 0, 0, frame);
+        router2.feed(umsg::ByteSpan{frame, n});
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, router2.stats().writeErrors);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, router2.stats().framesOut);
+        UMSG_TEST_EXPECT_EQ_SIZE(ctx, 1, up.writes);
+    }
+}
+
+void test_router(umsg_test::TestContext &ctx)
+{
+    test_router_stream(ctx);
+    test_router_datagram(ctx);
+}
@@ -26,7 +26,20 @@ from typing import List, Optional, Sequence, Tuple
 class Field:
     type_name: str  # e.g. uint32_t, double
     name: str
-    array_len: Optional[int] = None
+    array_len: Optional[int] = None  # fixed length, or the bound of a [<=N] array
+    bounded: bool = False  # [<=N]: varint element count, then up to N elements
+
+    @property
+    def cpp_type(self) -> str:
+        return _VARINT_TYPES.get(self.type_name, self.type_name)
+
+    @property
+    def is_varint(self) -> bool:
+        return self.type_name in _VARINT_TYPES
+
+    @property
+    def count_member(self) -> str:
+        return f"{self.name}_count"
 
 
 @dataclasses.dataclass(frozen=True)
@@ -37,6 +50,11 @@ class Message:
     canonical_text: str
     msg_hash: int
 
+    @property
+    def fixed_layout(self) -> bool:
+        """True when every field has a constant size and offset on the wire."""
+        return not any(f.is_varint or f.bounded for f in self.fields)
+
 
 # ---- hashing (design.md: FNV-1a 32-bit) ----
 
@@ -87,8 +105,31 @@ _ALLOWED_TYPES = {
     "double",
 }
 
+# Variable-length integers: schema type -> C++ member type. `varuint*` are LEB128,
+# `varint*` are zig-zag mapped first (see marshalling.hpp).
+_VARINT_TYPES = {
+    "varuint32_t": "uint32_t",
+    "varuint64_t": "uint64_t",
+    "varint32_t": "int32_t",
+    "varint64_t": "int64_t",
+}
+
+_ALLOWED_TYPES |= set(_VARINT_TYPES)
+
 _IDENT_RE = r"[A-Za-z_][A-Za-z0-9_]*"
 
+# Names the generated struct uses itself.
+_RESERVED_MEMBERS = {
+    "Offset",
+    "kMsgHash",
+    "kPayloadSize",
+    "encodeTo",
+    "encodedSize",
+    "encodeUnchecked",
+    "encode",
+    "decode",
+}
+
 
 class ParseError(Exception):
     pass
@@ -163,15 +204,15 @@ def parse_umsg(text: str) -> Message:
         if not stmt:
             continue
 
-        # Match: <type> <name> [ [N] ]
+        # Match: <type> <name> [ [N] | [<=N] ]
         fm = re.fullmatch(
-            rf"({_IDENT_RE})\s+({_IDENT_RE})\s*(?:\[\s*(\d+)\s*\])?\s*",
+            rf"({_IDENT_RE})\s+({_IDENT_RE})\s*(?:\[\s*(<=)?\s*(\d+)\s*\])?\s*",
             stmt,
         )
         if not fm:
             raise ParseError(f"invalid field declaration: '{stmt}'")
 
-        type_name, name, arr = fm.group(1), fm.group(2), fm.group(3)
+        type_name, name, bound, arr = fm.group(1), fm.group(2), fm.group(3), fm.group(4)
         if type_name not in _ALLOWED_TYPES:
             raise ParseError(f"unsupported type '{type_name}'")
 
@@ -181,11 +222,18 @@ def parse_umsg(text: str) -> Message:
             if array_len <= 0:
                 raise ParseError("array length must be > 0")
 
-        fields.append(Field(type_name=type_name, name=name, array_len=array_len))
+        fields.append(Field(type_name=type_name, name=name, array_len=array_len, bounded=bound is not None))
 
     if not fields:
         raise ParseError("struct has no fields")
 
+    members = [f.name for f in fields] + [f.count_member for f in fields if f.bounded]
+    for member in members:
+        if members.count(member) > 1:
+            raise ParseError(f"duplicate member '{member}'")
+        if member in _RESERVED_MEMBERS:
+            raise ParseError(f"field name '{member}' is reserved")
+
     _expect_no_extra_tokens(src)
 
     return Message(
@@ -205,16 +253,275 @@ def cpp_type_size_expr(type_name: str) -> str:
     return f"sizeof({type_name})"
 
 
+def varint_size(v: int) -> int:
+    n = 1
+    while v >= 0x80:
+        v >>= 7
+        n += 1
+    return n
+
+
+def cpp_element_size_expr(f: Field) -> str:
+    """Largest wire size of one element of @p f."""
+    if f.is_varint:
+        return "umsg::kMaxVarint64Size" if f.cpp_type.endswith("64_t") else "umsg::kMaxVarint32Size"
+    return cpp_type_size_expr(f.type_name)
+
+
 def cpp_payload_size_expr(fields: Sequence[Field]) -> str:
+    """Payload size, or for messages with varints / bounded arrays its upper bound."""
     parts: List[str] = []
     for f in fields:
         if f.array_len is None:
-            parts.append(cpp_type_size_expr(f.type_name))
+            parts.append(cpp_element_size_expr(f))
+        elif f.bounded:
+            parts.append(f"({varint_size(f.array_len)}u + {cpp_element_size_expr(f)} * {f.array_len}u)")
         else:
-            parts.append(f"({cpp_type_size_expr(f.type_name)} * {f.array_len}u)")
+            parts.append(f"({cpp_element_size_expr(f)} * {f.array_len}u)")
     return " + ".join(parts) if parts else "0u"
 
 
+def count_type(bound: int) -> str:
+    # Strictly below the type's maximum, so `count > bound` stays a meaningful check.
+    if bound < 0xFF:
+        return "uint8_t"
+    if bound < 0xFFFF:
+        return "uint16_t"
+    return "uint32_t"
+
+
+def varint_value_expr(f: Field, value: str) -> str:
+    """Unsigned value that goes on the wire for the varint field element @p value."""
+    if f.cpp_type.startswith("u"):
+        return value
+    return f"umsg::zigzag_encode({value})"
+
+
+def emit_encoded_size(msg: Message) -> List[str]:
+    if msg.fixed_layout:
+        return ["    size_t encodedSize() const { return kPayloadSize; }"]
+
+    fixed = cpp_payload_size_expr(
+        [f for f in msg.fields if not (f.is_varint or f.bounded)]
+    )
+    lines = [
+        "    size_t encodedSize() const",
+        "    {",
+        f"        size_t n = {fixed};",
+    ]
+    for f in msg.fields:
+        if not (f.is_varint or f.bounded):
+            continue
+        count = f.count_member if f.bounded else f"{f.array_len}u"
+        if f.bounded:
+            lines.append(f"        n += umsg::varint_size({f.count_member});")
+        if not f.is_varint:
+            lines.append(f"        n += {_WIRE_SIZES[f.type_name]}u * {count};")
+        elif f.array_len is None:
+            lines.append(f"        n += umsg::varint_size({varint_value_expr(f, f.name)});")
+        else:
+            lines.append(
+                f"        for (size_t i = 0; i < {count}; ++i) "
+                f"n += umsg::varint_size({varint_value_expr(f, f.name + '[i]')});"
+            )
+    lines += [
+        "        return n;",
+        "    }",
+    ]
+    return lines
+
+
+def emit_encode_field(f: Field) -> List[str]:
+    write = "writeZigzag" if f.is_varint and not f.cpp_type.startswith("u") else "writeVarint"
+    if f.array_len is None:
+        if f.is_varint:
+            return [f"        if (!w.{write}({f.name})) return false;"]
+        return [f"        if (!w.write({f.name})) return false;"]
+
+    lines: List[str] = []
+    count = f"{f.array_len}u"
+    if f.bounded:
+        count = f.count_member
+        lines.append(f"        if ({f.count_member} > {f.array_len}u || !w.writeVarint({f.count_member})) return false;")
+    if f.is_varint:
+        lines.append(f"        for (size_t i = 0; i < {count}; ++i)")
+        lines.append(f"            if (!w.{write}({f.name}[i])) return false;")
+    else:
+        lines.append(f"        if (!w.writeArray({f.name}, {count})) return false;")
+    return lines
+
+
+def emit_decode_field(f: Field) -> List[str]:
+    read = "readZigzag" if f.is_varint and not f.cpp_type.startswith("u") else "readVarint"
+    if f.array_len is None:
+        if f.is_varint:
+            return [f"        if (!r.{read}({f.name})) return false;"]
+        return [f"        if (!r.read({f.name})) return false;"]
+
+    lines: List[str] = []
+    count = f"{f.array_len}u"
+    if f.bounded:
+        count = f.count_member
+        lines += [
+            "        {",
+            "            uint32_t count;",
+            f"            if (!r.readVarint(count) || count > {f.array_len}u) return false;",
+            f"            {f.count_member} = static_cast<{count_type(f.array_len)}>(count);",
+            "        }",
+        ]
+    if f.is_varint:
+        lines.append(f"        for (size_t i = 0; i < {count}; ++i)")
+        lines.append(f"            if (!r.{read}({f.name}[i])) return false;")
+    else:
+        lines.append(f"        if (!r.readArray({f.name}, {count})) return false;")
+    return lines
+
+
+# Canonical on-wire size of each scalar (bool is one byte; see marshalling.hpp).
+_WIRE_SIZES = {
+    "uint8_t": 1,
+    "int8_t": 1,
+    "bool": 1,
+    "uint16_t": 2,
+    "int16_t": 2,
+    "uint32_t": 4,
+    "int32_t": 4,
+    "float": 4,
+    "uint64_t": 8,
+    "int64_t": 8,
+    "double": 8,
+}
+
+
+def field_offsets(msg: Message) -> List[Tuple[Field, int]]:
+    """Wire offset of each field of a fixed-layout message."""
+    offsets: List[Tuple[Field, int]] = []
+    offset = 0
+    for f in msg.fields:
+        offsets.append((f, offset))
+        offset += _WIRE_SIZES[f.type_name] * (f.array_len if f.array_len is not None else 1)
+    return offsets
+
+
+# Fixed arrays up to this length are unrolled into per-element stores and loads;
+# longer ones go through the bulk (SIMD) array codec.
+_UNROLL_MAX = 8
+
+
+def emit_fixed_codec(msg: Message) -> List[str]:
+    """Offset table plus encode/decode at constant offsets: one size check, no per-field bounds checks."""
+    lines: List[str] = [
+        "    // Wire offset of each field.",
+        "    struct Offset",
+        "    {",
+    ]
+    for f, offset in field_offsets(msg):
+        lines.append(f"        static const size_t {f.name} = {offset}u;")
+    lines += [
+        "    };",
+        "",
+        "    // Store every field at its offset; out must hold kPayloadSize bytes.",
+        "    void encodeUnchecked(uint8_t* out) const",
+        "    {",
+    ]
+    for f in msg.fields:
+        if f.array_len is None:
+            lines.append(f"        umsg::write_be(out + Offset::{f.name}, {f.name});")
+        elif f.array_len <= _UNROLL_MAX:
+            size = _WIRE_SIZES[f.type_name]
+            for i in range(f.array_len):
+                lines.append(f"        umsg::write_be(out + Offset::{f.name} + {size * i}u, {f.name}[{i}]);")
+        else:
+            lines.append(f"        umsg::write_array_be(out + Offset::{f.name}, {f.name}, {f.array_len}u);")
+    lines += [
+        "    }",
+        "",
+        "    bool encode(umsg::ByteSpan& payload) const",
+        "    {",
+        "        if (!payload.data || payload.length < kPayloadSize) return false;",
+        "        encodeUnchecked(payload.data);",
+        "        payload.length = kPayloadSize;",
+        "        return true;",
+        "    }",
+        "",
+        "    bool decode(umsg::ByteSpan payload)",
+        "    {",
+        "        if (!payload.data || payload.length < kPayloadSize) return false;",
+        "        const uint8_t* in = payload.data;",
+    ]
+    for f in msg.fields:
+        if f.type_name == "bool" and (f.array_len is None or f.array_len <= _UNROLL_MAX):
+            count = f.array_len if f.array_len is not None else 1
+            lines.append(f"        if (!umsg::valid_bools(in + Offset::{f.name}, {count}u)) return false;")
+    for f in msg.fields:
+        if f.array_len is None:
+            lines.append(f"        {f.name} = umsg::read_be<{f.type_name}>(in + Offset::{f.name});")
+        elif f.array_len <= _UNROLL_MAX:
+            size = _WIRE_SIZES[f.type_name]
+            for i in range(f.array_len):
+                lines.append(f"        {f.name}[{i}] = umsg::read_be<{f.type_name}>(in + Offset::{f.name} + {size * i}u);")
+        elif f.type_name == "bool":
+            lines.append(f"        if (!umsg::read_array_be({f.name}, in + Offset::{f.name}, {f.array_len}u)) return false;")
+        else:
+            lines.append(f"        umsg::read_array_be({f.name}, in + Offset::{f.name}, {f.array_len}u);")
+    lines += [
+        "        return true;",
+        "    }",
+    ]
+    return lines
+
+
+def emit_view(msg: Message) -> List[str]:
+    """Emit `<Name>View`: validates on decode, then reads fields in place at fixed offsets."""
+    name = f"{msg.struct_name}View"
+    lines: List[str] = [
+        f"// Zero-copy view of a {msg.struct_name} payload: subscribe with",
+        f"// `Error (T::*)(const {name}&)` to skip the decode copy. Accessors read the",
+        "// aliased payload, so a view is only valid for the duration of the handler call.",
+        f"struct {name}",
+        "{",
+        f"    static const uint32_t kMsgHash = {msg.struct_name}::kMsgHash;",
+        f"    static const size_t kPayloadSize = {msg.struct_name}::kPayloadSize;",
+        "",
+        f"    {name}() : data_(0) {{}}",
+        "",
+        "    bool decode(umsg::ByteSpan payload)",
+        "    {",
+        "        if (payload.length < kPayloadSize) return false;",
+    ]
+
+    accessors: List[str] = []
+    for f in msg.fields:
+        size = _WIRE_SIZES[f.type_name]
+        count = f.array_len if f.array_len is not None else 1
+        offset = f"{msg.struct_name}::Offset::{f.name}"
+        if f.type_name == "bool":
+            lines.append(f"        if (!umsg::valid_bools(payload.data + {offset}, {count}u)) return false;")
+        if f.array_len is None:
+            accessors.append(
+                f"    {f.type_name} {f.name}() const {{ return umsg::read_be<{f.type_name}>(data_ + {offset}); }}"
+            )
+        else:
+            accessors.append(f"    /** @pre i < {f.array_len} */")
+            accessors.append(
+                f"    {f.type_name} {f.name}(size_t i) const "
+                f"{{ return umsg::read_be<{f.type_name}>(data_ + {offset} + {size}u * i); }}"
+            )
+
+    lines += [
+        "        data_ = payload.data;",
+        "        return true;",
+        "    }",
+        "",
+        *accessors,
+        "",
+        "private:",
+        "    const uint8_t* data_;",
+        "};",
+    ]
+    return lines
+
+
 def emit_header(msg: Message, source_path: Optional[str] = None, header_guard: Optional[str] = None) -> str:
     # Prefer #pragma once in this repo.
     payload_size_expr = cpp_payload_size_expr(msg.fields)
@@ -223,28 +530,45 @@ def emit_header(msg: Message, source_path: Optional[str] = None, header_guard: O
     ]
     for f in msg.fields:
         if f.array_len is None:
-            struct_lines.append(f"    {f.type_name} {f.name};")
+            struct_lines.append(f"    {f.cpp_type} {f.name};")
         else:
-            struct_lines.append(f"    {f.type_name} {f.name}[{f.array_len}];")
+            struct_lines.append(f"    {f.cpp_type} {f.name}[{f.array_len}];")
+        if f.bounded:
+            struct_lines.append(f"    {count_type(f.array_len)} {f.count_member}; // valid elements of {f.name}")
     struct_lines.append("")
     struct_lines.append(f"    static const uint32_t kMsgHash = 0x{msg.msg_hash:08X}u;")
+    if not msg.fixed_layout:
+        struct_lines.append("    // Upper bound: varints and [<=N] arrays encode only what they hold.")
     struct_lines.append(f"    static const size_t kPayloadSize = {payload_size_expr};")
     struct_lines.append("")
 
-    # encode/decode use capacity-in/length-out for encode.
+    # encodeTo works with any Writer-like sink (umsg::Writer, umsg::StreamWriter<...>),
+    # so Node can stream fields straight into the packet encoder.
+    struct_lines.append("    template <class W>")
+    struct_lines.append("    bool encodeTo(W& w) const")
+    struct_lines.append("    {")
+    for f in msg.fields:
+        struct_lines += emit_encode_field(f)
+    struct_lines.append("        return true;")
+    struct_lines.append("    }")
+    struct_lines.append("")
+
+    struct_lines += emit_encoded_size(msg)
+    struct_lines.append("")
+
+    if msg.fixed_layout:
+        struct_lines += emit_fixed_codec(msg)
+        struct_lines.append("};")
+        struct_lines.append("")
+        struct_lines += emit_view(msg)
+        return finish_header(struct_lines, source_path, header_guard)
+
+    # encode uses capacity-in/length-out.
     struct_lines.append("    bool encode(umsg::ByteSpan& payload) const")
     struct_lines.append("    {")
     struct_lines.append("        if (!payload.data) return false;")
-    struct_lines.append("        const size_t cap = payload.length;")
     struct_lines.append("        umsg::Writer w(payload);")
-
-    for f in msg.fields:
-        if f.array_len is None:
-            struct_lines.append(f"        if (!w.write({f.name})) return false;")
-        else:
-            struct_lines.append(f"        if (!w.writeArray({f.name}, {f.array_len}u)) return false;")
-
-    struct_lines.append("        if (w.bytesWritten() > cap) return false;")
+    struct_lines.append("        if (!encodeTo(w)) return false;")
     struct_lines.append("        payload.length = w.bytesWritten();")
     struct_lines.append("        return true;")
     struct_lines.append("    }")
@@ -252,20 +576,20 @@ def emit_header(msg: Message, source_path: Optional[str] = None, header_guard: O
 
     struct_lines.append("    bool decode(umsg::ByteSpan payload)")
     struct_lines.append("    {")
-    struct_lines.append("        if (payload.length < kPayloadSize) return false;")
     struct_lines.append("        umsg::Reader r(payload);")
 
     for f in msg.fields:
-        if f.array_len is None:
-            struct_lines.append(f"        if (!r.read({f.name})) return false;")
-        else:
-            struct_lines.append(f"        if (!r.readArray({f.name}, {f.array_len}u)) return false;")
+        struct_lines += emit_decode_field(f)
 
     struct_lines.append("        return true;")
     struct_lines.append("    }")
 
+    # No view: varints and bounded arrays have no constant offsets.
     struct_lines.append("};")
+    return finish_header(struct_lines, source_path, header_guard)
+
 
+def finish_header(struct_lines: List[str], source_path: Optional[str], header_guard: Optional[str]) -> str:
     source_note = ""
     if source_path:
         source_note = os.path.basename(source_path)
@@ -304,6 +628,63 @@ def emit_header(msg: Message, source_path: Optional[str] = None, header_guard: O
     return header
 
 
+def emit_registry(name: str, entries: Sequence[Tuple[int, Message, str]]) -> str:
+    """Emit the `umsg::MessageRegistry` of one package: (msg_id, message, source path) entries."""
+    defs = ",\n".join(f"    umsg::MessageDef<{msg_id}, {msg.struct_name}>" for msg_id, msg, _ in entries)
+    sources = ", ".join(os.path.basename(path) for _, _, path in entries)
+    package = entries[0][1].package
+    lines: List[str] = [
+        "#pragma once",
+        "#include <stddef.h>",
+        "#include <stdint.h>",
+        "",
+        "// -----------------------------------------------------------------------------",
+        "// This file was generated by umsg-gen.",
+        f"// Source: {sources}",
+        "//",
+        "// DO NOT EDIT THIS FILE DIRECTLY.",
+        "// Edit the corresponding .umsg schemas and re-run umsg-gen instead.",
+        "// -----------------------------------------------------------------------------",
+        "",
+        "#include <umsg/registry.hpp>",
+        "",
+        *[f'#include "{msg.struct_name}.hpp"' for _, msg, _ in entries],
+        "",
+        f"// Messages of {'package `' + package + '`' if package else 'the default package'} and their msg_ids.",
+        f"struct {name} : umsg::MessageRegistry<",
+        defs + " >",
+        "{",
+        *[f"    static const uint8_t k{msg.struct_name}Id = {msg_id};" for msg_id, msg, _ in entries],
+        "};",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def parse_input_arg(arg: str) -> Tuple[str, Optional[int]]:
+    """`schema.umsg` or `schema.umsg=<msg_id>`."""
+    path, sep, msg_id = arg.rpartition("=")
+    if not sep or not msg_id.isdigit():
+        return arg, None
+    return path, int(msg_id)
+
+
+def assign_ids(requested: Sequence[Optional[int]], first_id: int) -> List[int]:
+    """Explicit ids are kept; the others continue from the previous message's id."""
+    ids: List[int] = []
+    next_id = first_id
+    for msg_id in requested:
+        if msg_id is None:
+            msg_id = next_id
+        if not 0 <= msg_id <= 255:
+            raise ParseError(f"msg_id {msg_id} out of range 0..255")
+        if msg_id in ids:
+            raise ParseError(f"duplicate msg_id {msg_id}")
+        ids.append(msg_id)
+        next_id = msg_id + 1
+    return ids
+
+
 # ---- CLI ----
 
 
@@ -323,20 +704,34 @@ def write_if_changed(path: str, content: str) -> None:
 
 def main(argv: Sequence[str]) -> int:
     ap = argparse.ArgumentParser(prog="umsg_gen", description="Generate C++ headers from .umsg")
-    ap.add_argument("input", nargs="+", help=".umsg file(s)")
+    ap.add_argument("input", nargs="+", help=".umsg file(s), each optionally suffixed '=<msg_id>' for --registry")
     ap.add_argument("-o", "--out", required=True, help="output directory")
     ap.add_argument("--stdout", action="store_true", help="write generated header(s) to stdout")
+    ap.add_argument("--registry", metavar="NAME", help="also emit NAME.hpp listing the inputs with their msg_ids")
+    ap.add_argument("--first-id", type=int, default=1, help="msg_id of the first input without '=<msg_id>'")
 
     args = ap.parse_args(list(argv))
 
     out_dir = args.out
-
-    for in_path in args.input:
+    inputs = [parse_input_arg(arg) for arg in args.input]
+    if not args.registry and any(msg_id is not None for _, msg_id in inputs):
+        ap.error("'=<msg_id>' suffixes need --registry")
+
+    registry: List[Tuple[int, Message, str]] = []
+    ids = [0] * len(inputs)
+    if args.registry:
+        try:
+            ids = assign_ids([msg_id for _, msg_id in inputs], args.first_id)
+        except ParseError as e:
+            ap.error(str(e))
+
+    for (in_path, _), msg_id in zip(inputs, ids):
         with open(in_path, "r", encoding="utf-8") as f:
             text = f.read()
 
         msg = parse_umsg(text)
         header = emit_header(msg, source_path=in_path)
+        registry.append((msg_id, msg, in_path))
 
         if args.stdout:
             sys.stdout.write(header)
@@ -349,6 +744,18 @@ def main(argv: Sequence[str]) -> int:
             out_path = os.path.join(out_dir, f"{msg.struct_name}.hpp")
         write_if_changed(out_path, header)
 
+    if args.registry:
+        packages = {msg.package for _, msg, _ in registry}
+        if len(packages) != 1:
+            ap.error("--registry inputs must all be in the same package")
+        header = emit_registry(args.registry, registry)
+        if args.stdout:
+            sys.stdout.write(header)
+        else:
+            package = registry[0][1].package
+            package_dir = os.path.join(out_dir, package.replace(".", os.sep)) if package else out_dir
+            write_if_changed(os.path.join(package_dir, f"{args.registry}.hpp"), header)
+
     return 0
 
 
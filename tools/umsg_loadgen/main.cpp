@@ -0,0 +1,718 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <umsg/transports/posix/frame_log.hpp>
+#include <umsg/transports/posix/io.hpp>
+#include <umsg/transports/posix/serial_port.hpp>
+#include <umsg/transports/posix/shm_ring.hpp>
+#include <umsg/transports/posix/tcp_client.hpp>
+#include <umsg/transports/posix/tcp_server.hpp>
+#include <umsg/transports/posix/udp_socket.hpp>
+#include <umsg/umsg.h>
+
+/*
+ * umsg_loadgen
+ *
+ * Latency and throughput of a Node over one transport, sender and receiver in
+ * this process (one thread each, one monotonic clock):
+ *
+ *   umsg_loadgen [options] loopback            in-memory byte pipe (Node cost only)
+ *   umsg_loadgen [options] udp                 two UdpSockets on 127.0.0.1
+ *   umsg_loadgen [options] tcp                 TcpClient -> TcpServer on 127.0.0.1
+ *   umsg_loadgen [options] pty                 pseudo-terminal pair, received by a SerialPort
+ *   umsg_loadgen [options] serial:DEV[@BAUD]   one SerialPort with TX wired to RX
+ *   umsg_loadgen [options] shm                 ShmRing writer -> reader
+ *
+ * Every probe carries its sequence number and send time; the receiver records
+ * one latency sample per probe. With a publish rate, the send time is the
+ * scheduled one, so a stalled sender shows in the percentiles instead of
+ * silently lowering the rate.
+ */
+
+namespace
+{
+    const size_t kMaxPayload = 16384;
+    const size_t kProbeHeader = 12; // seq (u32) | send time in ns (u64)
+    const uint8_t kProbeId = 1;
+    const uint32_t kProbeHash = 0x4C4F4144u; // "LOAD"
+    const size_t kMaxList = 16;
+    const uint64_t kDrainNs = 500000000ull; // wait for stragglers after the last send
+
+    uint64_t nowNs() { return umsg::posix::detail::clockNs(CLOCK_MONOTONIC); }
+
+    struct Options
+    {
+        const char *transport;
+        size_t sizes[kMaxList];
+        size_t sizeCount;
+        double rates[kMaxList];
+        size_t rateCount;
+        size_t count;
+        bool batch;
+        bool datagram;
+        bool csv;
+    };
+
+    struct Result
+    {
+        uint64_t sent;
+        uint64_t failed;
+        uint64_t received;
+        uint64_t reordered;
+        double seconds;
+        uint64_t p50;
+        uint64_t p99;
+        uint64_t p999;
+        uint64_t max;
+    };
+
+    void usage(const char *argv0)
+    {
+        fprintf(stderr,
+                "Usage: %s [options] loopback | udp | tcp | pty | serial:DEV[@BAUD] | shm\n"
+                "  --sizes A,B,..  payload bytes per probe, >= %zu (default 16,256,1024)\n"
+                "  --rates A,B,..  publishes per second, 0 = as fast as possible (default 0)\n"
+                "  --count N       probes per size and rate (default 100000)\n"
+                "  --batch         coalesce publishes in a TxBatch, flushed whenever the sender waits\n"
+                "  --datagram      DatagramNode framing (udp only; shm always uses it)\n"
+                "  --csv           comma-separated output\n",
+                argv0, kProbeHeader);
+    }
+
+    template <class T>
+    bool parseList(const char *text, T (&out)[kMaxList], size_t &count)
+    {
+        count = 0;
+        while (*text)
+        {
+            char *end;
+            const double v = strtod(text, &end);
+            if (end == text || v < 0.0 || count == kMaxList)
+            {
+                return false;
+            }
+            out[count++] = static_cast<T>(v);
+            text = *end == ',' ? end + 1 : end;
+            if (*end && *end != ',')
+            {
+                return false;
+            }
+        }
+        return count > 0;
+    }
+
+    bool parse(int argc, char **argv, Options &opt)
+    {
+        opt.transport = nullptr;
+        opt.sizes[0] = 16;
+        opt.sizes[1] = 256;
+        opt.sizes[2] = 1024;
+        opt.sizeCount = 3;
+        opt.rates[0] = 0.0;
+        opt.rateCount = 1;
+        opt.count = 100000;
+        opt.batch = false;
+        opt.datagram = false;
+        opt.csv = false;
+        for (int i = 1; i < argc; ++i)
+        {
+            const bool hasValue = i + 1 < argc;
+            if (strcmp(argv[i], "--sizes") == 0 && hasValue)
+            {
+                if (!parseList(argv[++i], opt.sizes, opt.sizeCount))
+                {
+                    return false;
+                }
+            }
+            else if (strcmp(argv[i], "--rates") == 0 && hasValue)
+            {
+                if (!parseList(argv[++i], opt.rates, opt.rateCount))
+                {
+                    return false;
+                }
+            }
+            else if (strcmp(argv[i], "--count") == 0 && hasValue)
+            {
+                opt.count = static_cast<size_t>(strtoull(argv[++i], nullptr, 10));
+            }
+            else if (strcmp(argv[i], "--batch") == 0)
+            {
+                opt.batch = true;
+            }
+            else if (strcmp(argv[i], "--datagram") == 0)
+            {
+                opt.datagram = true;
+            }
+            else if (strcmp(argv[i], "--csv") == 0)
+            {
+                opt.csv = true;
+            }
+            else if (argv[i][0] != '-' && !opt.transport)
+            {
+                opt.transport = argv[i];
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return opt.transport && opt.count > 0;
+    }
+
+    // In-process single-producer/single-consumer byte pipe. write() waits for
+    // room, as a blocking stream socket would.
+    class LoopbackPipe
+    {
+    public:
+        static const size_t kSize = 1u << 20;
+
+        LoopbackPipe() : head_(0), tail_(0) {}
+
+        bool write(const uint8_t *data, size_t length)
+        {
+            while (length)
+            {
+                const size_t head = head_.load(std::memory_order_relaxed);
+                const size_t room = kSize - (head - tail_.load(std::memory_order_acquire));
+                if (room == 0)
+                {
+                    sched_yield();
+                    continue;
+                }
+                const size_t offset = head & (kSize - 1);
+                size_t n = std::min(std::min(length, room), kSize - offset);
+                memcpy(buf_ + offset, data, n);
+                head_.store(head + n, std::memory_order_release);
+                data += n;
+                length -= n;
+            }
+            return true;
+        }
+
+        bool read(uint8_t *data, size_t capacity, size_t &length)
+        {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            const size_t offset = tail & (kSize - 1);
+            length = std::min(std::min(head_.load(std::memory_order_acquire) - tail, capacity), kSize - offset);
+            if (length == 0)
+            {
+                return false;
+            }
+            memcpy(data, buf_ + offset, length);
+            tail_.store(tail + length, std::memory_order_release);
+            return true;
+        }
+
+        bool read(uint8_t &byte)
+        {
+            size_t length;
+            return read(&byte, 1, length);
+        }
+
+    private:
+        std::atomic<size_t> head_;
+        std::atomic<size_t> tail_;
+        uint8_t buf_[kSize];
+    };
+
+    // Write side of a pty master (the SerialPort on the slave receives).
+    struct FdWriter
+    {
+        int fd;
+
+        bool read(uint8_t &) { return false; }
+        bool write(const uint8_t *data, size_t length) { return umsg::posix::detail::writeAll(fd, data, length); }
+    };
+
+    typedef umsg::posix::ShmRing<256, umsg::maxDatagramSize(kMaxPayload), 1> Ring;
+
+    // ShmRing writer that waits for the reader when the ring is full instead
+    // of failing the publish.
+    struct RingWriter
+    {
+        Ring *ring;
+
+        bool readDatagram(umsg::ByteSpan &) { return false; }
+        bool write(const uint8_t *data, size_t length)
+        {
+            while (!ring->write(data, length))
+            {
+                if (ring->readers() == 0)
+                {
+                    return false;
+                }
+                sched_yield();
+            }
+            return true;
+        }
+    };
+
+    class LatencySink
+    {
+    public:
+        void reset(size_t count)
+        {
+            samples_.clear();
+            samples_.reserve(count); // no allocation while receiving
+            received_.store(0, std::memory_order_relaxed);
+            bad_ = 0;
+            reordered_ = 0;
+            nextSeq_ = 0;
+            lastNs_ = 0;
+        }
+
+        umsg::Error onProbe(umsg::ByteSpan payload, uint32_t msgHash)
+        {
+            const uint64_t now = nowNs();
+            umsg::Reader r(payload);
+            uint32_t seq;
+            uint64_t sentNs;
+            if (msgHash != kProbeHash || !r.read(seq) || !r.read(sentNs) || samples_.size() == samples_.capacity())
+            {
+                ++bad_;
+                return umsg::Error::InvalidArgument;
+            }
+            samples_.push_back(now > sentNs ? now - sentNs : 0);
+            if (seq < nextSeq_)
+            {
+                ++reordered_;
+            }
+            else
+            {
+                nextSeq_ = seq + 1;
+            }
+            lastNs_ = now;
+            received_.store(samples_.size(), std::memory_order_release);
+            return umsg::Error::OK;
+        }
+
+        uint64_t received() const { return received_.load(std::memory_order_acquire); }
+        uint64_t reordered() const { return reordered_; }
+        uint64_t lastNs() const { return lastNs_; }
+        std::vector<uint64_t> &samples() { return samples_; }
+
+    private:
+        std::vector<uint64_t> samples_;
+        std::atomic<uint64_t> received_;
+        uint64_t bad_;
+        uint64_t reordered_;
+        uint32_t nextSeq_;
+        uint64_t lastNs_;
+    };
+
+    // Nearest-rank percentile of sorted samples.
+    uint64_t percentile(const std::vector<uint64_t> &sorted, double q)
+    {
+        if (sorted.empty())
+        {
+            return 0;
+        }
+        size_t rank = static_cast<size_t>(q * static_cast<double>(sorted.size()) + 0.999999);
+        rank = rank == 0 ? 1 : std::min(rank, sorted.size());
+        return sorted[rank - 1];
+    }
+
+    void waitUntil(uint64_t deadlineNs)
+    {
+        for (;;)
+        {
+            const uint64_t now = nowNs();
+            if (now >= deadlineNs)
+            {
+                return;
+            }
+            if (deadlineNs - now > 200000) // sleep through long gaps, spin the last 200 us
+            {
+                struct timespec ts;
+                const uint64_t sleepNs = deadlineNs - now - 100000;
+                ts.tv_sec = static_cast<time_t>(sleepNs / 1000000000ull);
+                ts.tv_nsec = static_cast<long>(sleepNs % 1000000000ull);
+                nanosleep(&ts, nullptr);
+            }
+        }
+    }
+
+    /*
+     * One run: @p count probes of @p size bytes at @p rate (0: unpaced) from
+     * @p tx, received on another thread by @p rx (a node or TcpServer with
+     * `subscribe()` and `poll()`).
+     */
+    template <class TxNode, class RxNode>
+    Result run(TxNode &tx, RxNode &rx, bool batch, size_t size, double rate, size_t count)
+    {
+        static LatencySink sink;
+        static uint8_t payload[kMaxPayload];
+        for (size_t i = kProbeHeader; i < size; ++i)
+        {
+            payload[i] = static_cast<uint8_t>(i * 31u + 7u); // every byte value, so COBS and ttys see them all
+        }
+        sink.reset(count);
+        (void)rx.subscribe(kProbeId, &sink, &LatencySink::onProbe);
+
+        std::atomic<bool> sending(true);
+        std::atomic<uint64_t> sent(0);
+        std::thread receiver([&]() {
+            uint64_t lastProgress = 0;
+            uint64_t seen = 0;
+            for (;;)
+            {
+                (void)rx.poll();
+                if (sending.load(std::memory_order_acquire))
+                {
+                    continue;
+                }
+                const uint64_t received = sink.received();
+                if (received >= sent.load(std::memory_order_acquire))
+                {
+                    break;
+                }
+                const uint64_t now = nowNs();
+                if (received != seen || lastProgress == 0)
+                {
+                    seen = received;
+                    lastProgress = now;
+                }
+                else if (now - lastProgress > kDrainNs)
+                {
+                    break;
+                }
+            }
+        });
+
+        Result res;
+        memset(&res, 0, sizeof(res));
+        const double intervalNs = rate > 0.0 ? 1e9 / rate : 0.0;
+        const uint64_t start = nowNs();
+        for (size_t k = 0; k < count; ++k)
+        {
+            uint64_t stamp;
+            if (rate > 0.0)
+            {
+                stamp = start + static_cast<uint64_t>(static_cast<double>(k) * intervalNs);
+                if (batch && nowNs() < stamp)
+                {
+                    (void)tx.flush();
+                }
+                waitUntil(stamp);
+            }
+            else
+            {
+                stamp = nowNs();
+            }
+            const umsg::ByteSpan header = {payload, kProbeHeader};
+            umsg::Writer w(header);
+            (void)w.write(static_cast<uint32_t>(k));
+            (void)w.write(stamp);
+            const umsg::ByteSpan probe = {payload, size};
+            if (tx.publish(kProbeId, kProbeHash, probe) != umsg::Error::OK)
+            {
+                ++res.failed;
+            }
+        }
+        if (batch && tx.flush() != umsg::Error::OK)
+        {
+            ++res.failed; // the tail of the batch was lost; counted as lost below
+        }
+        sent.store(count - std::min<uint64_t>(res.failed, count), std::memory_order_release);
+        sending.store(false, std::memory_order_release);
+        receiver.join();
+
+        std::vector<uint64_t> &samples = sink.samples();
+        std::sort(samples.begin(), samples.end());
+        res.sent = count;
+        res.received = samples.size();
+        res.reordered = sink.reordered();
+        res.seconds = samples.empty() ? 0.0 : static_cast<double>(sink.lastNs() - start) / 1e9;
+        res.p50 = percentile(samples, 0.50);
+        res.p99 = percentile(samples, 0.99);
+        res.p999 = percentile(samples, 0.999);
+        res.max = samples.empty() ? 0 : samples.back();
+        return res;
+    }
+
+    void printHeader(const Options &opt)
+    {
+        if (opt.csv)
+        {
+            printf("transport,size,rate,sent,failed,received,lost,reordered,msgs_per_s,mb_per_s,"
+                   "p50_us,p99_us,p999_us,max_us\n");
+            return;
+        }
+        printf("%s: %zu probes per run%s%s\n", opt.transport, opt.count, opt.batch ? ", batched" : "",
+               opt.datagram ? ", datagram framing" : "");
+        printf("%7s %9s %9s %9s %7s %11s %9s %9s %9s %9s %9s\n", "size", "rate", "sent", "received", "lost",
+               "msgs/s", "MB/s", "p50 us", "p99 us", "p99.9 us", "max us");
+    }
+
+    void printRow(const Options &opt, size_t size, double rate, const Result &r)
+    {
+        const uint64_t lost = r.sent - r.received;
+        const double msgs = r.seconds > 0.0 ? static_cast<double>(r.received) / r.seconds : 0.0;
+        const double mb = msgs * static_cast<double>(size) / 1e6;
+        if (opt.csv)
+        {
+            printf("%s,%zu,%.0f,%llu,%llu,%llu,%llu,%llu,%.0f,%.3f,%.1f,%.1f,%.1f,%.1f\n", opt.transport, size, rate,
+                   static_cast<unsigned long long>(r.sent), static_cast<unsigned long long>(r.failed),
+                   static_cast<unsigned long long>(r.received), static_cast<unsigned long long>(lost),
+                   static_cast<unsigned long long>(r.reordered), msgs, mb, r.p50 / 1e3, r.p99 / 1e3, r.p999 / 1e3,
+                   r.max / 1e3);
+            return;
+        }
+        char rateText[16];
+        if (rate > 0.0)
+        {
+            snprintf(rateText, sizeof(rateText), "%.0f", rate);
+        }
+        else
+        {
+            snprintf(rateText, sizeof(rateText), "max");
+        }
+        printf("%7zu %9s %9llu %9llu %7llu %11.0f %9.2f %9.1f %9.1f %9.1f %9.1f\n", size, rateText,
+               static_cast<unsigned long long>(r.sent), static_cast<unsigned long long>(r.received),
+               static_cast<unsigned long long>(lost), msgs, mb, r.p50 / 1e3, r.p99 / 1e3, r.p999 / 1e3, r.max / 1e3);
+        if (r.failed)
+        {
+            printf("%7s %llu publishes failed\n", "", static_cast<unsigned long long>(r.failed));
+        }
+    }
+
+    // Every size and rate of @p opt through one sender/receiver pair.
+    template <class TxNode, class RxNode>
+    int sweep(const Options &opt, TxNode &tx, RxNode &rx, umsg::TxBatchBuffer &batch, size_t maxSize)
+    {
+        for (size_t s = 0; s < opt.sizeCount; ++s)
+        {
+            if (opt.sizes[s] < kProbeHeader || opt.sizes[s] > maxSize)
+            {
+                fprintf(stderr, "%s: payload sizes must be %zu..%zu bytes\n", opt.transport, kProbeHeader, maxSize);
+                return 1;
+            }
+        }
+        if (opt.batch)
+        {
+            tx.beginBatch(batch);
+        }
+        printHeader(opt);
+        for (size_t s = 0; s < opt.sizeCount; ++s)
+        {
+            for (size_t r = 0; r < opt.rateCount; ++r)
+            {
+                printRow(opt, opt.sizes[s], opt.rates[r], run(tx, rx, opt.batch, opt.sizes[s], opt.rates[r], opt.count));
+                fflush(stdout);
+            }
+        }
+        return 0;
+    }
+
+    // Node buffers run to ~100 KB at kMaxPayload, hence the statics below.
+    template <class Transport>
+    struct StreamNode
+    {
+        typedef umsg::Node<Transport, kMaxPayload, 1> Type;
+    };
+
+    template <class Transport>
+    struct DatagramNodeOf
+    {
+        typedef umsg::DatagramNode<Transport, kMaxPayload, 1> Type;
+    };
+
+    umsg::TxBatch<16384> streamBatch;
+    umsg::TxBatch<umsg::posix::UdpSocket::kDatagramSize> datagramBatch;
+
+    int runLoopback(const Options &opt)
+    {
+        static LoopbackPipe pipe;
+        static StreamNode<LoopbackPipe>::Type tx(pipe);
+        static StreamNode<LoopbackPipe>::Type rx(pipe);
+        return sweep(opt, tx, rx, streamBatch, kMaxPayload);
+    }
+
+    int runUdp(const Options &opt)
+    {
+        static umsg::posix::UdpSocket rxSocket;
+        static umsg::posix::UdpSocket txSocket;
+        if (!rxSocket.bind(0) || !txSocket.bind(0))
+        {
+            fprintf(stderr, "udp: cannot bind sockets\n");
+            return 1;
+        }
+        txSocket.setDestination("127.0.0.1", rxSocket.port());
+        if (opt.datagram)
+        {
+            static DatagramNodeOf<umsg::posix::UdpSocket>::Type tx(txSocket);
+            static DatagramNodeOf<umsg::posix::UdpSocket>::Type rx(rxSocket);
+            const size_t maxSize = umsg::posix::UdpSocket::kDatagramSize - umsg::maxDatagramSize(0);
+            return sweep(opt, tx, rx, datagramBatch, std::min(maxSize, kMaxPayload));
+        }
+        static StreamNode<umsg::posix::UdpSocket>::Type tx(txSocket);
+        static StreamNode<umsg::posix::UdpSocket>::Type rx(rxSocket);
+        return sweep(opt, tx, rx, streamBatch, kMaxPayload);
+    }
+
+    int runTcp(const Options &opt)
+    {
+        static umsg::posix::TcpServer<kMaxPayload, 1, 1> server;
+        static umsg::posix::TcpClient client;
+        if (!server.listen(0) || !client.connect("127.0.0.1", server.port()))
+        {
+            fprintf(stderr, "tcp: cannot connect to a local listener\n");
+            return 1;
+        }
+        // Probes are small and latency-sensitive; batching is --batch's job, not Nagle's.
+        int one = 1;
+        ::setsockopt(client.nativeHandle(), IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        static StreamNode<umsg::posix::TcpClient>::Type tx(client);
+        return sweep(opt, tx, server, streamBatch, kMaxPayload);
+    }
+
+    int runPty(const Options &opt)
+    {
+        const int master = ::posix_openpt(O_RDWR | O_NOCTTY);
+        static umsg::posix::SerialPort slave;
+        if (master < 0 || ::grantpt(master) != 0 || ::unlockpt(master) != 0 || !slave.open(::ptsname(master)))
+        {
+            fprintf(stderr, "pty: cannot open a pseudo-terminal pair\n");
+            return 1;
+        }
+        static FdWriter writer = {master};
+        static StreamNode<FdWriter>::Type tx(writer);
+        static StreamNode<umsg::posix::SerialPort>::Type rx(slave);
+        const int rc = sweep(opt, tx, rx, streamBatch, kMaxPayload);
+        ::close(master);
+        return rc;
+    }
+
+    bool baudConstant(long baud, speed_t &out)
+    {
+        static const struct
+        {
+            long baud;
+            speed_t constant;
+        } kRates[] = {
+            {9600, B9600}, {19200, B19200}, {38400, B38400}, {57600, B57600}, {115200, B115200}, {230400, B230400},
+#ifdef B460800
+            {460800, B460800},
+#endif
+#ifdef B921600
+            {921600, B921600},
+#endif
+        };
+        for (size_t i = 0; i < sizeof(kRates) / sizeof(kRates[0]); ++i)
+        {
+            if (kRates[i].baud == baud)
+            {
+                out = kRates[i].constant;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int runSerial(const Options &opt, const char *spec)
+    {
+        char device[256];
+        const char *at = strchr(spec, '@');
+        const size_t n = at ? static_cast<size_t>(at - spec) : strlen(spec);
+        speed_t baud = B115200;
+        if (n == 0 || n >= sizeof(device) || (at && !baudConstant(atol(at + 1), baud)))
+        {
+            fprintf(stderr, "serial: expected serial:DEVICE[@BAUD] with a standard baud rate\n");
+            return 1;
+        }
+        memcpy(device, spec, n);
+        device[n] = 0;
+
+        static umsg::posix::SerialPort port;
+        if (!port.open(device, baud))
+        {
+            fprintf(stderr, "serial: cannot open %s\n", device);
+            return 1;
+        }
+        static StreamNode<umsg::posix::SerialPort>::Type tx(port);
+        static StreamNode<umsg::posix::SerialPort>::Type rx(port);
+        return sweep(opt, tx, rx, streamBatch, kMaxPayload);
+    }
+
+    int runShm(const Options &opt)
+    {
+        if (opt.batch)
+        {
+            fprintf(stderr, "shm: one message per slot, --batch does not apply\n");
+            return 1;
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "/umsg_loadgen_%d", static_cast<int>(getpid()));
+        static Ring writerRing;
+        static Ring readerRing;
+        if (!writerRing.create(name) || !readerRing.attach(name))
+        {
+            fprintf(stderr, "shm: cannot create %s\n", name);
+            return 1;
+        }
+        static RingWriter writer = {&writerRing};
+        static DatagramNodeOf<RingWriter>::Type tx(writer);
+        static DatagramNodeOf<Ring>::Type rx(readerRing);
+        const int rc = sweep(opt, tx, rx, datagramBatch, kMaxPayload);
+        readerRing.close();
+        writerRing.close();
+        return rc;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    if (!parse(argc, argv, opt))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    if (opt.datagram && strcmp(opt.transport, "udp") != 0)
+    {
+        fprintf(stderr, "--datagram applies to udp only\n");
+        return 1;
+    }
+
+    if (strcmp(opt.transport, "loopback") == 0)
+    {
+        return runLoopback(opt);
+    }
+    if (strcmp(opt.transport, "udp") == 0)
+    {
+        return runUdp(opt);
+    }
+    if (strcmp(opt.transport, "tcp") == 0)
+    {
+        return runTcp(opt);
+    }
+    if (strcmp(opt.transport, "pty") == 0)
+    {
+        return runPty(opt);
+    }
+    if (strncmp(opt.transport, "serial:", 7) == 0)
+    {
+        return runSerial(opt, opt.transport + 7);
+    }
+    if (strcmp(opt.transport, "shm") == 0)
+    {
+        return runShm(opt);
+    }
+    usage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,287 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <umsg/transports/posix/frame_log.hpp>
+#include <umsg/transports/posix/udp_socket.hpp>
+#include <umsg/umsg.h>
+
+/*
+ * umsg_replay
+ *
+ * Offline tool for frame logs written by umsg::posix::Recorder.
+ *
+ *   umsg_replay [--from SEC] LOG                 per-msg_id summary
+ *   umsg_replay --bench [--from SEC] LOG         dispatch throughput through a DatagramNode
+ *   umsg_replay --to IP:PORT [--speed X] LOG     replay to a DatagramNode peer over UDP
+ *
+ * --speed: 1 = recorded timing (default for --to), 2 = twice as fast, 0 = as
+ * fast as possible.
+ */
+
+namespace
+{
+    const size_t kMaxPayload = 0xFFFF;
+
+    struct Options
+    {
+        const char *log;
+        const char *to;
+        double speed;
+        double fromSeconds;
+        bool bench;
+    };
+
+    struct MsgSummary
+    {
+        uint64_t frames;
+        uint64_t bytes;
+        uint64_t firstNs;
+        uint64_t lastNs;
+    };
+
+    void usage(const char *argv0)
+    {
+        fprintf(stderr,
+                "Usage: %s [--bench | --to IP:PORT [--speed X]] [--from SEC] LOG\n"
+                "  (default)     per-msg_id frame counts, bytes and rates\n"
+                "  --bench       feed the log through a DatagramNode as fast as possible\n"
+                "  --to IP:PORT  send each record as a datagram (peer: DatagramNode)\n"
+                "  --speed X     1 = recorded timing (default with --to), 0 = no pacing\n"
+                "  --from SEC    start SEC seconds into the recording\n",
+                argv0);
+    }
+
+    bool parse(int argc, char **argv, Options &opt)
+    {
+        opt.log = nullptr;
+        opt.to = nullptr;
+        opt.speed = -1.0;
+        opt.fromSeconds = 0.0;
+        opt.bench = false;
+        for (int i = 1; i < argc; ++i)
+        {
+            const bool hasValue = i + 1 < argc;
+            if (strcmp(argv[i], "--bench") == 0)
+            {
+                opt.bench = true;
+            }
+            else if (strcmp(argv[i], "--to") == 0 && hasValue)
+            {
+                opt.to = argv[++i];
+            }
+            else if (strcmp(argv[i], "--speed") == 0 && hasValue)
+            {
+                opt.speed = atof(argv[++i]);
+            }
+            else if (strcmp(argv[i], "--from") == 0 && hasValue)
+            {
+                opt.fromSeconds = atof(argv[++i]);
+            }
+            else if (argv[i][0] != '-' && !opt.log)
+            {
+                opt.log = argv[i];
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return opt.log && !(opt.bench && opt.to);
+    }
+
+    double seconds(uint64_t ns) { return static_cast<double>(ns) / 1e9; }
+
+    // Header-only pass over the log: no handler runs, nothing is decoded.
+    int summarize(umsg::posix::Replayer &log)
+    {
+        static MsgSummary perId[256];
+        uint64_t frames = 0;
+        uint64_t bytes = 0;
+        uint64_t bad = 0;
+        const uint64_t firstNs = log.nextTimeNs();
+        uint64_t lastNs = firstNs;
+        for (;;)
+        {
+            const uint64_t tNs = log.nextTimeNs();
+            umsg::ByteSpan datagram;
+            if (!log.readDatagram(datagram))
+            {
+                break;
+            }
+            lastNs = tNs;
+            umsg::DatagramDeframer deframer;
+            deframer.load(datagram);
+            umsg::ByteSpan frame;
+            umsg::protocol::Header h;
+            umsg::ByteSpan payload;
+            if (deframer.next(frame) != umsg::Error::OK ||
+                umsg::protocol::decodeFrame(frame, h, payload) != umsg::Error::OK)
+            {
+                ++bad;
+                continue;
+            }
+            MsgSummary &s = perId[h.msgId];
+            if (s.frames == 0)
+            {
+                s.firstNs = tNs;
+            }
+            ++s.frames;
+            s.bytes += payload.length;
+            s.lastNs = tNs;
+            ++frames;
+            bytes += payload.length;
+        }
+
+        const double span = seconds(lastNs - firstNs);
+        printf("%llu frames, %llu payload bytes, %.3f s (%.3f .. %.3f)",
+               static_cast<unsigned long long>(frames), static_cast<unsigned long long>(bytes), span,
+               seconds(firstNs), seconds(lastNs));
+        printf(bad ? ", %llu corrupt records\n" : "\n", static_cast<unsigned long long>(bad));
+        printf("%6s %12s %14s %10s %12s\n", "msg_id", "frames", "bytes", "avg size", "rate (Hz)");
+        for (size_t id = 0; id < 256; ++id)
+        {
+            const MsgSummary &s = perId[id];
+            if (s.frames == 0)
+            {
+                continue;
+            }
+            const double active = seconds(s.lastNs - s.firstNs);
+            printf("%6zu %12llu %14llu %10.1f %12.1f\n", id, static_cast<unsigned long long>(s.frames),
+                   static_cast<unsigned long long>(s.bytes), static_cast<double>(s.bytes) / s.frames,
+                   active > 0.0 ? (s.frames - 1) / active : 0.0);
+        }
+        return bad ? 2 : 0;
+    }
+
+    struct CountingSink
+    {
+        uint64_t frames;
+        uint64_t bytes;
+
+        umsg::Error onPayload(umsg::ByteSpan payload, uint32_t)
+        {
+            ++frames;
+            bytes += payload.length;
+            return umsg::Error::OK;
+        }
+    };
+
+    // Handlers in the dense msg_id table (at most 254 of them).
+    typedef umsg::BasicNode<umsg::posix::Replayer, kMaxPayload, umsg::Dispatcher<254, true>, umsg::DatagramFraming>
+        ReplayNode;
+
+    int bench(umsg::posix::Replayer &log, uint64_t fromNs)
+    {
+        static CountingSink sink;
+        static ReplayNode node(log); // static: ~128 KB of packet buffers
+
+        // Subscribe the msg_ids the log holds, then rewind for the timed pass.
+        bool seen[256] = {false};
+        umsg::ByteSpan datagram;
+        while (log.readDatagram(datagram))
+        {
+            if (datagram.length >= umsg::kFrameHeaderSize)
+            {
+                seen[datagram.data[1]] = true;
+            }
+        }
+        for (size_t id = 0; id < 256; ++id)
+        {
+            if (seen[id] && node.subscribe(static_cast<uint8_t>(id), &sink, &CountingSink::onPayload) != umsg::Error::OK)
+            {
+                fprintf(stderr, "more msg_ids than handler slots; msg_id %zu is not counted\n", id);
+            }
+        }
+        (void)log.seek(fromNs);
+
+        const uint64_t logBytes = log.remaining();
+        const uint64_t start = umsg::posix::detail::clockNs(CLOCK_MONOTONIC);
+        while (!log.done())
+        {
+            (void)node.poll();
+        }
+        const double elapsed = seconds(umsg::posix::detail::clockNs(CLOCK_MONOTONIC) - start);
+        printf("%llu frames dispatched in %.3f s: %.0f frames/s, %.1f MB/s of log, %.1f MB/s of payload\n",
+               static_cast<unsigned long long>(sink.frames), elapsed, sink.frames / elapsed, logBytes / elapsed / 1e6,
+               sink.bytes / elapsed / 1e6);
+        return 0;
+    }
+
+    int replayTo(umsg::posix::Replayer &log, const char *to)
+    {
+        char ip[64];
+        const char *colon = strrchr(to, ':');
+        if (!colon || static_cast<size_t>(colon - to) >= sizeof(ip))
+        {
+            fprintf(stderr, "--to expects IP:PORT\n");
+            return 1;
+        }
+        memcpy(ip, to, static_cast<size_t>(colon - to));
+        ip[colon - to] = 0;
+
+        umsg::posix::UdpSocket udp;
+        if (!udp.bind(0))
+        {
+            fprintf(stderr, "cannot open a UDP socket\n");
+            return 1;
+        }
+        udp.setDestination(ip, static_cast<uint16_t>(atoi(colon + 1)));
+
+        uint64_t sent = 0;
+        uint64_t failed = 0;
+        umsg::ByteSpan datagram;
+        while (log.wait())
+        {
+            while (log.readDatagram(datagram))
+            {
+                if (udp.write(datagram.data, datagram.length))
+                {
+                    ++sent;
+                }
+                else
+                {
+                    ++failed;
+                }
+            }
+        }
+        printf("%llu datagrams sent, %llu failed\n", static_cast<unsigned long long>(sent),
+               static_cast<unsigned long long>(failed));
+        return failed ? 2 : 0;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    if (!parse(argc, argv, opt))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    umsg::posix::Replayer log;
+    if (!log.open(opt.log))
+    {
+        fprintf(stderr, "%s: not a umsg frame log\n", opt.log);
+        return 1;
+    }
+    const uint64_t fromNs = static_cast<uint64_t>(opt.fromSeconds * 1e9);
+    if (!log.seek(fromNs))
+    {
+        fprintf(stderr, "%s: no records after %.3f s\n", opt.log, opt.fromSeconds);
+        return 1;
+    }
+
+    if (opt.bench)
+    {
+        return bench(log, fromNs);
+    }
+    if (opt.to)
+    {
+        log.setSpeed(opt.speed < 0.0 ? 1.0 : opt.speed);
+        return replayTo(log, opt.to);
+    }
+    return summarize(log);
+}